@@ -40,6 +40,8 @@ struct GameLogin
     std::string charUuid;
     std::string mapUuid;
     std::string instanceUuid;
+    /// Client can decompress messages
+    bool compression;
 
     template<typename _Ar>
     void Serialize(_Ar& ar)
@@ -53,6 +55,7 @@ struct GameLogin
         ar.value(charUuid);
         ar.value(mapUuid);
         ar.value(instanceUuid);
+        ar.value(compression);
     }
 };
 
@@ -22,12 +22,13 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 namespace AB
 {
 
 /// Increase whenever the protocol changes
-static constexpr uint16_t PROTOCOL_VERSION = 1;
+static constexpr uint16_t PROTOCOL_VERSION = 2;
 
 static constexpr uint16_t CLIENT_OS_WIN = 1;
 static constexpr uint16_t CLIENT_OS_LINUX = 2;
@@ -49,6 +50,15 @@ enum ProtocolIds : uint8_t
 
 #define ENABLE_GAME_ENCRYTION true
 
+/// When the client asks for it, the game server compresses its messages with LZ4 in
+/// streaming mode before encrypting them. Such messages have this bit set in the
+/// message size, and the (encrypted) body starts with the uint16_t size of the
+/// compressed data. An uncompressed message resets the stream.
+static constexpr uint16_t MESSAGE_COMPRESSED_FLAG = 0x8000;
+/// The compression history, client and server must use the same sizes
+static constexpr size_t COMPRESSION_HISTORY_SIZE = 16 * 1024;
+static constexpr size_t COMPRESSION_MAX_BLOCK_SIZE = 4096;
+
 const uint32_t ENC_KEY[4] = {
     0xd705d09f,
     0x72a8a08c,
@@ -263,6 +273,7 @@ enum class ErrorCodes : uint8_t
     AllServersFull,
     TokenAuthFailure,
     AccountKeyAlreadyAdded,
+    ServerBusy,
 
     ErrorException = 0xff
 };
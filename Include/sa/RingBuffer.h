@@ -0,0 +1,106 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <sa/Assert.h>
+
+namespace sa {
+
+/// FIFO queue on a ring of slots. Unlike CircularQueue it grows when it is full
+/// and never drops elements. Slots are kept when elements are removed, so once it
+/// reached its working size it does not allocate anymore.
+template <typename T>
+class RingBuffer
+{
+private:
+    std::vector<T> slots_;
+    size_t head_{ 0 };
+    size_t size_{ 0 };
+    size_t Index(size_t index) const { return (head_ + index) & (slots_.size() - 1); }
+    void Grow()
+    {
+        // Capacity is always a power of 2
+        std::vector<T> slots(slots_.empty() ? 8 : slots_.size() * 2);
+        for (size_t i = 0; i < size_; ++i)
+            slots[i] = std::move(slots_[Index(i)]);
+        slots_ = std::move(slots);
+        head_ = 0;
+    }
+public:
+    RingBuffer() = default;
+    explicit RingBuffer(size_t capacity)
+    {
+        size_t c = 8;
+        while (c < capacity)
+            c *= 2;
+        slots_.resize(c);
+    }
+
+    void PushBack(T&& value)
+    {
+        if (size_ == slots_.size())
+            Grow();
+        slots_[Index(size_)] = std::move(value);
+        ++size_;
+    }
+    void PushBack(const T& value)
+    {
+        PushBack(T(value));
+    }
+    void PopFront()
+    {
+        ASSERT(!IsEmpty());
+        // Release what the element holds, but keep the slot
+        slots_[head_] = T();
+        head_ = Index(1);
+        --size_;
+    }
+    void Clear()
+    {
+        while (!IsEmpty())
+            PopFront();
+        head_ = 0;
+    }
+
+    [[nodiscard]] T& At(size_t index)
+    {
+        ASSERT(index < size_);
+        return slots_[Index(index)];
+    }
+    [[nodiscard]] const T& At(size_t index) const
+    {
+        ASSERT(index < size_);
+        return slots_[Index(index)];
+    }
+    [[nodiscard]] T& Front() { return At(0); }
+    [[nodiscard]] const T& Front() const { return At(0); }
+    [[nodiscard]] T& Back() { return At(size_ - 1); }
+    [[nodiscard]] const T& Back() const { return At(size_ - 1); }
+    size_t Size() const { return size_; }
+    size_t Capacity() const { return slots_.size(); }
+    bool IsEmpty() const { return size_ == 0; }
+};
+
+}
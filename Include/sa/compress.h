@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <iostream>
+#include <cstring>
 #include <sa/Noncopyable.h>
 #ifdef SA_ZLIB_SUPPORT
 #include <zlib.h>
@@ -259,6 +260,90 @@ public:
         return false;
     }
 };
+
+/// Compresses a stream of blocks, e.g. network messages. Each block is compressed on
+/// its own, but it can reference the previous HistorySize bytes, which works well for
+/// many small and similar blocks. The blocks are copied into a ring buffer which is
+/// the history. lz4_stream_decompress must use the same HistorySize and MaxBlockSize
+/// to be able to decompress the blocks, in the same order.
+template<size_t HistorySize, size_t MaxBlockSize>
+class lz4_stream_compress
+{
+    NON_COPYABLE(lz4_stream_compress)
+    NON_MOVEABLE(lz4_stream_compress)
+private:
+    LZ4_stream_t stream_;
+    char ring_[HistorySize + MaxBlockSize];
+    size_t pos_{ 0 };
+public:
+    lz4_stream_compress()
+    {
+        LZ4_resetStream(&stream_);
+    }
+    /// Forget the history. The decompressor must also be reset.
+    void reset()
+    {
+        LZ4_resetStream(&stream_);
+        pos_ = 0;
+    }
+    /// When it fails, e.g. because out is too small, the stream is reset.
+    bool operator()(const char* in, size_t in_size, char* out, size_t& out_size)
+    {
+        if (in_size == 0 || in_size > MaxBlockSize)
+            return false;
+        char* block = ring_ + pos_;
+        memcpy(block, in, in_size);
+        int ret = LZ4_compress_fast_continue(&stream_, block, out, (int)in_size, (int)out_size, 1);
+        if (ret <= 0)
+        {
+            reset();
+            return false;
+        }
+        pos_ += in_size;
+        if (pos_ >= HistorySize)
+            pos_ = 0;
+        out_size = ret;
+        return true;
+    }
+};
+
+template<size_t HistorySize, size_t MaxBlockSize>
+class lz4_stream_decompress
+{
+    NON_COPYABLE(lz4_stream_decompress)
+    NON_MOVEABLE(lz4_stream_decompress)
+private:
+    LZ4_streamDecode_t stream_;
+    char ring_[HistorySize + MaxBlockSize];
+    size_t pos_{ 0 };
+public:
+    lz4_stream_decompress()
+    {
+        LZ4_setStreamDecode(&stream_, nullptr, 0);
+    }
+    void reset()
+    {
+        LZ4_setStreamDecode(&stream_, nullptr, 0);
+        pos_ = 0;
+    }
+    /// When it fails the stream is reset.
+    bool operator()(const char* in, size_t in_size, char* out, size_t& out_size)
+    {
+        char* block = ring_ + pos_;
+        int ret = LZ4_decompress_safe_continue(&stream_, in, block, (int)in_size, (int)MaxBlockSize);
+        if (ret <= 0 || (size_t)ret > out_size)
+        {
+            reset();
+            return false;
+        }
+        memcpy(out, block, (size_t)ret);
+        pos_ += (size_t)ret;
+        if (pos_ >= HistorySize)
+            pos_ = 0;
+        out_size = ret;
+        return true;
+    }
+};
 #endif
 
 }
@@ -23,6 +23,7 @@
 #include "Application.h"
 #include "Version.h"
 #include "Server.h"
+#include "DatabaseWorkers.h"
 #include <abscommon/Logo.h>
 #include <abdb/Database.h>
 #include <abscommon/StringUtils.h>
@@ -45,13 +46,15 @@ Application::Application() :
     readonly_(false),
     ioService_(),
     flushInterval_(FLUSH_CACHE_MS),
-    cleanInterval_(CLEAN_CACHE_MS)
+    cleanInterval_(CLEAN_CACHE_MS),
+    dbThreads_(0)
 {
     programDescription_ = SERVER_PRODUCT_NAME;
     serverType_ = AB::Entities::ServiceTypeDataServer;
     Subsystems::Instance.CreateSubsystem<Asynch::Dispatcher>();
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
+    Subsystems::Instance.CreateSubsystem<DB::DatabaseWorkers>();
 
     std::stringstream dbDrivers;
 #ifdef USE_SQLITE
@@ -199,6 +202,7 @@ bool Application::LoadConfig()
 
     flushInterval_ = static_cast<uint32_t>(config->GetGlobalInt("flush_interval", flushInterval_));
     cleanInterval_ = static_cast<uint32_t>(config->GetGlobalInt("clean_interval", cleanInterval_));
+    dbThreads_ = static_cast<size_t>(config->GetGlobalInt("db_threads", static_cast<int64_t>(dbThreads_)));
 
     if (serverPort_ == 0)
     {
@@ -252,6 +256,7 @@ void Application::PrintServerInfo()
     LOG_INFO << "  Port: " << DB::Database::dbPort_ << std::endl;
     LOG_INFO << "  User: " << DB::Database::dbUser_ << std::endl;
     LOG_INFO << "  Password: " << (DB::Database::dbPass_.empty() ? "(empty)" : "***********") << std::endl;
+    LOG_INFO << "  Worker threads: " << GetSubsystem<DB::DatabaseWorkers>()->GetNumThreads() << std::endl;
 }
 
 int Application::GetDatabaseVersion()
@@ -377,6 +382,14 @@ bool Application::Initialize(const std::vector<std::string>& args)
         return false;
     }
     Subsystems::Instance.RegisterSubsystem<DB::Database>(db);
+    auto* workers = GetSubsystem<DB::DatabaseWorkers>();
+    workers->SetNumThreads(dbThreads_);
+    if (!workers->Start())
+    {
+        LOG_INFO << "[FAIL]" << std::endl;
+        LOG_ERROR << "Database connection of worker failed" << std::endl;
+        return false;
+    }
     LOG_INFO << "[done]" << std::endl;
     if (!CheckDatabaseVersion())
         return false;
@@ -448,4 +461,5 @@ void Application::Stop()
         LOG_ERROR << "Error reading service" << std::endl;
 
     server_->Shutdown();
+    GetSubsystem<DB::DatabaseWorkers>()->Stop();
 }
@@ -38,6 +38,8 @@ private:
     ea::unique_ptr<Server> server_;
     uint32_t flushInterval_;
     uint32_t cleanInterval_;
+    /// Number of DB worker threads, 0 = number of CPU cores
+    size_t dbThreads_;
     Net::IpList whiteList_;
     bool LoadConfig();
     void PrintServerInfo();
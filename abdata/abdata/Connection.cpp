@@ -25,6 +25,7 @@
 #include <algorithm>
 #include "ConnectionManager.h"
 #include "StorageProvider.h"
+#include <sa/Assert.h>
 
 sa::IdGenerator<uint32_t> Connection::idGenerator;
 
@@ -40,9 +41,12 @@ Connection::Connection(asio::io_service& io_service, ConnectionManager& manager,
 
 Connection::~Connection()
 {
-    // If we die, i guess it's a good idea to unlock all entities locked by us
+    // If we die, i guess it's a good idea to unlock all entities locked by us.
+    // Only the dispatcher thread modifies the cache.
     if (started_)
-        storageProvider_.UnlockAll(id_);
+        GetSubsystem<Asynch::Dispatcher>()->Add(
+            Asynch::CreateTask(std::bind(&StorageProvider::UnlockAll, &storageProvider_, id_))
+        );
 }
 
 asio::ip::tcp::socket& Connection::GetSocket()
@@ -53,228 +57,7 @@ asio::ip::tcp::socket& Connection::GetSocket()
 void Connection::Start()
 {
     started_ = true;
-    data_.reset(new StorageData(3));
-    auto self(shared_from_this());
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(3),
-        [this, self](const asio::error_code& error, size_t /* bytes_transferred */)
-    {
-        if (!error)
-        {
-            opcode_ = static_cast<IO::OpCodes>(data_->at(0));
-            const uint16_t keySize = ToInt16(*data_, 1);
-            if (keySize <= maxKeySize_)
-                StartReadKey(keySize);
-            else
-                AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::KeyTooBig, "Supplied key is too big. Maximum allowed key size is: " + std::to_string(maxKeySize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
-}
-
-void Connection::StartReadKey(uint16_t keySize)
-{
-    key_.resize(keySize);
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(key_.data_), asio::transfer_at_least(keySize),
-        [this, self, keySize](const asio::error_code& error, size_t byteTransferred)
-    {
-        if (!error)
-        {
-            if (static_cast<uint16_t>(byteTransferred) != keySize)
-                AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Data sent is not equal to the expected size");
-            else
-                StartClientRequestedOp();
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
-}
-
-void Connection::StartLockOperation()
-{
-    if (storageProvider_.Lock(id_, key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
-}
-
-void Connection::StartUnlockOperation()
-{
-    if (storageProvider_.Unlock(id_, key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
-}
-
-void Connection::StartCreateOperation()
-{
-    data_.reset(new StorageData(4));
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
-    {
-        if (!error)
-        {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new StorageData(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleCreateReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
-}
-
-void Connection::StartUpdateDataOperation()
-{
-    data_.reset(new StorageData(4));
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
-    {
-        if (!error)
-        {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new StorageData(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleUpdateReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
-}
-
-void Connection::StartReadOperation()
-{
-    data_.reset(new StorageData(4));
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
-    {
-        if (!error && bytes_transferred >= 4)
-        {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new StorageData(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleReadReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
-}
-
-void Connection::StartDeleteOperation()
-{
-    if (storageProvider_.Delete(id_, key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
-}
-
-void Connection::StartInvalidateOperation()
-{
-    if (storageProvider_.Invalidate(id_, key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
-}
-
-void Connection::StartPreloadOperation()
-{
-    if (storageProvider_.Preload(id_, key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
-}
-
-void Connection::StartExistsOperation()
-{
-    data_.reset(new StorageData(4));
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
-    {
-        if (!error)
-        {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new StorageData(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleExistsReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
-}
-
-void Connection::StartClearOperation()
-{
-    if (storageProvider_.Clear(id_, key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Other Error");
+    StartReadRequest();
 }
 
 void Connection::Stop()
@@ -282,230 +65,379 @@ void Connection::Stop()
     socket_.close();
 }
 
-void Connection::HandleUpdateReadRawData(const asio::error_code& error,
-    size_t bytes_transferred, size_t expected)
+void Connection::HandleNetworkError(const asio::error_code& error)
 {
-    // Network/main thread
-    if (error)
-    {
+    if (error != asio::error::eof && error != asio::error::operation_aborted)
         LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
-        return;
-    }
-
-    if (bytes_transferred != expected)
-    {
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        return;
-    }
-
-    AddTask(&Connection::UpdateDataTask);
-}
-
-void Connection::UpdateDataTask()
-{
-    bool res = storageProvider_.Update(id_, key_, data_);
-    if (res)
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Error");
-}
-
-void Connection::HandleCreateReadRawData(const asio::error_code& error,
-    size_t bytes_transferred, size_t expected)
-{
-    // Network/main thread
-    if (error)
-    {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
-        return;
-    }
-
-    if (bytes_transferred != expected)
-    {
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        return;
-    }
-
-    AddTask(&Connection::CreateDataTask);
+    connectionManager_.Stop(shared_from_this());
 }
 
-void Connection::CreateDataTask()
+void Connection::StartReadRequest()
 {
-    bool res = storageProvider_.Create(id_, key_, data_);
-    if (res)
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Error");
+    asio::async_read(socket_, asio::buffer(header_),
+        std::bind(&Connection::HandleReadHeader, shared_from_this(), std::placeholders::_1));
 }
 
-void Connection::HandleReadReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected)
+void Connection::HandleReadHeader(const asio::error_code& error)
 {
-    // Network/main thread
+    // Network thread
     if (error)
     {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
+        HandleNetworkError(error);
         return;
     }
 
-    if (!data_)
+    auto request = ea::make_shared<Request>();
+    request->opcode = static_cast<IO::OpCodes>(header_[0]);
+    request->id = ToInt32(&header_[1]);
+    const uint16_t keySize = ToInt16(&header_[5]);
+    const uint32_t dataSize = ToInt32(&header_[7]);
+    // We can't skip the body of a request we don't read, so close the connection after sending the error
+    if (keySize > maxKeySize_)
     {
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::NoSuchKey, "Requested data not in cache");
+        closeAfterWrite_ = true;
+        AddTask(&Connection::SendStatus, request->id, IO::ErrorCodes::KeyTooBig, "Supplied key is too big. Maximum allowed key size is: " + std::to_string(maxKeySize_));
         return;
     }
-    if (bytes_transferred != expected)
-    {
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        return;
-    }
-
-    AddTask(&Connection::ReadDataTask);
-}
-
-void Connection::ReadDataTask()
-{
-    bool res = storageProvider_.Read(id_, key_, data_);
-
-    if (!res)
+    if (dataSize > maxDataSize_)
     {
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Error");
+        closeAfterWrite_ = true;
+        AddTask(&Connection::SendStatus, request->id, IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
         return;
     }
 
-    uint8_t header[] = {
-        static_cast<uint8_t>(IO::OpCodes::Data),
-        static_cast<uint8_t>(data_->size()),
-        static_cast<uint8_t>(data_->size() >> 8),
-        static_cast<uint8_t>(data_->size() >> 16),
-        static_cast<uint8_t>(data_->size() >> 24)
-    };
-
-    std::vector<asio::mutable_buffer> bufs = {
-        asio::buffer(header),
-        asio::buffer(*data_.get())
+    request->key.resize(keySize);
+    request->data = ea::make_shared<StorageData>(dataSize);
+    std::array<asio::mutable_buffer, 2> buffers = {
+        asio::buffer(request->key.data_),
+        asio::buffer(*request->data)
     };
-    SendResponseAndStart(bufs, data_->size() + 4);
+    asio::async_read(socket_, buffers,
+        std::bind(&Connection::HandleReadBody, shared_from_this(), std::placeholders::_1, request));
 }
 
-void Connection::HandleExistsReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected)
+void Connection::HandleReadBody(const asio::error_code& error, ea::shared_ptr<Request> request)
 {
-    // Network/main thread
+    // Network thread
     if (error)
     {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
+        HandleNetworkError(error);
         return;
     }
 
-    if (bytes_transferred != expected)
+    StorageBlob cached;
+    if (request->opcode == IO::OpCodes::Read && pending_ == 0 &&
+        storageProvider_.ReadCached(request->key, cached))
     {
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        return;
+        // Cache hit, no need to wait for the dispatcher
+        SendData(request->id, std::move(cached));
     }
-
-    AddTask(&Connection::ExistsDataTask);
-}
-
-void Connection::ExistsDataTask()
-{
-    bool res = storageProvider_.Exists(id_, key_, data_);
-    if (res)
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::NotExists, "Record does not exist");
-}
-
-void Connection::HandleWriteReqResponse(const asio::error_code& error)
-{
-    if (!error)
-        Start();
     else
     {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
+        ++pending_;
+        AddTask(&Connection::HandleRequest, request);
     }
+    // Don't wait for the answer, read the next request
+    StartReadRequest();
 }
 
-void Connection::StartClientRequestedOp()
+void Connection::HandleRequest(ea::shared_ptr<Request> request)
 {
-    // All this executed in dispatcher thread
-    switch (opcode_)
+    // Dispatcher thread
+    const IO::DataKey& key = request->key;
+    switch (request->opcode)
     {
     case IO::OpCodes::Lock:
-        AddTask(&Connection::StartLockOperation);
+        if (storageProvider_.Lock(id_, key))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
         break;
     case IO::OpCodes::Unlock:
-        AddTask(&Connection::StartUnlockOperation);
+        if (storageProvider_.Unlock(id_, key))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
         break;
     case IO::OpCodes::Create:
-        AddTask(&Connection::StartCreateOperation);
+        if (request->data->empty())
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "No data");
+        else if (storageProvider_.Create(id_, key, request->data))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Error");
         break;
     case IO::OpCodes::Update:
-        AddTask(&Connection::StartUpdateDataOperation);
+        if (request->data->empty())
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "No data");
+        else if (storageProvider_.Update(id_, key, request->data))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Error");
         break;
     case IO::OpCodes::Read:
-        AddTask(&Connection::StartReadOperation);
-        break;
+    {
+        // The data is empty when the key contains the UUID.
+        // A cache miss is loaded by a DB worker, the answer is sent when it's loaded.
+        const uint32_t requestId = request->id;
+        storageProvider_.ReadAsync(id_, key, std::move(request->data), [self = shared_from_this(), requestId](StorageBlob data)
+        {
+            if (data)
+                self->SendData(requestId, std::move(data));
+            else
+                self->SendStatus(requestId, IO::ErrorCodes::OtherErrors, "Error");
+            --self->pending_;
+        });
+        return;
+    }
     case IO::OpCodes::Delete:
-        AddTask(&Connection::StartDeleteOperation);
+        if (storageProvider_.Delete(id_, key))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
         break;
     case IO::OpCodes::Invalidate:
-        AddTask(&Connection::StartInvalidateOperation);
+        if (storageProvider_.Invalidate(id_, key))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
         break;
     case IO::OpCodes::Preload:
-        AddTask(&Connection::StartPreloadOperation);
+        if (storageProvider_.Preload(id_, key))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
         break;
     case IO::OpCodes::Exists:
-        AddTask(&Connection::StartExistsOperation);
+        if (request->data->empty())
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "No data");
+        else if (storageProvider_.Exists(id_, key, request->data))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::NotExists, "Record does not exist");
         break;
     case IO::OpCodes::Clear:
-        AddTask(&Connection::StartClearOperation);
+        if (storageProvider_.Clear(id_, key))
+            SendStatus(request->id, IO::ErrorCodes::Ok, "OK");
+        else
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Other Error");
         break;
+    case IO::OpCodes::ReadMany:
+    case IO::OpCodes::UpdateMany:
+    case IO::OpCodes::InvalidateMany:
+        HandleBatchRequest(request);
+        return;
     case IO::OpCodes::Status:
     case IO::OpCodes::Data:
         LOG_ERROR << "Status and Data OP Codes are invalid here" << std::endl;
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
+        SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
         break;
     default:
     {
-        const auto ep = socket_.remote_endpoint();
-        LOG_ERROR << "Invalid OP Code " << static_cast<int>(opcode_) << " from " <<
+        asio::error_code ec;
+        const auto ep = socket_.remote_endpoint(ec);
+        LOG_ERROR << "Invalid OP Code " << static_cast<int>(request->opcode) << " from " <<
             ep.address().to_string() << ":" << ep.port() << std::endl;
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
+        SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
         break;
     }
     }
+    --pending_;
+}
+
+void Connection::HandleBatchRequest(ea::shared_ptr<Request> request)
+{
+    // Answers the request and decrements pending_ when all items are done
+    const StorageData& data = *request->data;
+    if (data.size() < 4)
+    {
+        SendStatus(request->id, IO::ErrorCodes::OtherErrors, "No data");
+        --pending_;
+        return;
+    }
+    const uint32_t count = ToInt32(data.data());
+    if (count > IO::MAX_BATCH_COUNT)
+    {
+        SendStatus(request->id, IO::ErrorCodes::DataTooBig, "Too many items. Maximum allowed is: " + std::to_string(IO::MAX_BATCH_COUNT));
+        --pending_;
+        return;
+    }
+
+    ea::vector<ea::pair<IO::DataKey, ea::shared_ptr<StorageData>>> items;
+    items.reserve(count);
+    size_t pos = 4;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (pos + 6 > data.size())
+        {
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
+            --pending_;
+            return;
+        }
+        const uint16_t keySize = ToInt16(&data[pos]);
+        const uint32_t dataSize = ToInt32(&data[pos + 2]);
+        pos += 6;
+        if (keySize > maxKeySize_ || pos + keySize + dataSize > data.size())
+        {
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
+            --pending_;
+            return;
+        }
+        IO::DataKey key(std::string_view{ reinterpret_cast<const char*>(&data[pos]), keySize });
+        pos += keySize;
+        auto itemData = ea::make_shared<StorageData>(data.begin() + pos, data.begin() + pos + dataSize);
+        pos += dataSize;
+        items.emplace_back(std::move(key), std::move(itemData));
+    }
+
+    if (request->opcode == IO::OpCodes::ReadMany)
+    {
+        HandleReadMany(request, std::move(items));
+        return;
+    }
+
+    auto response = ea::make_shared<StorageData>();
+    AddInt32(*response, count);
+    for (const auto& item : items)
+    {
+        bool success = false;
+        if (request->opcode == IO::OpCodes::InvalidateMany)
+            success = storageProvider_.Invalidate(id_, item.first);
+        else if (!item.second->empty())
+            success = storageProvider_.Update(id_, item.first, item.second);
+        response->push_back(static_cast<uint8_t>(success ? IO::ErrorCodes::Ok : IO::ErrorCodes::OtherErrors));
+        AddInt32(*response, 0);
+    }
+    SendData(request->id, response);
+    --pending_;
 }
 
-void Connection::SendStatusAndRestart(IO::ErrorCodes code, const std::string& message)
+void Connection::HandleReadMany(ea::shared_ptr<Request> request,
+    ea::vector<ea::pair<IO::DataKey, ea::shared_ptr<StorageData>>>&& items)
 {
-    data_.reset(new StorageData);
-    size_t length = std::min((size_t)255, message.length());
-    data_->reserve(length + 5);
-    data_->push_back(static_cast<uint8_t>(IO::OpCodes::Status));
-    data_->push_back(static_cast<uint8_t>(code));
-    data_->push_back(0);
-    data_->push_back(0);
-    data_->push_back(0);
+    // Cache misses are loaded by the DB workers, the answer is sent when all are read
+    struct BatchRead
+    {
+        ea::vector<StorageBlob> results;
+        size_t remaining{ 0 };
+    };
+    auto batch = ea::make_shared<BatchRead>();
+    batch->results.resize(items.size());
+    // One more than items, so it doesn't finish while we are still reading
+    batch->remaining = items.size() + 1;
 
-    data_->push_back(static_cast<uint8_t>(length));
-    size_t len = 0;
-    for (const auto& letter : message)
+    auto finish = [self = shared_from_this(), request, batch]()
     {
-        data_->push_back(static_cast<uint8_t>(letter));
-        ++len;
-        if (len >= 255)
-            break;
+        if (--batch->remaining != 0)
+            return;
+        // The response references the read records, so they are not copied. Only
+        // the item headers are new.
+        ea::vector<StorageBlob> parts;
+        parts.reserve(batch->results.size() * 2 + 1);
+        auto count = ea::make_shared<StorageData>();
+        AddInt32(*count, static_cast<uint32_t>(batch->results.size()));
+        parts.push_back(std::move(count));
+        for (auto& result : batch->results)
+        {
+            auto header = ea::make_shared<StorageData>();
+            header->push_back(static_cast<uint8_t>(result ? IO::ErrorCodes::Ok : IO::ErrorCodes::OtherErrors));
+            AddInt32(*header, result ? static_cast<uint32_t>(result->size()) : 0);
+            parts.push_back(std::move(header));
+            if (result)
+                parts.push_back(std::move(result));
+        }
+        self->SendData(request->id, std::move(parts));
+        --self->pending_;
+    };
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        storageProvider_.ReadAsync(id_, items[i].first, std::move(items[i].second), [batch, i, finish](StorageBlob data)
+        {
+            batch->results[i] = std::move(data);
+            finish();
+        });
     }
-    std::vector<asio::mutable_buffer> bufs = { asio::buffer(*data_) };
-    SendResponseAndStart(bufs, data_->size());
+    finish();
 }
 
-void Connection::SendResponseAndStart(std::vector<asio::mutable_buffer>& resp, size_t size)
+void Connection::SendStatus(uint32_t requestId, IO::ErrorCodes code, const std::string& message)
 {
-    asio::async_write(socket_, resp, asio::transfer_at_least(size),
-        std::bind(&Connection::HandleWriteReqResponse,
-            shared_from_this(), std::placeholders::_1));
+    auto data = ea::make_shared<StorageData>();
+    const size_t length = std::min((size_t)255, message.length());
+    data->reserve(length + 2);
+    data->push_back(static_cast<uint8_t>(code));
+    data->push_back(static_cast<uint8_t>(length));
+    data->insert(data->end(), message.begin(), message.begin() + length);
+    QueueResponse(IO::OpCodes::Status, requestId, { std::move(data) });
+}
+
+void Connection::SendData(uint32_t requestId, StorageBlob data)
+{
+    QueueResponse(IO::OpCodes::Data, requestId, { std::move(data) });
+}
+
+void Connection::SendData(uint32_t requestId, ea::vector<StorageBlob>&& parts)
+{
+    QueueResponse(IO::OpCodes::Data, requestId, std::move(parts));
+}
+
+void Connection::QueueResponse(IO::OpCodes opcode, uint32_t requestId, ea::vector<StorageBlob>&& data)
+{
+    uint32_t size = 0;
+    for (const auto& part : data)
+        size += static_cast<uint32_t>(part->size());
+    Response response{ {
+            static_cast<uint8_t>(opcode),
+            static_cast<uint8_t>(requestId), static_cast<uint8_t>(requestId >> 8),
+            static_cast<uint8_t>(requestId >> 16), static_cast<uint8_t>(requestId >> 24),
+            static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+            static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 24)
+        }, std::move(data) };
+    {
+        std::scoped_lock lock(lock_);
+        writeQueue_.push_back(std::move(response));
+        if (writing_)
+            return;
+        writing_ = true;
+    }
+    // The socket is only used by the network thread
+    asio::post(socket_.get_executor(), std::bind(&Connection::WriteNext, shared_from_this()));
+}
+
+void Connection::WriteNext()
+{
+    std::vector<asio::const_buffer> buffers;
+    {
+        std::scoped_lock lock(lock_);
+        ASSERT(!writeQueue_.empty());
+        const Response& response = writeQueue_.front();
+        buffers.reserve(response.data.size() + 1);
+        buffers.push_back(asio::buffer(response.header));
+        for (const auto& part : response.data)
+            buffers.push_back(asio::buffer(*part));
+    }
+    asio::async_write(socket_, buffers,
+        std::bind(&Connection::HandleWrite, shared_from_this(), std::placeholders::_1));
+}
+
+void Connection::HandleWrite(const asio::error_code& error)
+{
+    if (error)
+    {
+        HandleNetworkError(error);
+        return;
+    }
+    {
+        std::scoped_lock lock(lock_);
+        writeQueue_.pop_front();
+        if (writeQueue_.empty())
+        {
+            writing_ = false;
+            if (closeAfterWrite_)
+                connectionManager_.Stop(shared_from_this());
+            return;
+        }
+    }
+    WriteNext();
 }
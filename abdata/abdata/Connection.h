@@ -22,6 +22,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <array>
+#include <atomic>
+#include <deque>
 #include <vector>
 #include "StorageProvider.h"
 #include <abscommon/Dispatcher.h>
@@ -35,6 +38,9 @@
 
 class ConnectionManager;
 
+/// Connection of a DataClient. Requests are read one after another while
+/// previous requests are still processed, and the answers are tagged with the
+/// request ID, so they may be sent in any order.
 class Connection : public ea::enable_shared_from_this<Connection>
 {
 public:
@@ -46,6 +52,19 @@ public:
     void Stop();
     uint32_t GetId() const { return id_; }
 private:
+    struct Request
+    {
+        IO::OpCodes opcode{ IO::OpCodes::None };
+        uint32_t id{ 0 };
+        IO::DataKey key;
+        ea::shared_ptr<StorageData> data;
+    };
+    /// The data is written as it is, cached records are not copied
+    struct Response
+    {
+        std::array<uint8_t, IO::RESPONSE_HEADER_SIZE> header;
+        ea::vector<StorageBlob> data;
+    };
     static sa::IdGenerator<uint32_t> idGenerator;
     template <typename Callable, typename... Args>
     void AddTask(Callable&& function, Args&&... args)
@@ -55,40 +74,37 @@ private:
         );
     }
 
-    void StartLockOperation();
-    void StartUnlockOperation();
-    void StartCreateOperation();
-    void StartUpdateDataOperation();
-    void StartReadOperation();
-    void StartDeleteOperation();
-    void StartInvalidateOperation();
-    void StartPreloadOperation();
-    void StartExistsOperation();
-    void StartClearOperation();
-
-    void CreateDataTask();
-    void ReadDataTask();
-    void ExistsDataTask();
-    void UpdateDataTask();
-
-    void HandleUpdateReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleCreateReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleReadReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleExistsReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleWriteReqResponse(const asio::error_code& error);
+    void StartReadRequest();
+    void HandleReadHeader(const asio::error_code& error);
+    void HandleReadBody(const asio::error_code& error, ea::shared_ptr<Request> request);
+    void HandleNetworkError(const asio::error_code& error);
+    /// Executed in the dispatcher thread
+    void HandleRequest(ea::shared_ptr<Request> request);
+    void HandleBatchRequest(ea::shared_ptr<Request> request);
+    void HandleReadMany(ea::shared_ptr<Request> request, ea::vector<ea::pair<IO::DataKey, ea::shared_ptr<StorageData>>>&& items);
+    void SendStatus(uint32_t requestId, IO::ErrorCodes code, const std::string& message);
+    void SendData(uint32_t requestId, StorageBlob data);
+    /// Sends the data of all parts as one response
+    void SendData(uint32_t requestId, ea::vector<StorageBlob>&& parts);
+    void QueueResponse(IO::OpCodes opcode, uint32_t requestId, ea::vector<StorageBlob>&& data);
+    /// Executed in the network thread
+    void WriteNext();
+    void HandleWrite(const asio::error_code& error);
 
-    void StartClientRequestedOp();
-    void StartReadKey(uint16_t keySize);
-    void SendResponseAndStart(std::vector<asio::mutable_buffer>& resp, size_t size);
-    void SendStatusAndRestart(IO::ErrorCodes code, const std::string& message);
-
-    static inline uint32_t ToInt32(const StorageData& intBytes, size_t start)
+    static inline uint32_t ToInt32(const uint8_t* intBytes)
+    {
+        return (intBytes[3] << 24) | (intBytes[2] << 16) | (intBytes[1] << 8) | intBytes[0];
+    }
+    static inline uint16_t ToInt16(const uint8_t* intBytes)
     {
-        return (intBytes[start + 3] << 24) | (intBytes[start + 2] << 16) | (intBytes[start + 1] << 8) | intBytes[start];
+        return (intBytes[1] << 8) | intBytes[0];
     }
-    static inline uint16_t ToInt16(const StorageData& intBytes, size_t start)
+    static inline void AddInt32(StorageData& buffer, uint32_t value)
     {
-        return  (intBytes[start + 1] << 8) | intBytes[start];
+        buffer.push_back(static_cast<uint8_t>(value));
+        buffer.push_back(static_cast<uint8_t>(value >> 8));
+        buffer.push_back(static_cast<uint8_t>(value >> 16));
+        buffer.push_back(static_cast<uint8_t>(value >> 24));
     }
 
     uint32_t id_;
@@ -98,9 +114,14 @@ private:
     asio::ip::tcp::socket socket_;
     ConnectionManager& connectionManager_;
     StorageProvider& storageProvider_;
-    IO::OpCodes opcode_{ IO::OpCodes::None };
+    std::array<uint8_t, IO::REQUEST_HEADER_SIZE> header_;
     std::mutex lock_;
-
-    IO::DataKey key_;
-    ea::shared_ptr<StorageData> data_;
+    std::deque<Response> writeQueue_;
+    bool writing_{ false };
+    /// Protocol error, close the connection when the error was sent
+    bool closeAfterWrite_{ false };
+    /// Requests passed to the Dispatcher which are not answered yet. Cache hits are
+    /// only answered by the network thread when there are none, because a previous
+    /// request may change the record.
+    std::atomic<uint32_t> pending_{ 0 };
 };
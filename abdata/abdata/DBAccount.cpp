@@ -21,54 +21,11 @@
 
 #include "DBAccount.h"
 #include <sa/Assert.h>
-#include <sa/TemplateParser.h>
 #include <uuid.h>
 #include <abscommon/Profiler.h>
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::Account& account, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "uuid" || token.value == "account_uuid")
-            return db->EscapeString(account.uuid);
-        if (token.value == "name")
-            return db->EscapeString(account.name);
-        if (token.value == "password")
-            return db->EscapeString(account.password);
-        if (token.value == "email")
-            return db->EscapeString(account.email);
-        if (token.value == "auth_token")
-            return db->EscapeString(account.authToken);
-        if (token.value == "auth_token_expiry")
-            return std::to_string(account.authTokenExpiry);
-        if (token.value == "type")
-            return std::to_string(static_cast<int>(account.type));
-        if (token.value == "status")
-            return std::to_string(static_cast<int>(account.status));
-        if (token.value == "creation")
-            return std::to_string(account.creation);
-        if (token.value == "char_slots")
-            return std::to_string(account.charSlots);
-        if (token.value == "current_character_uuid")
-            return db->EscapeString(account.currentCharacterUuid);
-        if (token.value == "current_server_uuid")
-            return db->EscapeString(account.currentServerUuid);
-        if (token.value == "online_status")
-            return std::to_string(static_cast<int>(account.onlineStatus));
-        if (token.value == "guild_uuid")
-            return db->EscapeString(account.guildUuid);
-        if (token.value == "chest_size")
-            return std::to_string(account.chest_size);
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 bool DBAccount::Create(AB::Entities::Account& account)
 {
     static constexpr const char* SQL =
@@ -85,12 +42,25 @@ bool DBAccount::Create(AB::Entities::Account& account)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, account, std::placeholders::_1))))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", account.uuid)
+        .Bind("name", account.name)
+        .Bind("password", account.password)
+        .Bind("email", account.email)
+        .Bind("type", static_cast<int>(account.type))
+        .Bind("status", static_cast<int>(account.status))
+        .Bind("creation", account.creation)
+        .Bind("char_slots", account.charSlots)
+        .Bind("current_server_uuid", account.currentServerUuid)
+        .Bind("online_status", static_cast<int>(account.onlineStatus))
+        .Bind("guild_uuid", account.guildUuid)
+        .Bind("chest_size", account.chest_size);
+    if (!statement.Execute())
         return false;
 
     if (!transaction.Commit())
@@ -101,7 +71,7 @@ bool DBAccount::Create(AB::Entities::Account& account)
 
 bool DBAccount::Load(AB::Entities::Account& account)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT * FROM accounts WHERE uuid = ${uuid}";
     static constexpr const char* SQL_NAME = "SELECT * FROM accounts WHERE name = ${name}";
@@ -118,11 +88,15 @@ bool DBAccount::Load(AB::Entities::Account& account)
     }
     ASSERT(sql);
 
-    const std::string query = sa::templ::Parser::Evaluate(sql, std::bind(&PlaceholderCallback, db, account, std::placeholders::_1));
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    PreparedStatement& statement = db->Prepare(sql);
+    if (sql == SQL_UUID)
+        statement.Bind("uuid", account.uuid);
+    else if (sql == SQL_NAME)
+        statement.Bind("name", account.name);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
     {
-        LOG_ERROR << "No record found for " << query << std::endl;
+        LOG_ERROR << "No record found for " << statement.GetSql() << std::endl;
         return false;
     }
 
@@ -149,11 +123,13 @@ bool DBAccount::Load(AB::Entities::Account& account)
 
 void DBAccount::LoadCharacters(AB::Entities::Account& account)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     account.characterUuids.clear();
     static constexpr const char* SQL = "SELECT uuid, name FROM players WHERE account_uuid = ${account_uuid} ORDER BY name";
 
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, account, std::placeholders::_1))); result; result = result->Next())
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("account_uuid", account.uuid);
+    for (std::shared_ptr<DB::DBResult> result = statement.Query(); result; result = result->Next())
     {
         account.characterUuids.push_back(result->GetString("uuid"));
     }
@@ -182,17 +158,88 @@ bool DBAccount::Save(const AB::Entities::Account& account)
         "chest_size = ${chest_size} "
         "WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, account, std::placeholders::_1))))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("password", account.password)
+        .Bind("email", account.email)
+        .Bind("auth_token", account.authToken)
+        .Bind("auth_token_expiry", account.authTokenExpiry)
+        .Bind("type", static_cast<int>(account.type))
+        .Bind("status", static_cast<int>(account.status))
+        .Bind("char_slots", account.charSlots)
+        .Bind("current_character_uuid", account.currentCharacterUuid)
+        .Bind("current_server_uuid", account.currentServerUuid)
+        .Bind("online_status", static_cast<int>(account.onlineStatus))
+        .Bind("guild_uuid", account.guildUuid)
+        .Bind("chest_size", account.chest_size)
+        .Bind("uuid", account.uuid);
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
 }
 
+bool DBAccount::SaveMany(const std::vector<AB::Entities::Account>& accounts)
+{
+    static const std::vector<std::string> SQL = BuildMultiUpdates("accounts", {
+        { "uuid", "character(36)" },
+        { "password", "text" },
+        { "email", "text" },
+        { "auth_token", "character(36)" },
+        { "auth_token_expiry", "bigint" },
+        { "type", "bigint" },
+        { "status", "bigint" },
+        { "char_slots", "bigint" },
+        { "current_character_uuid", "character(36)" },
+        { "current_server_uuid", "character(36)" },
+        { "online_status", "bigint" },
+        { "guild_uuid", "character(36)" },
+        { "chest_size", "integer" }
+    });
+
+    Database* db = Database::Current();
+    DBTransaction transaction(db);
+    if (!transaction.Begin())
+        return false;
+
+    for (size_t start = 0; start < accounts.size(); start += MULTIUPDATE_MAX_ROWS)
+    {
+        const size_t count = std::min(accounts.size() - start, MULTIUPDATE_MAX_ROWS);
+        PreparedStatement& statement = db->Prepare(SQL[count - 1]);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const AB::Entities::Account& account = accounts[start + i];
+            if (Utils::Uuid::IsEmpty(account.uuid))
+            {
+                LOG_ERROR << "UUID is empty" << std::endl;
+                return false;
+            }
+            const std::string row = "_" + std::to_string(i);
+            statement.Bind("uuid" + row, account.uuid)
+                .Bind("password" + row, account.password)
+                .Bind("email" + row, account.email)
+                .Bind("auth_token" + row, account.authToken)
+                .Bind("auth_token_expiry" + row, account.authTokenExpiry)
+                .Bind("type" + row, static_cast<int>(account.type))
+                .Bind("status" + row, static_cast<int>(account.status))
+                .Bind("char_slots" + row, account.charSlots)
+                .Bind("current_character_uuid" + row, account.currentCharacterUuid)
+                .Bind("current_server_uuid" + row, account.currentServerUuid)
+                .Bind("online_status" + row, static_cast<int>(account.onlineStatus))
+                .Bind("guild_uuid" + row, account.guildUuid)
+                .Bind("chest_size" + row, account.chest_size);
+        }
+        if (!statement.Execute())
+            return false;
+    }
+
+    return transaction.Commit();
+}
+
 bool DBAccount::Delete(const AB::Entities::Account& account)
 {
     if (Utils::Uuid::IsEmpty(account.uuid))
@@ -201,16 +248,17 @@ bool DBAccount::Delete(const AB::Entities::Account& account)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "DELETE FROM accounts WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, account, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", account.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -218,7 +266,7 @@ bool DBAccount::Delete(const AB::Entities::Account& account)
 
 bool DBAccount::Exists(const AB::Entities::Account& account)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM accounts WHERE uuid = ${uuid}";
     static constexpr const char* SQL_NAME = "SELECT COUNT(*) AS count FROM accounts WHERE name = ${name}";
@@ -235,9 +283,13 @@ bool DBAccount::Exists(const AB::Entities::Account& account)
     }
     ASSERT(sql);
 
-    const std::string query = sa::templ::Parser::Evaluate(sql, std::bind(&PlaceholderCallback, db, account, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(sql);
+    if (sql == SQL_UUID)
+        statement.Bind("uuid", account.uuid);
+    else if (sql == SQL_NAME)
+        statement.Bind("name", account.name);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -245,7 +297,7 @@ bool DBAccount::Exists(const AB::Entities::Account& account)
 
 bool DBAccount::LogoutAll()
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static const std::string query = "UPDATE accounts SET online_status = 0";
     DBTransaction transaction(db);
     if (!transaction.Begin())
@@ -37,6 +37,8 @@ public:
     /// Load an account identified by id or name.
     static bool Load(AB::Entities::Account& account);
     static bool Save(const AB::Entities::Account& account);
+    /// Update many accounts with multi row UPDATE statements, requires DBPARAM_MULTIUPDATE
+    static bool SaveMany(const std::vector<AB::Entities::Account>& accounts);
     static bool Delete(const AB::Entities::Account& account);
     static bool Exists(const AB::Entities::Account& account);
     static bool LogoutAll();
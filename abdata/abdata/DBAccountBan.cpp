@@ -50,7 +50,7 @@ bool DBAccountBan::Create(AB::Entities::AccountBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
@@ -71,7 +71,7 @@ bool DBAccountBan::Create(AB::Entities::AccountBan& ban)
 
 bool DBAccountBan::Load(AB::Entities::AccountBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT * FROM account_bans WHERE uuid = ${uuid}";
     static constexpr const char* SQL_ACCOUNT = "SELECT * FROM account_bans WHERE account_uuid = ${account_uuid}";
@@ -107,7 +107,7 @@ bool DBAccountBan::Save(const AB::Entities::AccountBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE account_bans SET "
         "ban_uuid = ${ban_uuid}, "
@@ -132,7 +132,7 @@ bool DBAccountBan::Delete(const AB::Entities::AccountBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM account_bans WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
 
@@ -148,7 +148,7 @@ bool DBAccountBan::Delete(const AB::Entities::AccountBan& ban)
 
 bool DBAccountBan::Exists(const AB::Entities::AccountBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM account_bans WHERE uuid = ${uuid}";
     static constexpr const char* SQL_ACCOUNT = "SELECT COUNT(*) AS count FROM account_bans WHERE account_uuid = ${account_uuid}";
@@ -43,7 +43,7 @@ bool DBAccountBanList::Load(AB::Entities::AccountBanList& il)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT ban_uuid FROM account_bans WHERE account_uuid = ${account_uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &il](const sa::templ::Token& token) -> std::string
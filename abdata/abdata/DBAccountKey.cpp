@@ -59,7 +59,7 @@ bool DBAccountKey::Create(AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "INSERT INTO account_keys ("
             "uuid, used, total, description, status, key_type, email"
         ") VALUES ( "
@@ -89,7 +89,7 @@ bool DBAccountKey::Load(AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM account_keys WHERE uuid = ${uuid}");
@@ -122,7 +122,7 @@ bool DBAccountKey::Save(const AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE account_keys SET "
         "used = ${used}, "
@@ -159,7 +159,7 @@ bool DBAccountKey::Exists(const AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM account_keys WHERE uuid = ${uuid}");
@@ -49,7 +49,7 @@ bool DBAccountKeyAccounts::Create(AB::Entities::AccountKeyAccounts& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "INSERT INTO account_account_keys ("
             "account_uuid, account_key_uuid"
@@ -80,7 +80,7 @@ bool DBAccountKeyAccounts::Load(AB::Entities::AccountKeyAccounts& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM account_account_keys WHERE "
         "account_uuid = ${account_uuid} "
@@ -116,7 +116,7 @@ bool DBAccountKeyAccounts::Exists(const AB::Entities::AccountKeyAccounts& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM account_account_keys WHERE "
         "account_uuid = ${account_uuid} "
@@ -31,7 +31,7 @@ bool DBAccountKeyList::Create(AB::Entities::AccountKeyList&)
 
 bool DBAccountKeyList::Load(AB::Entities::AccountKeyList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM account_keys";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
@@ -31,7 +31,7 @@ bool DBAccountList::Create(AB::Entities::AccountList&)
 
 bool DBAccountList::Load(AB::Entities::AccountList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM accounts";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
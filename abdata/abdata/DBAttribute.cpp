@@ -55,7 +55,7 @@ bool DBAttribute::Create(AB::Entities::Attribute&)
 
 bool DBAttribute::Load(AB::Entities::Attribute& attr)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM game_attributes WHERE ");
@@ -98,7 +98,7 @@ bool DBAttribute::Delete(const AB::Entities::Attribute&)
 
 bool DBAttribute::Exists(const AB::Entities::Attribute& attr)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM game_attributes WHERE ");
@@ -30,7 +30,7 @@ bool DBAttributeList::Create(AB::Entities::AttributeList&)
 
 bool DBAttributeList::Load(AB::Entities::AttributeList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM game_attributes";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
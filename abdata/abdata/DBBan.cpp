@@ -67,7 +67,7 @@ bool DBBan::Create(AB::Entities::Ban& ban)
             "${uuid}, ${expires}, ${added}, ${reason}, ${active}, ${admin_uuid}, ${comment}, ${hits}"
         ")";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
 
@@ -89,7 +89,7 @@ bool DBBan::Load(AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM bans WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
@@ -128,7 +128,7 @@ bool DBBan::Save(const AB::Entities::Ban& ban)
         "hits = ${hits} "
         "WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
 
     DBTransaction transaction(db);
@@ -151,7 +151,7 @@ bool DBBan::Delete(const AB::Entities::Ban& ban)
 
     static constexpr const char* SQL = "DELETE FROM bans WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
 
     DBTransaction transaction(db);
@@ -172,7 +172,7 @@ bool DBBan::Exists(const AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM bans WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
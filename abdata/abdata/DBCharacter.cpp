@@ -20,69 +20,9 @@
  */
 
 #include "DBCharacter.h"
-#include <sa/TemplateParser.h>
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::Character& character, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "uuid")
-            return db->EscapeString(character.uuid);
-        if (token.value == "profession")
-            return db->EscapeString(character.profession);
-        if (token.value == "profession2")
-            return db->EscapeString(character.profession2);
-        if (token.value == "profession_uuid")
-            return db->EscapeString(character.professionUuid);
-        if (token.value == "profession2_uuid")
-            return db->EscapeString(character.profession2Uuid);
-        if (token.value == "skills")
-            return db->EscapeString(character.skillTemplate);
-        if (token.value == "name")
-            return db->EscapeString(character.name);
-        if (token.value == "pvp")
-            return std::to_string(character.pvp ? 1 : 0);
-        if (token.value == "account_uuid")
-            return db->EscapeString(character.accountUuid);
-        if (token.value == "level")
-            return std::to_string(character.level);
-        if (token.value == "experience")
-            return std::to_string(character.xp);
-        if (token.value == "skillpoints")
-            return std::to_string(character.skillPoints);
-        if (token.value == "sex")
-            return std::to_string(static_cast<uint32_t>(character.sex));
-        if (token.value == "model_index")
-            return std::to_string(character.modelIndex);
-        if (token.value == "creation")
-            return std::to_string(character.creation);
-        if (token.value == "inventory_size")
-            return std::to_string(character.inventorySize);
-        if (token.value == "lastlogin")
-            return std::to_string(character.lastLogin);
-        if (token.value == "lastlogout")
-            return std::to_string(character.lastLogout);
-        if (token.value == "onlinetime")
-            return std::to_string(character.onlineTime);
-        if (token.value == "deleted")
-            return std::to_string(character.deletedTime);
-        if (token.value == "current_map_uuid")
-            return db->EscapeString(character.currentMapUuid);
-        if (token.value == "last_outpost_uuid")
-            return db->EscapeString(character.lastOutpostUuid);
-        if (token.value == "death_stats")
-            return db->EscapeBlob(character.deathStats.data(), character.deathStats.length());
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 // Player names are case insensitive. The DB needs a proper index for that:
 // CREATE INDEX players_name_ci_index ON players USING btree (lower(name))
 
@@ -94,7 +34,7 @@ bool DBCharacter::Create(AB::Entities::Character& character)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
@@ -107,7 +47,23 @@ bool DBCharacter::Create(AB::Entities::Character& character)
             "${account_uuid}, ${level}, ${experience}, ${skillpoints}, ${sex}, ${model_index}, ${creation}, ${inventory_size}"
         ")";
 
-    if (!db->ExecuteQuery(sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, character, std::placeholders::_1))))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", character.uuid)
+        .Bind("profession", character.profession)
+        .Bind("profession2", character.profession2)
+        .Bind("profession_uuid", character.professionUuid)
+        .Bind("profession2_uuid", character.profession2Uuid)
+        .Bind("name", character.name)
+        .Bind("pvp", character.pvp ? 1 : 0)
+        .Bind("account_uuid", character.accountUuid)
+        .Bind("level", character.level)
+        .Bind("experience", character.xp)
+        .Bind("skillpoints", character.skillPoints)
+        .Bind("sex", character.sex)
+        .Bind("model_index", character.modelIndex)
+        .Bind("creation", character.creation)
+        .Bind("inventory_size", character.inventorySize);
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -115,7 +71,7 @@ bool DBCharacter::Create(AB::Entities::Character& character)
 
 bool DBCharacter::Load(AB::Entities::Character& character)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT * FROM players WHERE uuid= ${uuid}";
     static constexpr const char* SQL_NAME = "SELECT * FROM players WHERE LOWER(name) = LOWER(${name})";
@@ -131,9 +87,12 @@ bool DBCharacter::Load(AB::Entities::Character& character)
         return false;
     }
 
-    const std::string query = sa::templ::Parser::Evaluate(sql, std::bind(&PlaceholderCallback, db, character, std::placeholders::_1));
-
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    PreparedStatement& statement = db->Prepare(sql);
+    if (sql == SQL_UUID)
+        statement.Bind("uuid", character.uuid);
+    else
+        statement.Bind("name", character.name);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
 
@@ -172,7 +131,7 @@ bool DBCharacter::Save(const AB::Entities::Character& character)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
@@ -194,12 +153,89 @@ bool DBCharacter::Save(const AB::Entities::Character& character)
         "death_stats = ${death_stats} "
         "WHERE uuid = ${uuid}";
 
-    if (!db->ExecuteQuery(sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, character, std::placeholders::_1))))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", character.uuid)
+        .Bind("profession2", character.profession2)
+        .Bind("profession2_uuid", character.profession2Uuid)
+        .Bind("skills", character.skillTemplate)
+        .Bind("level", character.level)
+        .Bind("experience", character.xp)
+        .Bind("skillpoints", character.skillPoints)
+        .Bind("lastlogin", character.lastLogin)
+        .Bind("lastlogout", character.lastLogout)
+        .Bind("onlinetime", character.onlineTime)
+        .Bind("deleted", character.deletedTime)
+        .Bind("current_map_uuid", character.currentMapUuid)
+        .Bind("last_outpost_uuid", character.lastOutpostUuid)
+        .Bind("inventory_size", character.inventorySize)
+        .BindBlob("death_stats", character.deathStats);
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
 }
 
+bool DBCharacter::SaveMany(const std::vector<AB::Entities::Character>& characters)
+{
+    static const std::vector<std::string> SQL = BuildMultiUpdates("players", {
+        { "uuid", "character(36)" },
+        { "profession2", "character varying(2)" },
+        { "profession2_uuid", "character(36)" },
+        { "skills", "text" },
+        { "level", "bigint" },
+        { "experience", "bigint" },
+        { "skillpoints", "bigint" },
+        { "lastlogin", "bigint" },
+        { "lastlogout", "bigint" },
+        { "onlinetime", "bigint" },
+        { "deleted", "bigint" },
+        { "current_map_uuid", "character(36)" },
+        { "last_outpost_uuid", "character(36)" },
+        { "inventory_size", "integer" },
+        { "death_stats", "text" }
+    });
+
+    Database* db = Database::Current();
+    DBTransaction transaction(db);
+    if (!transaction.Begin())
+        return false;
+
+    for (size_t start = 0; start < characters.size(); start += MULTIUPDATE_MAX_ROWS)
+    {
+        const size_t count = std::min(characters.size() - start, MULTIUPDATE_MAX_ROWS);
+        PreparedStatement& statement = db->Prepare(SQL[count - 1]);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const AB::Entities::Character& character = characters[start + i];
+            if (Utils::Uuid::IsEmpty(character.uuid))
+            {
+                LOG_ERROR << "UUID is empty" << std::endl;
+                return false;
+            }
+            const std::string row = "_" + std::to_string(i);
+            statement.Bind("uuid" + row, character.uuid)
+                .Bind("profession2" + row, character.profession2)
+                .Bind("profession2_uuid" + row, character.profession2Uuid)
+                .Bind("skills" + row, character.skillTemplate)
+                .Bind("level" + row, character.level)
+                .Bind("experience" + row, character.xp)
+                .Bind("skillpoints" + row, character.skillPoints)
+                .Bind("lastlogin" + row, character.lastLogin)
+                .Bind("lastlogout" + row, character.lastLogout)
+                .Bind("onlinetime" + row, character.onlineTime)
+                .Bind("deleted" + row, character.deletedTime)
+                .Bind("current_map_uuid" + row, character.currentMapUuid)
+                .Bind("last_outpost_uuid" + row, character.lastOutpostUuid)
+                .Bind("inventory_size" + row, character.inventorySize)
+                .BindBlob("death_stats" + row, character.deathStats);
+        }
+        if (!statement.Execute())
+            return false;
+    }
+
+    return transaction.Commit();
+}
+
 bool DBCharacter::Delete(const AB::Entities::Character& character)
 {
     if (Utils::Uuid::IsEmpty(character.uuid))
@@ -208,15 +244,15 @@ bool DBCharacter::Delete(const AB::Entities::Character& character)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
     static constexpr const char* SQL = "DELETE FROM players WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, character, std::placeholders::_1));
-
-    if (!db->ExecuteQuery(query))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", character.uuid);
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -224,7 +260,7 @@ bool DBCharacter::Delete(const AB::Entities::Character& character)
 
 bool DBCharacter::Exists(const AB::Entities::Character& character)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM players WHERE uuid= ${uuid}";
     static constexpr const char* SQL_NAME = "SELECT COUNT(*) AS count FROM players WHERE LOWER(name) = LOWER(${name})";
@@ -240,9 +276,12 @@ bool DBCharacter::Exists(const AB::Entities::Character& character)
         return false;
     }
 
-    const std::string query = sa::templ::Parser::Evaluate(sql, std::bind(&PlaceholderCallback, db, character, std::placeholders::_1));
-
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    PreparedStatement& statement = db->Prepare(sql);
+    if (sql == SQL_UUID)
+        statement.Bind("uuid", character.uuid);
+    else
+        statement.Bind("name", character.name);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
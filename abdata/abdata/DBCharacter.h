@@ -34,6 +34,8 @@ public:
     static bool Create(AB::Entities::Character& character);
     static bool Load(AB::Entities::Character& character);
     static bool Save(const AB::Entities::Character& character);
+    /// Update many characters with multi row UPDATE statements, requires DBPARAM_MULTIUPDATE
+    static bool SaveMany(const std::vector<AB::Entities::Character>& characters);
     static bool Delete(const AB::Entities::Character& character);
     static bool Exists(const AB::Entities::Character& character);
 };
@@ -30,7 +30,7 @@ bool DBCharacterList::Create(AB::Entities::CharacterList&)
 
 bool DBCharacterList::Load(AB::Entities::CharacterList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM players";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
@@ -23,58 +23,81 @@
 #include "StorageProvider.h"
 #include <AB/Entities/GameInstance.h>
 #include <abscommon/Utils.h>
-#include <sa/TemplateParser.h>
 #include <sa/time.h>
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::ConcreteItem& item, const sa::templ::Token& token)
+static const std::vector<DBColumn> COLUMNS = {
+    { "uuid", "character(36)" },
+    { "player_uuid", "character(36)" },
+    { "storage_place", "integer" },
+    { "storage_pos", "integer" },
+    { "upgrade_1", "character(36)" },
+    { "upgrade_2", "character(36)" },
+    { "upgrade_3", "character(36)" },
+    { "account_uuid", "character(36)" },
+    { "item_uuid", "character(36)" },
+    { "stats", "text" },
+    { "count", "integer" },
+    { "creation", "bigint" },
+    { "deleted", "bigint" },
+    { "value", "integer" },
+    { "instance_uuid", "character(36)" },
+    { "map_uuid", "character(36)" },
+    { "flags", "integer" },
+    { "sold", "bigint" }
+};
+
+static void BindRow(PreparedStatement& statement, size_t index, const AB::Entities::ConcreteItem& item)
 {
-    switch (token.type)
+    const std::string row = "_" + std::to_string(index);
+    statement.Bind("uuid" + row, item.uuid)
+        .Bind("player_uuid" + row, item.playerUuid)
+        .Bind("storage_place" + row, static_cast<int>(item.storagePlace))
+        .Bind("storage_pos" + row, item.storagePos)
+        .Bind("upgrade_1" + row, item.upgrade1Uuid)
+        .Bind("upgrade_2" + row, item.upgrade2Uuid)
+        .Bind("upgrade_3" + row, item.upgrade3Uuid)
+        .Bind("account_uuid" + row, item.accountUuid)
+        .Bind("item_uuid" + row, item.itemUuid)
+        .BindBlob("stats" + row, item.itemStats)
+        .Bind("count" + row, item.count)
+        .Bind("creation" + row, item.creation)
+        .Bind("deleted" + row, item.deleted)
+        .Bind("value" + row, item.value)
+        .Bind("instance_uuid" + row, item.instanceUuid)
+        .Bind("map_uuid" + row, item.mapUuid)
+        .Bind("flags" + row, item.flags)
+        .Bind("sold" + row, item.sold);
+}
+
+/// Writes the items in chunks of up to MULTIUPDATE_MAX_ROWS, statements[i] writes i + 1 items
+static bool WriteMany(const std::vector<std::string>& statements, const std::vector<AB::Entities::ConcreteItem>& items)
+{
+    Database* db = Database::Current();
+    DBTransaction transaction(db);
+    if (!transaction.Begin())
+        return false;
+
+    for (size_t start = 0; start < items.size(); start += MULTIUPDATE_MAX_ROWS)
     {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "uuid")
-            return db->EscapeString(item.uuid);
-        if (token.value == "player_uuid")
-            return db->EscapeString(item.playerUuid);
-        if (token.value == "storage_place")
-            return std::to_string(static_cast<int>(item.storagePlace));
-        if (token.value == "storage_pos")
-            return std::to_string(item.storagePos);
-        if (token.value == "upgrade_1")
-            return db->EscapeString(item.upgrade1Uuid);
-        if (token.value == "upgrade_2")
-            return db->EscapeString(item.upgrade2Uuid);
-        if (token.value == "upgrade_3")
-            return db->EscapeString(item.upgrade3Uuid);
-        if (token.value == "account_uuid")
-            return db->EscapeString(item.accountUuid);
-        if (token.value == "item_uuid")
-            return db->EscapeString(item.itemUuid);
-        if (token.value == "stats")
-            return db->EscapeBlob(item.itemStats.data(), item.itemStats.length());
-        if (token.value == "count")
-            return std::to_string(item.count);
-        if (token.value == "creation")
-            return std::to_string(item.creation);
-        if (token.value == "deleted")
-            return std::to_string(item.deleted);
-        if (token.value == "value")
-            return std::to_string(item.value);
-        if (token.value == "instance_uuid")
-            return db->EscapeString(item.instanceUuid);
-        if (token.value == "map_uuid")
-            return db->EscapeString(item.mapUuid);
-        if (token.value == "flags")
-            return std::to_string(item.flags);
-        if (token.value == "sold")
-            return std::to_string(item.sold);
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
+        const size_t count = std::min(items.size() - start, MULTIUPDATE_MAX_ROWS);
+        PreparedStatement& statement = db->Prepare(statements[count - 1]);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const AB::Entities::ConcreteItem& item = items[start + i];
+            if (Utils::Uuid::IsEmpty(item.uuid))
+            {
+                LOG_ERROR << "UUID is empty" << std::endl;
+                return false;
+            }
+            BindRow(statement, i, item);
+        }
+        if (!statement.Execute())
+            return false;
     }
+
+    return transaction.Commit();
 }
 
 bool DBConcreteItem::Create(AB::Entities::ConcreteItem& item)
@@ -95,15 +118,33 @@ bool DBConcreteItem::Create(AB::Entities::ConcreteItem& item)
             "${map_uuid}, ${flags}, ${sold}"
         ")";
 
-    Database* db = GetSubsystem<Database>();
-
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
+    Database* db = Database::Current();
+
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", item.uuid)
+        .Bind("player_uuid", item.playerUuid)
+        .Bind("storage_place", static_cast<int>(item.storagePlace))
+        .Bind("storage_pos", item.storagePos)
+        .Bind("upgrade_1", item.upgrade1Uuid)
+        .Bind("upgrade_2", item.upgrade2Uuid)
+        .Bind("upgrade_3", item.upgrade3Uuid)
+        .Bind("account_uuid", item.accountUuid)
+        .Bind("item_uuid", item.itemUuid)
+        .BindBlob("stats", item.itemStats)
+        .Bind("count", item.count)
+        .Bind("creation", item.creation)
+        .Bind("deleted", item.deleted)
+        .Bind("value", item.value)
+        .Bind("instance_uuid", item.instanceUuid)
+        .Bind("map_uuid", item.mapUuid)
+        .Bind("flags", item.flags)
+        .Bind("sold", item.sold);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     if (!transaction.Commit())
@@ -112,6 +153,12 @@ bool DBConcreteItem::Create(AB::Entities::ConcreteItem& item)
     return true;
 }
 
+bool DBConcreteItem::CreateMany(const std::vector<AB::Entities::ConcreteItem>& items)
+{
+    static const std::vector<std::string> SQL = BuildMultiInserts("concrete_items", COLUMNS);
+    return WriteMany(SQL, items);
+}
+
 bool DBConcreteItem::Load(AB::Entities::ConcreteItem& item)
 {
     if (Utils::Uuid::IsEmpty(item.uuid))
@@ -122,10 +169,11 @@ bool DBConcreteItem::Load(AB::Entities::ConcreteItem& item)
 
     static constexpr const char* SQL = "SELECT * FROM concrete_items WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
+    Database* db = Database::Current();
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", item.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
 
@@ -179,18 +227,42 @@ bool DBConcreteItem::Save(const AB::Entities::ConcreteItem& item)
         "sold = ${sold} "
         "WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
-    if (!db->ExecuteQuery(query))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("player_uuid", item.playerUuid)
+        .Bind("storage_place", static_cast<int>(item.storagePlace))
+        .Bind("storage_pos", item.storagePos)
+        .Bind("upgrade_1", item.upgrade1Uuid)
+        .Bind("upgrade_2", item.upgrade2Uuid)
+        .Bind("upgrade_3", item.upgrade3Uuid)
+        .Bind("account_uuid", item.accountUuid)
+        .Bind("item_uuid", item.itemUuid)
+        .BindBlob("stats", item.itemStats)
+        .Bind("count", item.count)
+        .Bind("creation", item.creation)
+        .Bind("deleted", item.deleted)
+        .Bind("value", item.value)
+        .Bind("instance_uuid", item.instanceUuid)
+        .Bind("map_uuid", item.mapUuid)
+        .Bind("flags", item.flags)
+        .Bind("sold", item.sold)
+        .Bind("uuid", item.uuid);
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
 }
 
+bool DBConcreteItem::SaveMany(const std::vector<AB::Entities::ConcreteItem>& items)
+{
+    static const std::vector<std::string> SQL = BuildMultiUpdates("concrete_items", COLUMNS);
+    return WriteMany(SQL, items);
+}
+
 bool DBConcreteItem::Delete(const AB::Entities::ConcreteItem& item)
 {
     if (Utils::Uuid::IsEmpty(item.uuid))
@@ -201,14 +273,15 @@ bool DBConcreteItem::Delete(const AB::Entities::ConcreteItem& item)
 
     static constexpr const char* SQL = "DELETE FROM concrete_items WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", item.uuid);
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -225,11 +298,12 @@ bool DBConcreteItem::Exists(const AB::Entities::ConcreteItem& item)
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM concrete_items WHERE uuid = ${uuid}"
         " AND deleted = 0";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", item.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -238,21 +312,22 @@ bool DBConcreteItem::Exists(const AB::Entities::ConcreteItem& item)
 void DBConcreteItem::Clean(StorageProvider* sp)
 {
     LOG_INFO << "Cleaning concrete items" << std::endl;
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT uuid, instance_uuid FROM concrete_items WHERE "
         "storage_place = ${storage_place} "
         "AND deleted = 0";
     AB::Entities::ConcreteItem dummyItem;
     dummyItem.storagePlace = AB::Entities::StoragePlace::Scene;
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, dummyItem, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("storage_place", static_cast<int>(dummyItem.storagePlace));
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return;
 
     std::vector<std::string> uuids;
-    for (result = db->StoreQuery(query); result; result = result->Next())
+    for (; result; result = result->Next())
     {
         AB::Entities::GameInstance instance;
         instance.uuid = result->GetString("instance_uuid");
@@ -34,8 +34,12 @@ public:
     ~DBConcreteItem() = delete;
 
     static bool Create(AB::Entities::ConcreteItem& item);
+    /// Insert many items with multi row INSERT statements, requires DBPARAM_MULTIINSERT
+    static bool CreateMany(const std::vector<AB::Entities::ConcreteItem>& items);
     static bool Load(AB::Entities::ConcreteItem& item);
     static bool Save(const AB::Entities::ConcreteItem& item);
+    /// Update many items with multi row UPDATE statements, requires DBPARAM_MULTIUPDATE
+    static bool SaveMany(const std::vector<AB::Entities::ConcreteItem>& items);
     static bool Delete(const AB::Entities::ConcreteItem& item);
     static bool Exists(const AB::Entities::ConcreteItem& item);
     /// Delete not picked up items
@@ -33,13 +33,13 @@ bool DBCraftableItemList::Create(AB::Entities::CraftableItemList&)
 
 bool DBCraftableItemList::Load(AB::Entities::CraftableItemList& il)
 {
-    Database* db = GetSubsystem<Database>();
-    static std::string statement;
-    if (statement.empty())
+    Database* db = Database::Current();
+    // Loads may run on several DB worker threads, so build it only once
+    static const std::string statement = []()
     {
         static constexpr const char* SQL = "SELECT uuid, idx, type, item_flags, name, value "
             "FROM game_items WHERE item_flags & ${item_flags} = ${item_flags} ORDER BY type DESC, name ASC";
-        statement = sa::templ::Parser::Evaluate(SQL, [](const sa::templ::Token& token) -> std::string
+        return sa::templ::Parser::Evaluate(SQL, [](const sa::templ::Token& token) -> std::string
         {
             switch (token.type)
             {
@@ -52,7 +52,7 @@ bool DBCraftableItemList::Load(AB::Entities::CraftableItemList& il)
                 return token.value;
             }
         });
-    }
+    }();
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(statement); result; result = result->Next())
     {
         il.items.push_back({ result->GetUInt("idx"),
@@ -54,7 +54,7 @@ bool DBEffect::Create(AB::Entities::Effect& effect)
 
 bool DBEffect::Load(AB::Entities::Effect& effect)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM game_effects WHERE ");
@@ -110,7 +110,7 @@ bool DBEffect::Delete(const AB::Entities::Effect& effect)
 
 bool DBEffect::Exists(const AB::Entities::Effect& effect)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM game_effects WHERE ");
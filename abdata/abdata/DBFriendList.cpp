@@ -24,21 +24,6 @@
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::FriendList& fl, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "account_uuid")
-            return db->EscapeString(fl.uuid);
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 static std::string PlaceholderCallbackFriend(Database* db, const AB::Entities::FriendList& fl, const AB::Entities::Friend& fr, const sa::templ::Token& token)
 {
     switch (token.type)
@@ -81,13 +66,14 @@ bool DBFriendList::Load(AB::Entities::FriendList& fl)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM friend_list WHERE account_uuid = ${account_uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, fl, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("account_uuid", fl.uuid);
 
     fl.friends.clear();
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
+    for (std::shared_ptr<DB::DBResult> result = statement.Query(); result; result = result->Next())
     {
         fl.friends.push_back({
             result->GetString("friend_uuid"),
@@ -107,15 +93,16 @@ bool DBFriendList::Save(const AB::Entities::FriendList& fl)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
     // First delete all
     static constexpr const char* SQL_DELETE = "DELETE FROM friend_list WHERE account_uuid = ${account_uuid}";
-    const std::string deleteQuery = sa::templ::Parser::Evaluate(SQL_DELETE, std::bind(&PlaceholderCallback, db, fl, std::placeholders::_1));
-    if (!db->ExecuteQuery(deleteQuery))
+    PreparedStatement& statement = db->Prepare(SQL_DELETE);
+    statement.Bind("account_uuid", fl.uuid);
+    if (!statement.Execute())
         return false;
 
     if (fl.friends.size() > 0)
@@ -125,16 +112,36 @@ bool DBFriendList::Save(const AB::Entities::FriendList& fl)
             ") VALUES ("
                 "${account_uuid}, ${friend_uuid}, ${friend_name}, ${relation}, ${creation}"
             ")";
-        sa::templ::Parser parser;
-        const sa::templ::Tokens tokens = parser.Parse(SQL_INSERT);
-
+        static constexpr const char* SQL_VALUES = ", ("
+                "${account_uuid}, ${friend_uuid}, ${friend_name}, ${relation}, ${creation}"
+            ")";
         // Then add all
-        for (const auto& f : fl.friends)
+        if (db->GetParam(DBPARAM_MULTIINSERT))
         {
-            const std::string insertQuery = tokens.ToString(std::bind(&PlaceholderCallbackFriend, db, fl, f, std::placeholders::_1));
+            // One statement for all rows. The number of rows varies, so this can't be prepared.
+            sa::templ::Parser parser;
+            const sa::templ::Tokens tokens = parser.Parse(SQL_INSERT);
+            const sa::templ::Tokens valuesTokens = parser.Parse(SQL_VALUES);
+            std::string insertQuery = tokens.ToString(std::bind(&PlaceholderCallbackFriend, db, fl, fl.friends.front(), std::placeholders::_1));
+            for (auto it = std::next(fl.friends.begin()); it != fl.friends.end(); ++it)
+                insertQuery += valuesTokens.ToString(std::bind(&PlaceholderCallbackFriend, db, fl, *it, std::placeholders::_1));
             if (!db->ExecuteQuery(insertQuery))
                 return false;
         }
+        else
+        {
+            PreparedStatement& insertStatement = db->Prepare(SQL_INSERT);
+            for (const auto& f : fl.friends)
+            {
+                insertStatement.Bind("account_uuid", fl.uuid)
+                    .Bind("friend_uuid", f.friendUuid)
+                    .Bind("friend_name", f.friendName)
+                    .Bind("relation", static_cast<int>(f.relation))
+                    .Bind("creation", f.creation);
+                if (!insertStatement.Execute())
+                    return false;
+            }
+        }
     }
     return transaction.Commit();
 }
@@ -148,15 +155,16 @@ bool DBFriendList::Delete(const AB::Entities::FriendList& fl)
     }
 
     // Delete all friends of this account
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM friend_list WHERE account_uuid = ${account_uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, fl, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("account_uuid", fl.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -20,7 +20,6 @@
  */
 
 #include "DBFriendedMe.h"
-#include <sa/TemplateParser.h>
 
 namespace DB {
 
@@ -43,25 +42,14 @@ bool DBFriendedMe::Load(AB::Entities::FriendedMe& fl)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM friend_list WHERE friend_uuid = ${friend_uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &fl](const sa::templ::Token& token) -> std::string
-    {
-        switch (token.type)
-        {
-        case sa::templ::Token::Type::Variable:
-            if (token.value == "friend_uuid")
-                return db->EscapeString(fl.uuid);
-            LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-            return "";
-        default:
-            return token.value;
-        }
-    });
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("friend_uuid", fl.uuid);
 
     fl.friends.clear();
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
+    for (std::shared_ptr<DB::DBResult> result = statement.Query(); result; result = result->Next())
     {
         fl.friends.push_back({
             result->GetString("account_uuid"),
@@ -49,7 +49,7 @@ bool DBGame::Create(AB::Entities::Game&)
 
 bool DBGame::Load(AB::Entities::Game& game)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM game_maps WHERE ");
@@ -101,7 +101,7 @@ bool DBGame::Delete(const AB::Entities::Game&)
 
 bool DBGame::Exists(const AB::Entities::Game& game)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM game_maps WHERE ");
@@ -30,7 +30,7 @@ bool DBGameInstanceList::Create(AB::Entities::GameInstanceList&)
 
 bool DBGameInstanceList::Load(AB::Entities::GameInstanceList& game)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM instances WHERE is_running = 1 ORDER BY players DESC, start_time DESC";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
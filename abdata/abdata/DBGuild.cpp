@@ -73,7 +73,7 @@ bool DBGuild::Create(AB::Entities::Guild& g)
             "${creator_name}, ${creator_player_uuid}, ${guild_hall_instance_uuid}, ${guild_hall_server_uuid}"
         ")";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
@@ -88,7 +88,7 @@ bool DBGuild::Create(AB::Entities::Guild& g)
 
 bool DBGuild::Load(AB::Entities::Guild& g)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT * FROM guilds WHERE uuid= ${uuid}";
     static constexpr const char* SQL_NAME = "SELECT * FROM guilds WHERE LOWER(name) = LOWER(${name})";
@@ -131,7 +131,7 @@ bool DBGuild::Save(const AB::Entities::Guild& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE guilds SET "
         "name = ${name}, "
@@ -165,7 +165,7 @@ bool DBGuild::Delete(const AB::Entities::Guild& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "DELETE FROM guilds WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, g, std::placeholders::_1));
@@ -182,7 +182,7 @@ bool DBGuild::Delete(const AB::Entities::Guild& g)
 
 bool DBGuild::Exists(const AB::Entities::Guild& g)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM guilds WHERE uuid= ${uuid}";
     static constexpr const char* SQL_NAME = "SELECT COUNT(*) AS count FROM guilds WHERE LOWER(name) = LOWER(${name})";
@@ -21,28 +21,10 @@
 
 #include "DBGuildMembers.h"
 #include "StorageProvider.h"
-#include <sa/TemplateParser.h>
 #include <sa/time.h>
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::GuildMembers& g, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "guild_uuid")
-            return db->EscapeString(g.uuid);
-        if (token.value == "expires")
-            return std::to_string(sa::time::tick());
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 bool DBGuildMembers::Create(AB::Entities::GuildMembers& g)
 {
     if (Utils::Uuid::IsEmpty(g.uuid))
@@ -62,16 +44,18 @@ bool DBGuildMembers::Load(AB::Entities::GuildMembers& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM guild_members WHERE "
         "guild_uuid = ${guild_uuid} "
         "AND (expires = 0 OR expires > ${expires})";
 
     g.members.clear();
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, g, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("guild_uuid", g.uuid)
+        .Bind("expires", sa::time::tick());
 
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
+    for (std::shared_ptr<DB::DBResult> result = statement.Query(); result; result = result->Next())
     {
         AB::Entities::GuildMember gm;
         gm.accountUuid = result->GetString("account_uuid");
@@ -121,28 +105,12 @@ bool DBGuildMembers::Exists(const AB::Entities::GuildMembers& g)
 
 void DBGuildMembers::DeleteExpired(StorageProvider* sp)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
-    auto expires = sa::time::tick();
-    auto callback = [expires](const sa::templ::Token& token) -> std::string
-    {
-        switch (token.type)
-        {
-        case sa::templ::Token::Type::Variable:
-            if (token.value == "expires")
-                return std::to_string(expires);
-
-            LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-            return "";
-        default:
-            return token.value;
-        }
-    };
+    const int64_t expires = sa::time::tick();
     static constexpr const char* SQL_SELECT = "SELECT guild_uuid FROM guild_members WHERE "
         "(expires <> 0 AND expires < ${expires})";
-    const std::string selectQuery = sa::templ::Parser::Evaluate(SQL_SELECT, callback);
-
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(selectQuery);
+    std::shared_ptr<DB::DBResult> result = db->Prepare(SQL_SELECT).Bind("expires", expires).Query();
     if (!result)
         // No members
         return;
@@ -155,13 +123,14 @@ void DBGuildMembers::DeleteExpired(StorageProvider* sp)
 
     static constexpr const char* SQL_DELETE = "DELETE FROM guild_members WHERE "
         "(expires <> 0 AND expires < ${expires})";
-    const std::string deleteQuery = sa::templ::Parser::Evaluate(SQL_SELECT, callback);
+    PreparedStatement& statement = db->Prepare(SQL_DELETE);
+    statement.Bind("expires", expires);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return;
 
-    if (!db->ExecuteQuery(deleteQuery))
+    if (!statement.Execute())
         return;
 
     // End transaction
@@ -24,39 +24,6 @@
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::GameInstance& inst, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "uuid")
-            return db->EscapeString(inst.uuid);
-        if (token.value == "game_uuid")
-            return db->EscapeString(inst.gameUuid);
-        if (token.value == "server_uuid")
-            return db->EscapeString(inst.serverUuid);
-        if (token.value == "name")
-            return db->EscapeString(inst.name);
-        if (token.value == "recording")
-            return db->EscapeString(inst.recording);
-        if (token.value == "start_time")
-            return std::to_string(inst.startTime);
-        if (token.value == "stop_time")
-            return std::to_string(inst.stopTime);
-        if (token.value == "number")
-            return std::to_string(inst.number);
-        if (token.value == "is_running")
-            return std::to_string(inst.running ? 1 : 0);
-        if (token.value == "players")
-            return std::to_string(inst.players);
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 bool DBInstance::Create(AB::Entities::GameInstance& inst)
 {
     if (Utils::Uuid::IsEmpty(inst.uuid))
@@ -65,7 +32,7 @@ bool DBInstance::Create(AB::Entities::GameInstance& inst)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "INSERT INTO instances ("
             "uuid, game_uuid, server_uuid, name, recording, start_time, stop_time, number, is_running, players"
@@ -73,13 +40,23 @@ bool DBInstance::Create(AB::Entities::GameInstance& inst)
             "${uuid}, ${game_uuid}, ${server_uuid}, ${name}, ${recording}, ${start_time}, ${stop_time}, ${number}, ${is_running}, ${players}"
         ")";
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, inst, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", inst.uuid)
+        .Bind("game_uuid", inst.gameUuid)
+        .Bind("server_uuid", inst.serverUuid)
+        .Bind("name", inst.name)
+        .Bind("recording", inst.recording)
+        .Bind("start_time", inst.startTime)
+        .Bind("stop_time", inst.stopTime)
+        .Bind("number", inst.number)
+        .Bind("is_running", inst.running ? 1 : 0)
+        .Bind("players", inst.players);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -87,22 +64,21 @@ bool DBInstance::Create(AB::Entities::GameInstance& inst)
 
 bool DBInstance::Load(AB::Entities::GameInstance& inst)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
+
+    static constexpr const char* SQL_UUID = "SELECT * FROM instances WHERE uuid = ${uuid}";
+    static constexpr const char* SQL_RECORDING = "SELECT * FROM instances WHERE recording = ${recording}";
 
-    sa::templ::Parser parser;
-    sa::templ::Tokens tokens = parser.Parse("SELECT * FROM instances WHERE ");
+    std::shared_ptr<DB::DBResult> result;
     if (!Utils::Uuid::IsEmpty(inst.uuid))
-        parser.Append("uuid = ${uuid}", tokens);
+        result = db->Prepare(SQL_UUID).Bind("uuid", inst.uuid).Query();
     else if (!inst.recording.empty())
-        parser.Append("recording = ${recording}", tokens);
+        result = db->Prepare(SQL_RECORDING).Bind("recording", inst.recording).Query();
     else
     {
         LOG_ERROR << "UUID and recording are empty" << std::endl;
         return false;
     }
-
-    const std::string query = tokens.ToString(std::bind(&PlaceholderCallback, db, inst, std::placeholders::_1));
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
     if (!result)
         return false;
 
@@ -128,7 +104,7 @@ bool DBInstance::Save(const AB::Entities::GameInstance& inst)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE instances SET "
         "game_uuid = ${game_uuid}, "
@@ -142,13 +118,23 @@ bool DBInstance::Save(const AB::Entities::GameInstance& inst)
         "players = ${players} "
         "WHERE uuid = ${uuid}";
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, inst, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("game_uuid", inst.gameUuid)
+        .Bind("server_uuid", inst.serverUuid)
+        .Bind("name", inst.name)
+        .Bind("recording", inst.recording)
+        .Bind("start_time", inst.startTime)
+        .Bind("stop_time", inst.stopTime)
+        .Bind("number", inst.number)
+        .Bind("is_running", inst.running ? 1 : 0)
+        .Bind("players", inst.players)
+        .Bind("uuid", inst.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -162,14 +148,15 @@ bool DBInstance::Delete(const AB::Entities::GameInstance& inst)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM instances WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, inst, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", inst.uuid);
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -177,23 +164,21 @@ bool DBInstance::Delete(const AB::Entities::GameInstance& inst)
 
 bool DBInstance::Exists(const AB::Entities::GameInstance& inst)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
-    sa::templ::Parser parser;
-    sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM instances WHERE ");
+    static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM instances WHERE uuid = ${uuid}";
+    static constexpr const char* SQL_RECORDING = "SELECT COUNT(*) AS count FROM instances WHERE recording = ${recording}";
+
+    std::shared_ptr<DB::DBResult> result;
     if (!Utils::Uuid::IsEmpty(inst.uuid))
-        parser.Append("uuid = ${uuid}", tokens);
+        result = db->Prepare(SQL_UUID).Bind("uuid", inst.uuid).Query();
     else if (!inst.recording.empty())
-        parser.Append("recording = ${recording}", tokens);
+        result = db->Prepare(SQL_RECORDING).Bind("recording", inst.recording).Query();
     else
     {
         LOG_ERROR << "UUID and recording are empty" << std::endl;
         return false;
     }
-
-    const std::string query = tokens.ToString(std::bind(&PlaceholderCallback, db, inst, std::placeholders::_1));
-
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -201,7 +186,7 @@ bool DBInstance::Exists(const AB::Entities::GameInstance& inst)
 
 bool DBInstance::StopAll()
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "UPDATE instances SET is_running = 0, stop_time = ${stop_time} WHERE is_running = 1";
     const std::string query = sa::templ::Parser::Evaluate(SQL, [](const sa::templ::Token& token) -> std::string
     {
@@ -56,7 +56,7 @@ bool DBIpBan::Create(AB::Entities::IpBan& ban)
     static constexpr const char* SQL_SELECT = "SELECT COUNT(*) as count FROM ip_bans WHERE "
         "((${ip} & ${mask} & mask) = (ip & mask & ${mask}))";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string selectQuery = sa::templ::Parser::Evaluate(SQL_SELECT, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
     std::shared_ptr<DB::DBResult> result = db->StoreQuery(selectQuery);
     if (result && result->GetInt("count") != 0)
@@ -85,7 +85,7 @@ bool DBIpBan::Create(AB::Entities::IpBan& ban)
 
 bool DBIpBan::Load(AB::Entities::IpBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM ip_bans WHERE ");
@@ -127,7 +127,7 @@ bool DBIpBan::Save(const AB::Entities::IpBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE ip_bans SET "
         "ban_uuid = ${ban_uuid}, "
@@ -154,7 +154,7 @@ bool DBIpBan::Delete(const AB::Entities::IpBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM ip_bans WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, ban, std::placeholders::_1));
 
@@ -170,7 +170,7 @@ bool DBIpBan::Delete(const AB::Entities::IpBan& ban)
 
 bool DBIpBan::Exists(const AB::Entities::IpBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM ip_bans WHERE ");
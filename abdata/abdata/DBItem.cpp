@@ -54,7 +54,7 @@ bool DBItem::Create(AB::Entities::Item& item)
 
 bool DBItem::Load(AB::Entities::Item& item)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT * FROM game_items WHERE uuid= ${uuid}";
     static constexpr const char* SQL_INDEX = "SELECT * FROM game_items WHERE idx = ${index}";
@@ -117,7 +117,7 @@ bool DBItem::Delete(const AB::Entities::Item& item)
 
 bool DBItem::Exists(const AB::Entities::Item& item)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM game_items WHERE uuid= ${uuid}";
     static constexpr const char* SQL_INDEX = "SELECT COUNT(*) AS count FROM game_items WHERE idx = ${index}";
@@ -60,7 +60,7 @@ bool DBItemChanceList::Load(AB::Entities::ItemChanceList& il)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT item_uuid, chance, can_drop FROM game_item_chances WHERE "
         "map_uuid = ${map_uuid} OR map_uuid = ${empty_map_uuid}";
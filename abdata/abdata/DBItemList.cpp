@@ -30,7 +30,7 @@ bool DBItemList::Create(AB::Entities::ItemList&)
 
 bool DBItemList::Load(AB::Entities::ItemList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM game_items";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
@@ -37,7 +37,7 @@ uint32_t DBItemPrice::GetDropChance(const std::string& itemUuid)
     static constexpr const char* SQL = "SELECT AVG(chance) AS avg_chance FROM game_item_chances WHERE item_uuid = ${item_uuid}"
         " GROUP BY item_uuid";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &itemUuid](const sa::templ::Token& token) -> std::string
     {
@@ -63,7 +63,7 @@ uint32_t DBItemPrice::GetAvgValue(const std::string& itemUuid)
     static constexpr const char* SQL = "SELECT AVG(value) as avg_value FROM concrete_items WHERE deleted = 0 "
         "AND item_uuid = ${item_uuid} GROUP BY item_uuid";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &itemUuid](const sa::templ::Token& token) -> std::string
     {
         switch (token.type)
@@ -93,7 +93,7 @@ uint32_t DBItemPrice::GetAvailable(const std::string& itemUuid)
         "AND item_uuid = ${item_uuid} "
         "GROUP BY item_uuid";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &itemUuid](const sa::templ::Token& token) -> std::string
     {
         using namespace sa::time::literals;
@@ -130,7 +130,7 @@ bool DBItemPrice::Load(AB::Entities::ItemPrice& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT type, item_flags, value FROM game_items WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &item](const sa::templ::Token& token) -> std::string
@@ -215,7 +215,7 @@ bool DBItemPrice::Exists(const AB::Entities::ItemPrice& item)
 
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM concrete_items WHERE "
         "deleted = 0 AND item_uuid = ${item_uuid} AND storage_place = ${storage_place}";
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &item](const sa::templ::Token& token) -> std::string
     {
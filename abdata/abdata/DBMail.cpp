@@ -20,48 +20,17 @@
  */
 
 #include "DBMail.h"
-#include <sa/TemplateParser.h>
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::Mail& mail, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "uuid")
-            return db->EscapeString(mail.uuid);
-        if (token.value == "from_account_uuid")
-            return db->EscapeString(mail.fromAccountUuid);
-        if (token.value == "to_account_uuid")
-            return db->EscapeString(mail.toAccountUuid);
-        if (token.value == "from_name")
-            return db->EscapeString(mail.fromName);
-        if (token.value == "to_name")
-            return db->EscapeString(mail.toName);
-        if (token.value == "subject")
-            return db->EscapeString(mail.subject);
-        if (token.value == "message")
-            return db->EscapeString(mail.message);
-        if (token.value == "created")
-            return std::to_string(mail.created);
-        if (token.value == "is_read")
-            return std::to_string((mail.isRead ? 1 : 0));
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 uint32_t DBMail::GetMailCount(AB::Entities::Mail& mail)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM mails WHERE to_account_uuid = ${to_account_uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, mail, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("to_account_uuid", mail.toAccountUuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         // Something is wrong!
         return std::numeric_limits<uint32_t>::max();
@@ -80,7 +49,7 @@ bool DBMail::Create(AB::Entities::Mail& mail)
     if (GetMailCount(mail) >= AB::Entities::Limits::MAX_MAIL_COUNT)
         return false;
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "INSERT INTO mails ("
         "uuid, from_account_uuid, to_account_uuid, from_name, to_name, subject, message, created, is_read"
@@ -88,12 +57,21 @@ bool DBMail::Create(AB::Entities::Mail& mail)
         "${uuid}, ${from_account_uuid}, ${to_account_uuid}, ${from_name}, ${to_name}, ${subject}, ${message}, ${created}, ${is_read}"
         ")";
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, mail, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", mail.uuid)
+        .Bind("from_account_uuid", mail.fromAccountUuid)
+        .Bind("to_account_uuid", mail.toAccountUuid)
+        .Bind("from_name", mail.fromName)
+        .Bind("to_name", mail.toName)
+        .Bind("subject", mail.subject)
+        .Bind("message", mail.message)
+        .Bind("created", mail.created)
+        .Bind("is_read", (mail.isRead ? 1 : 0));
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return  transaction.Commit();
@@ -107,12 +85,13 @@ bool DBMail::Load(AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM mails WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, mail, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", mail.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
 
@@ -136,7 +115,7 @@ bool DBMail::Save(const AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE mails SET "
         "from_account_uuid = ${from_account_uuid}, "
@@ -153,7 +132,17 @@ bool DBMail::Save(const AB::Entities::Mail& mail)
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, mail, std::placeholders::_1))))
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("from_account_uuid", mail.fromAccountUuid)
+        .Bind("to_account_uuid", mail.toAccountUuid)
+        .Bind("from_name", mail.fromName)
+        .Bind("to_name", mail.toName)
+        .Bind("subject", mail.subject)
+        .Bind("message", mail.message)
+        .Bind("created", mail.created)
+        .Bind("is_read", (mail.isRead ? 1 : 0))
+        .Bind("uuid", mail.uuid);
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -167,15 +156,16 @@ bool DBMail::Delete(const AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "DELETE FROM mails WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, mail, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", mail.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -189,11 +179,12 @@ bool DBMail::Exists(const AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM mails WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, mail, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", mail.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -20,7 +20,6 @@
  */
 
 #include "DBMailList.h"
-#include <sa/TemplateParser.h>
 
 namespace DB {
 
@@ -45,23 +44,13 @@ bool DBMailList::Load(AB::Entities::MailList& ml)
     // Oldest first because the chat window scrolls down
     static constexpr const char* SQL = "SELECT uuid, from_name, subject, created, is_read FROM mails "
         "WHERE to_account_uuid = ${to_account_uuid} ORDER BY created ASC";
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, [db, &ml](const sa::templ::Token& token) -> std::string
-    {
-        switch (token.type)
-        {
-        case sa::templ::Token::Type::Variable:
-            if (token.value == "to_account_uuid")
-                return db->EscapeString(ml.uuid);
-            ASSERT_FALSE();
-        default:
-            return token.value;
-        }
-    });
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("to_account_uuid", ml.uuid);
     ml.mails.clear();
 
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
+    for (std::shared_ptr<DB::DBResult> result = statement.Query(); result; result = result->Next())
     {
         ml.mails.push_back({
             result->GetString("uuid"),
@@ -55,7 +55,7 @@ bool DBMerchantItem::Load(AB::Entities::MerchantItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT uuid FROM concrete_items WHERE "
         "deleted = 0 AND item_uuid = ${item_uuid} "
@@ -87,7 +87,7 @@ bool DBMerchantItem::Exists(const AB::Entities::MerchantItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT COUNT(*) AS count concrete_items WHERE "
         "deleted = 0 AND item_uuid = ${item_uuid} AND storage_place = ${storage_place}";
@@ -33,7 +33,7 @@ bool DBMerchantItemList::Create(AB::Entities::MerchantItemList&)
 
 bool DBMerchantItemList::Load(AB::Entities::MerchantItemList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     // Return a list of items, which are either stackable or were recently sold
     static constexpr const char* SQL = "SELECT concrete_items.uuid AS concrete_uuid, concrete_items.item_uuid AS item_uuid, concrete_items.sold AS sold, "
         "game_items.type AS type, game_items.idx AS idx, game_items.name AS name, game_items.item_flags AS item_flags "
@@ -57,7 +57,7 @@ bool DBMusic::Create(AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "INSERT INTO game_music ("
             "uuid, map_uuid, local_file, remote_file, sorting, style"
@@ -85,7 +85,7 @@ bool DBMusic::Load(AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM game_music WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
@@ -112,7 +112,7 @@ bool DBMusic::Save(const AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE game_music SET "
         "map_uuid = ${map_uuid}, "
@@ -141,7 +141,7 @@ bool DBMusic::Delete(const AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM game_music WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
     DBTransaction transaction(db);
@@ -162,7 +162,7 @@ bool DBMusic::Exists(const AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM game_music WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, item, std::placeholders::_1));
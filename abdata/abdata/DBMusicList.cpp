@@ -30,7 +30,7 @@ bool DBMusicList::Create(AB::Entities::MusicList&)
 
 bool DBMusicList::Load(AB::Entities::MusicList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM game_music ORDER BY sorting";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
@@ -57,7 +57,7 @@ bool DBNews::Create(AB::Entities::News& v)
         "${uuid}, ${created}, ${body}"
         ")";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, v, std::placeholders::_1));
 
@@ -79,7 +79,7 @@ bool DBNews::Load(AB::Entities::News& v)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM news WHERE uuid = ${uuid}");
@@ -109,7 +109,7 @@ bool DBNews::Save(const AB::Entities::News& v)
         "body = ${body} "
         "WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, v, std::placeholders::_1));
 
     DBTransaction transaction(db);
@@ -132,7 +132,7 @@ bool DBNews::Delete(const AB::Entities::News& v)
 
     static constexpr const char* SQL = "DELETE FROM news WHERE uuid = ${uuid}";
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, v, std::placeholders::_1));
 
     DBTransaction transaction(db);
@@ -153,7 +153,7 @@ bool DBNews::Exists(const AB::Entities::News& v)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) FROM news WHERE uuid = ${uuid}");
@@ -20,7 +20,6 @@
  */
 
 #include "DBPlayerItemList.h"
-#include <sa/TemplateParser.h>
 
 namespace DB {
 
@@ -33,27 +32,19 @@ static bool LoadList(AB::Entities::_PlayerItemList<_Place>& il)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    sa::templ::Parser parser;
-    sa::templ::Tokens tokens = parser.Parse("SELECT uuid FROM concrete_items WHERE player_uuid = ${player_uuid} AND deleted = 0");
+    Database* db = Database::Current();
+    static constexpr const char* SQL = "SELECT uuid FROM concrete_items WHERE player_uuid = ${player_uuid} AND deleted = 0";
+    static constexpr const char* SQL_PLACE = "SELECT uuid FROM concrete_items WHERE player_uuid = ${player_uuid} AND deleted = 0 AND storage_place = ${storage_place}";
+    std::shared_ptr<DB::DBResult> result;
     if (il.storagePlace != AB::Entities::StoragePlace::None)
-        parser.Append(" AND storage_place = ${storage_place}", tokens);
-    const std::string query = tokens.ToString([db, &il](const sa::templ::Token& token) -> std::string
-    {
-        switch (token.type)
-        {
-        case sa::templ::Token::Type::Variable:
-            if (token.value == "player_uuid")
-                return db->EscapeString(il.uuid);
-            if (token.value == "storage_place")
-                return std::to_string(static_cast<int>(il.storagePlace));
-            ASSERT_FALSE();
-        default:
-            return token.value;
-        }
-    });
-
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
+        result = db->Prepare(SQL_PLACE)
+            .Bind("player_uuid", il.uuid)
+            .Bind("storage_place", static_cast<int>(il.storagePlace))
+            .Query();
+    else
+        result = db->Prepare(SQL).Bind("player_uuid", il.uuid).Query();
+
+    for (; result; result = result->Next())
     {
         il.itemUuids.push_back(result->GetString("uuid"));
     }
@@ -20,25 +20,9 @@
  */
 
 #include "DBPlayerQuestListRewarded.h"
-#include <sa/TemplateParser.h>
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::PlayerQuestListRewarded& q, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "player_uuid")
-            return db->EscapeString(q.uuid);
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 bool DBPlayerQuestListRewarded::Create(AB::Entities::PlayerQuestListRewarded& g)
 {
     if (Utils::Uuid::IsEmpty(g.uuid))
@@ -57,13 +41,14 @@ bool DBPlayerQuestListRewarded::Load(AB::Entities::PlayerQuestListRewarded& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT quests_uuid FROM player_quests WHERE "
         "player_uuid = ${player_uuid} AND rewarded = 1";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, g, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("player_uuid", g.uuid);
 
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
+    for (std::shared_ptr<DB::DBResult> result = statement.Query(); result; result = result->Next())
     {
         g.questUuids.push_back(
             result->GetString("quest_uuid")
@@ -100,12 +85,13 @@ bool DBPlayerQuestListRewarded::Exists(const AB::Entities::PlayerQuestListReward
         LOG_ERROR << "UUID is empty" << std::endl;
         return false;
     }
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM player_quests WHERE "
         "player_uuid = ${player_uuid} AND rewarded = 1";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, g, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("player_uuid", g.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -58,7 +58,7 @@ bool DBProfession::Create(AB::Entities::Profession& prof)
 
 bool DBProfession::Load(AB::Entities::Profession& prof)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM game_professions WHERE ");
@@ -134,7 +134,7 @@ bool DBProfession::Delete(const AB::Entities::Profession& prof)
 
 bool DBProfession::Exists(const AB::Entities::Profession& prof)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM game_professions WHERE ");
@@ -66,7 +66,7 @@ bool DBQuest::Create(AB::Entities::Quest& v)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "INSERT INTO game_quests ("
             "uuid, idx, name, script, repeatable, description, depends_on_uuid, reward_xp, reward_money, reward_items"
@@ -87,7 +87,7 @@ bool DBQuest::Create(AB::Entities::Quest& v)
 
 bool DBQuest::Load(AB::Entities::Quest& v)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT * FROM game_quests WHERE uuid= ${uuid}";
     static constexpr const char* SQL_INDEX = "SELECT * FROM game_quests WHERE idx = ${index}";
@@ -130,7 +130,7 @@ bool DBQuest::Save(const AB::Entities::Quest& v)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     // Only these may be changed
     static constexpr const char* SQL = "UPDATE game_quests SET "
@@ -163,7 +163,7 @@ bool DBQuest::Delete(const AB::Entities::Quest&)
 
 bool DBQuest::Exists(const AB::Entities::Quest& v)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL_UUID = "SELECT COUNT(*) AS count FROM game_quests WHERE uuid= ${uuid}";
     static constexpr const char* SQL_INDEX = "SELECT COUNT(*) AS count FROM game_quests WHERE idx = ${index}";
@@ -30,7 +30,7 @@ bool DBQuestList::Create(AB::Entities::QuestList&)
 
 bool DBQuestList::Load(AB::Entities::QuestList& q)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static const std::string query = "SELECT uuid FROM game_quests";
     for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query); result; result = result->Next())
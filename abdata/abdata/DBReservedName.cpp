@@ -60,7 +60,7 @@ bool DBReservedName::Create(AB::Entities::ReservedName& rn)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "INSERT INTO reserved_names ("
             "uuid, name, is_reserved, reserved_for_account_uuid, expires"
         ") VALUES ("
@@ -80,7 +80,7 @@ bool DBReservedName::Create(AB::Entities::ReservedName& rn)
 
 bool DBReservedName::Load(AB::Entities::ReservedName& n)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM reserved_names WHERE ");
@@ -115,7 +115,7 @@ bool DBReservedName::Save(const AB::Entities::ReservedName& rn)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     // Only these may be changed
     static constexpr const char* SQL = "UPDATE reserved_names SET "
@@ -142,7 +142,7 @@ bool DBReservedName::Delete(const AB::Entities::ReservedName& rn)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM reserved_names WHERE uuid = ${uuid}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, rn, std::placeholders::_1));
 
@@ -158,7 +158,7 @@ bool DBReservedName::Delete(const AB::Entities::ReservedName& rn)
 
 bool DBReservedName::Exists(const AB::Entities::ReservedName& n)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM reserved_names WHERE ");
@@ -182,7 +182,7 @@ bool DBReservedName::Exists(const AB::Entities::ReservedName& n)
 void DBReservedName::DeleteExpired(StorageProvider* sp)
 {
     // When expires == 0 it does not expire, otherwise it's the time stamp
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT uuid FROM reserved_names WHERE (expires <> 0 AND expires < ${expires})";
     AB::Entities::ReservedName n;
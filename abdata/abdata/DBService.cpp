@@ -24,49 +24,6 @@
 
 namespace DB {
 
-static std::string PlaceholderCallback(Database* db, const AB::Entities::Service& s, const sa::templ::Token& token)
-{
-    switch (token.type)
-    {
-    case sa::templ::Token::Type::Variable:
-        if (token.value == "uuid")
-            return db->EscapeString(s.uuid);
-        if (token.value == "name")
-            return db->EscapeString(s.name);
-        if (token.value == "type")
-            return std::to_string(static_cast<int>(s.type));
-        if (token.value == "location")
-            return db->EscapeString(s.location);
-        if (token.value == "host")
-            return db->EscapeString(s.host);
-        if (token.value == "port")
-            return std::to_string(s.port);
-        if (token.value == "status")
-            return std::to_string(static_cast<int>(s.status));
-        if (token.value == "start_time")
-            return std::to_string(s.startTime);
-        if (token.value == "stop_time")
-            return std::to_string(s.stopTime);
-        if (token.value == "run_time")
-            return std::to_string(s.runTime);
-        if (token.value == "machine")
-            return db->EscapeString(s.machine);
-        if (token.value == "file")
-            return db->EscapeString(s.file);
-        if (token.value == "path")
-            return db->EscapeString(s.path);
-        if (token.value == "arguments")
-            return db->EscapeString(s.arguments);
-        if (token.value == "version")
-            return std::to_string(s.version);
-
-        LOG_WARNING << "Unhandled placeholder " << token.value << std::endl;
-        return "";
-    default:
-        return token.value;
-    }
-}
-
 bool DBService::Create(AB::Entities::Service& s)
 {
     if (Utils::Uuid::IsEmpty(s.uuid))
@@ -75,20 +32,35 @@ bool DBService::Create(AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "INSERT INTO services ("
             "uuid, name, type, location, host, port, status, start_time, stop_time, run_time, machine, file, path, arguments, version"
         ") VALUES ("
             "${uuid}, ${name}, ${type}, ${location}, ${host}, ${port}, ${status}, ${start_time}, ${stop_time}, ${run_time}, ${machine}, ${file}, ${path}, ${arguments}, ${version}"
         ")";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, s, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", s.uuid)
+        .Bind("name", s.name)
+        .Bind("type", static_cast<int>(s.type))
+        .Bind("location", s.location)
+        .Bind("host", s.host)
+        .Bind("port", s.port)
+        .Bind("status", static_cast<int>(s.status))
+        .Bind("start_time", s.startTime)
+        .Bind("stop_time", s.stopTime)
+        .Bind("run_time", s.runTime)
+        .Bind("machine", s.machine)
+        .Bind("file", s.file)
+        .Bind("path", s.path)
+        .Bind("arguments", s.arguments)
+        .Bind("version", s.version);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -102,12 +74,13 @@ bool DBService::Load(AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT * FROM services WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, s, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", s.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
 
@@ -138,7 +111,7 @@ bool DBService::Save(const AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "UPDATE services SET "
         "name = ${name}, "
@@ -157,13 +130,28 @@ bool DBService::Save(const AB::Entities::Service& s)
         "version = ${version} "
         "WHERE uuid = ${uuid}";
 
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, s, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("name", s.name)
+        .Bind("type", static_cast<int>(s.type))
+        .Bind("location", s.location)
+        .Bind("host", s.host)
+        .Bind("port", s.port)
+        .Bind("status", static_cast<int>(s.status))
+        .Bind("start_time", s.startTime)
+        .Bind("stop_time", s.stopTime)
+        .Bind("run_time", s.runTime)
+        .Bind("machine", s.machine)
+        .Bind("file", s.file)
+        .Bind("path", s.path)
+        .Bind("arguments", s.arguments)
+        .Bind("version", s.version)
+        .Bind("uuid", s.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -177,14 +165,15 @@ bool DBService::Delete(const AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "DELETE FROM services WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, s, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", s.uuid);
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query))
+    if (!statement.Execute())
         return false;
 
     return transaction.Commit();
@@ -198,12 +187,13 @@ bool DBService::Exists(const AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     static constexpr const char* SQL = "SELECT COUNT(*) AS count FROM services WHERE uuid = ${uuid}";
-    const std::string query = sa::templ::Parser::Evaluate(SQL, std::bind(&PlaceholderCallback, db, s, std::placeholders::_1));
+    PreparedStatement& statement = db->Prepare(SQL);
+    statement.Bind("uuid", s.uuid);
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query);
+    std::shared_ptr<DB::DBResult> result = statement.Query();
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -211,7 +201,7 @@ bool DBService::Exists(const AB::Entities::Service& s)
 
 bool DBService::StopAll()
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
     static constexpr const char* SQL = "UPDATE services SET status = ${status}, stop_time = ${stop_time} WHERE status = ${run_status}";
     const std::string query = sa::templ::Parser::Evaluate(SQL, [](const sa::templ::Token& token) -> std::string
     {
@@ -54,7 +54,7 @@ bool DBSkill::Create(AB::Entities::Skill& skill)
 
 bool DBSkill::Load(AB::Entities::Skill& skill)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM game_skills WHERE ");
@@ -118,7 +118,7 @@ bool DBSkill::Delete(const AB::Entities::Skill& skill)
 
 bool DBSkill::Exists(const AB::Entities::Skill& skill)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM game_skills WHERE ");
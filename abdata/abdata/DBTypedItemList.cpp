@@ -32,7 +32,7 @@ bool DBTypedItemList::Create(AB::Entities::TypedItemList&)
 
 bool DBTypedItemList::Load(AB::Entities::TypedItemList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT game_item_chances.chance AS chance, game_items.type AS type, game_items.belongs_to AS belongs_to, game_items.uuid AS uuid, "
@@ -49,7 +49,7 @@ bool DBVersion::Create(AB::Entities::Version&)
 
 bool DBVersion::Load(AB::Entities::Version& v)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT * FROM versions WHERE ");
@@ -91,7 +91,7 @@ bool DBVersion::Delete(const AB::Entities::Version&)
 
 bool DBVersion::Exists(const AB::Entities::Version& v)
 {
-    Database* db = GetSubsystem<Database>();
+    Database* db = Database::Current();
 
     sa::templ::Parser parser;
     sa::templ::Tokens tokens = parser.Parse("SELECT COUNT(*) AS count FROM versions WHERE ");
@@ -0,0 +1,152 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "DatabaseWorkers.h"
+#include <abdb/Database.h>
+#include <sa/time.h>
+
+namespace DB {
+
+DatabaseWorkers::~DatabaseWorkers()
+{
+    Stop();
+}
+
+void DatabaseWorkers::SetNumThreads(size_t value)
+{
+    if (value == 0)
+        value = std::max<size_t>(1, std::thread::hardware_concurrency());
+    numThreads_ = value;
+}
+
+bool DatabaseWorkers::Start()
+{
+    std::scoped_lock lock(lock_);
+    if (running_)
+        return true;
+    connections_.reserve(numThreads_);
+    for (size_t i = 0; i < numThreads_; ++i)
+    {
+        std::unique_ptr<Database> db(Database::CreateInstance(Database::driver_,
+            Database::dbHost_, Database::dbPort_,
+            Database::dbUser_, Database::dbPass_,
+            Database::dbName_));
+        if (!db || !db->IsConnected())
+        {
+            LOG_ERROR << "Unable to open database connection for worker " << i << std::endl;
+            connections_.clear();
+            return false;
+        }
+        connections_.push_back(std::move(db));
+    }
+    running_ = true;
+    threads_.reserve(numThreads_);
+    for (auto& db : connections_)
+        threads_.emplace_back(&DatabaseWorkers::WorkerThread, this, db.get());
+    return true;
+}
+
+void DatabaseWorkers::Stop()
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (!running_)
+            return;
+        // Queued jobs are still executed, they may write to the DB
+        running_ = false;
+    }
+    signal_.notify_all();
+    for (auto& thread : threads_)
+        thread.join();
+    threads_.clear();
+    connections_.clear();
+}
+
+void DatabaseWorkers::Enqueue(Job&& job)
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (running_)
+        {
+            jobs_.push_back({ std::move(job), sa::time::tick() });
+            stats_.queued = jobs_.size();
+            if (stats_.queued > stats_.maxQueued)
+                stats_.maxQueued = stats_.queued;
+            signal_.notify_one();
+            return;
+        }
+    }
+    job();
+}
+
+DatabaseWorkers::Stats DatabaseWorkers::GetStats() const
+{
+    std::scoped_lock lock(lock_);
+    return stats_;
+}
+
+void DatabaseWorkers::WorkerThread(Database* db)
+{
+    Database::SetThreadInstance(db);
+    int64_t lastCheck = sa::time::tick();
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true)
+    {
+        const bool signaled = signal_.wait_for(lock, std::chrono::milliseconds(CHECK_CONNECTION_MS),
+            [this]() { return !running_ || !jobs_.empty(); });
+        if (signaled && jobs_.empty())
+            break;
+
+        if (sa::time::time_elapsed(lastCheck) >= CHECK_CONNECTION_MS)
+        {
+            // The server may have closed an idle connection. Reconnects when it is lost.
+            lock.unlock();
+            db->CheckConnection();
+            lastCheck = sa::time::tick();
+            lock.lock();
+        }
+        if (jobs_.empty())
+            continue;
+
+        QueuedJob job = std::move(jobs_.front());
+        jobs_.pop_front();
+        stats_.queued = jobs_.size();
+        const int64_t wait = sa::time::time_elapsed(job.enqueued);
+        lock.unlock();
+
+        sa::time::timer timer;
+        job.job();
+        const int64_t execute = timer.elapsed_millis();
+
+        lock.lock();
+        ++stats_.jobs;
+        stats_.totalWait += wait;
+        stats_.totalExecute += execute;
+        if (wait > stats_.maxWait)
+            stats_.maxWait = wait;
+        if (execute > stats_.maxExecute)
+            stats_.maxExecute = execute;
+    }
+    Database::SetThreadInstance(nullptr);
+}
+
+}
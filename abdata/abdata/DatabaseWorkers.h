@@ -0,0 +1,92 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DB {
+
+class Database;
+
+/// Runs database jobs, i.e. loading cache misses and flushing the cache, on a pool
+/// of worker threads, so slow queries do not block the Dispatcher. Each worker has
+/// its own connection, DB classes get it with Database::Current(). Jobs must pass
+/// their results back to the Dispatcher themselves. Workers check their connection
+/// regularly and reconnect when it was lost.
+class DatabaseWorkers
+{
+public:
+    using Job = std::function<void(void)>;
+    static constexpr int64_t CHECK_CONNECTION_MS = 60 * 1000;
+    struct Stats
+    {
+        uint64_t jobs{ 0 };
+        size_t queued{ 0 };
+        size_t maxQueued{ 0 };
+        // All times in ms
+        int64_t totalWait{ 0 };
+        int64_t maxWait{ 0 };
+        int64_t totalExecute{ 0 };
+        int64_t maxExecute{ 0 };
+    };
+
+    DatabaseWorkers() = default;
+    ~DatabaseWorkers();
+
+    /// 0 = number of CPU cores
+    void SetNumThreads(size_t value);
+    size_t GetNumThreads() const { return numThreads_; }
+
+    /// Opens a connection for each worker and starts the threads. Returns false
+    /// when a connection could not be opened.
+    bool Start();
+    void Stop();
+    /// When the workers are not running, the job is executed on the calling thread.
+    void Enqueue(Job&& job);
+    Stats GetStats() const;
+private:
+    struct QueuedJob
+    {
+        Job job;
+        int64_t enqueued;
+    };
+    void WorkerThread(Database* db);
+
+    size_t numThreads_{ 1 };
+    bool running_{ false };
+    mutable std::mutex lock_;
+    std::condition_variable signal_;
+    std::deque<QueuedJob> jobs_;
+    std::vector<std::unique_ptr<Database>> connections_;
+    std::vector<std::thread> threads_;
+    Stats stats_;
+};
+
+}
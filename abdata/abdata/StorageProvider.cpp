@@ -22,11 +22,14 @@
 
 #include "StorageProvider.h"
 #include "DBAll.h"
+#include "DatabaseWorkers.h"
 #include <AB/Entities/Party.h>
 #include <abscommon/Dispatcher.h>
 #include <abscommon/Profiler.h>
 #include <abscommon/Scheduler.h>
 #include <abscommon/ThreadPool.h>
+#include <sa/time.h>
+#include <future>
 #include <sstream>
 
 inline constexpr size_t KEY_CHARACTERS_HASH = sa::StringHash(AB::Entities::Character::KEY());
@@ -41,14 +44,28 @@ inline constexpr size_t KEY_EQUIPPEDITEMLIST_HASH = sa::StringHash(AB::Entities:
 inline constexpr size_t KEY_TYPEDITEMLIST_HASH = sa::StringHash(AB::Entities::TypedItemList::KEY());
 inline constexpr size_t KEY_ITEMPRICE_HASH = sa::StringHash(AB::Entities::ItemPrice::KEY());
 
+/// These are only cached and never written to the DB
+static bool IsStoredInDB(size_t tableHash)
+{
+    switch (tableHash)
+    {
+    case KEY_SERVICELIST_HASH:
+    case KEY_INVENTORYITEMLIST_HASH:
+    case KEY_EQUIPPEDITEMLIST_HASH:
+    case KEY_PARTIES_HASH:
+        return false;
+    default:
+        return true;
+    }
+}
+
 StorageProvider::StorageProvider(size_t maxSize, bool readonly) :
     flushInterval_(FLUSH_CACHE_MS),
     cleanInterval_(CLEAN_CACHE_MS),
     readonly_(readonly),
     running_(true),
     maxSize_(maxSize),
-    currentSize_(0),
-    cache_()
+    currentSize_(0)
 {
     InitEnitityClasses();
     auto sched = GetSubsystem<Asynch::Scheduler>();
@@ -127,12 +144,45 @@ void StorageProvider::InitEnitityClasses()
     AddEntityClass<DB::DBNews, AB::Entities::News>();
     AddEntityClass<DB::DBNewsList, AB::Entities::LatestNewsList>();
     AddEntityClass<DB::DBNewsList, AB::Entities::AllNewsList>();
+
+    AddCreateMany<DB::DBConcreteItem, AB::Entities::ConcreteItem>();
+    AddSaveMany<DB::DBAccount, AB::Entities::Account>();
+    AddSaveMany<DB::DBCharacter, AB::Entities::Character>();
+    AddSaveMany<DB::DBConcreteItem, AB::Entities::ConcreteItem>();
+}
+
+StorageProvider::CacheShard& StorageProvider::GetShard(const IO::DataKey& key)
+{
+    return cache_[std::hash<IO::DataKey>()(key) % SHARD_COUNT];
+}
+
+StorageProvider::CacheItem* StorageProvider::FindItem(const IO::DataKey& key)
+{
+    auto& shard = GetShard(key);
+    const auto it = shard.items.find(key);
+    if (it == shard.items.end())
+        return nullptr;
+    return &it->second;
+}
+
+void StorageProvider::EraseItem(const IO::DataKey& key)
+{
+    auto& shard = GetShard(key);
+    std::scoped_lock lock(shard.lock);
+    shard.items.erase(key);
+}
+
+void StorageProvider::SetFlags(const IO::DataKey& key, CacheItem& item, CacheFlags flags)
+{
+    auto& shard = GetShard(key);
+    std::scoped_lock lock(shard.lock);
+    item.flags = flags;
 }
 
 bool StorageProvider::Lock(uint32_t clientId, const IO::DataKey& key)
 {
-    auto _data = cache_.find(key);
-    if (_data == cache_.end())
+    CacheItem* item = FindItem(key);
+    if (item == nullptr)
     {
         ea::shared_ptr<StorageData> data = ea::make_shared<StorageData>();
         if (!Read(clientId, key, data))
@@ -140,58 +190,62 @@ bool StorageProvider::Lock(uint32_t clientId, const IO::DataKey& key)
             LOG_WARNING << clientId << " is trying to lock an entity which does not exist " << key.format() << std::endl;
             return false;
         }
-        _data = cache_.find(key);
-        if (_data == cache_.end())
+        item = FindItem(key);
+        if (item == nullptr)
             return false;
     }
-    if (IsDeleted(_data->second.flags))
+    if (IsDeleted(item->flags))
     {
         LOG_WARNING << clientId << " Can not lock deleted entity " << key.format() << std::endl;
         return false;
     }
-    if (_data->second.locker != 0)
+    if (item->locker != 0)
     {
-        LOG_WARNING << clientId << " is trying to lock an locked entity by " << _data->second.locker << std::endl;
+        LOG_WARNING << clientId << " is trying to lock an locked entity by " << item->locker << std::endl;
         return false;
     }
 //    LOG_DEBUG << "Locking entity " << key.format() << " for " << clientId << std::endl;
-    _data->second.locker = clientId;
+    // The locker is only used by the Dispatcher, no need to lock the shard
+    item->locker = clientId;
     return true;
 }
 
 bool StorageProvider::Unlock(uint32_t clientId, const IO::DataKey& key)
 {
-    auto _data = cache_.find(key);
-    if (_data == cache_.end())
+    CacheItem* item = FindItem(key);
+    if (item == nullptr)
     {
         // This frequently happens when unlocking an item that was invalidated before
         return false;
     }
-    if (_data->second.locker == 0)
+    if (item->locker == 0)
     {
 //        LOG_DEBUG << clientId << " tries to unlock an unlocked entity, " << key.format() << std::endl;
         return true;
     }
-    if (_data->second.locker != clientId)
+    if (item->locker != clientId)
     {
-        LOG_WARNING << clientId << " is trying to unlock an locked entity, locker " << _data->second.locker << std::endl;
+        LOG_WARNING << clientId << " is trying to unlock an locked entity, locker " << item->locker << std::endl;
         return false;
     }
 //    LOG_DEBUG << clientId << " Unlocking entity " << key.format() << std::endl;
-    _data->second.locker = 0;
+    item->locker = 0;
     return true;
 }
 
 bool StorageProvider::Create(uint32_t clientId, const IO::DataKey& key, ea::shared_ptr<StorageData> data)
 {
-    auto _data = cache_.find(key);
+    const CacheItem* item = FindItem(key);
 
-    if (_data != cache_.end())
+    if (item != nullptr)
     {
         // If there is a deleted record we must delete it from DB now or we may get
         // a constraint violation.
-        if (IsDeleted((*_data).second.flags))
+        if (IsDeleted(item->flags))
+        {
             FlushData(clientId, key);
+            deleted_.erase(key);
+        }
         else
             // Already exists
             return false;
@@ -237,19 +291,20 @@ bool StorageProvider::Update(uint32_t, const IO::DataKey& key, ea::shared_ptr<St
         // Does not exist
         return false;
 
-    auto _data = cache_.find(key);
+    const CacheItem* item = FindItem(key);
     // The only possibility to update a not yet created entity is when its in cache and not flushed.
     bool isCreated = true;
-    if (_data != cache_.end())
-        isCreated = IsCreated((*_data).second.flags);
+    if (item != nullptr)
+        isCreated = IsCreated(item->flags);
 
     // The client sets the data so this is not stored in DB
     CacheData(table, id, data, CacheFlag::Modified | (isCreated ? CacheFlag::Created : 0));
+    dirty_.emplace(key);
     return true;
 }
 
 void StorageProvider::CacheData(const std::string& table, const uuids::uuid& id,
-    ea::shared_ptr<StorageData> data, CacheFlags flags)
+    StorageBlob data, CacheFlags flags)
 {
     size_t sizeNeeded = data->size();
     if (!EnoughSpace(sizeNeeded))
@@ -261,10 +316,11 @@ void StorageProvider::CacheData(const std::string& table, const uuids::uuid& id,
     }
 
     const IO::DataKey key(table, id);
+    auto& shard = GetShard(key);
 
     uint32_t locker = 0;
-    const auto itemIt = cache_.find(key);
-    if (itemIt == cache_.end())
+    const auto itemIt = shard.items.find(key);
+    if (itemIt == shard.items.end())
     {
         index_.Add(key);
         currentSize_ += data->size();
@@ -276,7 +332,10 @@ void StorageProvider::CacheData(const std::string& table, const uuids::uuid& id,
         locker = itemIt->second.locker;
     }
 
-    cache_[key] = { flags, locker, data };
+    {
+        std::scoped_lock lock(shard.lock);
+        shard.items[key] = { flags, locker, data };
+    }
 
     const size_t tableHash = sa::StringHashRt(table.c_str());
     // Special case for player names
@@ -288,88 +347,191 @@ void StorageProvider::CacheData(const std::string& table, const uuids::uuid& id,
     }
 }
 
-bool StorageProvider::Read(uint32_t, const IO::DataKey& key, ea::shared_ptr<StorageData> data)
+bool StorageProvider::ReadCached(const IO::DataKey& key, StorageBlob& data)
 {
-    auto _data = cache_.find(key);
-    if (_data != cache_.end())
+    auto& shard = GetShard(key);
     {
-        if (IsDeleted((*_data).second.flags))
-            // Don't return deleted items that are in cache
+        std::scoped_lock lock(shard.lock);
+        const auto it = shard.items.find(key);
+        if (it == shard.items.end() || IsDeleted(it->second.flags))
             return false;
-        data->assign((*_data).second.data->begin(), (*_data).second.data->end());
-        return true;
+        data = it->second.data;
     }
+    ++readHits_;
+    return true;
+}
 
-    std::string table;
-    uuids::uuid _id;
-    if (!key.decode(table, _id))
+StorageProvider::ReadStats StorageProvider::GetReadStats() const
+{
+    return { readHits_.load(), readMisses_.load(), readsCoalesced_.load() };
+}
+
+StorageProvider::CacheItem* StorageProvider::FindByName(const std::string& table, const StorageData& data)
+{
+    // Special case for player names
+    if (sa::StringHashRt(table.data()) != KEY_CHARACTERS_HASH)
+        return nullptr;
+    AB::Entities::Character ch;
+    if (!GetEntity(data, ch) || ch.name.empty())
+        return nullptr;
+    auto* nameKey = namesCache_.LookupName(KEY_CHARACTERS_HASH, ch.name);
+    if (nameKey == nullptr)
+        return nullptr;
+    return FindItem(*nameKey);
+}
+
+StorageBlob StorageProvider::CacheLoaded(const std::string& table, uuids::uuid id,
+    StorageBlob data)
+{
+    if (id.nil())
+        // If no UUID given in key (e.g. when reading by name) cache with the proper key
+        id = GetUuid(*data);
+    const CacheItem* item = FindItem(IO::DataKey(table, id));
+    if (item == nullptr)
     {
-        LOG_ERROR << "Unable to decode key" << std::endl;
-        return false;
+        CacheData(table, id, data, CacheFlag::Created);
+        return data;
     }
+    // Was already cached
+    if (IsDeleted(item->flags))
+        // Don't return deleted items that are in cache
+        return {};
+    // Return the cached object, it may have changed
+    return item->data;
+}
 
-    // Maybe in player names cache
-    // Special case for player names
-    size_t tableHash = sa::StringHashRt(table.data());
-    if (tableHash == KEY_CHARACTERS_HASH)
+bool StorageProvider::Read(uint32_t, const IO::DataKey& key, ea::shared_ptr<StorageData> data)
+{
+    const CacheItem* item = FindItem(key);
+    std::string table;
+    uuids::uuid _id;
+    if (item == nullptr)
     {
-        AB::Entities::Character ch;
-        if (GetEntity(*data, ch) && !ch.name.empty())
+        if (!key.decode(table, _id))
         {
-            auto* nameKey = namesCache_.LookupName(KEY_CHARACTERS_HASH, ch.name);
-            if (nameKey != nullptr)
-            {
-                _data = cache_.find(*nameKey);
-                if (_data != cache_.end())
-                {
-                    if (IsDeleted((*_data).second.flags))
-                        // Don't return deleted items that are in cache
-                        return false;
-                    data->assign((*_data).second.data->begin(), (*_data).second.data->end());
-                    return true;
-                }
-            }
+            LOG_ERROR << "Unable to decode key" << std::endl;
+            return false;
         }
+        // Maybe in player names cache
+        item = FindByName(table, *data);
+    }
+    if (item != nullptr)
+    {
+        if (IsDeleted(item->flags))
+            // Don't return deleted items that are in cache
+            return false;
+        data->assign(item->data->begin(), item->data->end());
+        ++readHits_;
+        return true;
     }
 
     // Really not in cache
+    ++readMisses_;
     if (!LoadData(key, data))
         return false;
 
-    if (_id.nil())
-        // If no UUID given in key (e.g. when reading by name) cache with the proper key
-        _id = GetUuid(*data);
-    const IO::DataKey newKey(table, _id);
-    auto _newdata = cache_.find(newKey);
-    if (_newdata == cache_.end())
+    const auto result = CacheLoaded(table, _id, data);
+    if (!result)
+        return false;
+    if (result != data)
+        data->assign(result->begin(), result->end());
+    return true;
+}
+
+void StorageProvider::ReadAsync(uint32_t, const IO::DataKey& key, ea::shared_ptr<StorageData> request,
+    ReadCallback&& callback)
+{
+    const CacheItem* item = FindItem(key);
+    std::string table;
+    uuids::uuid id;
+    if (item == nullptr)
     {
-        CacheData(table, _id, data, CacheFlag::Created);
+        if (!key.decode(table, id))
+        {
+            LOG_ERROR << "Unable to decode key" << std::endl;
+            callback({});
+            return;
+        }
+        item = FindByName(table, *request);
     }
-    else
+    if (item != nullptr)
     {
-        // Was already cached
-        if (IsDeleted((*_newdata).second.flags))
-            // Don't return deleted items that are in cache
-            return false;
-        // Return the cached object, it may have changed
-        data->assign((*_newdata).second.data->begin(), (*_newdata).second.data->end());
+        if (IsDeleted(item->flags))
+        {
+            callback({});
+            return;
+        }
+        ++readHits_;
+        callback(item->data);
+        return;
     }
-    return true;
 
+    ++readMisses_;
+    ea::shared_ptr<PendingReads> reads;
+    // Without UUID the record is identified by the data, e.g. a character by its
+    // name, so these can not wait for the same load.
+    if (!id.nil())
+    {
+        const auto it = loading_.find(key);
+        if (it != loading_.end())
+        {
+            it->second->push_back(std::move(callback));
+            ++readsCoalesced_;
+            return;
+        }
+        reads = ea::make_shared<PendingReads>();
+        loading_.emplace(key, reads);
+    }
+    else
+        reads = ea::make_shared<PendingReads>();
+    reads->push_back(std::move(callback));
+
+    // The worker loads into the request buffer, nobody else uses it, and does not
+    // touch the cache
+    GetSubsystem<DB::DatabaseWorkers>()->Enqueue([this, key, loaded = std::move(request), reads]()
+    {
+        const bool success = LoadData(key, loaded);
+        GetSubsystem<Asynch::Dispatcher>()->Add(
+            Asynch::CreateTask(std::bind(&StorageProvider::FinishLoad, this, key, loaded, reads, success))
+        );
+    });
+}
+
+void StorageProvider::FinishLoad(IO::DataKey key, ea::shared_ptr<StorageData> data,
+    ea::shared_ptr<PendingReads> reads, bool success)
+{
+    // Dispatcher thread
+    const auto it = loading_.find(key);
+    if (it != loading_.end() && it->second == reads)
+        loading_.erase(it);
+
+    StorageBlob result;
+    if (success)
+    {
+        std::string table;
+        uuids::uuid id;
+        if (key.decode(table, id))
+            result = CacheLoaded(table, id, data);
+    }
+    for (auto& callback : *reads)
+        callback(result);
 }
 
 bool StorageProvider::Delete(uint32_t clientId, const IO::DataKey& key)
 {
     // You can only delete what you've loaded before
-    auto data = cache_.find(key);
-    if (data == cache_.end())
+    CacheItem* item = FindItem(key);
+    if (item == nullptr)
     {
         return false;
     }
-    if (!IsUnlockedFor(clientId, data->second))
+    if (!IsUnlockedFor(clientId, *item))
         return false;
 
-    sa::bits::set((*data).second.flags, CacheFlag::Deleted);
+    SetFlags(key, *item, item->flags | CacheFlag::Deleted);
+    // Deleted records are written by CleanCache()
+    dirty_.erase(key);
+    deleted_.emplace(key);
     return true;
 }
 
@@ -383,56 +545,22 @@ bool StorageProvider::Invalidate(uint32_t clientId, const IO::DataKey& key)
     return RemoveData(clientId, key);
 }
 
-void StorageProvider::PreloadTask(IO::DataKey key)
-{
-    // Dispatcher thread
-
-    auto _data = cache_.find(key);
-    if (_data == cache_.end())
-        return;
-
-    std::string table;
-    uuids::uuid _id;
-    if (!key.decode(table, _id))
-    {
-        LOG_ERROR << "Unable to decode key " << key.format() << std::endl;
-        return;
-    }
-    ea::shared_ptr<StorageData> data = ea::make_shared<StorageData>(0);
-    if (!LoadData(key, data))
-        return;
-
-    if (_id.nil())
-        // If no UUID given in key (e.g. when reading by name) cache with the proper key
-        _id = GetUuid(*data);
-    IO::DataKey newKey(table, _id);
-
-    auto _newdata = cache_.find(newKey);
-    if (_newdata == cache_.end())
-    {
-        CacheData(table, _id, data, CacheFlag::Created);
-    }
-}
-
 bool StorageProvider::Preload(uint32_t, const IO::DataKey& key)
 {
-    auto _data = cache_.find(key);
-    if (_data == cache_.end())
+    if (FindItem(key) != nullptr)
         return true;
 
-    // Load later
-    GetSubsystem<Asynch::Dispatcher>()->Add(
-        Asynch::CreateTask(std::bind(&StorageProvider::PreloadTask, this, key))
-    );
+    // Load it on a DB worker, nobody waits for it
+    ReadAsync(MY_CLIENT_ID, key, ea::make_shared<StorageData>(), [](StorageBlob) { });
     return true;
 }
 
 bool StorageProvider::Exists(uint32_t, const IO::DataKey& key, ea::shared_ptr<StorageData> data)
 {
-    auto _data = cache_.find(key);
+    const CacheItem* item = FindItem(key);
 
-    if (_data != cache_.end())
-        return !IsDeleted((*_data).second.flags);
+    if (item != nullptr)
+        return !IsDeleted(item->flags);
 
     return ExistsData(key, *data);
 }
@@ -441,28 +569,29 @@ bool StorageProvider::Clear(uint32_t clientId, const IO::DataKey&)
 {
     std::vector<IO::DataKey> toDelete;
 
-    for (const auto& ci : cache_)
+    VisitItems([&](const IO::DataKey& key, const CacheItem& item)
     {
-        const IO::DataKey& key = ci.first;
         std::string table;
         uuids::uuid id;
         if (!key.decode(table, id))
-            continue;
+            return;
         size_t tableHash = sa::StringHashRt(table.data());
         if (tableHash == KEY_GAMEINSTANCES_HASH || tableHash == KEY_SERVICE_HASH || tableHash == KEY_PARTIES_HASH)
             // Can not delete these
-            continue;
+            return;
 
         if (FlushData(clientId, key))
         {
-            currentSize_ -= ci.second.data->size();
+            currentSize_ -= item.data->size();
             toDelete.push_back(key);
         }
-    }
+    });
     for (const auto& k : toDelete)
     {
-        cache_.erase(k);
+        EraseItem(k);
         index_.Delete(k);
+        dirty_.erase(k);
+        deleted_.erase(k);
     }
     namesCache_.Clear();
     LOG_INFO << "Cleared cache, removed " << toDelete.size() << " items" << std::endl;
@@ -471,12 +600,35 @@ bool StorageProvider::Clear(uint32_t clientId, const IO::DataKey&)
 
 void StorageProvider::Shutdown()
 {
-    std::mutex mutex;
-    // The only thing that not called from the dispatcher thread, so lock it.
-    std::scoped_lock lock(mutex);
+    // Stops rescheduling FlushCacheTask()
     running_ = false;
-    for (const auto& c : cache_)
-        FlushData(MY_CLIENT_ID, c.first);
+    const auto flush = [this]()
+    {
+        // FlushCache() returns early while a flush is running, so finish that
+        // first to also write what was modified meanwhile.
+        WaitForFlush();
+        FlushCache();
+        WaitForFlush();
+        const ea::vector<IO::DataKey> keys(deleted_.begin(), deleted_.end());
+        for (const auto& key : keys)
+            FlushData(MY_CLIENT_ID, key);
+    };
+    // Called from Application::Stop(). Flush on the Dispatcher thread, where
+    // FlushCacheTask() accesses dirty_ and flushJob_.
+    auto* dispatcher = GetSubsystem<Asynch::Dispatcher>();
+    if (dispatcher->IsRunning() && !dispatcher->IsDispatcherThread())
+    {
+        auto done = std::make_shared<std::promise<void>>();
+        auto future = done->get_future();
+        dispatcher->Add(Asynch::CreateTask([flush, done]()
+        {
+            flush();
+            done->set_value();
+        }));
+        future.wait();
+    }
+    else
+        flush();
 
     DB::DBAccount::LogoutAll();
     DB::DBInstance::StopAll();
@@ -485,48 +637,48 @@ void StorageProvider::Shutdown()
 
 void StorageProvider::UnlockAll(uint32_t clientId)
 {
-    for (auto& c : cache_)
+    VisitItems([clientId](const IO::DataKey&, CacheItem& item)
     {
-        if (c.second.locker != 0 && c.second.locker == clientId)
-            c.second.locker = 0;
-    }
+        if (item.locker != 0 && item.locker == clientId)
+            item.locker = 0;
+    });
 }
 
 void StorageProvider::CleanCache()
 {
     // Delete deleted records from DB and remove them from cache.
-    if (cache_.size() == 0)
+    if (deleted_.size() == 0)
         return;
     size_t oldSize = currentSize_;
     int removed = 0;
-    auto i = cache_.begin();
-    while ((i = ea::find_if(i, cache_.end(), [](const auto& current) -> bool
-    {
-        return IsDeleted(current.second.flags);
-    })) != cache_.end())
+    const ea::vector<IO::DataKey> keys(deleted_.begin(), deleted_.end());
+    for (const auto& key : keys)
     {
+        const CacheItem* item = FindItem(key);
+        if (item == nullptr)
+        {
+            deleted_.erase(key);
+            continue;
+        }
         bool ok = true;
-        const IO::DataKey& key = (*i).first;
-        if (IsCreated((*i).second.flags))
+        if (IsCreated(item->flags))
         {
             // If it's in DB (created == true) update changed data in DB
             ok = FlushData(MY_CLIENT_ID, key);
         }
-        if (ok)
-        {
-            // Remove from players cache
-            RemovePlayerFromCache(key);
-            currentSize_ -= (*i).second.data->size();
-            index_.Delete(key);
-            cache_.erase(i++);
-            ++removed;
-        }
-        else
+        if (!ok)
         {
             // Error, break for now and try  the next time.
             // In case of lost connection it would try forever.
             break;
         }
+        // Remove from players cache
+        RemovePlayerFromCache(key);
+        currentSize_ -= item->data->size();
+        index_.Delete(key);
+        EraseItem(key);
+        deleted_.erase(key);
+        ++removed;
     }
 
     if (removed > 0)
@@ -554,46 +706,263 @@ void StorageProvider::CleanTask()
 void StorageProvider::ClearPrices()
 {
     // Remove prices from cache for force recalculate
-    auto i = cache_.begin();
-    while ((i = ea::find_if(i, cache_.end(), [](const auto& current) -> bool
+    ea::vector<IO::DataKey> prices;
+    VisitItems([&prices](const IO::DataKey& key, const CacheItem&)
     {
         std::string table;
         uuids::uuid id;
-        current.first.decode(table, id);
+        key.decode(table, id);
         const size_t tableHash = sa::StringHashRt(table.c_str());
-        return (tableHash == KEY_ITEMPRICE_HASH);
-    })) != cache_.end())
+        if (tableHash == KEY_ITEMPRICE_HASH)
+            prices.push_back(key);
+    });
+    for (const auto& key : prices)
+        RemoveData(MY_CLIENT_ID, key);
+}
+
+void StorageProvider::FlushCache()
+{
+    if (dirty_.size() == 0)
+        return;
+    if (readonly_)
+    {
+        LOG_WARNING << "READONLY: Nothing is written to the database" << std::endl;
+        dirty_.clear();
+        return;
+    }
+    if (flushJob_)
+        // The last flush is still running, these are written with the next one
+        return;
+
+    // Group the dirty records by entity type so records of the same table are
+    // written one after another.
+    ea::unordered_map<size_t, ea::vector<IO::DataKey>> batches;
+    for (const auto& key : dirty_)
+    {
+        std::string table;
+        uuids::uuid id;
+        if (!key.decode(table, id))
+            continue;
+        batches[sa::StringHashRt(table.c_str())].push_back(key);
+    }
+    dirty_.clear();
+
+    auto job = ea::make_shared<FlushJob>();
+    job->types = batches.size();
+    for (const auto& batch : batches)
     {
-        RemoveData(MY_CLIENT_ID, (*i).first);
+        job->batchSize = std::max(job->batchSize, batch.second.size());
+        for (const auto& key : batch.second)
+        {
+            const CacheItem* item = FindItem(key);
+            if (item == nullptr)
+                continue;
+            const CacheFlags flags = item->flags;
+            // Don't write deleted, these are flushed in CleanCache()
+            if (IsDeleted(flags) || (!IsModified(flags) && IsCreated(flags)))
+                continue;
+            if (!IsStoredInDB(batch.first) || !flushCallables_.Exists(batch.first))
+            {
+                // Nothing to write to the DB, FlushData() just marks it as written
+                FlushData(MY_CLIENT_ID, key);
+                continue;
+            }
+            if (!IsUnlockedFor(MY_CLIENT_ID, *item))
+            {
+                // Maybe locked, try again the next time.
+                LOG_WARNING << "Error flushing " << key.format() << std::endl;
+                dirty_.emplace(key);
+                ++flushStats_.failed;
+                continue;
+            }
+            FlushEntry entry;
+            entry.key = key;
+            entry.tableHash = batch.first;
+            entry.original = item->data;
+            entry.flags = item->flags;
+            entry.data = ea::make_shared<StorageData>(*item->data);
+            job->entries.push_back(std::move(entry));
+        }
     }
+    if (job->entries.empty())
+        return;
+
+    flushJob_ = job;
+    GetSubsystem<DB::DatabaseWorkers>()->Enqueue([this, job]()
+    {
+        ExecuteFlush(*job);
+        GetSubsystem<Asynch::Dispatcher>()->Add(
+            Asynch::CreateTask(std::bind(&StorageProvider::FinishFlush, this, job))
+        );
+    });
 }
 
-void StorageProvider::FlushCache()
+void StorageProvider::ExecuteFlush(FlushJob& job)
 {
-    if (cache_.size() == 0)
+    // DB worker thread
+    sa::time::timer timer;
+    // Write all records in one transaction. Each record gets a savepoint, so a
+    // failing record doesn't roll back the others.
+    DB::DBTransaction transaction(DB::Database::Current());
+    if (transaction.Begin())
+    {
+        FlushMany(job);
+        for (auto& entry : job.entries)
+            entry.success = flushCallables_.Call(entry.tableHash, entry.flags, *entry.data);
+        job.committed = transaction.Commit();
+    }
+    else
+        LOG_WARNING << "Unable to start a transaction, flushing later" << std::endl;
+    job.latency = timer.elapsed_millis();
+
+    {
+        std::scoped_lock lock(job.lock);
+        job.done = true;
+    }
+    job.signal.notify_all();
+}
+
+void StorageProvider::FlushMany(FlushJob& job)
+{
+    // DB worker thread
+    DB::Database* db = DB::Database::Current();
+    const bool multiInsert = db->GetParam(DB::DBPARAM_MULTIINSERT);
+    const bool multiUpdate = db->GetParam(DB::DBPARAM_MULTIUPDATE);
+    if (!multiInsert && !multiUpdate)
         return;
 
-    auto i = cache_.begin();
-    while ((i = ea::find_if(i, cache_.end(), [](const auto& current) -> bool
+    // Entries of the same table are next to each other
+    size_t start = 0;
+    while (start < job.entries.size())
     {
-        // Don't return deleted, these are flushed in CleanCache()
-        if ((IsModified(current.second.flags) || !IsCreated(current.second.flags)) &&
-            !IsDeleted(current.second.flags))
-            return true;
+        const size_t tableHash = job.entries[start].tableHash;
+        size_t end = start;
+        while (end < job.entries.size() && job.entries[end].tableHash == tableHash)
+            ++end;
+
+        const bool canCreate = multiInsert && createManyCallables_.Exists(tableHash);
+        const bool canSave = multiUpdate && saveManyCallables_.Exists(tableHash);
+        ea::vector<FlushEntry*> creates;
+        ea::vector<FlushEntry*> saves;
+        for (size_t i = start; i < end; ++i)
+        {
+            FlushEntry& entry = job.entries[i];
+            if (IsDeleted(entry.flags))
+                continue;
+            if (!IsCreated(entry.flags))
+            {
+                if (canCreate)
+                    creates.push_back(&entry);
+            }
+            else if (IsModified(entry.flags) && canSave)
+                saves.push_back(&entry);
+        }
 
-        return false;
-    })) != cache_.end())
+        // These write inside a savepoint. When it fails, FlushRecord() tries them
+        // one by one.
+        const auto writeMany = [tableHash](auto& callables, const ea::vector<FlushEntry*>& entries) -> bool
+        {
+            if (entries.size() < 2)
+                return false;
+            ea::vector<StorageData*> data;
+            data.reserve(entries.size());
+            for (FlushEntry* entry : entries)
+                data.push_back(entry->data.get());
+            return callables.Call(tableHash, data);
+        };
+        if (writeMany(createManyCallables_, creates))
+        {
+            for (FlushEntry* entry : creates)
+            {
+                sa::bits::set(entry->flags, CacheFlag::Created);
+                sa::bits::un_set(entry->flags, CacheFlag::Modified);
+            }
+        }
+        if (writeMany(saveManyCallables_, saves))
+        {
+            // Nothing left to do for FlushRecord()
+            for (FlushEntry* entry : saves)
+                sa::bits::un_set(entry->flags, CacheFlag::Modified);
+        }
+        start = end;
+    }
+}
+
+void StorageProvider::FinishFlush(ea::shared_ptr<FlushJob> job)
+{
+    // Dispatcher thread
+    if (flushJob_ != job)
+        // Already applied by WaitForFlush()
+        return;
+    flushJob_.reset();
+    ApplyFlush(*job);
+}
+
+void StorageProvider::WaitForFlush()
+{
+    if (!flushJob_)
+        return;
+    auto job = flushJob_;
+    flushJob_.reset();
+    job->Wait();
+    ApplyFlush(*job);
+}
+
+void StorageProvider::ApplyFlush(FlushJob& job)
+{
+    if (!job.committed)
+        LOG_ERROR << "Error committing " << job.entries.size() << " record(s)" << std::endl;
+
+    size_t rows = 0;
+    size_t failed = 0;
+    for (auto& entry : job.entries)
     {
-        const IO::DataKey& key = (*i).first;
-        bool res = FlushData(MY_CLIENT_ID, key);
-        if (!res)
+        CacheItem* item = FindItem(entry.key);
+        if (!job.committed || !entry.success)
         {
-            LOG_WARNING << "Error flushing " << key.format() << std::endl;
-            // Error, break for now and try  the next time.
-            // In case of lost connection it would try forever.
-            break;
+            // Nothing was written, make it dirty again
+            if (job.committed)
+                LOG_WARNING << "Error flushing " << entry.key.format() << std::endl;
+            if (item != nullptr && !IsDeleted(item->flags))
+                dirty_.emplace(entry.key);
+            ++failed;
+            continue;
+        }
+        ++rows;
+        if (item == nullptr)
+            continue;
+
+        auto& shard = GetShard(entry.key);
+        std::scoped_lock lock(shard.lock);
+        if (item->data == entry.original)
+        {
+            // Creating it may have changed the data, e.g. the ID
+            if (*entry.data != *entry.original)
+            {
+                currentSize_ = (currentSize_ - entry.original->size()) + entry.data->size();
+                item->data = entry.data;
+            }
+            item->flags = entry.flags | (item->flags & CacheFlag::Deleted);
         }
+        else if (IsCreated(entry.flags))
+            // It was updated meanwhile, so it's still modified, but it exists now
+            sa::bits::set(item->flags, CacheFlag::Created);
     }
+
+    flushStats_.failed += failed;
+    if (rows == 0)
+        return;
+
+    ++flushStats_.flushes;
+    flushStats_.rows += rows;
+    flushStats_.lastRows = rows;
+    flushStats_.lastBatchSize = job.batchSize;
+    flushStats_.maxBatchSize = std::max(flushStats_.maxBatchSize, job.batchSize);
+    flushStats_.lastLatency = job.latency;
+    flushStats_.maxLatency = std::max(flushStats_.maxLatency, job.latency);
+    LOG_INFO << "Flushed " << rows << " record(s) of " << job.types <<
+        " type(s), largest batch " << job.batchSize << ", failed " << failed <<
+        ", took " << job.latency << "ms" << std::endl;
 }
 
 void StorageProvider::ClearPricesTask()
@@ -609,9 +978,21 @@ void StorageProvider::ClearPricesTask()
 
 void StorageProvider::FlushCacheTask()
 {
-    DB::Database* db = GetSubsystem<DB::Database>();
+    DB::Database* db = DB::Database::Current();
     db->CheckConnection();
     FlushCache();
+
+    const ReadStats reads = GetReadStats();
+    if (reads.hits != lastReadStats_.hits || reads.misses != lastReadStats_.misses)
+    {
+        const DB::DatabaseWorkers::Stats workers = GetSubsystem<DB::DatabaseWorkers>()->GetStats();
+        LOG_INFO << "Reads " << (reads.hits - lastReadStats_.hits) << " cached, " <<
+            (reads.misses - lastReadStats_.misses) << " loaded, " <<
+            (reads.coalesced - lastReadStats_.coalesced) << " coalesced, DB jobs " << workers.jobs <<
+            " max wait " << workers.maxWait << "ms max execute " << workers.maxExecute << "ms" << std::endl;
+        lastReadStats_ = reads;
+    }
+
     if (running_)
     {
         GetSubsystem<Asynch::Scheduler>()->Add(
@@ -620,7 +1001,7 @@ void StorageProvider::FlushCacheTask()
     }
 }
 
-uuids::uuid StorageProvider::GetUuid(StorageData& data)
+uuids::uuid StorageProvider::GetUuid(const StorageData& data)
 {
     // Get UUID from raw data. UUID is serialized first as string
     const std::string suuid(data.begin() + 1,
@@ -649,17 +1030,19 @@ void StorageProvider::CreateSpace(size_t size)
 
 bool StorageProvider::RemoveData(uint32_t clientId, const IO::DataKey& key)
 {
-    auto data = cache_.find(key);
-    if (data != cache_.end())
+    const CacheItem* item = FindItem(key);
+    if (item != nullptr)
     {
-        if (!IsUnlockedFor(clientId, data->second))
+        if (!IsUnlockedFor(clientId, *item))
             return false;
 
         RemovePlayerFromCache(key);
 
-        currentSize_ -= (*data).second.data->size();
-        cache_.erase(key);
+        currentSize_ -= item->data->size();
+        EraseItem(key);
         index_.Delete(key);
+        dirty_.erase(key);
+        deleted_.erase(key);
 
         return true;
     }
@@ -710,18 +1093,21 @@ bool StorageProvider::FlushData(uint32_t clientId, const IO::DataKey& key)
         return true;
     }
 
-    auto data = cache_.find(key);
-    if (data == cache_.end())
+    CacheItem* cached = FindItem(key);
+    if (cached == nullptr)
         // Not in cache so no need to flush anything
         return true;
 
-    CacheItem& item = (*data).second;
-
     // No need to save to DB when not modified
-    if (!IsModified(item.flags) && !IsDeleted(item.flags) && IsCreated(item.flags))
+    if (!IsModified(cached->flags) && !IsDeleted(cached->flags) && IsCreated(cached->flags))
         return true;
 
-    if (!IsUnlockedFor(clientId, item))
+    // A running flush may write this record too, and it must not overwrite what we write
+    WaitForFlush();
+    if (!IsModified(cached->flags) && !IsDeleted(cached->flags) && IsCreated(cached->flags))
+        return true;
+
+    if (!IsUnlockedFor(clientId, *cached))
         return false;
 
     std::string table;
@@ -734,6 +1120,10 @@ bool StorageProvider::FlushData(uint32_t clientId, const IO::DataKey& key)
 
     size_t tableHash = sa::StringHashRt(table.data());
     bool succ = false;
+    // Writing may change the data, and other threads may read the cached data, so
+    // write a copy
+    CacheFlags flags = cached->flags;
+    auto data = ea::make_shared<StorageData>(*cached->data);
 
     switch (tableHash)
     {
@@ -749,13 +1139,13 @@ bool StorageProvider::FlushData(uint32_t clientId, const IO::DataKey& key)
     case KEY_PARTIES_HASH:
         // Not written to DB
         // Mark not modified and created or it will infinitely try to flush it
-        item.flags = CacheFlag::Created;
+        flags = CacheFlag::Created;
         succ = true;
         break;
     default:
     {
         if (flushCallables_.Exists(tableHash))
-            succ = flushCallables_.Call(tableHash, item);
+            succ = flushCallables_.Call(tableHash, flags, *data);
         else
         {
             LOG_ERROR << "Unknown table " << table << std::endl;
@@ -764,8 +1154,22 @@ bool StorageProvider::FlushData(uint32_t clientId, const IO::DataKey& key)
     }
     }
 
+    {
+        auto& shard = GetShard(key);
+        std::scoped_lock lock(shard.lock);
+        cached->flags = flags;
+        // Creating it may have changed the data, e.g. the ID
+        if (*data != *cached->data)
+        {
+            currentSize_ = (currentSize_ - cached->data->size()) + data->size();
+            cached->data = data;
+        }
+    }
+
     if (!succ)
         LOG_ERROR << "Unable to write data" << std::endl;
+    else if (!IsDeleted(flags))
+        dirty_.erase(key);
     return succ;
 }
 
@@ -815,8 +1219,7 @@ void StorageProvider::RemovePlayerFromCache(const IO::DataKey& key)
     size_t tableHash = sa::StringHashRt(table.data());
     if (tableHash == KEY_CHARACTERS_HASH)
     {
-        auto _data = cache_.find(key);
-        if (_data == cache_.end())
+        if (FindItem(key) == nullptr)
             return;
         namesCache_.Delete(key);
     }
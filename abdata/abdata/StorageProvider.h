@@ -21,6 +21,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <vector>
 #include <sa/Compiler.h>
@@ -76,10 +80,48 @@ inline bool IsDeleted(CacheFlags flags)
 }
 
 using StorageData = std::vector<uint8_t>;
+/// Cached data is shared with the connections sending it and never modified,
+/// an update replaces it.
+using StorageBlob = ea::shared_ptr<const StorageData>;
 
+/// The cache is split into shards, each with its own lock. Only the Dispatcher
+/// thread modifies the cache, and it locks the shard while doing so. Other threads
+/// may read cached records with ReadCached(). Cached data is a StorageBlob, reads
+/// return the cached blob itself without copying it. Cache misses are loaded and the cache is flushed on the
+/// DB::DatabaseWorkers.
 class StorageProvider
 {
 public:
+    /// Called on the Dispatcher thread when an asynchronous read finished. data is
+    /// nullptr when it failed.
+    using ReadCallback = std::function<void(StorageBlob data)>;
+    struct ReadStats
+    {
+        /// Reads served from the cache
+        uint64_t hits{ 0 };
+        /// Reads which had to be loaded from the DB
+        uint64_t misses{ 0 };
+        /// Misses which waited for a load of the same record already in progress
+        uint64_t coalesced{ 0 };
+    };
+    struct FlushStats
+    {
+        /// Number of flushes that wrote something
+        uint64_t flushes{ 0 };
+        /// Total number of records written
+        uint64_t rows{ 0 };
+        /// Total number of records that failed and were queued again
+        uint64_t failed{ 0 };
+        /// Records written by the last flush
+        size_t lastRows{ 0 };
+        /// Largest number of records of one entity type in the last flush
+        size_t lastBatchSize{ 0 };
+        size_t maxBatchSize{ 0 };
+        /// Duration of the last flush in ms
+        int64_t lastLatency{ 0 };
+        int64_t maxLatency{ 0 };
+    };
+
     StorageProvider(size_t maxSize, bool readonly);
 
     bool Lock(uint32_t clientId, const IO::DataKey& key);
@@ -87,6 +129,14 @@ public:
     bool Create(uint32_t clientId, const IO::DataKey& key, ea::shared_ptr<StorageData> data);
     bool Update(uint32_t clientId, const IO::DataKey& key, ea::shared_ptr<StorageData> data);
     bool Read(uint32_t clientId, const IO::DataKey& key, ea::shared_ptr<StorageData> data);
+    /// Like Read() but a cache miss is loaded by a DB worker and does not block the
+    /// Dispatcher. Concurrent reads of the same record wait for the same load.
+    /// request is only needed when the key has no UUID, e.g. to find a character
+    /// by its name. It may be used as buffer for loading the record.
+    void ReadAsync(uint32_t clientId, const IO::DataKey& key, ea::shared_ptr<StorageData> request,
+        ReadCallback&& callback);
+    /// Thread safe. Returns true and the cached data when the record is in the cache.
+    bool ReadCached(const IO::DataKey& key, StorageBlob& data);
     bool Delete(uint32_t clientId, const IO::DataKey& key);
     bool Invalidate(uint32_t clientId, const IO::DataKey& key);
     bool Preload(uint32_t clientId, const IO::DataKey& key);
@@ -161,6 +211,8 @@ public:
     }
     void Shutdown();
     void UnlockAll(uint32_t clientId);
+    const FlushStats& GetFlushStats() const { return flushStats_; }
+    ReadStats GetReadStats() const;
     uint32_t flushInterval_;
     uint32_t cleanInterval_;
 private:
@@ -169,11 +221,52 @@ private:
     {
         CacheFlags flags{ 0 };
         uint32_t locker{ 0 };
+        StorageBlob data;
+    };
+    using CacheMap = ea::unordered_map<IO::DataKey, CacheItem, std::hash<IO::DataKey>>;
+    static constexpr size_t SHARD_COUNT = 16;
+    struct CacheShard
+    {
+        std::mutex lock;
+        CacheMap items;
+    };
+    /// Reads waiting for a record being loaded
+    using PendingReads = ea::vector<ReadCallback>;
+    /// A record written by a flush. Writing may change the data, e.g. the ID, so
+    /// it writes a copy.
+    struct FlushEntry
+    {
+        IO::DataKey key;
+        size_t tableHash{ 0 };
+        /// The cached data when the flush started, to see if it was updated meanwhile
+        StorageBlob original;
+        CacheFlags flags{ 0 };
         ea::shared_ptr<StorageData> data;
+        bool success{ false };
+    };
+    /// A flush executed by a DB worker
+    struct FlushJob
+    {
+        ea::vector<FlushEntry> entries;
+        size_t types{ 0 };
+        size_t batchSize{ 0 };
+        bool committed{ false };
+        int64_t latency{ 0 };
+        std::mutex lock;
+        std::condition_variable signal;
+        bool done{ false };
+        void Wait()
+        {
+            std::unique_lock<std::mutex> l(lock);
+            signal.wait(l, [this]() { return done; });
+        }
     };
     sa::CallableTable<size_t, bool, StorageData&> exitsCallables_;
-    sa::CallableTable<size_t, bool, CacheItem&> flushCallables_;
+    sa::CallableTable<size_t, bool, CacheFlags&, StorageData&> flushCallables_;
     sa::CallableTable<size_t, bool, const uuids::uuid&, StorageData&> loadCallables_;
+    /// Insert or update many records of a table with one statement
+    sa::CallableTable<size_t, bool, const ea::vector<StorageData*>&> createManyCallables_;
+    sa::CallableTable<size_t, bool, const ea::vector<StorageData*>&> saveManyCallables_;
     template<typename D, typename E>
     void AddEntityClass()
     {
@@ -187,35 +280,87 @@ private:
         {
             return ExistsInDB<D, E>(data);
         });
-        flushCallables_.Add(hash, [this](CacheItem& data) -> bool
+        flushCallables_.Add(hash, [this](CacheFlags& flags, StorageData& data) -> bool
         {
-            return FlushRecord<D, E>(data);
+            return FlushRecord<D, E>(flags, data);
         });
         loadCallables_.Add(hash, [this](const auto& id, auto& data) -> bool
         {
             return LoadFromDB<D, E>(id, data);
         });
     }
+    /// Entities that are created often, and D has a CreateMany() function
+    template<typename D, typename E>
+    void AddCreateMany()
+    {
+        static constexpr size_t hash = sa::StringHash(E::KEY());
+        createManyCallables_.Add(hash, [this](const auto& data) -> bool
+        {
+            return CreateManyInDB<D, E>(data);
+        });
+    }
+    /// Entities that are updated often, and D has a SaveMany() function
+    template<typename D, typename E>
+    void AddSaveMany()
+    {
+        static constexpr size_t hash = sa::StringHash(E::KEY());
+        saveManyCallables_.Add(hash, [this](const auto& data) -> bool
+        {
+            return SaveManyToDB<D, E>(data);
+        });
+    }
     void InitEnitityClasses();
 
     /// Read UUID from data
-    static uuids::uuid GetUuid(StorageData& data);
+    static uuids::uuid GetUuid(const StorageData& data);
 
     bool EnoughSpace(size_t size);
     void CreateSpace(size_t size);
     void CacheData(const std::string& table, const uuids::uuid& id,
-        ea::shared_ptr<StorageData> data,
+        StorageBlob data,
         CacheFlags flags);
     bool RemoveData(uint32_t clientId, const IO::DataKey& key);
-    void PreloadTask(IO::DataKey key);
     bool ExistsData(const IO::DataKey& key, StorageData& data);
     /// If the data is a player and it's in playerNames_ remove it from playerNames_
     void RemovePlayerFromCache(const IO::DataKey& key);
 
+    CacheShard& GetShard(const IO::DataKey& key);
+    /// Dispatcher thread only, it does not lock
+    CacheItem* FindItem(const IO::DataKey& key);
+    void EraseItem(const IO::DataKey& key);
+    void SetFlags(const IO::DataKey& key, CacheItem& item, CacheFlags flags);
+    template<typename Callback>
+    void VisitItems(Callback&& callback)
+    {
+        for (auto& shard : cache_)
+        {
+            for (auto& item : shard.items)
+                callback(item.first, item.second);
+        }
+    }
+    /// Looks up a character by name in the names cache
+    CacheItem* FindByName(const std::string& table, const StorageData& data);
+    /// Caches a record loaded from the DB. Returns the data which should be returned
+    /// to the client or nullptr when the cached record is deleted.
+    StorageBlob CacheLoaded(const std::string& table, uuids::uuid id,
+        StorageBlob data);
+    void FinishLoad(IO::DataKey key, ea::shared_ptr<StorageData> data,
+        ea::shared_ptr<PendingReads> reads, bool success);
+
     void CleanCache();
     void CleanTask();
+    /// Starts writing the dirty records on a DB worker
     void FlushCache();
     void FlushCacheTask();
+    void ExecuteFlush(FlushJob& job);
+    /// Writes new and modified records of the same table with multi row INSERTs and
+    /// UPDATEs. Records that could not be written this way are left to FlushRecord().
+    void FlushMany(FlushJob& job);
+    void FinishFlush(ea::shared_ptr<FlushJob> job);
+    /// Waits until a running flush finished and applies its result. Must be called
+    /// before writing to the DB on the Dispatcher, so records are written in order.
+    void WaitForFlush();
+    void ApplyFlush(FlushJob& job);
     void ClearPrices();
     void ClearPricesTask();
 
@@ -243,27 +388,27 @@ private:
     /// Depending on the data header calls CreateInDB(), SaveToDB() and/or DeleteFromDB()
     bool FlushData(uint32_t clientId, const IO::DataKey& key);
     template<typename D, typename E>
-    bool FlushRecord(CacheItem& data)
+    bool FlushRecord(CacheFlags& flags, StorageData& data)
     {
         bool succ = true;
         // These flags are not mutually exclusive, howerer creating it implies it is no longer modified
-        if (!IsCreated(data.flags))
+        if (!IsCreated(flags))
         {
-            succ = CreateInDB<D, E>(*data.data);
+            succ = CreateInDB<D, E>(data);
             if (succ)
             {
-                sa::bits::set(data.flags, CacheFlag::Created);
-                sa::bits::un_set(data.flags, CacheFlag::Modified);
+                sa::bits::set(flags, CacheFlag::Created);
+                sa::bits::un_set(flags, CacheFlag::Modified);
             }
         }
-        else if (IsModified(data.flags))
+        else if (IsModified(flags))
         {
-            succ = SaveToDB<D, E>(*data.data);
+            succ = SaveToDB<D, E>(data);
             if (succ)
-                sa::bits::un_set(data.flags, CacheFlag::Modified);
+                sa::bits::un_set(flags, CacheFlag::Modified);
         }
-        if (IsDeleted(data.flags))
-            succ = DeleteFromDB<D, E>(*data.data);
+        if (IsDeleted(flags))
+            succ = DeleteFromDB<D, E>(data);
 
         return succ;
     }
@@ -289,6 +434,35 @@ private:
             return D::Save(e);
         return false;
     }
+    template<typename E>
+    static bool GetEntities(const ea::vector<StorageData*>& data, std::vector<E>& entities)
+    {
+        entities.reserve(data.size());
+        for (StorageData* d : data)
+        {
+            E e{};
+            if (!GetEntity<E>(*d, e))
+                return false;
+            entities.push_back(std::move(e));
+        }
+        return true;
+    }
+    template<typename D, typename E>
+    bool CreateManyInDB(const ea::vector<StorageData*>& data)
+    {
+        std::vector<E> entities;
+        if (GetEntities<E>(data, entities))
+            return D::CreateMany(entities);
+        return false;
+    }
+    template<typename D, typename E>
+    bool SaveManyToDB(const ea::vector<StorageData*>& data)
+    {
+        std::vector<E> entities;
+        if (GetEntities<E>(data, entities))
+            return D::SaveMany(entities);
+        return false;
+    }
     template<typename D, typename E>
     bool DeleteFromDB(StorageData& data)
     {
@@ -307,10 +481,11 @@ private:
     }
 
     template<typename E>
-    static bool GetEntity(StorageData& data, E& e)
+    static bool GetEntity(const StorageData& data, E& e)
     {
         using InputAdapter = bitsery::InputBufferAdapter<StorageData>;
-        InputAdapter ia(data.begin(), data.size());
+        // The adapter wants a non-const iterator, but it only reads
+        InputAdapter ia(const_cast<StorageData&>(data).begin(), data.size());
         auto state = bitsery::quickDeserialization<InputAdapter, E>(ia, e);
         return state.first == bitsery::ReaderError::NoError;
     }
@@ -323,11 +498,24 @@ private:
     static bool IsUnlockedFor(uint32_t clientId, const CacheItem& item);
 
     bool readonly_;
-    bool running_;
+    std::atomic<bool> running_;
     size_t maxSize_;
     size_t currentSize_;
 
-    ea::unordered_map<IO::DataKey, CacheItem, std::hash<IO::DataKey>> cache_;
+    std::array<CacheShard, SHARD_COUNT> cache_;
+    /// Records currently loaded by a DB worker -> reads waiting for them
+    ea::unordered_map<IO::DataKey, ea::shared_ptr<PendingReads>, std::hash<IO::DataKey>> loading_;
+    /// The flush running on a DB worker
+    ea::shared_ptr<FlushJob> flushJob_;
+    std::atomic<uint64_t> readHits_{ 0 };
+    std::atomic<uint64_t> readMisses_{ 0 };
+    std::atomic<uint64_t> readsCoalesced_{ 0 };
+    /// Modified records which are written to the DB with the next FlushCache()
+    ea::unordered_set<IO::DataKey, std::hash<IO::DataKey>> dirty_;
+    /// Deleted records which are removed from the DB and the cache with the next CleanCache()
+    ea::unordered_set<IO::DataKey, std::hash<IO::DataKey>> deleted_;
+    FlushStats flushStats_;
+    ReadStats lastReadStats_;
     /// Name (Playername, Guildname etc.) -> Cache Key
     NameIndex namesCache_;
     CacheIndex index_;
@@ -34,6 +34,9 @@
 #include "DatabaseSqlite.h"
 #endif
 #include <abscommon/Logger.h>
+#include <abscommon/Subsystems.h>
+#include <sa/TemplateParser.h>
+#include <algorithm>
 
 namespace DB {
 
@@ -44,6 +47,20 @@ std::string Database::dbUser_ = "";
 std::string Database::dbPass_ = "";
 uint16_t Database::dbPort_ = 0;
 
+static thread_local Database* threadInstance = nullptr;
+
+void Database::SetThreadInstance(Database* db)
+{
+    threadInstance = db;
+}
+
+Database* Database::Current()
+{
+    if (threadInstance)
+        return threadInstance;
+    return GetSubsystem<Database>();
+}
+
 Database* Database::CreateInstance(const std::string& driver,
     const std::string& host, uint16_t port,
     const std::string& user, const std::string& pass,
@@ -75,6 +92,8 @@ Database* Database::CreateInstance(const std::string& driver,
     return nullptr;
 }
 
+Database::~Database() = default;
+
 bool Database::ExecuteQuery(const std::string& query)
 {
     return InternalQuery(query);
@@ -92,11 +111,291 @@ std::shared_ptr<DBResult> Database::VerifyResult(std::shared_ptr<DBResult> resul
     return result;
 }
 
+PreparedStatement& Database::Prepare(std::string_view sql)
+{
+    auto it = statements_.find(sql);
+    if (it == statements_.end())
+    {
+        std::unique_ptr<PreparedStatement> statement = CreateStatement(sql);
+        const std::string_view key = statement->GetSql();
+        it = statements_.emplace(key, std::move(statement)).first;
+    }
+    else
+        it->second->Reset();
+    return *it->second;
+}
+
+std::unique_ptr<PreparedStatement> Database::CreateStatement(std::string_view sql)
+{
+    return std::make_unique<PreparedStatement>(this, sql);
+}
+
+void Database::InvalidateStatements()
+{
+    for (auto& statement : statements_)
+        statement.second->Invalidate();
+}
+
 void Database::FreeResult(DBResult*)
 {
     LOG_ERROR << "No database driver loaded, yet a DBResult was freed.";
 }
 
+bool Database::Savepoint(const std::string& name)
+{
+    return ExecuteQuery("SAVEPOINT " + name);
+}
+
+bool Database::ReleaseSavepoint(const std::string& name)
+{
+    return ExecuteQuery("RELEASE SAVEPOINT " + name);
+}
+
+bool Database::RollbackToSavepoint(const std::string& name)
+{
+    return ExecuteQuery("ROLLBACK TO SAVEPOINT " + name);
+}
+
 DBResult::~DBResult() = default;
 
+DBTransaction::~DBTransaction()
+{
+    if (state_ != State::Started)
+        return;
+
+    --db_->transactionDepth_;
+    if (level_ == 1)
+        db_->Rollback();
+    else
+        db_->RollbackToSavepoint(GetSavepointName());
+}
+
+std::string DBTransaction::GetSavepointName() const
+{
+    return "sp_" + std::to_string(level_);
+}
+
+bool DBTransaction::Begin()
+{
+    level_ = db_->transactionDepth_ + 1;
+    const bool ret = (level_ == 1) ? db_->BeginTransaction() : db_->Savepoint(GetSavepointName());
+    if (!ret)
+        return false;
+    ++db_->transactionDepth_;
+    state_ = State::Started;
+    return true;
+}
+
+bool DBTransaction::Commit()
+{
+    if (state_ != State::Started)
+        return false;
+
+    state_ = State::Committed;
+    --db_->transactionDepth_;
+    if (level_ == 1)
+        return db_->Commit();
+    return db_->ReleaseSavepoint(GetSavepointName());
+}
+
+PreparedStatement::PreparedStatement(Database* db, std::string_view sql) :
+    db_(db),
+    sql_(sql)
+{
+    // Number the parameters in the order of their first appearance
+    sa::templ::Parser::Evaluate(sql_, [this](const sa::templ::Token& token) -> std::string
+    {
+        if (token.type == sa::templ::Token::Type::Variable &&
+            std::find(names_.begin(), names_.end(), token.value) == names_.end())
+            names_.push_back(token.value);
+        return std::string();
+    });
+    params_.resize(names_.size());
+}
+
+PreparedStatement::~PreparedStatement() = default;
+
+std::string PreparedStatement::BuildSql(const std::function<std::string(size_t)>& placeholder) const
+{
+    return sa::templ::Parser::Evaluate(sql_, [&](const sa::templ::Token& token) -> std::string
+    {
+        if (token.type != sa::templ::Token::Type::Variable)
+            return token.value;
+        const auto it = std::find(names_.begin(), names_.end(), token.value);
+        return placeholder(static_cast<size_t>(std::distance(names_.begin(), it)) + 1);
+    });
+}
+
+std::string PreparedStatement::Evaluate() const
+{
+    return BuildSql([this](size_t number) -> std::string
+    {
+        const Param& param = params_[number - 1];
+        switch (param.type)
+        {
+        case ParamType::Int:
+            return std::to_string(param.intValue);
+        case ParamType::UInt:
+            return std::to_string(static_cast<uint64_t>(param.intValue));
+        case ParamType::String:
+            return db_->EscapeString(param.stringValue);
+        case ParamType::Blob:
+            return db_->EscapeBlob(param.stringValue.data(), param.stringValue.length());
+        default:
+            return "NULL";
+        }
+    });
+}
+
+PreparedStatement::Param* PreparedStatement::GetParam(const std::string& name)
+{
+    for (size_t i = 0; i < names_.size(); ++i)
+    {
+        if (names_[i] == name)
+            return &params_[i];
+    }
+    LOG_WARNING << "Unknown parameter " << name << " in " << sql_ << std::endl;
+    return nullptr;
+}
+
+void PreparedStatement::Reset()
+{
+    for (auto& param : params_)
+    {
+        param.type = ParamType::Null;
+        param.stringValue.clear();
+    }
+}
+
+PreparedStatement& PreparedStatement::BindInt(const std::string& name, ParamType type, int64_t value)
+{
+    if (Param* param = GetParam(name))
+    {
+        param->type = type;
+        param->intValue = value;
+    }
+    return *this;
+}
+
+PreparedStatement& PreparedStatement::Bind(const std::string& name, const std::string& value)
+{
+    if (Param* param = GetParam(name))
+    {
+        param->type = ParamType::String;
+        param->stringValue = value;
+    }
+    return *this;
+}
+
+PreparedStatement& PreparedStatement::BindBlob(const std::string& name, const std::string& value)
+{
+    if (Param* param = GetParam(name))
+    {
+        param->type = ParamType::Blob;
+        param->stringValue = value;
+    }
+    return *this;
+}
+
+PreparedStatement& PreparedStatement::BindNull(const std::string& name)
+{
+    if (Param* param = GetParam(name))
+        param->type = ParamType::Null;
+    return *this;
+}
+
+bool PreparedStatement::Execute()
+{
+    return db_->ExecuteQuery(Evaluate());
+}
+
+std::shared_ptr<DBResult> PreparedStatement::Query()
+{
+    return db_->StoreQuery(Evaluate());
+}
+
+static std::string BuildMultiInsert(const std::string& table, const std::vector<DBColumn>& columns, size_t rows)
+{
+    std::ostringstream ss;
+    ss << "INSERT INTO " << table << " (";
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        if (c > 0)
+            ss << ", ";
+        ss << columns[c].name;
+    }
+    ss << ") VALUES ";
+    for (size_t r = 0; r < rows; ++r)
+    {
+        if (r > 0)
+            ss << ", ";
+        ss << "(";
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            if (c > 0)
+                ss << ", ";
+            ss << "${" << columns[c].name << "_" << r << "}";
+        }
+        ss << ")";
+    }
+    return ss.str();
+}
+
+std::vector<std::string> BuildMultiInserts(const std::string& table, const std::vector<DBColumn>& columns)
+{
+    std::vector<std::string> result;
+    result.reserve(MULTIUPDATE_MAX_ROWS);
+    for (size_t rows = 1; rows <= MULTIUPDATE_MAX_ROWS; ++rows)
+        result.push_back(BuildMultiInsert(table, columns, rows));
+    return result;
+}
+
+static std::string BuildMultiUpdate(const std::string& table, const std::vector<DBColumn>& columns, size_t rows)
+{
+    std::ostringstream ss;
+    ss << "UPDATE " << table << " SET ";
+    for (size_t c = 1; c < columns.size(); ++c)
+    {
+        if (c > 1)
+            ss << ", ";
+        ss << columns[c].name << " = v." << columns[c].name;
+    }
+    ss << " FROM (VALUES ";
+    for (size_t r = 0; r < rows; ++r)
+    {
+        if (r > 0)
+            ss << ", ";
+        ss << "(";
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            if (c > 0)
+                ss << ", ";
+            // The types of the other rows are resolved from the first row
+            if (r == 0)
+                ss << "CAST(${" << columns[c].name << "_0} AS " << columns[c].type << ")";
+            else
+                ss << "${" << columns[c].name << "_" << r << "}";
+        }
+        ss << ")";
+    }
+    ss << ") AS v(";
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        if (c > 0)
+            ss << ", ";
+        ss << columns[c].name;
+    }
+    ss << ") WHERE " << table << "." << columns[0].name << " = v." << columns[0].name;
+    return ss.str();
+}
+
+std::vector<std::string> BuildMultiUpdates(const std::string& table, const std::vector<DBColumn>& columns)
+{
+    std::vector<std::string> result;
+    result.reserve(MULTIUPDATE_MAX_ROWS);
+    for (size_t rows = 1; rows <= MULTIUPDATE_MAX_ROWS; ++rows)
+        result.push_back(BuildMultiUpdate(table, columns, rows));
+    return result;
+}
+
 }
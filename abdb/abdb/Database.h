@@ -23,7 +23,13 @@
 
 #include <mutex>
 #include <sstream>
+#include <functional>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include <sa/Compiler.h>
 
 namespace DB {
@@ -31,28 +37,65 @@ namespace DB {
 class DBTransaction;
 class DBQuery;
 class DBResult;
+class PreparedStatement;
 
 enum DBParam
 {
-    DBPARAM_MULTIINSERT = 1
+    DBPARAM_MULTIINSERT = 1,
+    /// UPDATE ... FROM (VALUES ...) to update many rows with one statement
+    DBPARAM_MULTIUPDATE = 2
 };
 
+/// Max number of rows written with one multi row INSERT or UPDATE statement
+static constexpr size_t MULTIUPDATE_MAX_ROWS = 32;
+
+struct DBColumn
+{
+    const char* name;
+    /// SQL type, the values are sent as text and casted to this type
+    const char* type;
+};
+
+/// Build multi row INSERT statements, index i inserts i + 1 rows, up to MULTIUPDATE_MAX_ROWS.
+/// Parameters are named <column>_<row>, e.g. ${uuid_0}. Requires DBPARAM_MULTIINSERT.
+std::vector<std::string> BuildMultiInserts(const std::string& table, const std::vector<DBColumn>& columns);
+
+/// Build multi row UPDATE statements, index i updates i + 1 rows, up to MULTIUPDATE_MAX_ROWS.
+/// The first column is the key. Parameters are named <column>_<row>, e.g. ${uuid_0}.
+/// Requires DBPARAM_MULTIUPDATE.
+std::vector<std::string> BuildMultiUpdates(const std::string& table, const std::vector<DBColumn>& columns);
+
 class SA_NOVTABLE Database
 {
 protected:
     Database() :
-        connected_(false)
+        connected_(false),
+        transactionDepth_(0)
     {}
 
     friend class DBTransaction;
+    friend class PreparedStatement;
     virtual bool BeginTransaction() = 0;
     virtual bool Rollback() = 0;
     virtual bool Commit() = 0;
+    /// Nested transactions are mapped to savepoints
+    virtual bool Savepoint(const std::string& name);
+    virtual bool ReleaseSavepoint(const std::string& name);
+    virtual bool RollbackToSavepoint(const std::string& name);
 
     virtual bool InternalQuery(const std::string& query) = 0;
     virtual std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) = 0;
     std::shared_ptr<DBResult> VerifyResult(std::shared_ptr<DBResult> result);
+    /// Create a driver specific statement. The default implementation evaluates the
+    /// statement on the client with escaped values.
+    virtual std::unique_ptr<PreparedStatement> CreateStatement(std::string_view sql);
+    /// Must be called when the connection was re-established, statements are gone then.
+    void InvalidateStatements();
     bool connected_;
+    /// Number of currently open (nested) DBTransactions
+    unsigned transactionDepth_;
+    /// SQL -> Statement. The key points to the SQL owned by the statement.
+    std::unordered_map<std::string_view, std::unique_ptr<PreparedStatement>> statements_;
 public:
     static std::string driver_;
     static std::string dbHost_;
@@ -62,17 +105,24 @@ public:
     static std::string dbName_;
     static uint16_t dbPort_;
 
-    virtual ~Database() {}
+    virtual ~Database();
     static Database* CreateInstance(const std::string& driver,
         const std::string& host, uint16_t port,
         const std::string& user, const std::string& pass,
         const std::string& name);
+    /// The connection of the calling thread. Threads which have their own connection
+    /// set it with SetThreadInstance(), all other threads use the Database subsystem.
+    static Database* Current();
+    static void SetThreadInstance(Database* db);
 
     virtual bool GetParam(DBParam) { return false; }
     bool IsConnected() const { return connected_; }
 
     bool ExecuteQuery(const std::string& query);
     std::shared_ptr<DBResult> StoreQuery(const std::string& query);
+    /// Returns the statement for this SQL. It is prepared once per connection with
+    /// the first use and all parameters are unbound.
+    PreparedStatement& Prepare(std::string_view sql);
     virtual void FreeResult(DBResult* res);
     virtual uint64_t GetLastInsertId() = 0;
     virtual std::string EscapeString(const std::string& s) = 0;
@@ -116,6 +166,71 @@ public:
     virtual bool Empty() const { return true; }
 };
 
+/// A statement which is prepared once and executed many times. Parameters are
+/// written like with sa::templ::Parser, i.e. ${name}, and are bound by name with
+/// their type, so there is no parsing and escaping when executing it.
+class PreparedStatement
+{
+public:
+    enum class ParamType
+    {
+        Null,
+        Int,
+        UInt,
+        String,
+        Blob
+    };
+    struct Param
+    {
+        ParamType type{ ParamType::Null };
+        int64_t intValue{ 0 };
+        std::string stringValue;
+    };
+protected:
+    Database* db_;
+    std::string sql_;
+    /// Parameter names, the index + 1 is the number of the parameter
+    std::vector<std::string> names_;
+    std::vector<Param> params_;
+    /// Returns the SQL with the parameters replaced by the result of placeholder(number)
+    std::string BuildSql(const std::function<std::string(size_t)>& placeholder) const;
+    /// SQL with the escaped parameter values, for drivers which can not prepare
+    std::string Evaluate() const;
+    std::shared_ptr<DBResult> VerifyResult(std::shared_ptr<DBResult> result) { return db_->VerifyResult(result); }
+    Param* GetParam(const std::string& name);
+    PreparedStatement& BindInt(const std::string& name, ParamType type, int64_t value);
+public:
+    PreparedStatement(Database* db, std::string_view sql);
+    virtual ~PreparedStatement();
+
+    const std::string& GetSql() const { return sql_; }
+    size_t GetParamCount() const { return names_.size(); }
+    /// Unbind all parameters, they are NULL then
+    void Reset();
+    template<typename T>
+    std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, PreparedStatement&>
+    Bind(const std::string& name, T value)
+    {
+        if constexpr (std::is_enum_v<T>)
+            return Bind(name, static_cast<std::underlying_type_t<T>>(value));
+        else if constexpr (std::is_signed_v<T>)
+            return BindInt(name, ParamType::Int, static_cast<int64_t>(value));
+        else
+            return BindInt(name, ParamType::UInt, static_cast<int64_t>(value));
+    }
+    PreparedStatement& Bind(const std::string& name, const std::string& value);
+    PreparedStatement& BindBlob(const std::string& name, const std::string& value);
+    PreparedStatement& BindNull(const std::string& name);
+
+    virtual bool Execute();
+    virtual std::shared_ptr<DBResult> Query();
+    /// The connection was lost, prepare it again with the next use
+    virtual void Invalidate() { }
+};
+
+/// Scoped transaction. When a transaction is already open on the database, e.g.
+/// when the StorageProvider flushes many records at once, it becomes a savepoint
+/// inside the outer transaction, so a failing record only rolls back itself.
 class DBTransaction
 {
 private:
@@ -127,32 +242,19 @@ private:
     };
     Database* db_;
     State state_;
+    /// Nesting level of this transaction, 1 is the outermost
+    unsigned level_;
+    std::string GetSavepointName() const;
 public:
     explicit DBTransaction(Database* db) :
         db_(db),
-        state_(State::Unknown)
+        state_(State::Unknown),
+        level_(0)
     {}
-    ~DBTransaction()
-    {
-        if (state_ == State::Started)
-        {
-            db_->Rollback();
-        }
-    }
-    bool Begin()
-    {
-        state_ = State::Started;
-        return db_->BeginTransaction();
-    }
-    bool Commit()
-    {
-        if (state_ == State::Started)
-        {
-            state_ = State::Committed;
-            return db_->Commit();
-        }
-        return false;
-    }
+    ~DBTransaction();
+    bool Begin();
+    bool Commit();
+    bool IsNested() const { return level_ > 1; }
 };
 
 }
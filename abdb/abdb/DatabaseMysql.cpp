@@ -71,6 +71,8 @@ DatabaseMysql::DatabaseMysql() :
 
 DatabaseMysql::~DatabaseMysql()
 {
+    // Close statements before the connection
+    statements_.clear();
     mysql_close(&handle_);
 }
 
@@ -227,6 +229,119 @@ std::shared_ptr<DBResult> DatabaseMysql::InternalSelectQuery(const std::string&
     return VerifyResult(res);
 }
 
+std::unique_ptr<PreparedStatement> DatabaseMysql::CreateStatement(std::string_view sql)
+{
+    return std::make_unique<MysqlStatement>(*this, sql);
+}
+
+MysqlStatement::MysqlStatement(DatabaseMysql& db, std::string_view sql) :
+    PreparedStatement(&db, sql),
+    mysql_(db),
+    stmt_(nullptr)
+{ }
+
+MysqlStatement::~MysqlStatement()
+{
+    Invalidate();
+}
+
+void MysqlStatement::Invalidate()
+{
+    if (stmt_)
+    {
+        mysql_stmt_close(stmt_);
+        stmt_ = nullptr;
+    }
+}
+
+bool MysqlStatement::Prepare()
+{
+    if (stmt_)
+        return true;
+
+    // MySQL only knows positional ? parameters
+    order_.clear();
+    const std::string sql = BuildSql([this](size_t number) -> std::string
+    {
+        order_.push_back(number - 1);
+        return "?";
+    });
+    stmt_ = mysql_stmt_init(&mysql_.handle_);
+    if (!stmt_)
+    {
+        LOG_ERROR << "mysql_stmt_init(): MYSQL ERROR: " << mysql_error(&mysql_.handle_) << std::endl;
+        return false;
+    }
+    if (mysql_stmt_prepare(stmt_, sql.c_str(), static_cast<unsigned long>(sql.length())) != 0)
+    {
+        LOG_ERROR << "mysql_stmt_prepare(): " << sql.substr(0, 256) << ": MYSQL ERROR: " << mysql_stmt_error(stmt_) << std::endl;
+        Invalidate();
+        return false;
+    }
+    return true;
+}
+
+bool MysqlStatement::Execute()
+{
+    if (!mysql_.connected_)
+        return false;
+
+#ifdef DEBUG_SQL
+    LOG_DEBUG << "MYSQL EXECUTE: " << sql_ << std::endl;
+#endif
+
+    for (int numTries = 1; ; ++numTries)
+    {
+        if (!Prepare())
+            return false;
+
+        std::vector<MYSQL_BIND> binds(order_.size(), MYSQL_BIND{});
+        for (size_t i = 0; i < order_.size(); ++i)
+        {
+            Param& param = params_[order_[i]];
+            MYSQL_BIND& bind = binds[i];
+            switch (param.type)
+            {
+            case ParamType::Null:
+                bind.buffer_type = MYSQL_TYPE_NULL;
+                break;
+            case ParamType::Int:
+            case ParamType::UInt:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = &param.intValue;
+                bind.is_unsigned = param.type == ParamType::UInt;
+                break;
+            case ParamType::String:
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = param.stringValue.data();
+                bind.buffer_length = static_cast<unsigned long>(param.stringValue.length());
+                break;
+            case ParamType::Blob:
+                // Same as EscapeBlob(), stored as is
+                bind.buffer_type = MYSQL_TYPE_BLOB;
+                bind.buffer = param.stringValue.data();
+                bind.buffer_length = static_cast<unsigned long>(param.stringValue.length());
+                break;
+            }
+        }
+
+        if (mysql_stmt_bind_param(stmt_, binds.data()) == 0 && mysql_stmt_execute(stmt_) == 0)
+            return true;
+
+        LOG_ERROR << "mysql_stmt_execute(): " << sql_.substr(0, 256) << ": MYSQL ERROR: " << mysql_stmt_error(stmt_) << std::endl;
+        const int error = static_cast<int>(mysql_stmt_errno(stmt_));
+        if (error != CR_SERVER_LOST && error != CR_SERVER_GONE_ERROR)
+            return false;
+        // With MYSQL_OPT_RECONNECT the client reconnects, but the statement is gone
+        Invalidate();
+        if (numTries >= 2)
+        {
+            mysql_.connected_ = false;
+            return false;
+        }
+    }
+}
+
 MysqlResult::MysqlResult(MYSQL_RES* res)
 {
     handle_ = res;
@@ -33,10 +33,12 @@ namespace DB {
 
 class DatabaseMysql final : public Database
 {
+    friend class MysqlStatement;
 protected:
     MYSQL handle_;
     bool InternalQuery(const std::string& query) override;
     std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) override;
+    std::unique_ptr<PreparedStatement> CreateStatement(std::string_view sql) override;
 public:
     DatabaseMysql();
     ~DatabaseMysql() override;
@@ -52,6 +54,23 @@ public:
     void FreeResult(DBResult* res) override;
 };
 
+/// Execute() uses a server side prepared statement. Query() evaluates the statement
+/// on the client, because MysqlResult reads the text protocol.
+class MysqlStatement final : public PreparedStatement
+{
+private:
+    DatabaseMysql& mysql_;
+    MYSQL_STMT* stmt_;
+    /// Parameter index for each ? in the SQL
+    std::vector<size_t> order_;
+    bool Prepare();
+public:
+    MysqlStatement(DatabaseMysql& db, std::string_view sql);
+    ~MysqlStatement() override;
+    bool Execute() override;
+    void Invalidate() override;
+};
+
 class MysqlResult final : public DBResult
 {
     friend class DatabaseMysql;
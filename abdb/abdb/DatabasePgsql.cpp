@@ -34,7 +34,8 @@ namespace DB {
 
 DatabasePgsql::DatabasePgsql() :
     Database(),
-    handle_(nullptr)
+    handle_(nullptr),
+    statementId_(0)
 {
     const std::string& host = Database::dbHost_;
     const std::string& user = Database::dbUser_;
@@ -57,6 +58,7 @@ DatabasePgsql::DatabasePgsql() :
 
 DatabasePgsql::~DatabasePgsql()
 {
+    statements_.clear();
     PQfinish(handle_);
 }
 
@@ -87,6 +89,9 @@ bool DatabasePgsql::Connect(int numTries /* = 1 */)
             // When ping OK then try to connect
             handle_ = PQconnectdb(dns_.c_str());
             connected_ = PQstatus(handle_) == CONNECTION_OK;
+            if (connected_)
+                // New connection, all prepared statements are gone
+                InvalidateStatements();
         }
         ++tr;
         if (!connected_ && remaingTries > 0)
@@ -121,6 +126,7 @@ bool DatabasePgsql::GetParam(DBParam param)
     switch (param)
     {
     case DBPARAM_MULTIINSERT:
+    case DBPARAM_MULTIUPDATE:
         return true;
     default:
         return false;
@@ -278,6 +284,112 @@ TryAgain:
     return VerifyResult(results);
 }
 
+std::unique_ptr<PreparedStatement> DatabasePgsql::CreateStatement(std::string_view sql)
+{
+    return std::make_unique<PgsqlStatement>(*this, sql);
+}
+
+PgsqlStatement::PgsqlStatement(DatabasePgsql& db, std::string_view sql) :
+    PreparedStatement(&db, sql),
+    pgsql_(db),
+    name_("abx_stmt_" + std::to_string(++db.statementId_)),
+    prepared_(false)
+{ }
+
+bool PgsqlStatement::DoPrepare()
+{
+    // PostgreSQL uses $1, $2... for parameters
+    const std::string sql = BuildSql([](size_t number) { return "$" + std::to_string(number); });
+    PGresult* res = PQprepare(pgsql_.handle_, name_.c_str(), sql.c_str(), static_cast<int>(names_.size()), nullptr);
+    ExecStatusType stat = PQresultStatus(res);
+    sa::ScopeGuard deleteGguard([res]()
+    {
+        PQclear(res);
+    });
+    if (!PG_OK(stat))
+    {
+        LOG_ERROR << "PQprepare(): " << sql << ": " << PQresultErrorMessage(res) << std::endl;
+        return false;
+    }
+    prepared_ = true;
+    return true;
+}
+
+PGresult* PgsqlStatement::Exec()
+{
+    if (!pgsql_.connected_)
+        return nullptr;
+
+#ifdef DEBUG_SQL
+    LOG_DEBUG << "PGSQL EXECUTE: " << sql_ << std::endl;
+#endif
+
+    // All values are sent in text format
+    std::vector<std::string> values(params_.size());
+    std::vector<const char*> pointers(params_.size(), nullptr);
+    for (size_t i = 0; i < params_.size(); ++i)
+    {
+        const Param& param = params_[i];
+        switch (param.type)
+        {
+        case ParamType::Null:
+            continue;
+        case ParamType::Int:
+            values[i] = std::to_string(param.intValue);
+            break;
+        case ParamType::UInt:
+            values[i] = std::to_string(static_cast<uint64_t>(param.intValue));
+            break;
+        case ParamType::String:
+            pointers[i] = param.stringValue.c_str();
+            continue;
+        case ParamType::Blob:
+            // Same encoding as EscapeBlob()
+            values[i] = base64::encode(reinterpret_cast<const unsigned char*>(param.stringValue.data()),
+                param.stringValue.length());
+            break;
+        }
+        pointers[i] = values[i].c_str();
+    }
+
+    for (int numTries = 1; ; ++numTries)
+    {
+        if (prepared_ || DoPrepare())
+        {
+            PGresult* res = PQexecPrepared(pgsql_.handle_, name_.c_str(), static_cast<int>(pointers.size()),
+                pointers.data(), nullptr, nullptr, 0);
+            ExecStatusType stat = PQresultStatus(res);
+            if (PG_OK(stat))
+                return res;
+            LOG_ERROR << "PQexecPrepared(): " << sql_ << ": " << PQresultErrorMessage(res) << std::endl;
+            PQclear(res);
+        }
+        // Only try again when the connection was lost, not e.g. on constraint violations
+        if (numTries >= 3 || PQstatus(pgsql_.handle_) != CONNECTION_BAD || !pgsql_.CheckConnection())
+            return nullptr;
+        LOG_INFO << "Reconnected to database, trying again" << std::endl;
+    }
+}
+
+bool PgsqlStatement::Execute()
+{
+    PGresult* res = Exec();
+    if (!res)
+        return false;
+    PQclear(res);
+    return true;
+}
+
+std::shared_ptr<DBResult> PgsqlStatement::Query()
+{
+    PGresult* res = Exec();
+    if (!res)
+        return std::shared_ptr<DBResult>();
+
+    std::shared_ptr<DBResult> results(new PgsqlResult(res), std::bind(&Database::FreeResult, &pgsql_, std::placeholders::_1));
+    return VerifyResult(results);
+}
+
 PgsqlResult::PgsqlResult(PGresult* res) :
     cursor_(-1),
     handle_(res)
@@ -30,12 +30,16 @@ namespace DB {
 
 class DatabasePgsql final : public Database
 {
+    friend class PgsqlStatement;
 protected:
     PGconn* handle_;
     std::string dns_;
+    /// Used to create unique statement names
+    size_t statementId_;
     bool Connect(int numTries = 1);
     bool InternalQuery(const std::string& query) override;
     std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) override;
+    std::unique_ptr<PreparedStatement> CreateStatement(std::string_view sql) override;
 public:
     DatabasePgsql();
     ~DatabasePgsql() override;
@@ -52,9 +56,26 @@ public:
     bool CheckConnection() override;
 };
 
+/// Server side prepared statement, prepared with PQprepare() and executed with PQexecPrepared()
+class PgsqlStatement final : public PreparedStatement
+{
+private:
+    DatabasePgsql& pgsql_;
+    std::string name_;
+    bool prepared_;
+    bool DoPrepare();
+    PGresult* Exec();
+public:
+    PgsqlStatement(DatabasePgsql& db, std::string_view sql);
+    bool Execute() override;
+    std::shared_ptr<DBResult> Query() override;
+    void Invalidate() override { prepared_ = false; }
+};
+
 class PgsqlResult final : public DBResult
 {
     friend class DatabasePgsql;
+    friend class PgsqlStatement;
 protected:
     explicit PgsqlResult(PGresult* res);
 
@@ -22,7 +22,7 @@
 #ifdef USE_SQLITE
 
 #include "DatabaseSqlite.h"
-#include "Logger.h"
+#include <abscommon/Logger.h>
 
 namespace DB {
 
@@ -43,13 +43,25 @@ DatabaseSqlite::DatabaseSqlite(const std::string& file) :
     {
         LOG_ERROR << "Failed to initialize SQLite connection." << std::endl;
         sqlite3_close(handle_);
+        return;
+    }
+    connected_ = true;
+
+    // The data server opens a connection for each DB worker on the same file. Wait for
+    // a lock instead of failing with SQLITE_BUSY, and let readers run while one writes.
+    sqlite3_busy_timeout(handle_, BUSY_TIMEOUT_MS);
+    char* error = nullptr;
+    if (sqlite3_exec(handle_, "PRAGMA journal_mode=WAL", nullptr, nullptr, &error) != SQLITE_OK)
+    {
+        LOG_WARNING << "Unable to enable WAL mode: " << (error ? error : "") << std::endl;
+        sqlite3_free(error);
     }
-    else
-        connected_ = true;
 }
 
 DatabaseSqlite::~DatabaseSqlite()
 {
+    // Statements must be finalized before closing
+    statements_.clear();
     sqlite3_close(handle_);
 }
 
@@ -164,8 +176,124 @@ void DatabaseSqlite::FreeResult(DBResult* res)
     delete (SqliteResult*)res;
 }
 
-SqliteResult::SqliteResult(sqlite3_stmt* res) :
+std::unique_ptr<PreparedStatement> DatabaseSqlite::CreateStatement(std::string_view sql)
+{
+    return std::make_unique<SqliteStatement>(*this, sql);
+}
+
+SqliteStatement::SqliteStatement(DatabaseSqlite& db, std::string_view sql) :
+    PreparedStatement(&db, sql),
+    sqlite_(db),
+    stmt_(nullptr)
+{ }
+
+SqliteStatement::~SqliteStatement()
+{
+    if (stmt_)
+        sqlite3_finalize(stmt_);
+}
+
+bool SqliteStatement::Prepare()
+{
+    if (stmt_)
+        return true;
+    // ?NNN are numbered parameters
+    const std::string sql = BuildSql([](size_t number) { return "?" + std::to_string(number); });
+    if (sqlite3_prepare_v2(sqlite_.handle_, sql.c_str(), (int)sql.length(), &stmt_, NULL) != SQLITE_OK)
+    {
+        LOG_ERROR << "sqlite3_prepare_v2(): SQLITE ERROR: " << sqlite3_errmsg(sqlite_.handle_) << " (" << sql << ")" << std::endl;
+        sqlite3_finalize(stmt_);
+        stmt_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool SqliteStatement::BindParams()
+{
+    if (!Prepare())
+        return false;
+    if (auto result = result_.lock())
+        static_cast<SqliteResult*>(result.get())->Detach();
+    sqlite3_reset(stmt_);
+    sqlite3_clear_bindings(stmt_);
+    for (size_t i = 0; i < params_.size(); ++i)
+    {
+        const Param& param = params_[i];
+        const int index = static_cast<int>(i) + 1;
+        int ret = SQLITE_OK;
+        switch (param.type)
+        {
+        case ParamType::Null:
+            ret = sqlite3_bind_null(stmt_, index);
+            break;
+        case ParamType::Int:
+        case ParamType::UInt:
+            ret = sqlite3_bind_int64(stmt_, index, param.intValue);
+            break;
+        case ParamType::String:
+            ret = sqlite3_bind_text(stmt_, index, param.stringValue.c_str(), (int)param.stringValue.length(), SQLITE_STATIC);
+            break;
+        case ParamType::Blob:
+        {
+            // Same encoding as EscapeBlob()
+            const std::string value = base64::encode((const unsigned char*)param.stringValue.data(), param.stringValue.length());
+            ret = sqlite3_bind_text(stmt_, index, value.c_str(), (int)value.length(), SQLITE_TRANSIENT);
+            break;
+        }
+        }
+        if (ret != SQLITE_OK)
+        {
+            LOG_ERROR << "sqlite3_bind(): SQLITE ERROR: " << sqlite3_errmsg(sqlite_.handle_) << " (" << sql_ << ")" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SqliteStatement::Execute()
+{
+    std::lock_guard<std::recursive_mutex> lockClass(sqlite_.lock_);
+
+    if (!sqlite_.connected_)
+        return false;
+
+#ifdef DEBUG_SQL
+    LOG_DEBUG << "SQLITE EXECUTE: " << sql_ << std::endl;
+#endif
+
+    if (!BindParams())
+        return false;
+
+    int ret = sqlite3_step(stmt_);
+    sqlite3_reset(stmt_);
+    if (ret != SQLITE_OK && ret != SQLITE_DONE && ret != SQLITE_ROW)
+    {
+        LOG_ERROR << "sqlite3_step(): SQLITE ERROR: " << sqlite3_errmsg(sqlite_.handle_) << " (" << sql_ << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<DBResult> SqliteStatement::Query()
+{
+    std::lock_guard<std::recursive_mutex> lockClass(sqlite_.lock_);
+
+    if (!sqlite_.connected_)
+        return std::shared_ptr<DBResult>();
+
+    if (!BindParams())
+        return std::shared_ptr<DBResult>();
+
+    std::shared_ptr<DBResult> results(new SqliteResult(stmt_, false),
+        std::bind(&Database::FreeResult, &sqlite_, std::placeholders::_1));
+    result_ = results;
+    return VerifyResult(results);
+}
+
+SqliteResult::SqliteResult(sqlite3_stmt* res, bool owner) :
     handle_(res),
+    owner_(owner),
     rowAvailable_(false)
 {
     listNames_.clear();
@@ -178,7 +306,19 @@ SqliteResult::SqliteResult(sqlite3_stmt* res) :
 
 SqliteResult::~SqliteResult()
 {
-    sqlite3_finalize(handle_);
+    if (!handle_)
+        return;
+    if (owner_)
+        sqlite3_finalize(handle_);
+    else
+        sqlite3_reset(handle_);
+}
+
+void SqliteResult::Detach()
+{
+    ASSERT(!owner_);
+    handle_ = nullptr;
+    rowAvailable_ = false;
 }
 
 int32_t SqliteResult::GetInt(const std::string& col)
@@ -264,6 +404,8 @@ bool SqliteResult::IsNull(const std::string& col)
 
 std::shared_ptr<DBResult> SqliteResult::Next()
 {
+    if (!handle_)
+        return std::shared_ptr<DBResult>();
     // checks if after moving to next step we have a row result
     bool rowAvail = (sqlite3_step(handle_) == SQLITE_ROW);
     return rowAvail ? shared_from_this() : std::shared_ptr<DBResult>();
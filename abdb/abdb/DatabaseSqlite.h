@@ -31,11 +31,15 @@ namespace DB {
 
 class DatabaseSqlite final : public Database
 {
+    friend class SqliteStatement;
+private:
+    static constexpr int BUSY_TIMEOUT_MS = 5000;
 protected:
     sqlite3* handle_;
     std::recursive_mutex lock_;
     bool InternalQuery(const std::string& query) override;
     std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) override;
+    std::unique_ptr<PreparedStatement> CreateStatement(std::string_view sql) override;
 public:
     DatabaseSqlite(const std::string& file);
     ~DatabaseSqlite() override;
@@ -51,16 +55,39 @@ public:
     void FreeResult(DBResult* res) override;
 };
 
+class SqliteStatement final : public PreparedStatement
+{
+private:
+    DatabaseSqlite& sqlite_;
+    sqlite3_stmt* stmt_;
+    /// The result of the last Query() which is still using stmt_
+    std::weak_ptr<DBResult> result_;
+    bool Prepare();
+    bool BindParams();
+public:
+    SqliteStatement(DatabaseSqlite& db, std::string_view sql);
+    ~SqliteStatement() override;
+    bool Execute() override;
+    std::shared_ptr<DBResult> Query() override;
+};
+
 class SqliteResult final : public DBResult
 {
     friend class DatabaseSqlite;
+    friend class SqliteStatement;
+private:
+    static constexpr int BUSY_TIMEOUT_MS = 5000;
 protected:
-    explicit SqliteResult(sqlite3_stmt* res);
+    /// When owner is false the statement belongs to a SqliteStatement and is only reset
+    explicit SqliteResult(sqlite3_stmt* res, bool owner = true);
 
     typedef std::map<const std::string, uint32_t> ListNames;
     ListNames listNames_;
     sqlite3_stmt* handle_;
+    bool owner_;
     bool rowAvailable_;
+    /// The statement is executed again, this result is finished
+    void Detach();
 public:
     ~SqliteResult() override;
     int32_t GetInt(const std::string& col) override;
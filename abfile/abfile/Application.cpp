@@ -20,6 +20,7 @@
  */
 
 #include "Application.h"
+#include "CatalogCache.h"
 #include "Version.h"
 #include <algorithm>
 #include <sa/StringTempl.h>
@@ -109,6 +110,9 @@ void Application::HandleMessage(const Net::MessageMsg& msg)
     case Net::MessageType::Spawn:
         Spawn("-temp");
         break;
+    case Net::MessageType::ClearCache:
+        catalogs_.Clear();
+        break;
     default:
         break;
     }
@@ -815,70 +819,73 @@ void Application::GetHandlerFiles(std::shared_ptr<HttpsServer::Response> respons
     response->write(stream, header);
 }
 
-void Application::GetHandlerGames(std::shared_ptr<HttpsServer::Response> response,
-    std::shared_ptr<HttpsServer::Request> request)
+void Application::SendCatalog(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request,
+    const std::string& versionName, const char* rootName,
+    const std::function<bool(pugi::xml_node& root)>& fill)
 {
-    AB_PROFILE;
-
-    if (!IsAllowed(request))
+    auto* dataClient = GetSubsystem<IO::DataClient>();
+    // This is cached by the data server, so it's cheap to read it on each request.
+    // When the version changes the cached document is rebuilt.
+    AB::Entities::Version v;
+    v.name = versionName;
+    if (!dataClient->Read(v))
     {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
+        LOG_ERROR << "Error reading version " << versionName << std::endl;
+        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::GameList gl;
-    if (!dataClient->Read(gl))
+    auto entry = catalogs_.Get(versionName, v.value, [&](std::string& body) -> bool
+    {
+        pugi::xml_document doc;
+        auto declarationNode = doc.append_child(pugi::node_declaration);
+        declarationNode.append_attribute("version").set_value("1.0");
+        declarationNode.append_attribute("encoding").set_value("UTF-8");
+        declarationNode.append_attribute("standalone").set_value("yes");
+        auto root = doc.append_child(rootName);
+        root.append_attribute("version").set_value(v.value);
+        if (!fill(root))
+            return false;
+
+        std::stringstream stream;
+        doc.save(stream);
+        body = stream.str();
+        return true;
+    });
+    if (!entry)
     {
-        LOG_ERROR << "Error reading game list" << std::endl;
         response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
         return;
     }
 
-    AB::Entities::Version gamesVersion;
-    gamesVersion.name = "game_maps";
-    if (!dataClient->Read(gamesVersion))
+    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
+    header.emplace("Content-Type", "text/xml");
+    header.emplace("ETag", entry->etag);
+    header.emplace("Vary", "Accept-Encoding");
+
+    const auto inmIt = request->header.find("If-None-Match");
+    if (inmIt != request->header.end() && CatalogCache::MatchETag((*inmIt).second, entry->etag))
     {
-        LOG_ERROR << "Error reading game version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
+        response->write(SimpleWeb::StatusCode::redirection_not_modified, header);
         return;
     }
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("games");
-    root.append_attribute("version").set_value(gamesVersion.value);
-
-    for (const std::string& uuid : gl.gameUuids)
-    {
-        AB::Entities::Game g;
-        g.uuid = uuid;
-        if (!dataClient->Read(g))
-            continue;
-        auto gNd = root.append_child("game");
-        gNd.append_attribute("uuid").set_value(g.uuid.c_str());
-        gNd.append_attribute("name").set_value(g.name.c_str());
-        gNd.append_attribute("type").set_value(g.type);
-        gNd.append_attribute("landing").set_value(g.landing);
-        gNd.append_attribute("map_coord_x").set_value(g.mapCoordX);
-        gNd.append_attribute("map_coord_y").set_value(g.mapCoordY);
-        // The client should know about that to show/hide the 'Enter' button
-        gNd.append_attribute("queue_map").set_value(g.queueMapUuid.c_str());
-        // The rest is not interesting for the player, so skip it
+
+    const auto aeIt = request->header.find("Accept-Encoding");
+    if (!entry->gzipBody.empty() && aeIt != request->header.end() &&
+        (*aeIt).second.find("gzip") != std::string::npos)
+    {
+        header.emplace("Content-Encoding", "gzip");
+        UpdateBytesSent(entry->gzipBody.size());
+        response->write(entry->gzipBody, header);
+        return;
     }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+    UpdateBytesSent(entry->body.size());
+    response->write(entry->body, header);
 }
 
-void Application::GetHandlerSkills(std::shared_ptr<HttpsServer::Response> response,
+void Application::GetHandlerGames(std::shared_ptr<HttpsServer::Response> response,
     std::shared_ptr<HttpsServer::Request> request)
 {
     AB_PROFILE;
@@ -890,66 +897,81 @@ void Application::GetHandlerSkills(std::shared_ptr<HttpsServer::Response> respon
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::SkillList sl;
-    if (!dataClient->Read(sl))
+    SendCatalog(response, request, "game_maps", "games", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading skill list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_skills";
-    if (!dataClient->Read(v))
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::GameList gl;
+        if (!dataClient->Read(gl))
+        {
+            LOG_ERROR << "Error reading game list" << std::endl;
+            return false;
+        }
+
+        for (const auto& g : dataClient->ReadAll<AB::Entities::Game>(gl.gameUuids))
+        {
+            auto gNd = root.append_child("game");
+            gNd.append_attribute("uuid").set_value(g.uuid.c_str());
+            gNd.append_attribute("name").set_value(g.name.c_str());
+            gNd.append_attribute("type").set_value(g.type);
+            gNd.append_attribute("landing").set_value(g.landing);
+            gNd.append_attribute("map_coord_x").set_value(g.mapCoordX);
+            gNd.append_attribute("map_coord_y").set_value(g.mapCoordY);
+            // The client should know about that to show/hide the 'Enter' button
+            gNd.append_attribute("queue_map").set_value(g.queueMapUuid.c_str());
+            // The rest is not interesting for the player, so skip it
+        }
+        return true;
+    });
+}
+
+void Application::GetHandlerSkills(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request)
+{
+    AB_PROFILE;
+
+    if (!IsAllowed(request))
     {
-        LOG_ERROR << "Error reading skill version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
+        response->write(SimpleWeb::StatusCode::client_error_forbidden,
+            "Forbidden");
         return;
     }
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("skills");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : sl.skillUuids)
-    {
-        AB::Entities::Skill s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("skill");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("attribute").set_value(s.attributeUuid.c_str());
-        gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
-        gNd.append_attribute("type").set_value(static_cast<unsigned long long>(s.type));
-        gNd.append_attribute("elite").set_value(s.isElite);
-        gNd.append_attribute("access").set_value(s.access);
-        gNd.append_attribute("description").set_value(s.description.c_str());
-        gNd.append_attribute("short_description").set_value(s.shortDescription.c_str());
-        gNd.append_attribute("icon").set_value(s.icon.c_str());
-        gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
-        gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
-        gNd.append_attribute("activation").set_value(s.activation);
-        gNd.append_attribute("recharge").set_value(s.recharge);
-        gNd.append_attribute("const_energy").set_value(s.costEnergy);
-        gNd.append_attribute("const_energy_regen").set_value(s.costEnergyRegen);
-        gNd.append_attribute("const_adrenaline").set_value(s.costAdrenaline);
-        gNd.append_attribute("const_overcast").set_value(s.costOvercast);
-        gNd.append_attribute("const_hp").set_value(s.costHp);
-    }
+    SendCatalog(response, request, "game_skills", "skills", [](pugi::xml_node& root) -> bool
+    {
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::SkillList sl;
+        if (!dataClient->Read(sl))
+        {
+            LOG_ERROR << "Error reading skill list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& s : dataClient->ReadAll<AB::Entities::Skill>(sl.skillUuids))
+        {
+            auto gNd = root.append_child("skill");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("attribute").set_value(s.attributeUuid.c_str());
+            gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
+            gNd.append_attribute("type").set_value(static_cast<unsigned long long>(s.type));
+            gNd.append_attribute("elite").set_value(s.isElite);
+            gNd.append_attribute("access").set_value(s.access);
+            gNd.append_attribute("description").set_value(s.description.c_str());
+            gNd.append_attribute("short_description").set_value(s.shortDescription.c_str());
+            gNd.append_attribute("icon").set_value(s.icon.c_str());
+            gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
+            gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
+            gNd.append_attribute("activation").set_value(s.activation);
+            gNd.append_attribute("recharge").set_value(s.recharge);
+            gNd.append_attribute("const_energy").set_value(s.costEnergy);
+            gNd.append_attribute("const_energy_regen").set_value(s.costEnergyRegen);
+            gNd.append_attribute("const_adrenaline").set_value(s.costAdrenaline);
+            gNd.append_attribute("const_overcast").set_value(s.costOvercast);
+            gNd.append_attribute("const_hp").set_value(s.costHp);
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerProfessions(std::shared_ptr<HttpsServer::Response> response,
@@ -964,58 +986,34 @@ void Application::GetHandlerProfessions(std::shared_ptr<HttpsServer::Response> r
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::ProfessionList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading profession list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_professions";
-    if (!dataClient->Read(v))
+    SendCatalog(response, request, "game_professions", "professions", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading profession version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("professions");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : pl.profUuids)
-    {
-        AB::Entities::Profession s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("prof");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("abbr").set_value(s.abbr.c_str());
-        gNd.append_attribute("model_index_female").set_value(s.modelIndexFemale);
-        gNd.append_attribute("model_index_male").set_value(s.modelIndexMale);
-        gNd.append_attribute("num_attr").set_value(s.attributeCount);
-        for (const AB::Entities::AttriInfo& a : s.attributes)
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::ProfessionList pl;
+        if (!dataClient->Read(pl))
         {
-            auto attrNd = gNd.append_child("attr");
-            attrNd.append_attribute("uuid").set_value(a.uuid.c_str());
+            LOG_ERROR << "Error reading profession list" << std::endl;
+            return false;
         }
-    }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& s : dataClient->ReadAll<AB::Entities::Profession>(pl.profUuids))
+        {
+            auto gNd = root.append_child("prof");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("abbr").set_value(s.abbr.c_str());
+            gNd.append_attribute("model_index_female").set_value(s.modelIndexFemale);
+            gNd.append_attribute("model_index_male").set_value(s.modelIndexMale);
+            gNd.append_attribute("num_attr").set_value(s.attributeCount);
+            for (const AB::Entities::AttriInfo& a : s.attributes)
+            {
+                auto attrNd = gNd.append_child("attr");
+                attrNd.append_attribute("uuid").set_value(a.uuid.c_str());
+            }
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerAttributes(std::shared_ptr<HttpsServer::Response> response,
@@ -1030,51 +1028,27 @@ void Application::GetHandlerAttributes(std::shared_ptr<HttpsServer::Response> re
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::AttributeList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading attribute list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_attributes";
-    if (!dataClient->Read(v))
+    SendCatalog(response, request, "game_attributes", "attributes", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading attribute version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("attributes");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : pl.uuids)
-    {
-        AB::Entities::Attribute s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("attrib");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
-        gNd.append_attribute("primary").set_value(s.isPrimary);
-    }
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::AttributeList pl;
+        if (!dataClient->Read(pl))
+        {
+            LOG_ERROR << "Error reading attribute list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& s : dataClient->ReadAll<AB::Entities::Attribute>(pl.uuids))
+        {
+            auto gNd = root.append_child("attrib");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
+            gNd.append_attribute("primary").set_value(s.isPrimary);
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerEffects(std::shared_ptr<HttpsServer::Response> response,
@@ -1089,53 +1063,29 @@ void Application::GetHandlerEffects(std::shared_ptr<HttpsServer::Response> respo
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::EffectList pl;
-    if (!dataClient->Read(pl))
+    SendCatalog(response, request, "game_effects", "effects", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading effect list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_effects";
-    if (!dataClient->Read(v))
-    {
-        LOG_ERROR << "Error reading effect version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("effects");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : pl.effectUuids)
-    {
-        AB::Entities::Effect s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("effect");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("category").set_value(s.category);
-        gNd.append_attribute("icon").set_value(s.icon.c_str());
-        gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
-        gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
-    }
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::EffectList pl;
+        if (!dataClient->Read(pl))
+        {
+            LOG_ERROR << "Error reading effect list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& s : dataClient->ReadAll<AB::Entities::Effect>(pl.effectUuids))
+        {
+            auto gNd = root.append_child("effect");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("category").set_value(s.category);
+            gNd.append_attribute("icon").set_value(s.icon.c_str());
+            gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
+            gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerItems(std::shared_ptr<HttpsServer::Response> response,
@@ -1150,54 +1100,30 @@ void Application::GetHandlerItems(std::shared_ptr<HttpsServer::Response> respons
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::ItemList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading item list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_items";
-    if (!dataClient->Read(v))
+    SendCatalog(response, request, "game_items", "items", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading items version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("items");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : pl.itemUuids)
-    {
-        AB::Entities::Item s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("item");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("model_class").set_value(static_cast<uint32_t>(s.model_class));
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("type").set_value(static_cast<int>(s.type));
-        gNd.append_attribute("object").set_value(s.objectFile.c_str());
-        gNd.append_attribute("icon").set_value(s.iconFile.c_str());
-        gNd.append_attribute("item_flags").set_value(s.itemFlags);
-    }
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::ItemList pl;
+        if (!dataClient->Read(pl))
+        {
+            LOG_ERROR << "Error reading item list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& s : dataClient->ReadAll<AB::Entities::Item>(pl.itemUuids))
+        {
+            auto gNd = root.append_child("item");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("model_class").set_value(static_cast<uint32_t>(s.model_class));
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("type").set_value(static_cast<int>(s.type));
+            gNd.append_attribute("object").set_value(s.objectFile.c_str());
+            gNd.append_attribute("icon").set_value(s.iconFile.c_str());
+            gNd.append_attribute("item_flags").set_value(s.itemFlags);
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerQuests(std::shared_ptr<HttpsServer::Response> response,
@@ -1212,53 +1138,29 @@ void Application::GetHandlerQuests(std::shared_ptr<HttpsServer::Response> respon
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::QuestList gl;
-    if (!dataClient->Read(gl))
-    {
-        LOG_ERROR << "Error reading game list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-
-    AB::Entities::Version gamesVersion;
-    gamesVersion.name = "game_quests";
-    if (!dataClient->Read(gamesVersion))
+    SendCatalog(response, request, "game_quests", "quests", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading game version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("quests");
-    root.append_attribute("version").set_value(gamesVersion.value);
-
-    for (const std::string& uuid : gl.questUuids)
-    {
-        AB::Entities::Quest g;
-        g.uuid = uuid;
-        if (!dataClient->Read(g))
-            continue;
-        auto gNd = root.append_child("game");
-        gNd.append_attribute("uuid").set_value(g.uuid.c_str());
-        gNd.append_attribute("index").set_value(g.index);
-        gNd.append_attribute("name").set_value(g.name.c_str());
-        gNd.append_attribute("description").set_value(g.description.c_str());
-        gNd.append_attribute("reward_xp").set_value(g.rewardXp);
-        gNd.append_attribute("reward_money").set_value(g.rewardMoney);
-        gNd.append_attribute("reward_items").set_value(sa::CombineString(g.rewardItems, std::string(";")).c_str());
-    }
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::QuestList gl;
+        if (!dataClient->Read(gl))
+        {
+            LOG_ERROR << "Error reading quest list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& g : dataClient->ReadAll<AB::Entities::Quest>(gl.questUuids))
+        {
+            auto gNd = root.append_child("game");
+            gNd.append_attribute("uuid").set_value(g.uuid.c_str());
+            gNd.append_attribute("index").set_value(g.index);
+            gNd.append_attribute("name").set_value(g.name.c_str());
+            gNd.append_attribute("description").set_value(g.description.c_str());
+            gNd.append_attribute("reward_xp").set_value(g.rewardXp);
+            gNd.append_attribute("reward_money").set_value(g.rewardMoney);
+            gNd.append_attribute("reward_items").set_value(sa::CombineString(g.rewardItems, std::string(";")).c_str());
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerMusic(std::shared_ptr<HttpsServer::Response> response,
@@ -1273,52 +1175,28 @@ void Application::GetHandlerMusic(std::shared_ptr<HttpsServer::Response> respons
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::MusicList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading music list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_music";
-    if (!dataClient->Read(v))
+    SendCatalog(response, request, "game_music", "music_list", [](pugi::xml_node& root) -> bool
     {
-        LOG_ERROR << "Error reading music version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("music_list");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : pl.musicUuids)
-    {
-        AB::Entities::Music s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("music");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("map_uuid").set_value(s.mapUuid.c_str());
-        gNd.append_attribute("local_file").set_value(s.localFile.c_str());
-        gNd.append_attribute("remote_file").set_value(s.remoteFile.c_str());
-        gNd.append_attribute("sorting").set_value(s.sorting);
-        gNd.append_attribute("style").set_value(static_cast<uint32_t>(s.style));
-    }
+        auto* dataClient = GetSubsystem<IO::DataClient>();
+        AB::Entities::MusicList pl;
+        if (!dataClient->Read(pl))
+        {
+            LOG_ERROR << "Error reading music list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const auto& s : dataClient->ReadAll<AB::Entities::Music>(pl.musicUuids))
+        {
+            auto gNd = root.append_child("music");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("map_uuid").set_value(s.mapUuid.c_str());
+            gNd.append_attribute("local_file").set_value(s.localFile.c_str());
+            gNd.append_attribute("remote_file").set_value(s.remoteFile.c_str());
+            gNd.append_attribute("sorting").set_value(s.sorting);
+            gNd.append_attribute("style").set_value(static_cast<uint32_t>(s.style));
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerVersion(std::shared_ptr<HttpsServer::Response> response,
@@ -1440,13 +1318,8 @@ void Application::GetHandlerNews(std::shared_ptr<HttpsServer::Response> response
     declarationNode.append_attribute("standalone").set_value("yes");
     auto root = doc.append_child("news_list");
 
-    for (const std::string& uuid : vl.uuids)
+    for (const auto& n : dataClient->ReadAll<AB::Entities::News>(vl.uuids))
     {
-        AB::Entities::News n;
-        n.uuid = uuid;
-        if (!dataClient->Read(n))
-            continue;
-
         auto gNd = root.append_child("news");
         gNd.append_attribute("created").set_value(n.created);
         gNd.append_attribute("body").set_value(Utils::XML::Escape(n.body).c_str());
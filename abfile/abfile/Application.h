@@ -33,6 +33,7 @@
 #   include <filesystem>
 #endif
 #include <abscommon/MessageClient.h>
+#include "CatalogCache.h"
 #include "Servers.h"
 #include <numeric>
 #include <sa/CircularQueue.h>
@@ -81,6 +82,7 @@ private:
     uint64_t maxThroughput_;
     sa::CircularQueue<unsigned, 10> loads_;
     std::mutex mutex_;
+    CatalogCache catalogs_;
     void HandleMessage(const Net::MessageMsg& msg);
     void UpdateBytesSent(size_t bytes);
     void HeartBeatTask();
@@ -94,6 +96,11 @@ private:
         std::shared_ptr<HttpsServer::Request> request);
     void GetHandlerFiles(std::shared_ptr<HttpsServer::Response> response,
         std::shared_ptr<HttpsServer::Request> request);
+    /// Send a catalog document. It is built with fill once per version and then served from the cache.
+    void SendCatalog(std::shared_ptr<HttpsServer::Response> response,
+        std::shared_ptr<HttpsServer::Request> request,
+        const std::string& versionName, const char* rootName,
+        const std::function<bool(pugi::xml_node& root)>& fill);
     void GetHandlerGames(std::shared_ptr<HttpsServer::Response> response,
         std::shared_ptr<HttpsServer::Request> request);
     void GetHandlerSkills(std::shared_ptr<HttpsServer::Response> response,
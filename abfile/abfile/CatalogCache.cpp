@@ -0,0 +1,100 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "CatalogCache.h"
+#include <abscommon/Logger.h>
+#include <sa/StringTempl.h>
+#define SA_ZLIB_SUPPORT
+#include <sa/compress.h>
+
+std::string CatalogCache::MakeETag(const std::string& name, uint32_t version)
+{
+    return "\"" + name + "-" + std::to_string(version) + "\"";
+}
+
+bool CatalogCache::MatchETag(const std::string& ifNoneMatch, const std::string& etag)
+{
+    if (ifNoneMatch.empty())
+        return false;
+    for (const auto& part : sa::Split(ifNoneMatch, ","))
+    {
+        std::string value = sa::Trim<char>(part);
+        if (value == "*")
+            return true;
+        // We don't care about weak or strong
+        if (value.compare(0, 2, "W/") == 0)
+            value.erase(0, 2);
+        if (value == etag)
+            return true;
+    }
+    return false;
+}
+
+CatalogCache::EntryPtr CatalogCache::Find(const std::string& name, uint32_t version)
+{
+    std::scoped_lock lock(lock_);
+    const auto it = entries_.find(name);
+    if (it == entries_.end() || it->second->version != version)
+        return {};
+    return it->second;
+}
+
+CatalogCache::EntryPtr CatalogCache::Get(const std::string& name, uint32_t version, const Builder& builder)
+{
+    if (auto entry = Find(name, version))
+        return entry;
+
+    std::scoped_lock buildLock(buildLock_);
+    // Another thread may have built it while we were waiting
+    if (auto entry = Find(name, version))
+        return entry;
+
+    auto entry = std::make_shared<Entry>();
+    entry->version = version;
+    entry->etag = MakeETag(name, version);
+    if (!builder(entry->body))
+        return {};
+
+    if (!entry->body.empty())
+    {
+        sa::zlib_compress compress;
+        entry->gzipBody.resize(entry->body.length() + 1024);
+        size_t compressedSize = entry->gzipBody.length();
+        if (compress(entry->body.data(), entry->body.length(), entry->gzipBody.data(), compressedSize))
+            entry->gzipBody.resize(compressedSize);
+        else
+        {
+            LOG_ERROR << "Compression Error" << std::endl;
+            entry->gzipBody.clear();
+        }
+    }
+
+    std::scoped_lock lock(lock_);
+    entries_[name] = entry;
+    return entry;
+}
+
+void CatalogCache::Clear()
+{
+    std::scoped_lock lock(lock_);
+    entries_.clear();
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// Catalog documents (skills, items, ...) only change when their row in the versions
+/// table changes. Build them once per version and keep the raw and gzip compressed
+/// bodies, so a client storm after a patch is served from memory.
+class CatalogCache
+{
+public:
+    struct Entry
+    {
+        uint32_t version{ 0 };
+        std::string etag;
+        std::string body;
+        /// Empty when compression failed
+        std::string gzipBody;
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+    /// Returns false when the content could not be created
+    using Builder = std::function<bool(std::string& body)>;
+private:
+    std::mutex lock_;
+    /// Serializes building so concurrent misses build the document only once
+    std::mutex buildLock_;
+    std::unordered_map<std::string, EntryPtr> entries_;
+    EntryPtr Find(const std::string& name, uint32_t version);
+public:
+    static std::string MakeETag(const std::string& name, uint32_t version);
+    /// Check if the value of an If-None-Match header matches etag
+    static bool MatchETag(const std::string& ifNoneMatch, const std::string& etag);
+
+    /// Get the entry for the given version. When the cached entry is missing or has
+    /// a different version, it is created with builder.
+    EntryPtr Get(const std::string& name, uint32_t version, const Builder& builder);
+    void Clear();
+};
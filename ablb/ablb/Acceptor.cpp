@@ -23,6 +23,7 @@
 #include <functional>
 #include <abscommon/Subsystems.h>
 #include <abscommon/BanManager.h>
+#include <abscommon/IoServicePool.h>
 
 void Acceptor::HandleAccept(const std::error_code& error)
 {
@@ -39,8 +40,9 @@ void Acceptor::HandleAccept(const std::error_code& error)
         else
         {
             AB::Entities::Service svc;
-            if (getServiceCallback_(svc))
-                session_->Start(svc.host, svc.port);
+            ConnectionCounter connections;
+            if (getServiceCallback_(svc, connections))
+                session_->Start(svc.host, svc.port, std::move(connections));
         }
 
         // Accept more connections
@@ -57,7 +59,9 @@ bool Acceptor::AcceptConnections()
 {
     try
     {
-        session_ = std::make_shared<Bridge>(ioService_);
+        // Relays are spread over all network threads
+        auto* pool = GetSubsystem<Net::IoServicePool>();
+        session_ = std::make_shared<Bridge>(pool ? pool->GetNext() : ioService_);
 
         acceptor_.async_accept(session_->GetDownstreamSocket(),
             std::bind(&Acceptor::HandleAccept,
@@ -27,7 +27,7 @@
 class Acceptor
 {
 public:
-    typedef std::function<bool(AB::Entities::Service& svc)> GetServiceCallback;
+    typedef std::function<bool(AB::Entities::Service& svc, ConnectionCounter& connections)> GetServiceCallback;
 private:
     asio::io_service& ioService_;
     asio::ip::address_v4 localhostAddress;
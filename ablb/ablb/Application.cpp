@@ -24,6 +24,7 @@
 #include "Version.h"
 #include <AB/Entities/ServiceList.h>
 #include <abscommon/BanManager.h>
+#include <abscommon/IoServicePool.h>
 #include <abscommon/Logo.h>
 #include <abscommon/PingServer.h>
 #include <abscommon/SimpleConfigManager.h>
@@ -44,6 +45,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
     Subsystems::Instance.CreateSubsystem<Auth::BanManager>();
     Subsystems::Instance.CreateSubsystem<Net::PingServer>();
+    Subsystems::Instance.CreateSubsystem<Net::IoServicePool>(ioService_);
     dataClient_ = std::make_unique<IO::DataClient>(ioService_);
 }
 
@@ -58,8 +60,14 @@ void Application::PrintServerInfo()
     LOG_INFO << "  Location: " << serverLocation_ << std::endl;
     LOG_INFO << "  Config file: " << (configFile_.empty() ? "(empty)" : configFile_) << std::endl;
     LOG_INFO << "  Listening: " << serverHost_ << ":" << static_cast<int>(serverPort_) << std::endl;
+    LOG_INFO << "  Network threads: " << GetSubsystem<Net::IoServicePool>()->GetNumThreads() << std::endl;
     if (dataClient_->IsConnected())
+    {
         LOG_INFO << "  Data Server: " << dataClient_->GetHost() << ":" << dataClient_->GetPort() << std::endl;
+        if (registry_)
+            LOG_INFO << "  Policy: " << ServiceRegistry::PolicyName(registry_->GetPolicy()) <<
+                ", refresh every " << registry_->GetInterval() << "ms" << std::endl;
+    }
     else
     {
         LOG_INFO << "  Upstreams: ";
@@ -136,18 +144,24 @@ bool Application::LoadMain()
     {
         serverPort_ = static_cast<uint16_t>(config->GetGlobalInt("lb_port", 2740));
     }
+    GetSubsystem<Net::IoServicePool>()->SetNumThreads(static_cast<size_t>(config->GetGlobalInt("network_threads", 1ll)));
     lbType_ = static_cast<AB::Entities::ServiceType>(
         // Default is login server
         config->GetGlobalInt("lb_type", static_cast<int64_t>(AB::Entities::ServiceTypeLoginServer))
     );
     if (dataPort != 0)
+    {
         // We have a data port so we can query the data server
+        registry_ = std::make_unique<ServiceRegistry>(*dataClient_, lbType_,
+            ServiceRegistry::PolicyFromString(config->GetGlobalString("lb_policy", "least_load")),
+            static_cast<uint32_t>(config->GetGlobalInt("lb_refresh_interval", 1000ll)));
         acceptor_ = std::make_unique<Acceptor>(ioService_, serverHost_, serverPort_,
-            std::bind(&Application::GetServiceCallback, this, std::placeholders::_1));
+            std::bind(&ServiceRegistry::Select, registry_.get(), std::placeholders::_1, std::placeholders::_2));
+    }
     else
         // Get service list from config file
         acceptor_ = std::make_unique<Acceptor>(ioService_, serverHost_, serverPort_,
-            std::bind(&Application::GetServiceCallbackList, this, std::placeholders::_1));
+            std::bind(&Application::GetServiceCallbackList, this, std::placeholders::_1, std::placeholders::_2));
 
     GetSubsystem<Net::PingServer>()->port_ = serverPort_;
 
@@ -155,55 +169,7 @@ bool Application::LoadMain()
     return true;
 }
 
-bool Application::GetServiceCallback(AB::Entities::Service& svc)
-{
-    AB::Entities::ServiceList sl;
-    if (!dataClient_->Read(sl))
-        return false;
-
-    std::vector<AB::Entities::Service> services;
-
-    for (const std::string& uuid : sl.uuids)
-    {
-        AB::Entities::Service s;
-        s.uuid = uuid;
-        if (!dataClient_->Read(s))
-            continue;
-        if (s.status != AB::Entities::ServiceStatusOnline)
-            continue;
-        if (s.type == AB::Entities::ServiceTypeFileServer ||
-            s.type == AB::Entities::ServiceTypeGameServer ||
-            s.type == AB::Entities::ServiceTypeLoginServer)
-        {
-            if (sa::time::time_elapsed(s.heartbeat) > AB::Entities::HEARTBEAT_INTERVAL * 2)
-                // Maybe dead
-                continue;
-        }
-        if (s.type == lbType_)
-        {
-            services.push_back(s);
-        }
-    }
-
-    if (services.size() != 0)
-    {
-        std::sort(services.begin(), services.end(),
-            [](AB::Entities::Service const& a, AB::Entities::Service const& b)
-        {
-            return a.load < b.load;
-        });
-        if (services[0].type == AB::Entities::ServiceTypeFileServer || services[0].load < 100)
-        {
-            svc = services[0];
-            return true;
-        }
-    }
-
-    LOG_WARNING << "No server of type " << static_cast<int>(lbType_) << " online" << std::endl;
-    return false;
-}
-
-bool Application::GetServiceCallbackList(AB::Entities::Service& svc)
+bool Application::GetServiceCallbackList(AB::Entities::Service& svc, ConnectionCounter&)
 {
     if (serviceList_.size() == 0)
     {
@@ -318,6 +284,9 @@ void Application::Run()
     AB::Entities::ServiceList sl;
     dataClient_->Invalidate(sl);
 
+    if (registry_)
+        registry_->Start();
+
     LOG_INFO << "Server is running" << std::endl;
 
     acceptor_->AcceptConnections();
@@ -325,7 +294,7 @@ void Application::Run()
     running_ = true;
     if (lbType_ == AB::Entities::ServiceTypeLoginServer)
         GetSubsystem<Net::PingServer>()->Start();
-    ioService_.run();
+    GetSubsystem<Net::IoServicePool>()->Run();
 }
 
 void Application::Stop()
@@ -335,6 +304,8 @@ void Application::Stop()
 
     running_ = false;
     LOG_INFO << "Server shutdown..." << std::endl;
+    if (registry_)
+        registry_->Stop();
 
     AB::Entities::Service serv;
     serv.uuid = GetServerId();
@@ -353,5 +324,5 @@ void Application::Stop()
         LOG_ERROR << "Unable to read service" << std::endl;
     if (lbType_ == AB::Entities::ServiceTypeLoginServer)
         GetSubsystem<Net::PingServer>()->Stop();
-    ioService_.stop();
+    GetSubsystem<Net::IoServicePool>()->Stop();
 }
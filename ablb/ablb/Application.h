@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Acceptor.h"
+#include "ServiceRegistry.h"
 #include <AB/Entities/Service.h>
 #include <abscommon/DataClient.h>
 #include <abscommon/ServerApp.h>
@@ -35,10 +36,10 @@ private:
     AB::Entities::ServiceType lbType_;
     std::unique_ptr<IO::DataClient> dataClient_;
     std::unique_ptr<Acceptor> acceptor_;
+    std::unique_ptr<ServiceRegistry> registry_;
     void PrintServerInfo();
     bool LoadMain();
-    bool GetServiceCallback(AB::Entities::Service& svc);
-    bool GetServiceCallbackList(AB::Entities::Service& svc);
+    bool GetServiceCallbackList(AB::Entities::Service& svc, ConnectionCounter& connections);
     bool ParseServerList(const std::string& fileName);
     void ShowLogo();
 protected:
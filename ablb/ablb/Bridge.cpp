@@ -22,6 +22,12 @@
 #include "Bridge.h"
 #include <functional>
 
+Bridge::~Bridge()
+{
+    if (connections_)
+        --(*connections_);
+}
+
 void Bridge::HandleUpstreamConnect(const std::error_code& error)
 {
     if (error)
@@ -118,8 +124,13 @@ void Bridge::Close()
         upstreamSocket_.close();
 }
 
-void Bridge::Start(const std::string& upstreamHost, uint16_t unstreamPort)
+void Bridge::Start(const std::string& upstreamHost, uint16_t unstreamPort,
+    ConnectionCounter connections)
 {
+    connections_ = std::move(connections);
+    if (connections_)
+        ++(*connections_);
+
     // Connect to remote server, upstream
     upstreamSocket_.async_connect(
         asio::ip::tcp::endpoint(
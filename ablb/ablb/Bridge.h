@@ -21,10 +21,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <memory>
 #include <asio.hpp>
 
+/// Number of live connections relayed to an upstream
+using ConnectionCounter = std::shared_ptr<std::atomic<uint32_t>>;
+
 class Bridge : public std::enable_shared_from_this<Bridge>
 {
 public:
@@ -39,6 +43,7 @@ private:
     }; //8KB
     uint8_t downstreamData_[max_data_length];
     uint8_t upstreamData_[max_data_length];
+    ConnectionCounter connections_;
 
     void HandleUpstreamConnect(const std::error_code& error);
     void HandleUpstreamRead(const std::error_code& error,
@@ -53,7 +58,7 @@ public:
         downstreamSocket_(ioService),
         upstreamSocket_(ioService)
     { }
-    ~Bridge() = default;
+    ~Bridge();
 
     socket_type& GetDownstreamSocket()
     {
@@ -63,6 +68,8 @@ public:
     {
         return upstreamSocket_;
     }
-    void Start(const std::string& upstreamHost, uint16_t unstreamPort);
+    /// connections is incremented while this Bridge is alive
+    void Start(const std::string& upstreamHost, uint16_t unstreamPort,
+        ConnectionCounter connections = {});
 };
 
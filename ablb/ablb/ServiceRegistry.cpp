@@ -0,0 +1,213 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "ServiceRegistry.h"
+#include <AB/Entities/ServiceList.h>
+#include <abscommon/Logger.h>
+#include <algorithm>
+#include <random>
+#include <sa/time.h>
+
+BalancePolicy ServiceRegistry::PolicyFromString(const std::string& value)
+{
+    if (value == "least_connections")
+        return BalancePolicy::LeastConnections;
+    if (value == "power_of_two")
+        return BalancePolicy::PowerOfTwoChoices;
+    if (!value.empty() && value != "least_load")
+        LOG_WARNING << "Unknown balancing policy " << value << ", using least_load" << std::endl;
+    return BalancePolicy::LeastLoad;
+}
+
+const char* ServiceRegistry::PolicyName(BalancePolicy policy)
+{
+    switch (policy)
+    {
+    case BalancePolicy::LeastConnections:
+        return "least_connections";
+    case BalancePolicy::PowerOfTwoChoices:
+        return "power_of_two";
+    default:
+        return "least_load";
+    }
+}
+
+ServiceRegistry::ServiceRegistry(IO::DataClient& client, AB::Entities::ServiceType type,
+    BalancePolicy policy, uint32_t interval) :
+    client_(client),
+    type_(type),
+    policy_(policy),
+    interval_(interval),
+    upstreams_(std::make_shared<UpstreamList>())
+{ }
+
+ServiceRegistry::~ServiceRegistry()
+{
+    Stop();
+}
+
+void ServiceRegistry::Start()
+{
+    if (running_)
+        return;
+    Refresh();
+    running_ = true;
+    thread_ = std::thread(&ServiceRegistry::Update, this);
+}
+
+void ServiceRegistry::Stop()
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (!running_)
+            return;
+        running_ = false;
+    }
+    signal_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void ServiceRegistry::Update()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (running_)
+    {
+        signal_.wait_for(lock, std::chrono::milliseconds(interval_), [this]() { return !running_; });
+        if (!running_)
+            break;
+        lock.unlock();
+        Refresh();
+        lock.lock();
+    }
+}
+
+void ServiceRegistry::Refresh()
+{
+    AB::Entities::ServiceList sl;
+    if (!client_.Read(sl))
+    {
+        // Keep the last known services
+        LOG_WARNING << "Unable to read the service list" << std::endl;
+        return;
+    }
+
+    auto upstreams = std::make_shared<UpstreamList>();
+    for (auto& s : client_.ReadAll<AB::Entities::Service>(sl.uuids))
+    {
+        if (s.type != type_ || s.status != AB::Entities::ServiceStatusOnline)
+            continue;
+        if (s.type == AB::Entities::ServiceTypeFileServer ||
+            s.type == AB::Entities::ServiceTypeGameServer ||
+            s.type == AB::Entities::ServiceTypeLoginServer)
+        {
+            if (sa::time::time_elapsed(s.heartbeat) > AB::Entities::HEARTBEAT_INTERVAL * 2)
+                // Maybe dead
+                continue;
+        }
+        // Full, except file servers, they can always take more
+        if (s.type != AB::Entities::ServiceTypeFileServer && s.load >= 100)
+            continue;
+        auto& counter = counters_[s.uuid];
+        if (!counter)
+            counter = std::make_shared<std::atomic<uint32_t>>(0);
+        upstreams->push_back({ std::move(s), counter });
+    }
+
+    // Forget services which are gone and have no connections left
+    for (auto it = counters_.begin(); it != counters_.end(); )
+    {
+        const bool listed = std::any_of(upstreams->begin(), upstreams->end(), [&it](const Upstream& current)
+        {
+            return current.service.uuid == it->first;
+        });
+        if (!listed && *it->second == 0)
+            it = counters_.erase(it);
+        else
+            ++it;
+    }
+
+    std::scoped_lock lock(lock_);
+    upstreams_ = std::move(upstreams);
+}
+
+std::shared_ptr<const ServiceRegistry::UpstreamList> ServiceRegistry::GetUpstreams()
+{
+    std::scoped_lock lock(lock_);
+    return upstreams_;
+}
+
+bool ServiceRegistry::Select(AB::Entities::Service& svc, ConnectionCounter& connections)
+{
+    const auto upstreams = GetUpstreams();
+    if (upstreams->empty())
+    {
+        LOG_WARNING << "No server of type " << static_cast<int>(type_) << " online" << std::endl;
+        return false;
+    }
+
+    // Fewer connections first, for the same number of connections the lower load
+    auto fewerConnections = [](const Upstream& a, const Upstream& b)
+    {
+        const uint32_t ca = *a.connections;
+        const uint32_t cb = *b.connections;
+        if (ca != cb)
+            return ca < cb;
+        return a.service.load < b.service.load;
+    };
+
+    const Upstream* selected = nullptr;
+    switch (policy_)
+    {
+    case BalancePolicy::LeastLoad:
+        selected = &*std::min_element(upstreams->begin(), upstreams->end(), [](const Upstream& a, const Upstream& b)
+        {
+            return a.service.load < b.service.load;
+        });
+        break;
+    case BalancePolicy::LeastConnections:
+        selected = &*std::min_element(upstreams->begin(), upstreams->end(), fewerConnections);
+        break;
+    case BalancePolicy::PowerOfTwoChoices:
+    {
+        if (upstreams->size() == 1)
+        {
+            selected = &upstreams->front();
+            break;
+        }
+        thread_local std::mt19937 gen{ std::random_device{}() };
+        std::uniform_int_distribution<size_t> dis(0, upstreams->size() - 1);
+        const size_t first = dis(gen);
+        size_t second = dis(gen);
+        if (second == first)
+            second = (first + 1) % upstreams->size();
+        const Upstream& a = (*upstreams)[first];
+        const Upstream& b = (*upstreams)[second];
+        selected = fewerConnections(b, a) ? &b : &a;
+        break;
+    }
+    }
+
+    svc = selected->service;
+    connections = selected->connections;
+    return true;
+}
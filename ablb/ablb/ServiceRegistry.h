@@ -0,0 +1,88 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "Bridge.h"
+#include <AB/Entities/Service.h>
+#include <abscommon/DataClient.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class BalancePolicy
+{
+    /// The service with the lowest load it reports
+    LeastLoad,
+    /// The service with the fewest connections relayed by us
+    LeastConnections,
+    /// The one with fewer connections of two random services
+    PowerOfTwoChoices
+};
+
+/// Cached list of the services the load balancer relays to. It is refreshed from the
+/// data server on a background thread, so accepting a connection never waits for
+/// the data server.
+class ServiceRegistry
+{
+public:
+    struct Upstream
+    {
+        AB::Entities::Service service;
+        ConnectionCounter connections;
+    };
+    using UpstreamList = std::vector<Upstream>;
+private:
+    IO::DataClient& client_;
+    AB::Entities::ServiceType type_;
+    BalancePolicy policy_;
+    uint32_t interval_;
+    std::mutex lock_;
+    std::condition_variable signal_;
+    bool running_{ false };
+    std::thread thread_;
+    std::shared_ptr<const UpstreamList> upstreams_;
+    /// Service UUID -> connections. Only used by the refresh thread.
+    std::unordered_map<std::string, ConnectionCounter> counters_;
+    void Update();
+    void Refresh();
+    std::shared_ptr<const UpstreamList> GetUpstreams();
+public:
+    static BalancePolicy PolicyFromString(const std::string& value);
+    static const char* PolicyName(BalancePolicy policy);
+
+    /// interval: Refresh interval in ms
+    ServiceRegistry(IO::DataClient& client, AB::Entities::ServiceType type,
+        BalancePolicy policy, uint32_t interval);
+    ~ServiceRegistry();
+
+    /// Reads the services and starts the refresh thread
+    void Start();
+    void Stop();
+    /// Thread safe
+    bool Select(AB::Entities::Service& svc, ConnectionCounter& connections);
+    BalancePolicy GetPolicy() const { return policy_; }
+    uint32_t GetInterval() const { return interval_; }
+};
@@ -20,6 +20,7 @@
  */
 
 #include "Application.h"
+#include "PasswordHasher.h"
 #include "ProtocolLogin.h"
 #include "Version.h"
 #include <AB/DHKeys.hpp>
@@ -30,6 +31,7 @@
 #include <abscommon/DataClient.h>
 #include <abscommon/Dispatcher.h>
 #include <abscommon/FileUtils.h>
+#include <abscommon/IoServicePool.h>
 #include <abscommon/Logo.h>
 #include <abscommon/OutputMessage.h>
 #include <abscommon/PingServer.h>
@@ -61,6 +63,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<Asynch::Dispatcher>();
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<Net::ConnectionManager>();
+    Subsystems::Instance.CreateSubsystem<Net::IoServicePool>(*ioService_);
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
     Subsystems::Instance.CreateSubsystem<IO::DataClient>(*ioService_);
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(*ioService_);
@@ -68,6 +71,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<Crypto::Random>();
     Subsystems::Instance.CreateSubsystem<Crypto::DHKeys>();
     Subsystems::Instance.CreateSubsystem<Net::PingServer>();
+    Subsystems::Instance.CreateSubsystem<Auth::PasswordHasher>();
 
     serviceManager_ = std::make_unique<Net::ServiceManager>(*ioService_);
 }
@@ -75,6 +79,7 @@ Application::Application() :
 Application::~Application()
 {
     serviceManager_->Stop();
+    GetSubsystem<Auth::PasswordHasher>()->Stop();
     GetSubsystem<Asynch::Scheduler>()->Stop();
     GetSubsystem<Asynch::Dispatcher>()->Stop();
     GetSubsystem<Net::ConnectionManager>()->CloseAll();
@@ -114,6 +119,10 @@ bool Application::LoadMain()
     Net::ConnectionManager::maxPacketsPerSec = static_cast<uint32_t>(config->GetGlobalInt("max_packets_per_second", 0ll));
     Auth::BanManager::LoginTries = static_cast<uint32_t>(config->GetGlobalInt("login_tries", 5ll));
     Auth::BanManager::LoginRetryTimeout = static_cast<uint32_t>(config->GetGlobalInt("login_retrytimeout", 5000ll));
+    auto* hasher = GetSubsystem<Auth::PasswordHasher>();
+    hasher->SetNumThreads(static_cast<size_t>(config->GetGlobalInt("password_threads", 0ll)));
+    hasher->SetMaxQueue(static_cast<size_t>(config->GetGlobalInt("password_queue_size", 256ll)));
+    GetSubsystem<Net::IoServicePool>()->SetNumThreads(static_cast<size_t>(config->GetGlobalInt("network_threads", 1ll)));
 
     LOG_INFO << "Initializing RNG...";
     GetSubsystem<Crypto::Random>()->Initialize();
@@ -229,6 +238,9 @@ void Application::PrintServerInfo()
     }
     LOG_INFO << std::endl;
 
+    auto* hasher = GetSubsystem<Auth::PasswordHasher>();
+    LOG_INFO << "  Password threads: " << hasher->GetNumThreads() << ", queue size: " << hasher->GetMaxQueue() << std::endl;
+    LOG_INFO << "  Network threads: " << GetSubsystem<Net::IoServicePool>()->GetNumThreads() << std::endl;
     LOG_INFO << "  Data Server: " << dataClient->GetHost() << ":" << dataClient->GetPort() << std::endl;
     LOG_INFO << "  Message Server: " << msgClient->GetHost() << ":" << msgClient->GetPort() << std::endl;
 }
@@ -243,6 +255,17 @@ void Application::HeartBeatTask()
         ", used: " << info.used << ", avail: " << info.avail << std::endl;
 #endif
 
+    const Auth::PasswordHasher::Stats stats = GetSubsystem<Auth::PasswordHasher>()->GetStats();
+    if (stats.jobs != lastPasswordJobs_ || stats.rejected != lastPasswordRejected_)
+    {
+        lastPasswordJobs_ = stats.jobs;
+        lastPasswordRejected_ = stats.rejected;
+        LOG_INFO << "Passwords: jobs " << stats.jobs << ", rejected " << stats.rejected <<
+            ", queued " << stats.queued << " (max " << stats.maxQueued << ")" <<
+            ", wait avg " << (stats.jobs ? stats.totalWait / static_cast<int64_t>(stats.jobs) : 0) << " ms (max " << stats.maxWait << " ms)" <<
+            ", hash avg " << (stats.jobs ? stats.totalHash / static_cast<int64_t>(stats.jobs) : 0) << " ms (max " << stats.maxHash << " ms)" << std::endl;
+    }
+
     auto* dataClient = GetSubsystem<IO::DataClient>();
     if (dataClient->IsConnected())
     {
@@ -318,6 +341,7 @@ bool Application::Initialize(const std::vector<std::string>& args)
 
     GetSubsystem<Asynch::Dispatcher>()->Start();
     GetSubsystem<Asynch::Scheduler>()->Start();
+    GetSubsystem<Auth::PasswordHasher>()->Start();
 
     if (!serviceManager_->IsRunning())
         LOG_ERROR << "No services running" << std::endl;
@@ -352,7 +376,7 @@ void Application::Run()
     serviceManager_->Run();
     if (enablePingServer_)
         GetSubsystem<Net::PingServer>()->Start();
-    ioService_->run();
+    GetSubsystem<Net::IoServicePool>()->Run();
 }
 
 void Application::Stop()
@@ -385,7 +409,7 @@ void Application::Stop()
 
     if (enablePingServer_)
         GetSubsystem<Net::PingServer>()->Stop();
-    ioService_->stop();
+    GetSubsystem<Net::IoServicePool>()->Stop();
 }
 
 std::string Application::GetKeysFile() const
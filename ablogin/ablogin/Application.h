@@ -31,6 +31,8 @@ private:
     std::shared_ptr<asio::io_service> ioService_;
     std::unique_ptr<Net::ServiceManager> serviceManager_;
     bool enablePingServer_{ true };
+    uint64_t lastPasswordJobs_{ 0 };
+    uint64_t lastPasswordRejected_{ 0 };
     bool LoadMain();
     void PrintServerInfo();
     void HeartBeatTask();
@@ -28,7 +28,6 @@
 #include <AB/Entities/PlayerItemList.h>
 #include <AB/Entities/Profession.h>
 #include <AB/Entities/ReservedName.h>
-#include <abcrypto.hpp>
 #include <abscommon/DataClient.h>
 #include <abscommon/Profiler.h>
 #include <abscommon/Subsystems.h>
@@ -39,7 +38,36 @@
 
 namespace IO {
 
-IOAccount::CreateAccountResult IOAccount::CreateAccount(const std::string& name, const std::string& pass,
+IOAccount::CreateAccountResult IOAccount::CanCreateAccount(const std::string& name, const std::string& email,
+    const std::string& accKey)
+{
+    AB_PROFILE;
+    IO::DataClient* client = GetSubsystem<IO::DataClient>();
+    if (name.empty())
+        return CreateAccountResult::NameExists;
+#if defined(EMAIL_MANDATORY)
+    if (email.empty())
+        return CreateAccountResult::EmailError;
+#else
+    (void)email;
+#endif
+    AB::Entities::Account acc;
+    acc.name = name;
+    if (client->Exists(acc))
+        return CreateAccountResult::NameExists;
+
+    AB::Entities::AccountKey akey;
+    akey.uuid = accKey;
+    akey.status = AB::Entities::AccountKeyStatus::KeryStatusReadyForUse;
+    akey.type = AB::Entities::AccountKeyType::KeyTypeAccount;
+    if (!client->Read(akey))
+        return CreateAccountResult::InvalidAccountKey;
+    if (akey.used + 1 > akey.total)
+        return CreateAccountResult::InvalidAccountKey;
+    return CreateAccountResult::OK;
+}
+
+IOAccount::CreateAccountResult IOAccount::CreateAccount(const std::string& name, const std::string& passwordHash,
     const std::string& email, const std::string& accKey)
 {
     AB_PROFILE;
@@ -47,12 +75,13 @@ IOAccount::CreateAccountResult IOAccount::CreateAccount(const std::string& name,
     AB::Entities::Account acc;
     if (name.empty())
         return CreateAccountResult::NameExists;
-    if (pass.empty())
+    if (passwordHash.empty())
         return CreateAccountResult::PasswordError;
 #if defined(EMAIL_MANDATORY)
     if (email.empty())
-        return Result::EmailError;
+        return CreateAccountResult::EmailError;
 #endif
+    // Hashing the password took some time, so check again
     acc.name = name;
     if (client->Exists(acc))
         return CreateAccountResult::NameExists;
@@ -67,13 +96,6 @@ IOAccount::CreateAccountResult IOAccount::CreateAccount(const std::string& name,
         return CreateAccountResult::InvalidAccountKey;
 
     // Create the account
-    char pwhash[61];
-    if (bcrypt_newhash(pass.c_str(), 10, pwhash, 61) != 0)
-    {
-        LOG_ERROR << "bcrypt_newhash() failed" << std::endl;
-        return CreateAccountResult::InternalError;
-    }
-    std::string passwordHash(pwhash, 61);
     acc.uuid = Utils::Uuid::New();
     acc.password = passwordHash;
     acc.email = email;
@@ -176,8 +198,7 @@ IOAccount::CreateAccountResult IOAccount::AddAccountKey(AB::Entities::Account& a
     return CreateAccountResult::OK;
 }
 
-IOAccount::PasswordAuthResult IOAccount::PasswordAuth(const std::string& pass,
-    AB::Entities::Account& account)
+IOAccount::PasswordAuthResult IOAccount::BeginPasswordAuth(AB::Entities::Account& account)
 {
     AB_PROFILE;
     IO::DataClient* client = GetSubsystem<IO::DataClient>();
@@ -207,9 +228,30 @@ IOAccount::PasswordAuthResult IOAccount::PasswordAuth(const std::string& pass,
     if (banMan->IsAccountBanned(uuids::uuid(account.uuid)))
         return PasswordAuthResult::AccountBanned;
 
-    if (bcrypt_checkpass(pass.c_str(), account.password.c_str()) != 0)
+    return PasswordAuthResult::OK;
+}
+
+IOAccount::PasswordAuthResult IOAccount::EndPasswordAuth(bool passwordMatch,
+    AB::Entities::Account& account)
+{
+    AB_PROFILE;
+    if (!passwordMatch)
         return PasswordAuthResult::PasswordMismatch;
 
+    IO::DataClient* client = GetSubsystem<IO::DataClient>();
+    // The account may have changed while the password was checked
+    if (!client->Read(account))
+    {
+        LOG_ERROR << "Unable to read account UUID " << account.uuid << std::endl;
+        return PasswordAuthResult::InvalidAccount;
+    }
+    IO::EntityLocker locker(*client, account);
+    if (!locker.Lock())
+    {
+        LOG_ERROR << "Unable to lock account" << std::endl;
+        return PasswordAuthResult::InternalError;
+    }
+
     if (account.onlineStatus != AB::Entities::OnlineStatusOffline)
         return PasswordAuthResult::AlreadyLoggedIn;
 
@@ -71,11 +71,18 @@ public:
         InvalidName
     };
     IOAccount() = delete;
-    static CreateAccountResult CreateAccount(const std::string& name, const std::string& pass,
+    /// Cheap checks before the password is hashed
+    static CreateAccountResult CanCreateAccount(const std::string& name, const std::string& email,
+        const std::string& accKey);
+    /// Creates the account with an already hashed password
+    static CreateAccountResult CreateAccount(const std::string& name, const std::string& passwordHash,
         const std::string& email, const std::string& accKey);
     static CreateAccountResult AddAccountKey(AB::Entities::Account& account,
         const std::string& accKey);
-    static IOAccount::PasswordAuthResult PasswordAuth(const std::string& pass,
+    /// Reads the account and checks whether it may login. After this the password
+    /// must be checked against account.password and the result passed to EndPasswordAuth().
+    static IOAccount::PasswordAuthResult BeginPasswordAuth(AB::Entities::Account& account);
+    static IOAccount::PasswordAuthResult EndPasswordAuth(bool passwordMatch,
         AB::Entities::Account& account);
     static bool TokenAuth(const std::string& token,
         AB::Entities::Account& account);
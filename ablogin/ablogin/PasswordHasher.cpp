@@ -0,0 +1,160 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PasswordHasher.h"
+#include <abcrypto.hpp>
+#include <abscommon/Dispatcher.h>
+#include <abscommon/Logger.h>
+#include <abscommon/Subsystems.h>
+#include <sa/time.h>
+
+namespace Auth {
+
+PasswordHasher::~PasswordHasher()
+{
+    Stop();
+}
+
+void PasswordHasher::SetNumThreads(size_t value)
+{
+    if (value == 0)
+        value = std::max<size_t>(1, std::thread::hardware_concurrency());
+    numThreads_ = value;
+}
+
+void PasswordHasher::Start()
+{
+    std::scoped_lock lock(lock_);
+    if (running_)
+        return;
+    running_ = true;
+    threads_.reserve(numThreads_);
+    for (size_t i = 0; i < numThreads_; ++i)
+        threads_.emplace_back(&PasswordHasher::WorkerThread, this);
+}
+
+void PasswordHasher::Stop()
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (!running_)
+            return;
+        running_ = false;
+        jobs_.clear();
+        stats_.queued = 0;
+    }
+    signal_.notify_all();
+    for (auto& thread : threads_)
+        thread.join();
+    threads_.clear();
+}
+
+bool PasswordHasher::Check(const std::string& pass, const std::string& hash, CheckCallback&& callback)
+{
+    return Enqueue({ pass, hash, std::move(callback), {}, 0 });
+}
+
+bool PasswordHasher::Hash(const std::string& pass, HashCallback&& callback)
+{
+    return Enqueue({ pass, {}, {}, std::move(callback), 0 });
+}
+
+PasswordHasher::Stats PasswordHasher::GetStats() const
+{
+    std::scoped_lock lock(lock_);
+    return stats_;
+}
+
+bool PasswordHasher::Enqueue(Job&& job)
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (!running_ || (maxQueue_ != 0 && jobs_.size() >= maxQueue_))
+        {
+            ++stats_.rejected;
+            return false;
+        }
+        job.enqueued = sa::time::tick();
+        jobs_.push_back(std::move(job));
+        stats_.queued = jobs_.size();
+        if (stats_.queued > stats_.maxQueued)
+            stats_.maxQueued = stats_.queued;
+    }
+    signal_.notify_one();
+    return true;
+}
+
+void PasswordHasher::WorkerThread()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true)
+    {
+        signal_.wait(lock, [this]() { return !running_ || !jobs_.empty(); });
+        if (!running_)
+            break;
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        stats_.queued = jobs_.size();
+        const int64_t wait = sa::time::time_elapsed(job.enqueued);
+        lock.unlock();
+
+        sa::time::timer timer;
+        Execute(job);
+        const int64_t hashTime = timer.elapsed_millis();
+
+        lock.lock();
+        ++stats_.jobs;
+        stats_.totalWait += wait;
+        stats_.totalHash += hashTime;
+        if (wait > stats_.maxWait)
+            stats_.maxWait = wait;
+        if (hashTime > stats_.maxHash)
+            stats_.maxHash = hashTime;
+    }
+}
+
+void PasswordHasher::Execute(Job& job)
+{
+    auto* dispatcher = GetSubsystem<Asynch::Dispatcher>();
+    if (job.checkCallback)
+    {
+        const bool match = bcrypt_checkpass(job.pass.c_str(), job.hash.c_str()) == 0;
+        dispatcher->Add(Asynch::CreateTask([callback = std::move(job.checkCallback), match]()
+        {
+            callback(match);
+        }));
+        return;
+    }
+
+    char pwhash[61];
+    std::string hash;
+    if (bcrypt_newhash(job.pass.c_str(), HASH_COST, pwhash, 61) == 0)
+        hash.assign(pwhash, 61);
+    else
+        LOG_ERROR << "bcrypt_newhash() failed" << std::endl;
+    dispatcher->Add(Asynch::CreateTask([callback = std::move(job.hashCallback), hash = std::move(hash)]()
+    {
+        callback(hash);
+    }));
+}
+
+}
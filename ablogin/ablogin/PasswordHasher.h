@@ -0,0 +1,102 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Auth {
+
+/// Runs bcrypt password hashing and verification on a pool of worker threads,
+/// so these slow calls do not block the Dispatcher. Results are passed back to
+/// the Dispatcher thread. The queue has an upper bound, when it is full new jobs
+/// are rejected and the caller should tell the client to try again later.
+class PasswordHasher
+{
+public:
+    /// match is true when the password matches the hash
+    using CheckCallback = std::function<void(bool match)>;
+    /// hash is empty on failure
+    using HashCallback = std::function<void(const std::string& hash)>;
+    struct Stats
+    {
+        uint64_t jobs{ 0 };
+        uint64_t rejected{ 0 };
+        size_t queued{ 0 };
+        size_t maxQueued{ 0 };
+        // All times in ms
+        int64_t totalWait{ 0 };
+        int64_t maxWait{ 0 };
+        int64_t totalHash{ 0 };
+        int64_t maxHash{ 0 };
+    };
+    /// bcrypt cost factor used for new hashes
+    static constexpr int HASH_COST = 10;
+
+    PasswordHasher() = default;
+    ~PasswordHasher();
+
+    /// 0 = number of CPU cores
+    void SetNumThreads(size_t value);
+    size_t GetNumThreads() const { return numThreads_; }
+    /// 0 = unlimited
+    void SetMaxQueue(size_t value) { maxQueue_ = value; }
+    size_t GetMaxQueue() const { return maxQueue_; }
+
+    void Start();
+    void Stop();
+    /// Returns false when the job was rejected because the queue is full
+    bool Check(const std::string& pass, const std::string& hash, CheckCallback&& callback);
+    /// Returns false when the job was rejected because the queue is full
+    bool Hash(const std::string& pass, HashCallback&& callback);
+    Stats GetStats() const;
+private:
+    struct Job
+    {
+        std::string pass;
+        std::string hash;
+        CheckCallback checkCallback;
+        HashCallback hashCallback;
+        int64_t enqueued;
+    };
+    bool Enqueue(Job&& job);
+    void WorkerThread();
+    void Execute(Job& job);
+
+    size_t numThreads_{ 1 };
+    size_t maxQueue_{ 0 };
+    bool running_{ false };
+    mutable std::mutex lock_;
+    std::condition_variable signal_;
+    std::deque<Job> jobs_;
+    std::vector<std::thread> threads_;
+    Stats stats_;
+};
+
+}
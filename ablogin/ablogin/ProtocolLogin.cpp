@@ -23,6 +23,7 @@
 #include "IOAccount.h"
 #include "IOGame.h"
 #include "IOService.h"
+#include "PasswordHasher.h"
 #include <AB/CommonConfig.h>
 #include <AB/Entities/Account.h>
 #include <AB/Entities/Game.h>
@@ -360,32 +361,59 @@ void ProtocolLogin::AuthenticateSendCharacterList(AB::Packets::Client::Login::Lo
 {
     AB::Entities::Account account;
     account.name = request.accountName;
-    IO::IOAccount::PasswordAuthResult res = IO::IOAccount::PasswordAuth(request.password, account);
-    auto banMan = GetSubsystem<Auth::BanManager>();
+    IO::IOAccount::PasswordAuthResult res = IO::IOAccount::BeginPasswordAuth(account);
+    if (!HandlePasswordAuthResult(res))
+        return;
+
+    // Checking the password is expensive, do it in a worker thread. The callback
+    // is executed by the dispatcher again.
+    std::shared_ptr<ProtocolLogin> thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this());
+    const std::string hash = account.password;
+    if (!GetSubsystem<Auth::PasswordHasher>()->Check(request.password, hash,
+        [thisPtr, request, account](bool match) mutable
+    {
+        thisPtr->PasswordChecked(std::move(request), std::move(account), match);
+    }))
+    {
+        LOG_WARNING << "Password queue full, rejecting login of " << request.accountName << std::endl;
+        DisconnectClient(AB::ErrorCodes::ServerBusy);
+    }
+}
+
+bool ProtocolLogin::HandlePasswordAuthResult(IO::IOAccount::PasswordAuthResult res)
+{
+    auto* banMan = GetSubsystem<Auth::BanManager>();
     switch (res)
     {
     case IO::IOAccount::PasswordAuthResult::InvalidAccount:
         DisconnectClient(AB::ErrorCodes::InvalidAccount);
         banMan->AddLoginAttempt(GetIP(), false);
-        return;
+        return false;
     case IO::IOAccount::PasswordAuthResult::PasswordMismatch:
         DisconnectClient(AB::ErrorCodes::NamePasswordMismatch);
         banMan->AddLoginAttempt(GetIP(), false);
-        return;
+        return false;
     case IO::IOAccount::PasswordAuthResult::AlreadyLoggedIn:
         DisconnectClient(AB::ErrorCodes::AlreadyLoggedIn);
         banMan->AddLoginAttempt(GetIP(), false);
-        return;
+        return false;
     case IO::IOAccount::PasswordAuthResult::AccountBanned:
         DisconnectClient(AB::ErrorCodes::AlreadyLoggedIn);
         banMan->AddLoginAttempt(GetIP(), false);
-        return;
+        return false;
     case IO::IOAccount::PasswordAuthResult::InternalError:
         DisconnectClient(AB::ErrorCodes::UnknownError);
-        return;
+        return false;
     default:
-        break;
+        return true;
     }
+}
+
+void ProtocolLogin::PasswordChecked(AB::Packets::Client::Login::Login request, AB::Entities::Account account, bool match)
+{
+    IO::IOAccount::PasswordAuthResult res = IO::IOAccount::EndPasswordAuth(match, account);
+    if (!HandlePasswordAuthResult(res))
+        return;
 
     AB::Entities::Service gameServer;
     if (!IO::IOService::EnsureService(
@@ -406,7 +434,7 @@ void ProtocolLogin::AuthenticateSendCharacterList(AB::Packets::Client::Login::Lo
         return;
     }
 
-    banMan->AddLoginAttempt(GetIP(), true);
+    GetSubsystem<Auth::BanManager>()->AddLoginAttempt(GetIP(), true);
 
     LOG_INFO << Utils::ConvertIPToString(GetIP(), true) << ": " << request.accountName << " logged in" << std::endl;
 
@@ -524,9 +552,40 @@ void ProtocolLogin::SendServers(AB::Packets::Client::Login::GetServers request)
 
 void ProtocolLogin::CreateAccount(AB::Packets::Client::Login::CreateAccount request)
 {
-    IO::IOAccount::CreateAccountResult res = IO::IOAccount::CreateAccount(
-        request.accountName, request.password, request.email, request.accountKey);
+    IO::IOAccount::CreateAccountResult res = IO::IOAccount::CanCreateAccount(
+        request.accountName, request.email, request.accountKey);
+    if (res != IO::IOAccount::CreateAccountResult::OK)
+    {
+        SendCreateAccountResult(res);
+        return;
+    }
 
+    std::shared_ptr<ProtocolLogin> thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this());
+    const std::string password = request.password;
+    if (!GetSubsystem<Auth::PasswordHasher>()->Hash(password,
+        [thisPtr, request](const std::string& hash)
+    {
+        thisPtr->PasswordHashed(request, hash);
+    }))
+    {
+        LOG_WARNING << "Password queue full, rejecting creation of account " << request.accountName << std::endl;
+        DisconnectClient(AB::ErrorCodes::ServerBusy);
+    }
+}
+
+void ProtocolLogin::PasswordHashed(const AB::Packets::Client::Login::CreateAccount& request, const std::string& hash)
+{
+    if (hash.empty())
+    {
+        SendCreateAccountResult(IO::IOAccount::CreateAccountResult::InternalError);
+        return;
+    }
+    SendCreateAccountResult(IO::IOAccount::CreateAccount(
+        request.accountName, hash, request.email, request.accountKey));
+}
+
+void ProtocolLogin::SendCreateAccountResult(IO::IOAccount::CreateAccountResult res)
+{
     auto output = OutputMessagePool::GetOutputMessage();
 
     if (res == IO::IOAccount::CreateAccountResult::OK)
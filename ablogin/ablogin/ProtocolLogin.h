@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "IOAccount.h"
+#include <AB/Entities/Account.h>
 #include <AB/Entities/Character.h>
 #include <AB/Packets/LoginPackets.h>
 #include <AB/ProtocolCodes.h>
@@ -60,6 +62,12 @@ private:
     void SendOutposts(AB::Packets::Client::Login::GetOutposts request);
     void SendServers(AB::Packets::Client::Login::GetServers request);
     void CreateAccount(AB::Packets::Client::Login::CreateAccount request);
+    // Called by the dispatcher when the PasswordHasher finished
+    void PasswordChecked(AB::Packets::Client::Login::Login request, AB::Entities::Account account, bool match);
+    void PasswordHashed(const AB::Packets::Client::Login::CreateAccount& request, const std::string& hash);
+    /// Returns false when the client was disconnected
+    bool HandlePasswordAuthResult(IO::IOAccount::PasswordAuthResult res);
+    void SendCreateAccountResult(IO::IOAccount::CreateAccountResult res);
     void AddAccountKey(AB::Packets::Client::Login::AddAccountKey request);
     void CreatePlayer(AB::Packets::Client::Login::CreatePlayer request);
     void DeletePlayer(AB::Packets::Client::Login::DeleteCharacter request);
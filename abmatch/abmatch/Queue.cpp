@@ -55,24 +55,20 @@ std::string Queue::FindServerForMatch(const MatchTeams& teams)
 {
     auto* dataclient = GetSubsystem<IO::DataClient>();
 
+    std::vector<std::string> members;
+    for (const auto& team : teams)
+        members.insert(members.end(), team.members.begin(), team.members.end());
+
+    std::vector<std::string> accounts;
+    for (const auto& ch : dataclient->ReadAll<AB::Entities::Character>(members))
+        accounts.push_back(ch.accountUuid);
+
     std::vector<std::string> servers;
     std::map<std::string, unsigned> sorting;
-    for (const auto& team : teams)
+    for (const auto& acc : dataclient->ReadAll<AB::Entities::Account>(accounts))
     {
-        for (const auto& m : team.members)
-        {
-            AB::Entities::Character ch;
-            ch.uuid = m;
-            if (!dataclient->Read(ch))
-                continue;
-            AB::Entities::Account acc;
-            acc.uuid = ch.accountUuid;
-            if (!dataclient->Read(acc))
-                continue;
-
-            servers.push_back(acc.currentServerUuid);
-            sorting[acc.currentServerUuid] += 1;
-        }
+        servers.push_back(acc.currentServerUuid);
+        sorting[acc.currentServerUuid] += 1;
     }
     if (servers.size() == 0)
     {
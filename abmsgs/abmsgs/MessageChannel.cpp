@@ -22,7 +22,6 @@
 #include "MessageChannel.h"
 #include "Application.h"
 #include <AB/Entities/Account.h>
-#include <AB/Entities/Character.h>
 #include <AB/Entities/FriendList.h>
 #include <AB/Entities/FriendedMe.h>
 #include <AB/Entities/GuildMembers.h>
@@ -73,6 +72,7 @@ void MessageSession::HandleRead(const asio::error_code& error)
     else
     {
         LOG_ERROR << "(" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
+        channel_.routes_.RemoveServer(serverId_);
         channel_.Leave(shared_from_this());
     }
 }
@@ -92,12 +92,14 @@ void MessageSession::HandleMessage(const Net::MessageMsg& msg)
             // Get type and UUID of server
             prop.Read<AB::Entities::ServiceType>(serviceType_);
             prop.ReadString(serverId_);
+            channel_.routes_.RemoveOffline();
             channel_.Deliver(msg);
         }
         break;
     }
     case Net::MessageType::ServerLeft:
         // Server was shut down
+        channel_.routes_.RemoveServer(serverId_);
         channel_.Deliver(msg);
         break;
     case Net::MessageType::Shutdown:
@@ -135,6 +137,12 @@ void MessageSession::HandleMessage(const Net::MessageMsg& msg)
     case Net::MessageType::TeamsEnterMatch:
         HandleQueueTeamEnterMessage(msg);
         break;
+    case Net::MessageType::PlayerLoggedIn:
+        HandlePlayerLoggedInMessage(msg);
+        break;
+    case Net::MessageType::PlayerLoggedOut:
+        HandlePlayerLoggedOutMessage(msg);
+        break;
     default:
         channel_.Deliver(msg);
         break;
@@ -303,7 +311,7 @@ void MessageSession::HandlePlayerChangedMessage(const Net::MessageMsg& msg)
     std::vector<std::string> servers;
     for (const auto& informAcc : interested)
     {
-        std::string serverUuid = GetServerUuidWidthAccount(informAcc);
+        std::string serverUuid = channel_.routes_.GetServerWithAccount(informAcc);
         if (!Utils::Uuid::IsEmpty(serverUuid))
             servers.push_back(serverUuid);
     }
@@ -359,30 +367,47 @@ void MessageSession::HandleNewMailMessage(const Net::MessageMsg& msg)
     }
 }
 
-MessageParticipant* MessageSession::GetServerWidthPlayer(const std::string& playerUuid)
+void MessageSession::HandlePlayerLoggedInMessage(const Net::MessageMsg& msg)
+{
+    std::string accountUuid;
+    std::string playerUuid;
+    std::string serverUuid;
+    sa::PropReadStream stream;
+    if (!msg.GetPropStream(stream))
+        return;
+    if (!stream.ReadString(accountUuid))
+        return;
+    if (!stream.ReadString(playerUuid))
+        return;
+    if (!stream.ReadString(serverUuid))
+        return;
+
+    channel_.routes_.PlayerLoggedIn(accountUuid, playerUuid, serverUuid);
+}
+
+void MessageSession::HandlePlayerLoggedOutMessage(const Net::MessageMsg& msg)
 {
-    IO::DataClient* cli = GetSubsystem<IO::DataClient>();
-    // Find the server this player is on
-    AB::Entities::Character ch;
-    ch.uuid = playerUuid;
-    if (!cli->Read(ch))
-        return nullptr;
-    return GetServerWidthAccount(ch.accountUuid);
+    std::string accountUuid;
+    std::string serverUuid;
+    sa::PropReadStream stream;
+    if (!msg.GetPropStream(stream))
+        return;
+    if (!stream.ReadString(accountUuid))
+        return;
+    if (!stream.ReadString(serverUuid))
+        return;
+
+    channel_.routes_.PlayerLoggedOut(accountUuid, serverUuid);
 }
 
-std::string MessageSession::GetServerUuidWidthAccount(const std::string& accountUuid)
+MessageParticipant* MessageSession::GetServerWidthPlayer(const std::string& playerUuid)
 {
-    IO::DataClient* cli = GetSubsystem<IO::DataClient>();
-    AB::Entities::Account acc;
-    acc.uuid = accountUuid;
-    if (!cli->Read(acc))
-        return Utils::Uuid::EMPTY_UUID;
-    return acc.currentServerUuid;
+    return GetServer(channel_.routes_.GetServerWithPlayer(playerUuid));
 }
 
 MessageParticipant* MessageSession::GetServerWidthAccount(const std::string& accountUuid)
 {
-    return GetServer(GetServerUuidWidthAccount(accountUuid));
+    return GetServer(channel_.routes_.GetServerWithAccount(accountUuid));
 }
 
 MessageParticipant* MessageSession::GetServerByType(AB::Entities::ServiceType type)
@@ -26,6 +26,7 @@
 #include <abscommon/MessageMsg.h>
 #include <eastl.hpp>
 #include <AB/Entities/Service.h>
+#include "RoutingTable.h"
 
 class MessageParticipant
 {
@@ -46,6 +47,7 @@ public:
     void Leave(std::shared_ptr<MessageParticipant> participant);
     void Deliver(const Net::MessageMsg& msg);
     ea::set<std::shared_ptr<MessageParticipant>> participants_;
+    RoutingTable routes_;
 };
 
 class MessageSession : public MessageParticipant, public std::enable_shared_from_this<MessageSession>
@@ -65,9 +67,10 @@ private:
     void HandlePlayerChangedMessage(const Net::MessageMsg& msg);
     void HandleQueuePlayerMessage(const Net::MessageMsg& msg);
     void HandleQueueTeamEnterMessage(const Net::MessageMsg& msg);
+    void HandlePlayerLoggedInMessage(const Net::MessageMsg& msg);
+    void HandlePlayerLoggedOutMessage(const Net::MessageMsg& msg);
     void SendPlayerMessage(const std::string& playerUuid, const Net::MessageMsg& msg);
     MessageParticipant* GetServerWidthPlayer(const std::string& playerUuid);
-    std::string GetServerUuidWidthAccount(const std::string& accountUuid);
     MessageParticipant* GetServerWidthAccount(const std::string& accountUuid);
     MessageParticipant* GetServer(const std::string& serverUuid);
     MessageParticipant* GetServerByType(AB::Entities::ServiceType type);
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "RoutingTable.h"
+#include <AB/Entities/Account.h>
+#include <AB/Entities/Character.h>
+#include <abscommon/DataClient.h>
+#include <abscommon/Subsystems.h>
+#include <abscommon/UuidUtils.h>
+#include <sa/time.h>
+
+void RoutingTable::SetServer(Route& route, const uuids::uuid& server)
+{
+    route.server = server;
+    route.expires = server.nil() ? sa::time::tick() + OFFLINE_TTL : 0;
+}
+
+const uuids::uuid* RoutingTable::LoadAccount(const uuids::uuid& accountUuid)
+{
+    ++stats_.misses;
+    IO::DataClient* cli = GetSubsystem<IO::DataClient>();
+    AB::Entities::Account acc;
+    acc.uuid = accountUuid.to_string();
+    if (!cli->Read(acc))
+        return nullptr;
+    // From now on we get told when it logs in or out
+    uuids::uuid server;
+    if (acc.onlineStatus != AB::Entities::OnlineStatusOffline)
+        server = uuids::uuid(acc.currentServerUuid);
+    Route& route = accounts_[accountUuid];
+    SetServer(route, server);
+    return &route.server;
+}
+
+std::string RoutingTable::GetServerWithAccount(const std::string& accountUuid)
+{
+    const uuids::uuid account(accountUuid);
+    if (account.nil())
+        return Utils::Uuid::EMPTY_UUID;
+    const uuids::uuid* server = nullptr;
+    const auto it = accounts_.find(account);
+    if (it != accounts_.end() && (!it->second.server.nil() || !sa::time::is_expired(it->second.expires)))
+    {
+        ++stats_.hits;
+        server = &it->second.server;
+    }
+    else
+        server = LoadAccount(account);
+    if (server == nullptr)
+        return Utils::Uuid::EMPTY_UUID;
+    return server->to_string();
+}
+
+std::string RoutingTable::GetServerWithPlayer(const std::string& playerUuid)
+{
+    const uuids::uuid player(playerUuid);
+    if (player.nil())
+        return Utils::Uuid::EMPTY_UUID;
+    const auto it = players_.find(player);
+    if (it != players_.end())
+        return GetServerWithAccount(it->second.to_string());
+
+    ++stats_.misses;
+    IO::DataClient* cli = GetSubsystem<IO::DataClient>();
+    AB::Entities::Character ch;
+    ch.uuid = playerUuid;
+    if (!cli->Read(ch))
+        return Utils::Uuid::EMPTY_UUID;
+    players_[player] = uuids::uuid(ch.accountUuid);
+    return GetServerWithAccount(ch.accountUuid);
+}
+
+void RoutingTable::PlayerLoggedIn(const std::string& accountUuid, const std::string& playerUuid,
+    const std::string& serverUuid)
+{
+    const uuids::uuid account(accountUuid);
+    if (account.nil())
+        return;
+    SetServer(accounts_[account], uuids::uuid(serverUuid));
+    const uuids::uuid player(playerUuid);
+    if (!player.nil())
+        players_[player] = account;
+}
+
+void RoutingTable::PlayerLoggedOut(const std::string& accountUuid, const std::string& serverUuid)
+{
+    const auto it = accounts_.find(uuids::uuid(accountUuid));
+    if (it == accounts_.end())
+        return;
+    // When changing the server, the new server may tell us about the login before
+    // the old one about the logout.
+    if (it->second.server == uuids::uuid(serverUuid))
+        SetServer(it->second, uuids::uuid());
+}
+
+void RoutingTable::RemoveServer(const std::string& serverUuid)
+{
+    const uuids::uuid server(serverUuid);
+    if (server.nil())
+        return;
+    for (auto it = accounts_.begin(); it != accounts_.end(); )
+    {
+        if (it->second.server == server)
+            it = accounts_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void RoutingTable::RemoveOffline()
+{
+    for (auto it = accounts_.begin(); it != accounts_.end(); )
+    {
+        if (it->second.server.nil())
+            it = accounts_.erase(it);
+        else
+            ++it;
+    }
+}
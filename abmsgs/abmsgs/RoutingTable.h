@@ -0,0 +1,75 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <uuid.h>
+#include <eastl.hpp>
+
+/// Knows which player is on which game server. It is updated with the PlayerLoggedIn
+/// and PlayerLoggedOut messages of the game servers. The data server is only asked
+/// for players it doesn't know yet, e.g. players which logged in before this server
+/// was started. Offline accounts are read again after a short time, in case we
+/// missed a login.
+class RoutingTable
+{
+public:
+    struct Stats
+    {
+        uint64_t hits{ 0 };
+        /// Lookups which had to read from the data server
+        uint64_t misses{ 0 };
+    };
+private:
+    /// Time in ms after which an offline account is read again from the data server
+    static constexpr int64_t OFFLINE_TTL = 10000;
+    struct Route
+    {
+        /// Nil when the account is offline
+        uuids::uuid server;
+        /// Only used for offline accounts
+        int64_t expires{ 0 };
+    };
+    using UuidMap = ea::unordered_map<uuids::uuid, uuids::uuid, std::hash<uuids::uuid>>;
+    /// Account -> Server
+    ea::unordered_map<uuids::uuid, Route, std::hash<uuids::uuid>> accounts_;
+    /// Character -> Account, this never changes
+    UuidMap players_;
+    Stats stats_;
+    static void SetServer(Route& route, const uuids::uuid& server);
+    const uuids::uuid* LoadAccount(const uuids::uuid& accountUuid);
+public:
+    /// Returns the UUID of the server the account is on, or an empty UUID when it's not online.
+    std::string GetServerWithAccount(const std::string& accountUuid);
+    std::string GetServerWithPlayer(const std::string& playerUuid);
+    void PlayerLoggedIn(const std::string& accountUuid, const std::string& playerUuid,
+        const std::string& serverUuid);
+    void PlayerLoggedOut(const std::string& accountUuid, const std::string& serverUuid);
+    /// Forget the players on this server, they are read from the data server again
+    /// when needed.
+    void RemoveServer(const std::string& serverUuid);
+    /// Forget all offline accounts, e.g. when a server joins. They may have logged
+    /// in while we didn't get its messages.
+    void RemoveOffline();
+    const Stats& GetStats() const { return stats_; }
+};
@@ -52,67 +52,123 @@ Connection::~Connection()
     CloseSocket();
 }
 
-bool Connection::Send(sa::SharedPtr<OutputMessage>&& message)
-{
+namespace {
+std::atomic<uint64_t> writtenMessages{ 0 };
+std::atomic<uint64_t> writeOperations{ 0 };
+std::atomic<uint64_t> writtenBytes{ 0 };
+}
 
-    if (state_ != State::Open)
-    {
-        LOG_ERROR << "State not open " << static_cast<int>(state_.load()) << std::endl;
-        return false;
-    }
+Connection::WriteStats Connection::GetWriteStats()
+{
+    return { writtenMessages.load(), writeOperations.load(), writtenBytes.load() };
+}
 
-    OutputMessage& msg = *message;
-    bool noPendingWrite = messageQueue_.empty();
+bool Connection::Send(sa::SharedPtr<OutputMessage>&& message)
+{
+    bool startWrite = false;
     {
         std::scoped_lock<std::mutex> lockClass(lock_);
-        messageQueue_.emplace_back(std::move(message));
+        if (state_ != State::Open)
+        {
+            LOG_ERROR << "State not open " << static_cast<int>(state_.load()) << std::endl;
+            return false;
+        }
+        messageQueue_.PushBack(std::move(message));
+        if (!writing_)
+        {
+            writing_ = true;
+            startWrite = true;
+        }
     }
-    if (noPendingWrite)
-        InternalSend(msg);
+    // The write is started on the IO thread of this connection. Messages sent until
+    // then go with the same write operation.
+    if (startWrite)
+        asio::post(socket_.get_executor(), std::bind(&Connection::InternalSend, shared_from_this()));
 
     return true;
 }
 
-void Connection::InternalSend(OutputMessage& message)
+void Connection::InternalSend()
 {
-    if (!protocol_->OnSendMessage(message))
+    ASSERT(writeCount_ == 0);
+    ASSERT(writeMessages_.empty());
+    {
+        std::scoped_lock<std::mutex> lockClass(lock_);
+        // Always at least one message, then as many as fit into the batch. The messages
+        // stay in the queue until they are written, and only this thread removes them.
+        size_t batchSize = 0;
+        while (writeCount_ < messageQueue_.Size())
+        {
+            OutputMessage* message = messageQueue_.At(writeCount_).Ptr();
+            batchSize += static_cast<size_t>(message->GetSize());
+            if (writeCount_ != 0 && batchSize > MaxWriteBatchSize)
+                break;
+            writeMessages_.push_back(message);
+            ++writeCount_;
+        }
+    }
+
+    size_t bytes = 0;
+    for (auto* message : writeMessages_)
     {
-        LOG_ERROR << "Message will be discarded" << std::endl;
+        if (!protocol_->OnSendMessage(*message))
+        {
+            LOG_ERROR << "Message will be discarded" << std::endl;
+            continue;
+        }
+        writeBuffers_.push_back(asio::buffer(message->GetOutputBuffer(), static_cast<size_t>(message->GetSize())));
+        bytes += static_cast<size_t>(message->GetSize());
+    }
+    writeMessages_.clear();
+    if (writeBuffers_.empty())
+    {
+        // All discarded
+        OnWriteOperation({});
         return;
     }
+
+    ++writeOperations;
+    writtenMessages += writeBuffers_.size();
+    writtenBytes += bytes;
     try
     {
         writeTimer_.expires_from_now(std::chrono::seconds(Connection::WriteTimeout));
         writeTimer_.async_wait(std::bind(&Connection::HandleWriteTimeout,
             std::weak_ptr<Connection>(shared_from_this()), std::placeholders::_1));
 
-        asio::async_write(socket_,
-            asio::buffer(message.GetOutputBuffer(), static_cast<size_t>(message.GetSize())),
+        asio::async_write(socket_, writeBuffers_,
             std::bind(&Connection::OnWriteOperation, shared_from_this(), std::placeholders::_1));
     }
     catch (asio::system_error& e)
     {
         LOG_ERROR << "Network " << e.code() << " " << e.what() << std::endl;
+        OnWriteOperation(e.code());
     }
 }
 
 void Connection::OnWriteOperation(const asio::error_code& error)
 {
     writeTimer_.cancel();
+    writeBuffers_.clear();
+    bool more = false;
     {
         std::scoped_lock<std::mutex> lockClass(lock_);
-        messageQueue_.pop_front();
+        for (; writeCount_ > 0; --writeCount_)
+            messageQueue_.PopFront();
+        if (error)
+            messageQueue_.Clear();
+        more = !messageQueue_.IsEmpty();
+        writing_ = more;
     }
 
     if (error)
     {
-        messageQueue_.clear();
         Close(true);
         return;
     }
 
-    if (!messageQueue_.empty())
-        InternalSend(*messageQueue_.front());
+    if (more)
+        InternalSend();
     else if (state_ == State::Closed)
         CloseSocket();
 }
@@ -127,9 +183,14 @@ void Connection::Close(bool force /* = false */)
     }
     connMngr->ReleaseConnection(shared_from_this());
 
-    if (state_ != State::Open)
-        return;
-    state_ = State::Closed;
+    bool writing = false;
+    {
+        std::scoped_lock<std::mutex> lockClass(lock_);
+        if (state_ != State::Open)
+            return;
+        state_ = State::Closed;
+        writing = writing_;
+    }
     if (protocol_)
     {
         GetSubsystem<Asynch::Dispatcher>()->Add(
@@ -137,7 +198,8 @@ void Connection::Close(bool force /* = false */)
         );
     }
 
-    if (messageQueue_.empty() || force)
+    // Otherwise the socket is closed when the pending write is done
+    if (!writing || force)
         CloseSocket();
 }
 
@@ -22,9 +22,10 @@
 #pragma once
 
 #include <unordered_set>
-#include <list>
 #include <memory>
+#include <vector>
 #include <asio.hpp>
+#include <sa/RingBuffer.h>
 #include <sa/SmartPtr.h>
 #include "NetworkMessage.h"
 #include <sa/Noncopyable.h>
@@ -60,11 +61,23 @@ class Connection : public std::enable_shared_from_this<Connection>
 public:
     enum { WriteTimeout = 30 };
     enum { ReadTimeout = 30 };
+    /// Queued messages are written with one write operation up to this size
+    enum { MaxWriteBatchSize = 64 * 1024 };
     enum class State
     {
         Open = 0,
         Closed = 3
     };
+    struct WriteStats
+    {
+        /// Messages written
+        uint64_t messages;
+        /// Write operations, each writes one or more messages
+        uint64_t writes;
+        uint64_t bytes;
+    };
+    /// Stats of all connections
+    static WriteStats GetWriteStats();
 public:
     Connection(asio::io_service& ioService, std::shared_ptr<ServicePort> servicPort);
     ~Connection();
@@ -90,7 +103,8 @@ private:
     void ParsePacket(const asio::error_code& error);
     void CloseSocket();
     void OnWriteOperation(const asio::error_code& error);
-    void InternalSend(OutputMessage& message);
+    /// Writes the queued messages, IO thread
+    void InternalSend();
 
 #ifdef DEBUG_NET
     int64_t lastReadHeader_{ 0 };
@@ -104,8 +118,14 @@ private:
     asio::steady_timer writeTimer_;
     /// Message read from the client
     std::unique_ptr<NetworkMessage> msg_;
-    /// Messages will be sent to the client
-    std::list<sa::SharedPtr<OutputMessage>> messageQueue_;
+    /// Messages will be sent to the client, guarded by lock_
+    sa::RingBuffer<sa::SharedPtr<OutputMessage>> messageQueue_;
+    /// A write is in progress or scheduled, guarded by lock_
+    bool writing_{ false };
+    /// Number of messages at the front of messageQueue_ which are currently written
+    size_t writeCount_{ 0 };
+    std::vector<OutputMessage*> writeMessages_;
+    std::vector<asio::const_buffer> writeBuffers_;
     time_t timeConnected_;
     uint32_t packetsSent_;
 
@@ -21,97 +21,432 @@
 
 
 #include "DataClient.h"
+#include "Logger.h"
+#include <sa/Assert.h>
+#include <sa/time.h>
 #include <chrono>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace IO {
 
+/// How often the timeout thread looks for requests without an answer
+static constexpr int64_t TIMEOUT_CHECK_MS = 100;
+
+class DataClient::Connection
+{
+private:
+    struct Pending
+    {
+        ResponseHandler handler;
+        /// Tick when the request times out
+        int64_t expires;
+    };
+    DataClient& owner_;
+    asio::ip::tcp::socket socket_;
+    asio::ip::tcp::resolver resolver_;
+    /// Requests must be written at once, and reconnecting must not happen while writing.
+    std::mutex writeLock_;
+    std::mutex pendingLock_;
+    /// Request ID -> Handler of requests waiting for an answer
+    std::unordered_map<uint32_t, Pending> pending_;
+    std::thread reader_;
+    /// ID of the reader thread while it runs, to find handlers making requests
+    std::atomic<std::thread::id> readerId_;
+    std::atomic<bool> connected_{ false };
+    void InternalConnect();
+    void ReadLoop();
+    void Disconnect();
+    void FailPending();
+    void AddPending(uint32_t id, ResponseHandler&& handler);
+    ResponseHandler TakePending(uint32_t id);
+    bool Write(const std::vector<asio::const_buffer>& buffers);
+    static uint32_t ToInt32(const uint8_t* bytes)
+    {
+        return (bytes[3] << 24) | (bytes[2] << 16) | (bytes[1] << 8) | bytes[0];
+    }
+public:
+    Connection(DataClient& owner, asio::io_service& ioService) :
+        owner_(owner),
+        socket_(ioService),
+        resolver_(ioService)
+    { }
+    ~Connection()
+    {
+        std::scoped_lock lock(writeLock_);
+        Disconnect();
+    }
+    /// Try connect to server.
+    /// @param[in] force If force is true it disconnects first.
+    /// @return true on success.
+    bool TryConnect(bool force, unsigned numTries = 10);
+    void Send(uint32_t id, const std::vector<asio::const_buffer>& buffers, ResponseHandler&& handler);
+    /// Fail the requests which timed out at now
+    void FailExpired(int64_t now);
+    bool IsConnected() const { return connected_; }
+};
+
+void DataClient::Connection::InternalConnect()
+{
+    if (connected_)
+        return;
+
+    const asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), owner_.host_, std::to_string(owner_.port_));
+    asio::error_code error;
+    asio::ip::tcp::resolver::iterator endpoint = resolver_.resolve(query, error);
+    if (error)
+        return;
+    socket_.connect(*endpoint, error);
+    if (error)
+    {
+        socket_.close(error);
+        return;
+    }
+    socket_.set_option(asio::ip::tcp::no_delay(true), error);
+    connected_ = true;
+    reader_ = std::thread(&Connection::ReadLoop, this);
+}
+
+bool DataClient::Connection::TryConnect(bool force, unsigned numTries /* = 10 */)
+{
+    if (force)
+        Disconnect();
+    // By default try for 1 second, 10 tries
+    unsigned tries = 0;
+    while (!connected_ && tries < numTries)
+    {
+        ++tries;
+        // The reader thread of a lost connection has finished or is about to
+        Disconnect();
+        InternalConnect();
+        if (connected_)
+            return true;
+        if (tries >= numTries)
+            return false;
+
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(100ms);
+    }
+    return connected_;
+}
+
+void DataClient::Connection::Disconnect()
+{
+    connected_ = false;
+    asio::error_code ec;
+    // Wakes up the reader thread
+    socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+    if (reader_.joinable())
+        reader_.join();
+    socket_.close(ec);
+    FailPending();
+}
+
+void DataClient::Connection::FailPending()
+{
+    std::unordered_map<uint32_t, Pending> pending;
+    {
+        std::scoped_lock lock(pendingLock_);
+        pending.swap(pending_);
+    }
+    DataBuff empty;
+    for (auto& request : pending)
+        request.second.handler(false, empty);
+}
+
+void DataClient::Connection::FailExpired(int64_t now)
+{
+    std::vector<ResponseHandler> expired;
+    {
+        std::scoped_lock lock(pendingLock_);
+        for (auto it = pending_.begin(); it != pending_.end(); )
+        {
+            if (it->second.expires > now)
+            {
+                ++it;
+                continue;
+            }
+            LOG_WARNING << "Request " << it->first << " timed out" << std::endl;
+            expired.push_back(std::move(it->second.handler));
+            it = pending_.erase(it);
+        }
+    }
+    DataBuff empty;
+    for (auto& handler : expired)
+        handler(false, empty);
+}
+
+void DataClient::Connection::AddPending(uint32_t id, ResponseHandler&& handler)
+{
+    std::scoped_lock lock(pendingLock_);
+    pending_.emplace(id, Pending{ std::move(handler), sa::time::tick() + owner_.requestTimeout_ });
+}
+
+DataClient::ResponseHandler DataClient::Connection::TakePending(uint32_t id)
+{
+    std::scoped_lock lock(pendingLock_);
+    auto it = pending_.find(id);
+    if (it == pending_.end())
+        return {};
+    ResponseHandler result = std::move(it->second.handler);
+    pending_.erase(it);
+    return result;
+}
+
+void DataClient::Connection::ReadLoop()
+{
+    readerId_ = std::this_thread::get_id();
+    uint8_t header[RESPONSE_HEADER_SIZE];
+    DataBuff data;
+    asio::error_code ec;
+    while (connected_)
+    {
+        asio::read(socket_, asio::buffer(header), ec);
+        if (ec)
+            break;
+        const OpCodes opCode = static_cast<OpCodes>(header[0]);
+        const uint32_t id = ToInt32(&header[1]);
+        const uint32_t size = ToInt32(&header[5]);
+        data.resize(size);
+        if (size != 0)
+        {
+            asio::read(socket_, asio::buffer(data), ec);
+            if (ec)
+                break;
+        }
+        ResponseHandler handler = TakePending(id);
+        if (!handler)
+        {
+            LOG_WARNING << "No request with ID " << id << std::endl;
+            continue;
+        }
+        if (opCode == OpCodes::Status)
+        {
+            const bool success = size != 0 && static_cast<ErrorCodes>(data[0]) == ErrorCodes::Ok;
+            data.clear();
+            handler(success, data);
+        }
+        else
+            handler(opCode == OpCodes::Data, data);
+    }
+    // Lost the connection, next request reconnects
+    connected_ = false;
+    FailPending();
+    readerId_ = std::thread::id();
+}
+
+bool DataClient::Connection::Write(const std::vector<asio::const_buffer>& buffers)
+{
+    asio::error_code ec;
+    asio::write(socket_, buffers, ec);
+    return !ec;
+}
+
+void DataClient::Connection::Send(uint32_t id, const std::vector<asio::const_buffer>& buffers, ResponseHandler&& handler)
+{
+    // A handler making a request would wait for its own answer, or join the reader
+    // thread from itself when it must reconnect.
+    ASSERT(std::this_thread::get_id() != readerId_.load());
+    std::scoped_lock lock(writeLock_);
+    if (!connected_ && !TryConnect(true))
+    {
+        DataBuff empty;
+        handler(false, empty);
+        return;
+    }
+    // Register before sending, the answer may arrive before Write() returns
+    AddPending(id, std::move(handler));
+    if (Write(buffers))
+        return;
+
+    // Try to reconnect once and send it again
+    handler = TakePending(id);
+    if (!handler)
+        // The reader thread failed it already
+        return;
+    if (TryConnect(true))
+    {
+        AddPending(id, std::move(handler));
+        if (Write(buffers))
+            return;
+        handler = TakePending(id);
+    }
+    if (handler)
+    {
+        DataBuff empty;
+        handler(false, empty);
+    }
+}
+
 DataClient::DataClient(asio::io_service& io_service) :
-    socket_(io_service),
-    resolver_(io_service)
+    ioService_(io_service)
 {
 }
 
 DataClient::~DataClient()
 {
-    socket_.close();
+    StopTimeoutThread();
+}
+
+void DataClient::StopTimeoutThread()
+{
+    {
+        std::scoped_lock lock(timeoutLock_);
+        stopTimeout_ = true;
+    }
+    timeoutSignal_.notify_one();
+    if (timeoutThread_.joinable())
+        timeoutThread_.join();
 }
 
-void DataClient::Connect(const std::string& host, uint16_t port)
+void DataClient::TimeoutLoop()
 {
+    std::unique_lock<std::mutex> lock(timeoutLock_);
+    while (!timeoutSignal_.wait_for(lock, std::chrono::milliseconds(TIMEOUT_CHECK_MS), [this]() { return stopTimeout_; }))
+    {
+        const int64_t now = sa::time::tick();
+        for (const auto& connection : connections_)
+            connection->FailExpired(now);
+    }
+}
+
+void DataClient::Connect(const std::string& host, uint16_t port, size_t connections /* = 1 */)
+{
+    // The timeout thread uses connections_
+    StopTimeoutThread();
     host_ = host;
     port_ = port;
-    // First time connect, try longer other servers may not be up yet.
-    TryConnect(false, 100);
+    connections_.clear();
+    for (size_t i = 0; i < std::max<size_t>(connections, 1); ++i)
+    {
+        auto connection = std::make_unique<Connection>(*this, ioService_);
+        // First time connect, try longer other servers may not be up yet.
+        connection->TryConnect(false, 100);
+        connections_.push_back(std::move(connection));
+    }
+    stopTimeout_ = false;
+    timeoutThread_ = std::thread(&DataClient::TimeoutLoop, this);
 }
 
-bool DataClient::MakeRequest(OpCodes opCode, const DataKey& key, DataBuff& data)
+bool DataClient::IsConnected() const
 {
-    const uint8_t ksize1 = static_cast<uint8_t>(key.size());
-    const uint8_t ksize2 = static_cast<uint8_t>(key.size() >> 8);
-    const uint8_t header[] = { static_cast<uint8_t>(opCode), ksize1, ksize2 };
-    // All data must be sent at once. Multiple threads must not send different requests at the same time.
-    std::scoped_lock lock(lock_);
-    if (!TryWrite(asio::buffer(header)))
-        return false;
-
-    if (!TryWrite(asio::buffer(key.data_)))
-        return false;
-
-    const uint8_t dsize4 = static_cast<uint8_t>(data.size() >> 24);
-    const uint8_t dsize3 = static_cast<uint8_t>(data.size() >> 16);
-    const uint8_t dsize2 = static_cast<uint8_t>(data.size() >> 8);
-    const uint8_t dsize1 = static_cast<uint8_t>(data.size());
-
-    const uint8_t data_header[] = { dsize1, dsize2, dsize3, dsize4 };
-    if (!TryWrite(asio::buffer(data_header)))
-        return false;
-
-    if (!TryWrite(asio::buffer(data)))
-        return false;
-
-    std::vector<uint8_t> dataheader(5);
-    /* size_t read = */ asio::read(socket_, asio::buffer(dataheader, 5), asio::transfer_at_least(5));
-    if (static_cast<OpCodes>(dataheader[0]) == OpCodes::Status)
-    {
-        // Does not return data
-        uint8_t result[128];
-        // Read the rest of the status
-        socket_.read_some(asio::buffer(result));
-        return dataheader[1] == static_cast<unsigned char>(ErrorCodes::Ok);
+    for (const auto& connection : connections_)
+    {
+        if (connection->IsConnected())
+            return true;
     }
+    return false;
+}
 
-    // If we are here it returns data
-    const size_t size = static_cast<size_t>(ToInt32(dataheader, 1));
-    data.resize(size);
-    const size_t read2 = asio::read(socket_, asio::buffer(data), asio::transfer_at_least(size));
-    if (read2 != size)
-        return false;
+DataClient::Connection& DataClient::GetConnection()
+{
+    ASSERT(!connections_.empty());
+    if (connections_.size() == 1)
+        return *connections_.front();
+    const size_t index = nextConnection_.fetch_add(1, std::memory_order_relaxed) % connections_.size();
+    return *connections_[index];
+}
 
-    return true;
+void DataClient::SendRequest(OpCodes opCode, const DataKey& key, const DataBuff& data, ResponseHandler&& handler)
+{
+    const uint32_t id = nextRequestId_.fetch_add(1, std::memory_order_relaxed);
+    const uint16_t keySize = static_cast<uint16_t>(key.size());
+    const uint32_t dataSize = static_cast<uint32_t>(data.size());
+    const uint8_t header[REQUEST_HEADER_SIZE] = {
+        static_cast<uint8_t>(opCode),
+        static_cast<uint8_t>(id), static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id >> 16), static_cast<uint8_t>(id >> 24),
+        static_cast<uint8_t>(keySize), static_cast<uint8_t>(keySize >> 8),
+        static_cast<uint8_t>(dataSize), static_cast<uint8_t>(dataSize >> 8), static_cast<uint8_t>(dataSize >> 16), static_cast<uint8_t>(dataSize >> 24)
+    };
+    const std::vector<asio::const_buffer> buffers = {
+        asio::buffer(header),
+        asio::buffer(key.data_),
+        asio::buffer(data)
+    };
+    GetConnection().Send(id, buffers, std::move(handler));
 }
 
-bool DataClient::MakeRequestNoData(OpCodes opCode, const DataKey& key)
+std::future<bool> DataClient::MakeRequestAsync(OpCodes opCode, const DataKey& key, const DataBuff& data)
 {
-    const uint8_t ksize1 = static_cast<uint8_t>(key.size());
-    const uint8_t ksize2 = static_cast<uint8_t>(key.size() >> 8);
-    const uint8_t header[] = { static_cast<uint8_t>(opCode), ksize1, ksize2 };
-    // All data must be sent at once. Multiple threads must not send different requests at the same time.
-    std::scoped_lock lock(lock_);
-    if (!TryWrite(asio::buffer(header)))
-        return false;
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto result = promise->get_future();
+    SendRequest(opCode, key, data, [promise](bool success, DataBuff&)
+    {
+        promise->set_value(success);
+    });
+    return result;
+}
 
-    if (!TryWrite(asio::buffer(key.data_)))
-        return false;
+void DataClient::MakeBatchRequest(OpCodes opCode, std::vector<BatchItem>& items)
+{
+    static const DataKey emptyKey;
+    std::vector<std::future<bool>> results;
+    for (size_t start = 0; start < items.size(); start += MAX_BATCH_COUNT)
+    {
+        const size_t end = std::min(items.size(), start + MAX_BATCH_COUNT);
+        DataBuff data;
+        const uint32_t count = static_cast<uint32_t>(end - start);
+        AddInt32(data, count);
+        for (size_t i = start; i < end; ++i)
+        {
+            const BatchItem& item = items[i];
+            const uint16_t keySize = static_cast<uint16_t>(item.key.size());
+            data.push_back(static_cast<uint8_t>(keySize));
+            data.push_back(static_cast<uint8_t>(keySize >> 8));
+            AddInt32(data, static_cast<uint32_t>(item.data.size()));
+            data.insert(data.end(), item.key.data(), item.key.data() + keySize);
+            data.insert(data.end(), item.data.begin(), item.data.end());
+        }
+
+        auto promise = std::make_shared<std::promise<bool>>();
+        results.push_back(promise->get_future());
+        // All chunks are in flight at the same time
+        SendRequest(opCode, emptyKey, data, [&items, start, end, promise](bool success, DataBuff& response)
+        {
+            if (!success || response.size() < 4 || ToInt32(response, 0) != end - start)
+            {
+                promise->set_value(false);
+                return;
+            }
+            size_t pos = 4;
+            for (size_t i = start; i < end; ++i)
+            {
+                if (pos + 5 > response.size())
+                    break;
+                const bool ok = static_cast<ErrorCodes>(response[pos]) == ErrorCodes::Ok;
+                const size_t size = ToInt32(response, static_cast<uint32_t>(pos + 1));
+                pos += 5;
+                if (pos + size > response.size())
+                    break;
+                items[i].success = ok;
+                if (ok && size != 0)
+                    items[i].data.assign(response.begin() + pos, response.begin() + pos + size);
+                pos += size;
+            }
+            promise->set_value(true);
+        });
+    }
+    for (auto& result : results)
+        result.wait();
+}
 
-    uint8_t result[128];
-    const size_t read = socket_.read_some(asio::buffer(result));
-    if (read < 2)
-        return false;
+bool DataClient::MakeRequest(OpCodes opCode, const DataKey& key, DataBuff& data)
+{
+    std::promise<bool> promise;
+    auto result = promise.get_future();
+    SendRequest(opCode, key, data, [&promise, &data](bool success, DataBuff& response)
+    {
+        if (success && !response.empty())
+            data = std::move(response);
+        promise.set_value(success);
+    });
+    return result.get();
+}
 
-    if (static_cast<OpCodes>(result[0]) == OpCodes::Status && static_cast<ErrorCodes>(result[1]) == ErrorCodes::Ok)
-        return true;
-    return false;
+bool DataClient::MakeRequestNoData(OpCodes opCode, const DataKey& key)
+{
+    return MakeRequestAsync(opCode, key, {}).get();
 }
 
 bool DataClient::LockData(const DataKey& key)
@@ -167,41 +502,4 @@ bool DataClient::Clear()
     return MakeRequestNoData(OpCodes::Clear, key);
 }
 
-void DataClient::InternalConnect()
-{
-    if (connected_)
-        return;
-
-    const asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), host_, std::to_string(port_));
-    asio::ip::tcp::resolver::iterator endpoint = resolver_.resolve(query);
-    asio::error_code error;
-    socket_.connect(*endpoint, error);
-    if (!error)
-        connected_ = true;
-}
-
-bool DataClient::TryConnect(bool force, unsigned numTries /* = 10 */)
-{
-    if (force)
-    {
-        connected_ = false;
-        socket_.close();
-    }
-    // By default try for 1 second, 10 tries
-    unsigned tries = 0;
-    while (!connected_ && tries < numTries)
-    {
-        ++tries;
-        InternalConnect();
-        if (connected_)
-            return true;
-        if (tries >= 10)
-            return false;
-
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(100ms);
-    }
-    return connected_;
-}
-
 }
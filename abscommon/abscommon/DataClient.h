@@ -34,22 +34,43 @@ PRAGMA_WARNING_POP
 #include <uuid.h>
 #include "DataKey.h"
 #include "DataCodes.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <asio.hpp>
 
 namespace IO {
 
 using DataBuff = std::vector<uint8_t>;
 
+/// Client of the data server. Requests are tagged with an ID, so many requests
+/// may be in flight on one connection and the server may answer them in any order.
+/// Requests are distributed over a small pool of connections.
+/// The synchronous methods block only the calling thread until the answer arrives,
+/// the *Async methods return a future or call a callback from the reader thread.
+/// Requests without an answer fail after the request timeout.
 class DataClient
 {
+public:
+    /// Called with the result of a request. data contains the answer of a read request.
+    /// It runs on the reader thread of the connection, or the timeout thread when the
+    /// request timed out, so it must not make another request or wait for one.
+    using ResponseHandler = std::function<void(bool success, DataBuff& data)>;
+    static constexpr uint32_t DEFAULT_REQUEST_TIMEOUT_MS = 10000;
 private:
-    std::mutex lock_;
+    class Connection;
 public:
     explicit DataClient(asio::io_service& io_service);
     ~DataClient();
 
-    void Connect(const std::string& host, uint16_t port);
+    void Connect(const std::string& host, uint16_t port, size_t connections = 1);
+    /// Requests which got no answer after ms milliseconds fail
+    void SetRequestTimeout(uint32_t ms) { requestTimeout_ = ms; }
+    uint32_t GetRequestTimeout() const { return requestTimeout_; }
 
     // Lock this entity so it can only be modified by this client, i.e. make it read-only for all other clients.
     // If it is not in the cache it loads it, so you can call Lock() before Read() and be sure the data you have
@@ -73,7 +94,7 @@ public:
     {
         const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
         DataBuff data;
-        SetEntity<E>(entity, data);
+        SetReadRequest<E>(entity, data);
         if (!ReadData(aKey, data))
             return false;
         if (GetEntity(data, entity))
@@ -144,12 +165,147 @@ public:
         const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
         return InvalidateData(aKey);
     }
-    /// Clears all cache
-    bool Clear();
-    bool IsConnected() const
+
+    /// Read many entities with as few requests as possible. Entities which could
+    /// not be read are removed. Returns the number of read entities.
+    template<typename E>
+    size_t ReadAll(std::vector<E>& entities)
+    {
+        std::vector<BatchItem> items;
+        items.reserve(entities.size());
+        for (const auto& entity : entities)
+        {
+            BatchItem item{ DataKey(E::KEY(), uuids::uuid(entity.uuid)), {}, false };
+            SetReadRequest<E>(entity, item.data);
+            items.push_back(std::move(item));
+        }
+        MakeBatchRequest(OpCodes::ReadMany, items);
+        size_t count = 0;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            if (!items[i].success)
+                continue;
+            E entity;
+            if (!GetEntity(items[i].data, entity))
+                continue;
+            entities[count] = std::move(entity);
+            ++count;
+        }
+        entities.resize(count);
+        return count;
+    }
+    /// Read the entities with the given UUIDs with as few requests as possible.
+    template<typename E>
+    std::vector<E> ReadAll(const std::vector<std::string>& uuids)
     {
-        return connected_;
+        std::vector<E> result;
+        result.resize(uuids.size());
+        for (size_t i = 0; i < uuids.size(); ++i)
+            result[i].uuid = uuids[i];
+        ReadAll(result);
+        return result;
     }
+    /// Update many entities with as few requests as possible.
+    /// Returns true when all entities were updated.
+    template<typename E>
+    bool UpdateAll(const std::vector<E>& entities)
+    {
+        std::vector<BatchItem> items;
+        items.reserve(entities.size());
+        for (const auto& entity : entities)
+        {
+            BatchItem item{ DataKey(E::KEY(), uuids::uuid(entity.uuid)), {}, false };
+            if (SetEntity<E>(entity, item.data) == 0)
+                return false;
+            items.push_back(std::move(item));
+        }
+        MakeBatchRequest(OpCodes::UpdateMany, items);
+        for (const auto& item : items)
+        {
+            if (!item.success)
+                return false;
+        }
+        return true;
+    }
+    /// Flushes many entities and removes them from cache with as few requests as possible.
+    /// Returns true when all entities were invalidated.
+    template<typename E>
+    bool InvalidateAll(const std::vector<E>& entities)
+    {
+        std::vector<BatchItem> items;
+        items.reserve(entities.size());
+        for (const auto& entity : entities)
+            items.push_back({ DataKey(E::KEY(), uuids::uuid(entity.uuid)), {}, false });
+        MakeBatchRequest(OpCodes::InvalidateMany, items);
+        for (const auto& item : items)
+        {
+            if (!item.success)
+                return false;
+        }
+        return true;
+    }
+
+    /// Read an entity without waiting for the answer. The callback is called like a
+    /// ResponseHandler with the read entity, it must not make other requests.
+    template<typename E>
+    void ReadAsync(const E& entity, std::function<void(bool success, E& entity)>&& callback)
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        SetReadRequest<E>(entity, data);
+        SendRequest(OpCodes::Read, aKey, data, [entity = E(entity), callback = std::move(callback)](bool success, DataBuff& data) mutable
+        {
+            if (success)
+                success = GetEntity(data, entity);
+            callback(success, entity);
+        });
+    }
+    /// Read an entity without waiting for the answer. The entity must stay alive
+    /// until the future is ready.
+    template<typename E>
+    std::future<bool> ReadAsync(E& entity)
+    {
+        auto promise = std::make_shared<std::promise<bool>>();
+        auto result = promise->get_future();
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        SetReadRequest<E>(entity, data);
+        SendRequest(OpCodes::Read, aKey, data, [&entity, promise](bool success, DataBuff& data)
+        {
+            if (success)
+                success = GetEntity(data, entity);
+            promise->set_value(success);
+        });
+        return result;
+    }
+    template<typename E>
+    std::future<bool> UpdateAsync(const E& entity)
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        if (SetEntity<E>(entity, data) == 0)
+            return MakeReadyFuture(false);
+        return MakeRequestAsync(OpCodes::Update, aKey, data);
+    }
+    template<typename E>
+    std::future<bool> CreateAsync(const E& entity)
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        if (SetEntity<E>(entity, data) == 0)
+            return MakeReadyFuture(false);
+        return MakeRequestAsync(OpCodes::Create, aKey, data);
+    }
+    template<typename E>
+    std::future<bool> DeleteAsync(const E& entity)
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        return MakeRequestAsync(OpCodes::Delete, aKey, {});
+    }
+
+    /// Clears all cache
+    bool Clear();
+    bool IsConnected() const;
     const std::string& GetHost() const
     {
         return host_;
@@ -158,7 +314,17 @@ public:
     {
         return port_;
     }
+    size_t GetConnectionCount() const
+    {
+        return connections_.size();
+    }
 private:
+    struct BatchItem
+    {
+        DataKey key;
+        DataBuff data;
+        bool success;
+    };
     /// Unserialize Entitiy
     /// @param[in] data Input data
     /// @param[out] Resulting Entity
@@ -181,7 +347,21 @@ private:
         auto writtenSize = bitsery::quickSerialization<OutputAdapter, E>(buffer, e);
         return writtenSize;
     }
-
+    /// The key is all the server needs to find a record by its UUID. Only records
+    /// looked up by other fields, e.g. a character by its name, send the entity.
+    template<typename E>
+    static void SetReadRequest(const E& e, DataBuff& buffer)
+    {
+        if (uuids::uuid(e.uuid).nil())
+            SetEntity<E>(e, buffer);
+    }
+    static void AddInt32(DataBuff& buffer, uint32_t value)
+    {
+        buffer.push_back(static_cast<uint8_t>(value));
+        buffer.push_back(static_cast<uint8_t>(value >> 8));
+        buffer.push_back(static_cast<uint8_t>(value >> 16));
+        buffer.push_back(static_cast<uint8_t>(value >> 24));
+    }
     static uint32_t ToInt32(const DataBuff& intBytes, uint32_t start)
     {
         return (intBytes[static_cast<size_t>(start) + 3] << 24) |
@@ -189,12 +369,20 @@ private:
             (intBytes[static_cast<size_t>(start) + 1] << 8) |
             intBytes[static_cast<size_t>(start)];
     }
-    static uint16_t ToInt16(const DataBuff& intBytes, uint32_t start)
+    static std::future<bool> MakeReadyFuture(bool value)
     {
-        return (intBytes[static_cast<size_t>(start) + 1] << 8) |
-            intBytes[static_cast<size_t>(start)];
+        std::promise<bool> promise;
+        promise.set_value(value);
+        return promise.get_future();
     }
-
+    /// Fails requests waiting longer than the request timeout
+    void TimeoutLoop();
+    void StopTimeoutThread();
+    /// Send a request and call handler with the answer
+    void SendRequest(OpCodes opCode, const DataKey& key, const DataBuff& data, ResponseHandler&& handler);
+    std::future<bool> MakeRequestAsync(OpCodes opCode, const DataKey& key, const DataBuff& data);
+    /// Send the items in chunks of MAX_BATCH_COUNT and wait for all answers
+    void MakeBatchRequest(OpCodes opCode, std::vector<BatchItem>& items);
     bool MakeRequest(OpCodes opCode, const DataKey& key, DataBuff& data);
     bool MakeRequestNoData(OpCodes opCode, const DataKey& key);
     bool LockData(const DataKey& key);
@@ -206,31 +394,19 @@ private:
     bool CreateData(const DataKey& key, DataBuff& data);
     bool PreloadData(const DataKey& key);
     bool InvalidateData(const DataKey& key);
-    void InternalConnect();
-    /// Try connect to server.
-    /// @param[in] force If force is true it disconnects first.
-    /// @return true on success.
-    bool TryConnect(bool force, unsigned numTries = 10);
-    /// Try to send some data. If not connected tries to reconnect.
-    template<typename B>
-    bool TryWrite(const B& buffer)
-    {
-        asio::error_code ec;
-        socket_.send(buffer, 0, ec);
-        if (ec)
-        {
-            if (!TryConnect(true))
-                return false;
-            socket_.send(buffer, 0, ec);
-        }
-        return !(bool)ec;
-    }
+    Connection& GetConnection();
 
+    asio::io_service& ioService_;
     std::string host_;
     uint16_t port_{ 0 };
-    asio::ip::tcp::socket socket_;
-    asio::ip::tcp::resolver resolver_;
-    bool connected_{ false };
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::atomic<uint32_t> nextRequestId_{ 0 };
+    std::atomic<size_t> nextConnection_{ 0 };
+    std::atomic<uint32_t> requestTimeout_{ DEFAULT_REQUEST_TIMEOUT_MS };
+    std::mutex timeoutLock_;
+    std::condition_variable timeoutSignal_;
+    bool stopTimeout_{ false };
+    std::thread timeoutThread_;
 };
 
 // RAII Entity locker
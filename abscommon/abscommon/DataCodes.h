@@ -22,9 +22,23 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 namespace IO {
 
+// Request:  OpCode (1) | Request ID (4) | Key size (2) | Data size (4) | Key | Data
+// Response: OpCode (1) | Request ID (4) | Data size (4) | Data
+// A Status response has the data ErrorCode (1) | Message length (1) | Message.
+// All integers are little endian. Responses may arrive in any order.
+// ReadMany, UpdateMany and InvalidateMany have an empty key and the data
+// Count (4) | { Key size (2) | Data size (4) | Key | Data } * Count
+// and are answered with Data
+// Count (4) | { ErrorCode (1) | Data size (4) | Data } * Count
+static constexpr size_t REQUEST_HEADER_SIZE = 11;
+static constexpr size_t RESPONSE_HEADER_SIZE = 9;
+/// Max number of entities in one ReadMany/UpdateMany/InvalidateMany request
+static constexpr size_t MAX_BATCH_COUNT = 128;
+
 enum class OpCodes : uint8_t
 {
     None = 0,
@@ -43,7 +57,12 @@ enum class OpCodes : uint8_t
     Clear,
     // Responses
     Status,
-    Data
+    Data,
+    // Read/Update many entities with one request
+    ReadMany,
+    UpdateMany,
+    // Invalidate many cache items with one request, the item data is empty
+    InvalidateMany
 };
 
 enum class ErrorCodes : uint8_t
@@ -79,6 +79,35 @@ void Dispatcher::Add(Task* task, bool front /* = false */)
         signal_.notify_one();
 }
 
+void Dispatcher::Add(const std::vector<Task*>& tasks, bool front /* = false */)
+{
+    if (tasks.empty())
+        return;
+
+    bool doSignal = false;
+    lock_.lock();
+
+    if (state_ == State::Running)
+    {
+        doSignal = tasks_.empty();
+
+        if (!front)
+            tasks_.insert(tasks_.end(), tasks.begin(), tasks.end());
+        else
+            tasks_.insert(tasks_.begin(), tasks.begin(), tasks.end());
+    }
+    else
+    {
+        for (auto* task : tasks)
+            delete task;
+    }
+
+    lock_.unlock();
+
+    if (doSignal)
+        signal_.notify_one();
+}
+
 void Dispatcher::DispatcherThread()
 {
 #ifdef DEBUG_DISPATCHER
@@ -125,7 +154,7 @@ void Dispatcher::DispatcherThread()
                 const uint32_t busyTime = sa::time::time_elapsed(startExecTime);
                 const uint32_t observationTime = sa::time::time_elapsed(observationStart);
                 if (observationTime != 0)
-                    utilization_ = static_cast<uint32_t>(busyTime / observationTime);
+                    utilization_ = static_cast<uint32_t>((busyTime * 100) / observationTime);
             }
 
             delete task;
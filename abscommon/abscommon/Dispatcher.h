@@ -22,9 +22,11 @@
 #pragma once
 
 #include "Task.h"
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <condition_variable>
 
 namespace Asynch {
@@ -43,12 +45,15 @@ public:
     void Start();
     void Stop();
     void Add(Task* task, bool front = false);
+    /// Add many tasks at once, keeping their order
+    void Add(const std::vector<Task*>& tasks, bool front = false);
     /// CPU Utilization in % something between 0..100
     uint32_t GetUtilization() const
     {
         return utilization_;
     }
 
+    bool IsRunning() const { return state_ == State::Running; }
     bool IsDispatcherThread() const { return (state_ == State::Running) ? thread_.get_id() == std::this_thread::get_id() : false; }
 
     enum class State
@@ -62,7 +67,7 @@ private:
     State state_;
     std::thread thread_;
     std::condition_variable signal_;
-    uint32_t utilization_;
+    std::atomic<uint32_t> utilization_;
     void DispatcherThread();
 };
 
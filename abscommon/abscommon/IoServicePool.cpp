@@ -0,0 +1,215 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "IoServicePool.h"
+#include <algorithm>
+#include <sa/time.h>
+#if defined(AB_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(AB_UNIX)
+#include <pthread.h>
+#include <time.h>
+#endif
+
+namespace Net {
+
+IoServicePool::IoServicePool(asio::io_service& main) :
+    main_(main)
+{
+    services_.push_back(&main_);
+    clocks_.resize(1);
+}
+
+IoServicePool::~IoServicePool()
+{
+    Stop();
+    // Only the handle of the thread calling Run() is ours
+    if (clocks_[0].valid)
+        CloseThreadHandle(clocks_[0].handle);
+}
+
+void IoServicePool::SetNumThreads(size_t value)
+{
+    if (running_ || services_.size() > 1)
+        return;
+    if (value == 0)
+        value = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t i = 1; i < value; ++i)
+    {
+        ownServices_.push_back(std::make_unique<asio::io_service>());
+        services_.push_back(ownServices_.back().get());
+    }
+    clocks_.resize(services_.size());
+}
+
+asio::io_service& IoServicePool::GetNext()
+{
+    const size_t index = next_.fetch_add(1, std::memory_order_relaxed) % services_.size();
+    return *services_[index];
+}
+
+void IoServicePool::Run()
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (running_)
+            return;
+        running_ = true;
+    }
+    // Keep them running when there are no connections
+    for (auto* service : services_)
+        work_.push_back(std::make_unique<WorkGuard>(asio::make_work_guard(*service)));
+    for (size_t i = 1; i < services_.size(); ++i)
+    {
+        asio::io_service* service = services_[i];
+        threads_.emplace_back([service]()
+        {
+            service->run();
+        });
+        SetClock(i, threads_.back().native_handle());
+    }
+
+    std::thread::native_handle_type handle;
+    if (GetThreadHandle(handle))
+        SetClock(0, handle);
+    main_.run();
+    Stop();
+}
+
+void IoServicePool::Stop()
+{
+    std::scoped_lock lock(lock_);
+    if (!running_)
+        return;
+    running_ = false;
+    main_.stop();
+    for (auto& work : work_)
+        work->reset();
+    for (auto& service : ownServices_)
+        service->stop();
+    for (size_t i = 0; i < threads_.size(); ++i)
+    {
+        auto& thread = threads_[i];
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+        {
+            thread.join();
+            clocks_[i + 1].valid = false;
+        }
+    }
+}
+
+void IoServicePool::SetClock(size_t index, std::thread::native_handle_type handle)
+{
+    std::scoped_lock lock(lock_);
+    auto& clock = clocks_[index];
+    clock.handle = handle;
+    clock.valid = true;
+    clock.lastCpu = GetThreadTime(handle);
+    clock.lastWall = sa::time::tick();
+}
+
+uint32_t IoServicePool::GetUtilization(size_t index)
+{
+    std::scoped_lock lock(lock_);
+    if (index >= clocks_.size())
+        return 0;
+    auto& clock = clocks_[index];
+    if (!clock.valid)
+        return 0;
+    const int64_t now = sa::time::tick();
+    const int64_t wall = (now - clock.lastWall) * 1000;
+    // Don't sample too often, the values would be too inaccurate
+    if (wall < 100000)
+        return clock.utilization;
+    const int64_t cpu = GetThreadTime(clock.handle);
+    clock.utilization = static_cast<uint32_t>(std::clamp<int64_t>(((cpu - clock.lastCpu) * 100) / wall, 0, 100));
+    clock.lastCpu = cpu;
+    clock.lastWall = now;
+    return clock.utilization;
+}
+
+uint32_t IoServicePool::GetMaxUtilization()
+{
+    uint32_t result = 0;
+    for (size_t i = 0; i < services_.size(); ++i)
+        result = std::max(result, GetUtilization(i));
+    return result;
+}
+
+#if defined(AB_WINDOWS)
+
+bool IoServicePool::GetThreadHandle(std::thread::native_handle_type& handle)
+{
+    // GetCurrentThread() returns a pseudo handle which is only valid in the calling thread
+    HANDLE result;
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &result,
+        0, FALSE, DUPLICATE_SAME_ACCESS))
+        return false;
+    handle = result;
+    return true;
+}
+
+void IoServicePool::CloseThreadHandle(std::thread::native_handle_type handle)
+{
+    CloseHandle(handle);
+}
+
+int64_t IoServicePool::GetThreadTime(std::thread::native_handle_type handle)
+{
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(handle, &creation, &exit, &kernel, &user))
+        return 0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    // 100ns units
+    return static_cast<int64_t>((k.QuadPart + u.QuadPart) / 10);
+}
+
+#else
+
+bool IoServicePool::GetThreadHandle(std::thread::native_handle_type& handle)
+{
+    handle = pthread_self();
+    return true;
+}
+
+void IoServicePool::CloseThreadHandle(std::thread::native_handle_type)
+{
+}
+
+int64_t IoServicePool::GetThreadTime(std::thread::native_handle_type handle)
+{
+    clockid_t clockId;
+    if (pthread_getcpuclockid(handle, &clockId) != 0)
+        return 0;
+    timespec ts;
+    if (clock_gettime(clockId, &ts) != 0)
+        return 0;
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif
+
+}
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <asio.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sa/Noncopyable.h>
+#include <thread>
+#include <vector>
+
+namespace Net {
+
+/// Runs the io_services of a server on one or more threads. The first io_service
+/// is the main io_service of the server, it is run by the thread calling Run().
+/// Each additional io_service is run by its own thread. Connections are spread
+/// round robin over all io_services, so all handlers of one connection are still
+/// executed by the same thread and don't need a strand.
+class IoServicePool
+{
+    NON_COPYABLE(IoServicePool)
+public:
+    explicit IoServicePool(asio::io_service& main);
+    ~IoServicePool();
+
+    /// Number of threads including the thread calling Run(). Must be set before
+    /// connections are created. 0 = number of CPU cores.
+    void SetNumThreads(size_t value);
+    size_t GetNumThreads() const { return services_.size(); }
+    asio::io_service& GetMain() { return main_; }
+    /// Returns the io_service for a new connection
+    asio::io_service& GetNext();
+    /// Blocks until Stop() is called
+    void Run();
+    void Stop();
+    /// CPU utilization of the thread in % since the last call, something between 0..100
+    uint32_t GetUtilization(size_t index);
+    uint32_t GetMaxUtilization();
+private:
+    using WorkGuard = asio::executor_work_guard<asio::io_service::executor_type>;
+    struct ThreadClock
+    {
+        std::thread::native_handle_type handle{};
+        bool valid{ false };
+        int64_t lastCpu{ 0 };
+        int64_t lastWall{ 0 };
+        uint32_t utilization{ 0 };
+    };
+    static bool GetThreadHandle(std::thread::native_handle_type& handle);
+    static void CloseThreadHandle(std::thread::native_handle_type handle);
+    /// CPU time of the thread in microseconds
+    static int64_t GetThreadTime(std::thread::native_handle_type handle);
+    void SetClock(size_t index, std::thread::native_handle_type handle);
+
+    asio::io_service& main_;
+    std::vector<asio::io_service*> services_;
+    std::vector<std::unique_ptr<asio::io_service>> ownServices_;
+    std::vector<std::unique_ptr<WorkGuard>> work_;
+    std::vector<std::thread> threads_;
+    std::mutex lock_;
+    std::vector<ThreadClock> clocks_;
+    std::atomic<size_t> next_{ 0 };
+    bool running_{ false };
+};
+
+}
@@ -57,6 +57,9 @@ public:
     }
 
     std::optional<AB::GameProtocol::ServerPacketType> GetNext();
+    /// Current position in the buffer of the message
+    size_t GetPos() const { return pos_; }
+    bool IsEof() const { return pos_ >= size_; }
 };
 
 template <>
@@ -58,6 +58,12 @@ enum class MessageType : uint8_t
     TeamsEnterMatch,
     CreateGameInstance,
 
+    /// A player logged in to a game server. Body contains account UUID, character UUID
+    /// and server UUID. The message server uses it to know where players are.
+    PlayerLoggedIn,
+    /// Body contains account UUID and server UUID.
+    PlayerLoggedOut,
+
     __Count
 };
 
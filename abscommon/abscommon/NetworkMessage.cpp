@@ -32,6 +32,8 @@
 
 namespace Net {
 
+std::mutex NetworkMessage::poolLock_;
+
 void NetworkMessage::Delete(NetworkMessage* p)
 {
     auto* pool = GetSubsystem<NetworkMessage::MessagePool>();
@@ -40,6 +42,7 @@ void NetworkMessage::Delete(NetworkMessage* p)
         LOG_ERROR << "No NetworkMessage::MessagePool" << std::endl;
         return;
     }
+    std::scoped_lock lock(poolLock_);
     pool->deallocate(p, 1);
 }
 
@@ -51,7 +54,11 @@ std::unique_ptr<NetworkMessage> NetworkMessage::GetNew()
         LOG_ERROR << "No NetworkMessage::MessagePool" << std::endl;
         return std::unique_ptr<NetworkMessage>();
     }
-    auto* ptr = pool->allocate(1, nullptr);
+    NetworkMessage* ptr;
+    {
+        std::scoped_lock lock(poolLock_);
+        ptr = pool->allocate(1, nullptr);
+    }
     ASSERT(ptr);
     ptr->Reset();
     return std::unique_ptr<NetworkMessage>(ptr);
@@ -65,6 +72,7 @@ sa::PoolInfo NetworkMessage::GetPoolInfo()
         LOG_ERROR << "No NetworkMessage::MessagePool" << std::endl;
         return { };
     }
+    std::scoped_lock lock(poolLock_);
     return pool->GetInfo();
 }
 
@@ -72,7 +80,10 @@ unsigned NetworkMessage::GetPoolUsage()
 {
     auto* pool = GetSubsystem<NetworkMessage::MessagePool>();
     if (pool)
+    {
+        std::scoped_lock lock(poolLock_);
         return pool->GetUsage();
+    }
     return 0;
 }
 
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <sa/PoolAllocator.h>
 #include <sa/Noncopyable.h>
@@ -54,6 +55,9 @@ public:
     static sa::PoolInfo GetPoolInfo();
     static unsigned GetPoolUsage();
     NetworkMessage();
+private:
+    /// Messages are allocated by network and game threads
+    static std::mutex poolLock_;
 protected:
     struct NetworkMessageInfo
     {
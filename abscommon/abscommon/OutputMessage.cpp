@@ -37,16 +37,26 @@ std::mutex PoolWrapper::lock_;
 
 void OutputMessagePool::SendAll()
 {
-    // Dispatcher Thread
-    for (const auto& proto : bufferedProtocols_)
+    // Dispatcher Thread, while other threads add and remove protocols
+    std::vector<std::shared_ptr<Protocol>> protocols;
+    {
+        std::scoped_lock lock(lock_);
+        if (bufferedProtocols_.empty())
+        {
+            // The next AddToAutoSend() schedules it again
+            scheduled_ = false;
+            return;
+        }
+        protocols = bufferedProtocols_;
+    }
+    for (const auto& proto : protocols)
     {
         auto msg = proto->TakeCurrentBuffer();
         if (msg && msg->GetSize() > 0)
             proto->Send(std::move(msg));
     }
 
-    if (!bufferedProtocols_.empty())
-        ScheduleSendAll();
+    ScheduleSendAll();
 }
 
 void OutputMessagePool::ScheduleSendAll()
@@ -78,17 +88,21 @@ sa::SharedPtr<OutputMessage> OutputMessagePool::GetOutputMessage()
 
 void OutputMessagePool::AddToAutoSend(std::shared_ptr<Protocol> protocol)
 {
-    // Dispatcher Thread
-    if (bufferedProtocols_.empty())
+    // Any thread
+    std::scoped_lock lock(lock_);
+    bufferedProtocols_.emplace_back(protocol);
+    if (!scheduled_)
+    {
         // Create first task
+        scheduled_ = true;
         ScheduleSendAll();
-
-    bufferedProtocols_.emplace_back(protocol);
+    }
 }
 
 void OutputMessagePool::RemoveFromAutoSend(const std::shared_ptr<Protocol>& protocol)
 {
-    // Dispatcher Thread
+    // Any thread
+    std::scoped_lock lock(lock_);
     auto it = std::find(bufferedProtocols_.begin(), bufferedProtocols_.end(), protocol);
     if (it != bufferedProtocols_.end())
     {
@@ -24,6 +24,7 @@
 #include "NetworkMessage.h"
 #include "Utils.h"
 #include "Logger.h"
+#include <AB/ProtocolCodes.h>
 #include <sa/PoolAllocator.h>
 #include <sa/SmartPtr.h>
 #include <cstring>
@@ -59,7 +60,7 @@ public:
     OutputMessage();
 
     uint8_t* GetOutputBuffer() { return buffer_ + outputBufferStart_; }
-    bool AddCryptoHeader(bool addChecksum)
+    bool AddCryptoHeader(bool addChecksum, bool compressed = false)
     {
         if (addChecksum)
         {
@@ -67,11 +68,22 @@ public:
             if (!AddHeader<uint32_t>(checksum))
                 return false;
         }
-        return WriteMessageLength();
+        return WriteMessageLength(compressed);
     }
-    bool WriteMessageLength()
+    bool WriteMessageLength(bool compressed = false)
     {
-        return AddHeader<uint16_t>(info_.length);
+        if (!compressed)
+            return AddHeader<uint16_t>(info_.length);
+        return AddHeader<uint16_t>(info_.length | AB::MESSAGE_COMPRESSED_FLAG);
+    }
+    /// Replace the body, e.g. with a compressed version of it. Before any header was added.
+    void SetBody(const uint8_t* data, size_t size)
+    {
+        ASSERT(outputBufferStart_ == INITIAL_BUFFER_POSITION);
+        ASSERT(size <= MaxBodyLength);
+        memcpy(buffer_ + outputBufferStart_, data, size);
+        info_.length = static_cast<MsgSize_t>(size);
+        info_.position = static_cast<MsgSize_t>(outputBufferStart_ + size);
     }
 
     void Append(const NetworkMessage& msg)
@@ -152,13 +164,17 @@ public:
     }
 
     void SendAll();
-    void ScheduleSendAll();
     void AddToAutoSend(std::shared_ptr<Protocol> protocol);
     void RemoveFromAutoSend(const std::shared_ptr<Protocol>& protocol);
 private:
+    void ScheduleSendAll();
     //NOTE: A vector is used here because this container is mostly read
     //and relatively rarely modified (only when a client connects/disconnects)
     std::vector<std::shared_ptr<Protocol>> bufferedProtocols_;
+    /// Protocols are added and removed from network threads and the game threads
+    std::mutex lock_;
+    /// SendAll() is scheduled
+    bool scheduled_{ false };
 };
 
 }
@@ -28,9 +28,26 @@
 #include "Connection.h"
 #include "OutputMessage.h"
 #include "MessageAnalyzer.h"
+#define SA_LZ4_SUPPORT
+#include <sa/compress.h>
+#include <array>
+#include <atomic>
 
 namespace Net {
 
+struct Protocol::Compressor : public sa::lz4_stream_compress<AB::COMPRESSION_HISTORY_SIZE, AB::COMPRESSION_MAX_BLOCK_SIZE>
+{ };
+
+namespace {
+std::atomic<uint64_t> compressedBytesIn{ 0 };
+std::atomic<uint64_t> compressedBytesOut{ 0 };
+}
+
+Protocol::CompressionStats Protocol::GetCompressionStats()
+{
+    return { compressedBytesIn.load(), compressedBytesOut.load() };
+}
+
 Protocol::Protocol(std::shared_ptr<Connection> connection) :
     connection_(connection),
     encryptionEnabled_(false)
@@ -73,6 +90,7 @@ void Protocol::Send(sa::SharedPtr<OutputMessage>&& message)
 
 sa::SharedPtr<OutputMessage> Protocol::TakeCurrentBuffer()
 {
+    std::scoped_lock lock(outputLock_);
     auto curr = std::move(outputBuffer_);
     ResetOutputBuffer();
     return curr;
@@ -102,14 +120,58 @@ bool Protocol::XTEADecrypt(NetworkMessage& msg) const
     return true;
 }
 
-bool Protocol::OnSendMessage(OutputMessage& message) const
+bool Protocol::OnSendMessage(OutputMessage& message)
 {
 #ifdef DEBUG_NET
 //    LOG_DEBUG << "Sending message with size " << message.GetSize() << std::endl;
 #endif
+    // Compress before encrypting, encrypted data doesn't compress
+    const bool compressed = compressor_ && Compress(message);
     if (encryptionEnabled_)
         XTEAEncrypt(message);
-    return message.AddCryptoHeader(true);
+    return message.AddCryptoHeader(true, compressed);
+}
+
+void Protocol::EnableCompression()
+{
+    if (!compressor_)
+        compressor_ = std::make_unique<Compressor>();
+}
+
+bool Protocol::Compress(OutputMessage& message)
+{
+    const size_t size = message.GetSize();
+    if (size == 0 || size > AB::COMPRESSION_MAX_BLOCK_SIZE)
+    {
+        // Sent uncompressed, the client resets its stream then
+        compressor_->reset();
+        return false;
+    }
+
+    // Size of the compressed data followed by the data. It must fit into the message.
+    // Leave room for the XTEA padding.
+    std::array<uint8_t, NetworkMessage::MaxBodyLength> buffer;
+    size_t compressedSize = buffer.size() - NetworkMessage::INITIAL_BUFFER_POSITION - NetworkMessage::XteaMultiple - sizeof(uint16_t);
+    if (!(*compressor_)(reinterpret_cast<const char*>(message.GetOutputBuffer()), size,
+        reinterpret_cast<char*>(buffer.data() + sizeof(uint16_t)), compressedSize))
+    {
+        // The stream may have changed, the client resets its stream with the raw message
+        compressor_->reset();
+        return false;
+    }
+    if (compressedSize + sizeof(uint16_t) >= size)
+    {
+        // Doesn't get smaller, send it raw. The compressor already has it in its
+        // dictionary, but the client won't, so both start over.
+        compressor_->reset();
+        return false;
+    }
+    const uint16_t header = static_cast<uint16_t>(compressedSize);
+    memcpy(buffer.data(), &header, sizeof(header));
+    message.SetBody(buffer.data(), compressedSize + sizeof(uint16_t));
+    compressedBytesIn += size;
+    compressedBytesOut += compressedSize + sizeof(uint16_t);
+    return true;
 }
 
 void Protocol::OnRecvMessage(NetworkMessage& message)
@@ -145,6 +207,12 @@ sa::SharedPtr<OutputMessage> Protocol::GetOutputBuffer(size_t size)
     return outputBuffer_;
 }
 
+void Protocol::AppendToOutput(const NetworkMessage& message)
+{
+    std::scoped_lock lock(outputLock_);
+    GetOutputBuffer(message.GetSize())->Append(message);
+}
+
 void Protocol::ResetOutputBuffer()
 {
     outputBuffer_ = OutputMessagePool::GetOutputMessage();
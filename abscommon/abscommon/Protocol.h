@@ -24,6 +24,8 @@
 #include "Logger.h"
 #include <abcrypto.hpp>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <sa/SmartPtr.h>
 #include <sa/Noncopyable.h>
 
@@ -39,16 +41,35 @@ class Protocol : public std::enable_shared_from_this<Protocol>
 protected:
     std::weak_ptr<Connection> connection_;
     sa::SharedPtr<OutputMessage> outputBuffer_;
+    /// Output may be written from a game thread while the auto send task takes it
+    std::mutex outputLock_;
     bool encryptionEnabled_;
     DH_KEY encKey_;
     void XTEAEncrypt(OutputMessage& msg) const;
     bool XTEADecrypt(NetworkMessage& msg) const;
+    /// Compress outgoing messages from now on. IO thread.
+    void EnableCompression();
 
     void Disconnect() const;
     virtual void Release() {}
 
     friend class Connection;
+private:
+    struct Compressor;
+    /// Compression state of the outgoing stream, used by the IO thread only
+    std::unique_ptr<Compressor> compressor_;
+    bool Compress(OutputMessage& message);
 public:
+    struct CompressionStats
+    {
+        /// Size of the messages
+        uint64_t bytesIn;
+        /// Size of the compressed messages
+        uint64_t bytesOut;
+    };
+    /// Stats of all protocols
+    static CompressionStats GetCompressionStats();
+
     explicit Protocol(std::shared_ptr<Connection> connection);
     virtual ~Protocol();
 
@@ -57,7 +78,7 @@ public:
         memcpy(&encKey_, key, sizeof(encKey_));
     }
 
-    virtual bool OnSendMessage(OutputMessage& message) const;
+    virtual bool OnSendMessage(OutputMessage& message);
     void OnRecvMessage(NetworkMessage& message);
 
     virtual void OnRecvFirstMessage(NetworkMessage& msg) = 0;
@@ -72,6 +93,8 @@ public:
     void ResetOutputBuffer();
     uint32_t GetIP();
     sa::SharedPtr<OutputMessage> TakeCurrentBuffer();
+    /// Append the message to the current output buffer. Thread safe.
+    void AppendToOutput(const NetworkMessage& message);
 
     void Send(sa::SharedPtr<OutputMessage>&& message);
 };
@@ -24,9 +24,87 @@
 #include "Dispatcher.h"
 #include "Logger.h"
 #include "Subsystems.h"
+#include <limits>
 
 namespace Asynch {
 
+namespace {
+
+/// Free list of ScheduledTask memory. It is never destroyed, because tasks may
+/// still be deleted during static destruction.
+class TaskPool
+{
+private:
+    static constexpr size_t MAX_FREE = 4096;
+    std::mutex lock_;
+    std::vector<void*> free_;
+public:
+    TaskPool()
+    {
+        free_.reserve(MAX_FREE);
+    }
+    void* Allocate(size_t size)
+    {
+        if (size == sizeof(ScheduledTask))
+        {
+            std::scoped_lock lock(lock_);
+            if (!free_.empty())
+            {
+                void* result = free_.back();
+                free_.pop_back();
+                return result;
+            }
+        }
+        return ::operator new(size);
+    }
+    void Free(void* p, size_t size)
+    {
+        if (size == sizeof(ScheduledTask))
+        {
+            std::scoped_lock lock(lock_);
+            if (free_.size() < MAX_FREE)
+            {
+                free_.push_back(p);
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+};
+
+TaskPool& GetTaskPool()
+{
+    static TaskPool* pool = new TaskPool();
+    return *pool;
+}
+
+int64_t ToTick(the_clock::time_point time)
+{
+    return std::chrono::ceil<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+int64_t GetTick()
+{
+    return ToTick(the_clock::now());
+}
+
+}
+
+void* ScheduledTask::operator new(size_t size)
+{
+    return GetTaskPool().Allocate(size);
+}
+
+void ScheduledTask::operator delete(void* p, size_t size)
+{
+    GetTaskPool().Free(p, size);
+}
+
+Scheduler::Scheduler() :
+    state_(State::Terminated),
+    nextWakeup_(std::numeric_limits<int64_t>::max())
+{ }
+
 void Scheduler::SchedulerThread()
 {
 #ifdef DEBUG_SCHEDULER
@@ -36,52 +114,77 @@ void Scheduler::SchedulerThread()
     std::unique_lock<std::mutex> lockUnique(lock_, std::defer_lock);
     while (state_ != State::Terminated)
     {
-        ScheduledTask* task = nullptr;
-        std::cv_status ret = std::cv_status::no_timeout;
-
         lockUnique.lock();
 
-        if (events_.empty())
+        const int64_t next = wheel_.GetNextExpiration();
+        if (next < 0)
         {
+            nextWakeup_ = std::numeric_limits<int64_t>::max();
             signal_.wait(lockUnique);
         }
-        else
+        else if (next > GetTick())
         {
-            ret = signal_.wait_until(
-                lockUnique,
-                events_.top()->GetCycle()
-            );
+            nextWakeup_ = next;
+            signal_.wait_until(lockUnique, the_clock::time_point(std::chrono::milliseconds(next)));
+        }
+
+        if (state_ == State::Terminated)
+        {
+            lockUnique.unlock();
+            break;
         }
 
-        if (ret == std::cv_status::timeout)
+        wheel_.Advance(GetTick(), [this](TimerNode* node)
         {
-            // Timeout
-            task = events_.top();
-            events_.pop();
+            auto* task = static_cast<ScheduledTask*>(node);
+            events_.erase(task->GetEventId());
+            expired_.push_back(task);
+        });
+        lockUnique.unlock();
 
-            auto it = eventIds_.find(task->GetEventId());
-            if (it == eventIds_.end())
+        if (!expired_.empty())
+            DispatchExpired();
+    }
+#ifdef DEBUG_SCHEDULER
+    LOG_DEBUG << "Scheduler threat stopped" << std::endl;
+#endif
+}
+
+void Scheduler::DispatchExpired()
+{
+    // Scheduler Thread
+    auto* defaultDispatcher = GetSubsystem<Asynch::Dispatcher>();
+    // Usually all tasks go to the same Dispatcher, so this loop runs once
+    while (!expired_.empty())
+    {
+        Dispatcher* disp = expired_.front()->GetDispatcher();
+        if (!disp)
+            disp = defaultDispatcher;
+        auto it = expired_.begin();
+        while (it != expired_.end())
+        {
+            ScheduledTask* task = *it;
+            Dispatcher* taskDisp = task->GetDispatcher();
+            if (!taskDisp)
+                taskDisp = defaultDispatcher;
+            if (taskDisp != disp)
             {
-                lockUnique.unlock();
-                delete task;
+                ++it;
                 continue;
             }
-
-            eventIds_.erase(it);
-            lockUnique.unlock();
-
             task->SetDontExpires();
-            auto* disp = GetSubsystem<Asynch::Dispatcher>();
-            if (disp)
-                disp->Add(task, true);
+            batch_.push_back(task);
+            it = expired_.erase(it);
         }
+        if (disp)
+            disp->Add(batch_, true);
         else
-            lockUnique.unlock();
-
+        {
+            for (auto* task : batch_)
+                delete task;
+        }
+        batch_.clear();
     }
-#ifdef DEBUG_SCHEDULER
-    LOG_DEBUG << "Scheduler threat stopped" << std::endl;
-#endif
 }
 
 uint32_t Scheduler::Add(ScheduledTask* task)
@@ -97,13 +200,25 @@ uint32_t Scheduler::Add(ScheduledTask* task)
             if (task->GetEventId() == 0)
                 // Generate new ID
                 task->SetEventId(idGenerator_.Next());
-            // Insert this ID in the list of active events
-            eventIds_.insert(task->GetEventId());
 
-            // Add it to the Queue
-            events_.push(task);
-            // Signal if the list was empty or this event is at the top
-            doSignal = (task == events_.top());
+            auto it = events_.find(task->GetEventId());
+            if (it != events_.end())
+            {
+                // Adding a task with the ID of a pending task replaces it
+                wheel_.Remove((*it).second);
+                delete (*it).second;
+                (*it).second = task;
+            }
+            else
+                events_.emplace(task->GetEventId(), task);
+
+            if (wheel_.IsEmpty())
+                // The thread doesn't advance an empty wheel, catch up now
+                wheel_.Reset(GetTick());
+            const int64_t expires = ToTick(task->GetCycle());
+            wheel_.Add(task, expires);
+            // Signal if this task expires before the thread wakes up
+            doSignal = expires < nextWakeup_;
 
 #ifdef DEBUG_SCHEDULER
             LOG_DEBUG << "Added event " << task->GetEventId() << std::endl;
@@ -134,10 +249,13 @@ bool Scheduler::StopEvent(uint32_t eventId)
 
     std::scoped_lock lock(lock_);
 
-    auto it = eventIds_.find(eventId);
-    if (it != eventIds_.end())
+    auto it = events_.find(eventId);
+    if (it != events_.end())
     {
-        eventIds_.erase(it);
+        ScheduledTask* task = (*it).second;
+        events_.erase(it);
+        wheel_.Remove(task);
+        delete task;
         return true;
     }
 
@@ -149,6 +267,7 @@ void Scheduler::Start()
 {
     if (state_ != State::Running)
     {
+        wheel_.Reset(GetTick());
         state_ = State::Running;
         thread_ = std::thread(&Scheduler::SchedulerThread, this);
     }
@@ -161,13 +280,12 @@ void Scheduler::Stop()
         {
             std::scoped_lock lock(lock_);
             state_ = State::Terminated;
-            while (!events_.empty())
+            for (const auto& e : events_)
             {
-                ScheduledTask* task = events_.top();
-                events_.pop();
-                delete task;
+                wheel_.Remove(e.second);
+                delete e.second;
             }
-            eventIds_.clear();
+            events_.clear();
         }
 
         signal_.notify_one();
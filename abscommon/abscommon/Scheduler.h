@@ -22,38 +22,50 @@
 #pragma once
 
 #include "Task.h"
-#include <set>
-#include <queue>
-#include <mutex>
+#include "TimerWheel.h"
 #include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include <sa/IdGenerator.h>
 
 namespace Asynch {
 
+class Dispatcher;
+
 inline constexpr uint32_t SCHEDULER_MINTICKS = 10u;
 
-class ScheduledTask : public Task
+class ScheduledTask : public Task, public TimerNode
 {
 public:
-    ~ScheduledTask() {}
+    ~ScheduledTask() override {}
     void SetEventId(uint32_t eventId) { eventId_ = eventId; }
     uint32_t GetEventId() const { return eventId_; }
+    /// Set the Dispatcher which executes this task. If not set, it runs on the
+    /// default Dispatcher.
+    void SetDispatcher(Dispatcher* dispatcher) { dispatcher_ = dispatcher; }
+    Dispatcher* GetDispatcher() const { return dispatcher_; }
     the_clock::time_point GetCycle() const { return expiration_; }
     bool operator < (const ScheduledTask& rhs) const
     {
         return GetCycle() > rhs.GetCycle();
     }
+    /// Scheduled tasks are created and deleted all the time, so they come from a pool.
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
 protected:
     ScheduledTask(uint32_t delay, std::function<void(void)>&& f) :
         Task(delay, std::move(f)),
-        eventId_(0)
+        eventId_(0),
+        dispatcher_(nullptr)
     {}
 
     friend ScheduledTask* CreateScheduledTask(uint32_t delay, std::function<void(void)>&&);
     friend ScheduledTask* CreateScheduledTask(std::function<void(void)>&&);
 private:
     uint32_t eventId_;
+    Dispatcher* dispatcher_;
 };
 
 inline ScheduledTask* CreateScheduledTask(std::function<void(void)>&& f)
@@ -68,14 +80,6 @@ inline ScheduledTask* CreateScheduledTask(uint32_t delay, std::function<void(voi
     return new ScheduledTask(delay, std::move(f));
 }
 
-struct TaskComparator
-{
-    bool operator()(const ScheduledTask* lhs, const ScheduledTask* rhs) const
-    {
-        return lhs->GetCycle() > rhs->GetCycle();
-    }
-};
-
 class Scheduler
 {
 public:
@@ -87,15 +91,20 @@ private:
     State state_;
     std::mutex lock_;
     std::condition_variable signal_;
-    std::set<uint32_t> eventIds_;
+    /// Pending tasks by event ID
+    std::unordered_map<uint32_t, ScheduledTask*> events_;
     std::thread thread_;
-    std::priority_queue<ScheduledTask*, std::deque<ScheduledTask*>, TaskComparator> events_;
+    TimerWheel wheel_;
+    /// When the thread wakes up next, so Add() knows if it must signal
+    int64_t nextWakeup_;
+    /// Expired tasks, handed over to the Dispatcher in one batch
+    std::vector<ScheduledTask*> expired_;
+    std::vector<Task*> batch_;
     sa::IdGenerator<uint32_t> idGenerator_;
     void SchedulerThread();
+    void DispatchExpired();
 public:
-    Scheduler() :
-        state_(State::Terminated)
-    {}
+    Scheduler();
     ~Scheduler() = default;
 
     /// Add a Task, return EventID
@@ -22,6 +22,7 @@
 
 #include "Service.h"
 #include "Connection.h"
+#include "IoServicePool.h"
 #include "Scheduler.h"
 #include "NetworkMessage.h"
 #include "Logger.h"
@@ -168,8 +169,10 @@ void ServicePort::Accept()
             LOG_ERROR << "No ConnectionManager subsystem!" << std::endl;
             return;
         }
+        // With more network threads the connection may run on another io_service
+        auto* pool = GetSubsystem<IoServicePool>();
         std::shared_ptr<Connection> conn = connMan->CreateConnection(
-            service_, shared_from_this()
+            pool ? pool->GetNext() : service_, shared_from_this()
         );
 
         if (conn)
@@ -42,7 +42,7 @@ public:
         expires_(false),
         function_(std::move(f))
     {}
-    ~Task() = default;
+    virtual ~Task() = default;
 
     /// Execute function
     void operator()()
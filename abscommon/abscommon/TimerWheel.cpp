@@ -0,0 +1,152 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "TimerWheel.h"
+#include <sa/Assert.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Asynch {
+
+static inline unsigned CountTrailingZeros(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long result;
+    _BitScanForward64(&result, value);
+    return static_cast<unsigned>(result);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+TimerWheel::TimerWheel(int64_t now) :
+    current_(now)
+{
+    for (unsigned level = 0; level < LEVELS; ++level)
+    {
+        for (unsigned slot = 0; slot < SLOTS; ++slot)
+        {
+            TimerNode& head = slots_[level][slot];
+            head.prev_ = &head;
+            head.next_ = &head;
+        }
+        for (unsigned i = 0; i < SLOTS / 64; ++i)
+            occupied_[level][i] = 0;
+    }
+}
+
+void TimerWheel::Reset(int64_t now)
+{
+    ASSERT(count_ == 0);
+    current_ = now;
+}
+
+void TimerWheel::Link(TimerNode* node)
+{
+    int64_t expires = node->expires_;
+    if (expires < current_)
+        expires = current_;
+    int64_t diff = expires - current_;
+    unsigned level = 0;
+    while (level < LEVELS - 1 && diff >= (int64_t(1) << ((level + 1) * SLOT_BITS)))
+        ++level;
+    if (level == LEVELS - 1)
+    {
+        // Out of range nodes are put into the farthest slot and cascaded down again
+        const int64_t range = (int64_t(1) << (LEVELS * SLOT_BITS)) - 1;
+        if (diff > range)
+            expires = current_ + range;
+    }
+    const unsigned slot = static_cast<unsigned>((expires >> (level * SLOT_BITS)) & SLOT_MASK);
+
+    TimerNode& head = slots_[level][slot];
+    node->level_ = static_cast<uint16_t>(level);
+    node->slot_ = static_cast<uint16_t>(slot);
+    node->prev_ = head.prev_;
+    node->next_ = &head;
+    head.prev_->next_ = node;
+    head.prev_ = node;
+    occupied_[level][slot / 64] |= (uint64_t(1) << (slot % 64));
+    ++count_;
+}
+
+void TimerWheel::Unlink(TimerNode* node)
+{
+    node->prev_->next_ = node->next_;
+    node->next_->prev_ = node->prev_;
+    TimerNode& head = slots_[node->level_][node->slot_];
+    if (head.next_ == &head)
+        occupied_[node->level_][node->slot_ / 64] &= ~(uint64_t(1) << (node->slot_ % 64));
+    node->prev_ = nullptr;
+    node->next_ = nullptr;
+    --count_;
+}
+
+void TimerWheel::Cascade(unsigned level, unsigned slot)
+{
+    TimerNode& head = slots_[level][slot];
+    while (head.next_ != &head)
+    {
+        TimerNode* node = head.next_;
+        Unlink(node);
+        Link(node);
+    }
+}
+
+unsigned TimerWheel::FindOccupied(unsigned level, unsigned start) const
+{
+    for (unsigned i = start / 64; i < SLOTS / 64; ++i)
+    {
+        uint64_t bits = occupied_[level][i];
+        if (i == start / 64)
+            bits &= ~((uint64_t(1) << (start % 64)) - 1);
+        if (bits != 0)
+            return i * 64 + CountTrailingZeros(bits);
+    }
+    return SLOTS;
+}
+
+void TimerWheel::Add(TimerNode* node, int64_t expires)
+{
+    ASSERT(!node->IsLinked());
+    node->expires_ = expires;
+    Link(node);
+}
+
+void TimerWheel::Remove(TimerNode* node)
+{
+    if (node->IsLinked())
+        Unlink(node);
+}
+
+int64_t TimerWheel::GetNextExpiration() const
+{
+    if (count_ == 0)
+        return -1;
+    const unsigned index = static_cast<unsigned>(current_ & SLOT_MASK);
+    // When there is nothing in this round, wake up at the start of the next round
+    // to cascade the higher levels.
+    const unsigned next = FindOccupied(0, index);
+    return (current_ & ~static_cast<int64_t>(SLOT_MASK)) + next;
+}
+
+}
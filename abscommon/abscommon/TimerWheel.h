@@ -0,0 +1,129 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sa/Noncopyable.h>
+
+namespace Asynch {
+
+class TimerWheel;
+
+/// Intrusive node of the TimerWheel. Objects which are scheduled inherit from this.
+class TimerNode
+{
+    NON_COPYABLE(TimerNode)
+    friend class TimerWheel;
+private:
+    TimerNode* prev_{ nullptr };
+    TimerNode* next_{ nullptr };
+    int64_t expires_{ 0 };
+    uint16_t level_{ 0 };
+    uint16_t slot_{ 0 };
+public:
+    TimerNode() = default;
+    bool IsLinked() const { return next_ != nullptr; }
+    int64_t GetExpires() const { return expires_; }
+};
+
+/// Hierarchical timing wheel with a resolution of 1ms. Adding and removing a
+/// node is O(1). Not thread safe.
+class TimerWheel
+{
+    NON_COPYABLE(TimerWheel)
+public:
+    static constexpr unsigned SLOT_BITS = 8;
+    static constexpr unsigned SLOTS = 1u << SLOT_BITS;
+    static constexpr unsigned SLOT_MASK = SLOTS - 1;
+    static constexpr unsigned LEVELS = 4;
+private:
+    /// Sentinels of the circular lists
+    TimerNode slots_[LEVELS][SLOTS];
+    /// One bit for each non empty slot
+    uint64_t occupied_[LEVELS][SLOTS / 64];
+    /// The next tick which is not yet processed
+    int64_t current_{ 0 };
+    size_t count_{ 0 };
+    void Link(TimerNode* node);
+    void Unlink(TimerNode* node);
+    void Cascade(unsigned level, unsigned slot);
+    /// Returns the first non empty slot >= start or SLOTS
+    unsigned FindOccupied(unsigned level, unsigned start) const;
+public:
+    explicit TimerWheel(int64_t now = 0);
+    ~TimerWheel() = default;
+
+    void Add(TimerNode* node, int64_t expires);
+    void Remove(TimerNode* node);
+    /// Set the current time. The wheel must be empty.
+    void Reset(int64_t now);
+    /// Process all ticks up to and including now and call callback(TimerNode*) for
+    /// each expired node. The node is already removed when callback is called.
+    template<typename Callback>
+    void Advance(int64_t now, Callback&& callback);
+    /// Returns the tick when the wheel must be advanced next or -1 when it is empty.
+    int64_t GetNextExpiration() const;
+    size_t GetCount() const { return count_; }
+    bool IsEmpty() const { return count_ == 0; }
+    int64_t GetCurrent() const { return current_; }
+};
+
+template<typename Callback>
+void TimerWheel::Advance(int64_t now, Callback&& callback)
+{
+    while (current_ <= now)
+    {
+        const unsigned index = static_cast<unsigned>(current_ & SLOT_MASK);
+        if (index == 0)
+        {
+            // Start of a new round, move the nodes of the next higher levels down
+            for (unsigned level = 1; level < LEVELS; ++level)
+            {
+                const unsigned slot = static_cast<unsigned>((current_ >> (level * SLOT_BITS)) & SLOT_MASK);
+                Cascade(level, slot);
+                if (slot != 0)
+                    break;
+            }
+        }
+
+        TimerNode& head = slots_[0][index];
+        while (head.next_ != &head)
+        {
+            TimerNode* node = head.next_;
+            Unlink(node);
+            callback(node);
+        }
+
+        if (count_ == 0)
+        {
+            current_ = now + 1;
+            break;
+        }
+        // Skip empty slots, but never beyond now, new nodes are added relative to current_
+        const unsigned next = FindOccupied(0, index + 1);
+        const int64_t nextTick = (current_ & ~static_cast<int64_t>(SLOT_MASK)) + next;
+        current_ = (nextTick < now + 1) ? nextTick : now + 1;
+    }
+}
+
+}
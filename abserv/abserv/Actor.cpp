@@ -387,16 +387,12 @@ void Actor::DropRandomItem()
             // Drop nothing when no target
             return;
 
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::AddRandomItemDropFor, game, this, target))
-        );
+        game->Schedule(std::bind(&Game::AddRandomItemDropFor, game, this, target));
     }
     else
     {
         // Not killed by an actor, drop for any player in game
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::AddRandomItemDrop, game, this))
-        );
+        game->Schedule(std::bind(&Game::AddRandomItemDrop, game, this));
     }
 }
 
@@ -21,7 +21,10 @@
 
 
 #include "AiComp.h"
+#include "Game.h"
 #include "Npc.h"
+#include "Player.h"
+#include "SkillsComp.h"
 
 namespace Game {
 namespace Components {
@@ -29,12 +32,79 @@ namespace Components {
 AiComp::AiComp(Npc& owner) :
     owner_(owner),
     agent_(owner)
-{ }
+{
+    // Spread the NPCs created in the same tick over the update interval
+    phase_ = owner_.GetId() % AI_UPDATE_INTERVAL_FAR;
+}
+
+bool AiComp::IsInCombat() const
+{
+    return owner_.IsAttacked() || owner_.attackComp_->IsAttackState() || owner_.skillsComp_->IsUsing();
+}
+
+bool AiComp::IsPlayerInRange(Ranges range) const
+{
+    auto game = owner_.GetGame();
+    if (!game)
+        return false;
+    bool result = false;
+    game->VisitPlayers([&](Player* player)
+    {
+        if (player && owner_.IsInRange(range, player))
+        {
+            result = true;
+            return Iteration::Break;
+        }
+        return Iteration::Continue;
+    });
+    return result;
+}
+
+uint32_t AiComp::GetInterval() const
+{
+    switch (detail_)
+    {
+    case Detail::Active:
+        return 0;
+    case Detail::Near:
+        return AI_UPDATE_INTERVAL_NEAR;
+    case Detail::Far:
+        return AI_UPDATE_INTERVAL_FAR;
+    }
+    return 0;
+}
+
+float AiComp::GetUrgency(uint32_t tick) const
+{
+    // Active agents have no interval, and tick may be 0
+    const uint32_t interval = std::max({ GetInterval(), tick, 1u });
+    return static_cast<float>(elapsed_ + phase_) / static_cast<float>(interval);
+}
+
+bool AiComp::Tick(uint32_t timeElapsed)
+{
+    if (owner_.IsDead())
+    {
+        elapsed_ = 0;
+        return false;
+    }
+    elapsed_ += timeElapsed;
+
+    if (IsInCombat() || IsPlayerInRange(Ranges::Compass))
+        detail_ = Detail::Active;
+    else if (IsPlayerInRange(Ranges::Interest))
+        detail_ = Detail::Near;
+    else
+        detail_ = Detail::Far;
+
+    return elapsed_ + phase_ >= GetInterval();
+}
 
-void AiComp::Update(uint32_t timeElapsed)
+void AiComp::Update()
 {
-    if (!owner_.IsDead())
-        agent_.Update(timeElapsed);
+    agent_.Update(elapsed_);
+    elapsed_ = 0;
+    phase_ = 0;
 }
 
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "AiAgent.h"
+#include <abshared/Mechanic.h>
 #include <sa/Noncopyable.h>
 
 namespace Game {
@@ -34,15 +35,41 @@ class AiComp
 {
     NON_COPYABLE(AiComp)
     NON_MOVEABLE(AiComp)
+public:
+    /// How often the BT runs, depends on what happens around the NPC
+    enum class Detail
+    {
+        /// Fighting or a player in compass range, run every tick
+        Active,
+        /// A player in interest range
+        Near,
+        /// Nobody cares
+        Far
+    };
 private:
     Npc& owner_;
     AI::AiAgent agent_;
+    Detail detail_{ Detail::Active };
+    /// Time since the BT was executed the last time
+    uint32_t elapsed_{ 0 };
+    /// Makes the first run due earlier, so NPCs created in the same tick don't
+    /// all run in the same tick. Doesn't count as elapsed time.
+    uint32_t phase_{ 0 };
     AiComp() = delete;
+    bool IsInCombat() const;
+    bool IsPlayerInRange(Ranges range) const;
 public:
     explicit AiComp(Npc& owner);
     ~AiComp() = default;
 
-    void Update(uint32_t timeElapsed);
+    /// Called by the AiScheduler each tick. Returns true when the BT is due.
+    bool Tick(uint32_t timeElapsed);
+    /// Execute the BT with the time elapsed since the last run
+    void Update();
+    Detail GetDetail() const { return detail_; }
+    uint32_t GetInterval() const;
+    /// How much the BT is overdue in relation to its interval, 1 means right on time
+    float GetUrgency(uint32_t tick) const;
     AI::AiAgent& GetAgent() { return agent_; }
 };
 
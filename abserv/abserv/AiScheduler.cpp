@@ -0,0 +1,76 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "AiScheduler.h"
+#include "AiComp.h"
+#include "Game.h"
+#include "Npc.h"
+#include <chrono>
+
+namespace Game {
+
+AiScheduler::AiScheduler(int64_t budgetUs) :
+    budgetUs_(budgetUs)
+{ }
+
+void AiScheduler::Update(Game& game, uint32_t timeElapsed)
+{
+    due_.clear();
+    stats_ = {};
+    game.VisitObjects<Npc>([&](Npc& current)
+    {
+        if (!current.aiComp_)
+            return Iteration::Continue;
+        ++stats_.agents;
+        if (current.aiComp_->Tick(timeElapsed))
+            due_.push_back({ current.GetId(), current.aiComp_->GetUrgency(timeElapsed) });
+        return Iteration::Continue;
+    });
+    if (due_.empty())
+        return;
+
+    ea::sort(due_.begin(), due_.end(), [](const DueItem& lhs, const DueItem& rhs)
+    {
+        return lhs.urgency > rhs.urgency;
+    });
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    for (const auto& item : due_)
+    {
+        // Run at least one, so all agents make progress even with a tiny budget
+        if (stats_.executed != 0)
+        {
+            const auto used = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+            if (used >= budgetUs_)
+                break;
+        }
+        ++stats_.executed;
+        Npc* npc = game.GetObject<Npc>(item.npcId);
+        if (npc && npc->aiComp_)
+            npc->aiComp_->Update();
+    }
+    stats_.deferred = due_.size() - stats_.executed;
+    stats_.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+}
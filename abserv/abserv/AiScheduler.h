@@ -0,0 +1,67 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <eastl.hpp>
+#include <sa/Noncopyable.h>
+
+namespace Game {
+
+class Game;
+
+/// Runs the behavior trees of the NPCs of a game. NPCs far away from players run
+/// less often, and the time spent per tick is capped. Agents which didn't get their
+/// turn keep the elapsed time and are the first in the next tick.
+class AiScheduler
+{
+    NON_COPYABLE(AiScheduler)
+    NON_MOVEABLE(AiScheduler)
+public:
+    struct Stats
+    {
+        size_t agents{ 0 };
+        size_t executed{ 0 };
+        /// Due but deferred because the budget was used up
+        size_t deferred{ 0 };
+        int64_t timeUs{ 0 };
+    };
+private:
+    struct DueItem
+    {
+        /// The NPC, not its AiComp. A BT may run Lua which removes an NPC or
+        /// replaces its AiComp, so it's looked up again before it runs.
+        uint32_t npcId;
+        float urgency;
+    };
+    ea::vector<DueItem> due_;
+    Stats stats_;
+    int64_t budgetUs_;
+public:
+    explicit AiScheduler(int64_t budgetUs);
+    ~AiScheduler() = default;
+
+    void Update(Game& game, uint32_t timeElapsed);
+    const Stats& GetStats() const { return stats_; }
+};
+
+}
@@ -28,8 +28,10 @@
 #include "DataProvider.h"
 #include "EffectManager.h"
 #include "Game.h"
+#include "GameExecutor.h"
 #include "GameManager.h"
 #include "GuildManager.h"
+#include "IOScript.h"
 #include "ItemFactory.h"
 #include "ItemsCache.h"
 #include "Maintenance.h"
@@ -51,6 +53,7 @@
 #include <abai/Dump.h>
 #include <abscommon/BanManager.h>
 #include <abscommon/CpuUsage.h>
+#include <abscommon/IoServicePool.h>
 #include <abscommon/Logo.h>
 #include <abscommon/MessageClient.h>
 #include <abscommon/MessageMsg.h>
@@ -87,6 +90,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<Asynch::ThreadPool>();
     Subsystems::Instance.CreateSubsystem<Net::ConnectionManager>();
+    Subsystems::Instance.CreateSubsystem<Net::IoServicePool>(ioService_);
     Subsystems::Instance.CreateSubsystem<IO::DataClient>(ioService_);
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(ioService_);
 
@@ -96,6 +100,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<IO::DataProvider>();
 
     Subsystems::Instance.CreateSubsystem<Auth::BanManager>();
+    Subsystems::Instance.CreateSubsystem<Game::GameExecutor>();
     Subsystems::Instance.CreateSubsystem<Game::GameManager>();
     Subsystems::Instance.CreateSubsystem<Game::PlayerManager>();
     Subsystems::Instance.CreateSubsystem<Game::PartyManager>();
@@ -122,6 +127,7 @@ Application::~Application()
     GetSubsystem<Net::ConnectionManager>()->CloseAll();
     GetSubsystem<Asynch::ThreadPool>()->Stop();
     GetSubsystem<Asynch::Scheduler>()->Stop();
+    GetSubsystem<Game::GameExecutor>()->Stop();
     GetSubsystem<Asynch::Dispatcher>()->Stop();
 }
 
@@ -344,8 +350,14 @@ bool Application::LoadMain()
         serverLocation_ = (*config)[ConfigManager::Key::Location].GetString();
     Net::ProtocolGame::serverId_ = GetServerId();
     GetSubsystem<IO::DataProvider>()->watchFiles_ = (*config)[ConfigManager::Key::WatchAssets].GetBool();
+    IO::IOScript::cacheDir_ = (*config)[ConfigManager::Key::ScriptCacheDir].GetString();
+    Game::Lua::GcManager::tickBudgetUs = (*config)[ConfigManager::Key::LuaGcBudget].GetInt64();
 
     Net::ConnectionManager::maxPacketsPerSec = static_cast<uint32_t>((*config)[ConfigManager::Key::MaxPacketsPerSecond].GetInt64());
+    auto* gameExecutor = GetSubsystem<Game::GameExecutor>();
+    gameExecutor->SetNumWorkers(static_cast<size_t>((*config)[ConfigManager::Key::GameThreads].GetInt()));
+    gameExecutor->Start();
+    GetSubsystem<Net::IoServicePool>()->SetNumThreads(static_cast<size_t>((*config)[ConfigManager::Key::NetworkThreads].GetInt()));
     // Not relevant for the game server since it does not count login attempts,
     // because the player authenticates with a token from the login server.
     Auth::BanManager::LoginTries = 0;
@@ -417,8 +429,9 @@ bool Application::LoadMain()
     LOG_INFO << "Connecting to data server...";
     const std::string& dataHost = (*config)[ConfigManager::Key::DataServerHost].GetString();
     uint16_t dataPort = static_cast<uint16_t>((*config)[ConfigManager::Key::DataServerPort].GetInt());
+    const size_t dataConnections = static_cast<size_t>((*config)[ConfigManager::Key::DataServerConnections].GetInt());
     auto* dataClient = GetSubsystem<IO::DataClient>();
-    dataClient->Connect(dataHost, dataPort);
+    dataClient->Connect(dataHost, dataPort, dataConnections);
     if (!dataClient->IsConnected())
     {
         LOG_INFO << "[FAIL]" << std::endl;
@@ -550,7 +563,11 @@ void Application::PrintServerInfo()
     LOG_INFO << "  Recording games: " << (*config)[ConfigManager::Key::RecordGames].GetBool() << std::endl;
     const std::string& recDir = (*config)[ConfigManager::Key::RecordingsDir].GetString();
     LOG_INFO << "  Recording directory: " << (recDir.empty() ? "(empty)" : recDir) << std::endl;
+    LOG_INFO << "  Script cache: " << (IO::IOScript::cacheDir_.empty() ? "(disabled)" : IO::IOScript::cacheDir_) << std::endl;
     LOG_INFO << "  Background threads: " << GetSubsystem<Asynch::ThreadPool>()->GetNumThreads() << std::endl;
+    LOG_INFO << "  Game threads: " << GetSubsystem<Game::GameExecutor>()->GetNumWorkers() << std::endl;
+    LOG_INFO << "  Network threads: " << GetSubsystem<Net::IoServicePool>()->GetNumThreads() << std::endl;
+    LOG_INFO << "  Lua GC budget: " << Game::Lua::GcManager::tickBudgetUs << "us" << std::endl;
     if ((*config)[ConfigManager::Key::AiServer])
     {
         const std::string& sAiIp = (*config)[ConfigManager::Key::AiServerIp].GetString();
@@ -612,7 +629,7 @@ void Application::Run()
 
     running_ = true;
     serviceManager_->Run();
-    ioService_.run();
+    GetSubsystem<Net::IoServicePool>()->Run();
 }
 
 void Application::Stop()
@@ -683,7 +700,7 @@ void Application::Stop()
     maintenance_->Stop();
 
     msgClient->Close();
-    ioService_.stop();
+    GetSubsystem<Net::IoServicePool>()->Stop();
 }
 
 std::string Application::GetKeysFile() const
@@ -704,7 +721,10 @@ unsigned Application::GetLoad()
         float ld = (static_cast<float>(playerCount) / static_cast<float>(SERVER_MAX_CONNECTIONS)) * 100.0f;
         unsigned load = static_cast<unsigned>(ld);
 
-        load = std::max(load, GetSubsystem<Asynch::Dispatcher>()->GetUtilization());
+        // The busiest game thread limits how many games we can still take
+        load = std::max(load, GetSubsystem<Game::GameExecutor>()->GetMaxUtilization());
+        // Same for the busiest network thread
+        load = std::max(load, GetSubsystem<Net::IoServicePool>()->GetMaxUtilization());
         load = std::max(load, usage.GetUsage());
 
         {
@@ -67,16 +67,14 @@ AreaOfEffect::AreaOfEffect() :
     // AOE usually not colliding
     SetCollisionLayer(0);
     selectable_ = false;
-
-    InitializeLua();
 }
 
 AreaOfEffect::~AreaOfEffect() = default;
 
-void AreaOfEffect::InitializeLua()
+void AreaOfEffect::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
     luaInitialized_ = true;
 }
 
@@ -98,34 +96,37 @@ bool AreaOfEffect::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    // The game is set before the script is loaded, so it can run in the VM of the game
+    auto game = GetGame();
+    InitializeLua(game ? game->GetScriptState() : ea::shared_ptr<Lua::SharedState>());
+    if (!script->Execute(luaEnv_))
         return false;
 
-    if (Lua::IsNumber(luaState_, "itemIndex"))
-        itemIndex_ = luaState_["itemIndex"];
+    if (Lua::IsNumber(luaEnv_, "itemIndex"))
+        itemIndex_ = luaEnv_["itemIndex"];
     else
         LOG_WARNING << "AOE " << fileName << " does not have an itemIndex" << std::endl;
-    if (Lua::IsNumber(luaState_, "creatureState"))
-        stateComp_.SetState(luaState_["creatureState"], true);
+    if (Lua::IsNumber(luaEnv_, "creatureState"))
+        stateComp_.SetState(luaEnv_["creatureState"], true);
     else
         stateComp_.SetState(AB::GameProtocol::CreatureState::Idle, true);
-    if (Lua::IsNumber(luaState_, "effect"))
-        skillEffect_ = luaState_["effect"];
-    if (Lua::IsNumber(luaState_, "effectTarget"))
-        effectTarget_ = luaState_["effectTarget"];
+    if (Lua::IsNumber(luaEnv_, "effect"))
+        skillEffect_ = luaEnv_["effect"];
+    if (Lua::IsNumber(luaEnv_, "effectTarget"))
+        effectTarget_ = luaEnv_["effectTarget"];
 
-    if (Lua::IsFunction(luaState_, "onUpdate"))
+    if (Lua::IsFunction(luaEnv_, "onUpdate"))
         sa::bits::set(functions_, FunctionUpdate);
-    if (Lua::IsFunction(luaState_, "onEnded"))
+    if (Lua::IsFunction(luaEnv_, "onEnded"))
         sa::bits::set(functions_, FunctionEnded);
-    if (Lua::IsFunction(luaState_, "onCollide"))
+    if (Lua::IsFunction(luaEnv_, "onCollide"))
         sa::bits::set(functions_, FunctionOnCollide);
-    if (Lua::IsFunction(luaState_, "onTrigger"))
+    if (Lua::IsFunction(luaEnv_, "onTrigger"))
         sa::bits::set(functions_, FunctionOnTrigger);
-    if (Lua::IsFunction(luaState_, "onLeftArea"))
+    if (Lua::IsFunction(luaEnv_, "onLeftArea"))
         sa::bits::set(functions_, FunctionOnLeftArea);
 
-    bool ret = luaState_["onInit"]();
+    bool ret = luaEnv_["onInit"]();
     return ret;
 }
 
@@ -138,11 +139,11 @@ void AreaOfEffect::Update(uint32_t timeElapsed, Net::NetworkMessage& message)
     stateComp_.Write(message);
 
     if (HaveFunction(FunctionUpdate))
-        Lua::CallFunction(luaState_, "onUpdate", timeElapsed);
+        Lua::CallFunction(luaEnv_, "onUpdate", timeElapsed);
     if (sa::time::time_elapsed(startTime_) > lifetime_)
     {
         if (HaveFunction(FunctionEnded))
-            Lua::CallFunction(luaState_, "onEnded");
+            Lua::CallFunction(luaEnv_, "onEnded");
         Remove();
     }
 }
@@ -152,21 +153,21 @@ void AreaOfEffect::OnCollide(GameObject* other)
     // Called from collisionComp_ of the moving object
     // AOE can also be a trap for example
     if (HaveFunction(FunctionOnCollide))
-        Lua::CallFunction(luaState_, "onCollide", other);
+        Lua::CallFunction(luaEnv_, "onCollide", other);
 }
 
 void AreaOfEffect::OnTrigger(GameObject* other)
 {
     // AOE can also be a trap for example
     if (HaveFunction(FunctionOnTrigger))
-        Lua::CallFunction(luaState_, "onTrigger", other);
+        Lua::CallFunction(luaEnv_, "onTrigger", other);
 }
 
 void AreaOfEffect::OnLeftArea(GameObject* other)
 {
     // AOE can also be a trap for example
     if (HaveFunction(FunctionOnLeftArea))
-        Lua::CallFunction(luaState_, "onLeftArea", other);
+        Lua::CallFunction(luaEnv_, "onLeftArea", other);
 }
 
 Math::ShapeType AreaOfEffect::GetShapeType() const
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "GameObject.h"
+#include "LuaEnvironment.h"
 #include "Skill.h"
 #include <sa/Bits.h>
 #include <eastl.hpp>
@@ -43,7 +44,7 @@ private:
         FunctionOnCollide = 1 << 4,
     };
     ea::weak_ptr<Actor> source_;
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     bool luaInitialized_{ false };
     /// Effect or skill index
     uint32_t index_{ 0 };
@@ -59,7 +60,7 @@ private:
     {
         return luaInitialized_ && sa::bits::is_set(functions_, func);
     }
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     void _LuaSetSource(Actor* source);
     Actor* _LuaGetSource();
 private:
@@ -56,6 +56,7 @@ ea::shared_ptr<ChatChannel> Chat::Get(ChatType type, uint64_t id)
     }
 
     const ea::pair<ChatType, uint64_t> channelId = { type, id };
+    std::scoped_lock lock(lock_);
     const auto it = channels_.find(channelId);
     if (it != channels_.end())
         return (*it).second;
@@ -83,6 +84,7 @@ ea::shared_ptr<ChatChannel> Chat::Get(ChatType type, const std::string& uuid)
         return ea::shared_ptr<ChatChannel>();
 
     const ea::pair<ChatType, uint64_t> channelId = { type, sa::StringHashRt(uuid.c_str()) };
+    std::scoped_lock lock(lock_);
     const auto it = channels_.find(channelId);
     if (it != channels_.end())
         return (*it).second;
@@ -107,6 +109,7 @@ ea::shared_ptr<ChatChannel> Chat::Get(ChatType type, const std::string& uuid)
 void Chat::Remove(ChatType type, uint64_t id)
 {
     const ea::pair<ChatType, uint64_t> channelId = { type, id };
+    std::scoped_lock lock(lock_);
     auto it = channels_.find(channelId);
     if (it != channels_.end())
         channels_.erase(it);
@@ -114,6 +117,7 @@ void Chat::Remove(ChatType type, uint64_t id)
 
 void Chat::CleanChats()
 {
+    std::scoped_lock lock(lock_);
     if (channels_.size() == 0)
         return;
 
@@ -196,21 +200,49 @@ bool WhisperChatChannel::Talk(Player& player, const std::string& text)
 {
     if (auto p = player_.lock())
     {
-        if (p->IsIgnored(player))
-            return false;
-        if (!p->IsOnline())
-            return false;
-
-        auto msg = Net::NetworkMessage::GetNew();
-        msg->AddByte(AB::GameProtocol::ServerPacketType::ChatMessage);
-        AB::Packets::Server::ChatMessage packet = {
-            static_cast<uint8_t>(AB::GameProtocol::ChatChannel::Whisper),
-            player.id_,
-            player.GetName(),
-            text
-        };
-        AB::Packets::Add(packet, *msg);
-        p->WriteToOutput(*msg);
+        // The recipient may be in a game running on another thread. It also sends the
+        // confirmation to the sender, so the sender doesn't need to know the recipient.
+        p->RunOnGameThread([sender = player.GetPtr<Player>(), text](Player& recipient)
+        {
+            if (!recipient.IsOnline())
+            {
+                auto nmsg = Net::NetworkMessage::GetNew();
+                nmsg->AddByte(AB::GameProtocol::ServerPacketType::ServerMessage);
+                AB::Packets::Server::ServerMessage packet = {
+                    static_cast<uint8_t>(AB::GameProtocol::ServerMessageType::PlayerNotOnline),
+                    sender->GetName(),
+                    recipient.GetName()
+                };
+                AB::Packets::Add(packet, *nmsg);
+                sender->WriteToOutput(*nmsg);
+                return;
+            }
+
+            // Ignored players don't know they are ignored
+            if (!recipient.IsIgnored(*sender))
+            {
+                auto msg = Net::NetworkMessage::GetNew();
+                msg->AddByte(AB::GameProtocol::ServerPacketType::ChatMessage);
+                AB::Packets::Server::ChatMessage packet = {
+                    static_cast<uint8_t>(AB::GameProtocol::ChatChannel::Whisper),
+                    sender->id_,
+                    sender->GetName(),
+                    text
+                };
+                AB::Packets::Add(packet, *msg);
+                recipient.WriteToOutput(*msg);
+            }
+
+            auto nmsg = Net::NetworkMessage::GetNew();
+            nmsg->AddByte(AB::GameProtocol::ServerPacketType::ServerMessage);
+            AB::Packets::Server::ServerMessage packet = {
+                static_cast<uint8_t>(AB::GameProtocol::ServerMessageType::PlayerGotMessage),
+                recipient.GetName(),
+                text
+            };
+            AB::Packets::Add(packet, *nmsg);
+            sender->WriteToOutput(*nmsg);
+        });
         return true;
     }
 
@@ -231,21 +263,24 @@ bool WhisperChatChannel::Talk(const std::string& playerName, const std::string&
 {
     if (auto p = player_.lock())
     {
-        if (p->IsIgnored(playerName))
-            return false;
-        if (!p->IsOnline())
-            return false;
-
-        auto msg = Net::NetworkMessage::GetNew();
-        msg->AddByte(AB::GameProtocol::ServerPacketType::ChatMessage);
-        AB::Packets::Server::ChatMessage packet = {
-            static_cast<uint8_t>(AB::GameProtocol::ChatChannel::Whisper),
-            0,
-            playerName,
-            text
-        };
-        AB::Packets::Add(packet, *msg);
-        p->WriteToOutput(*msg);
+        p->RunOnGameThread([playerName, text](Player& recipient)
+        {
+            if (recipient.IsIgnored(playerName))
+                return;
+            if (!recipient.IsOnline())
+                return;
+
+            auto msg = Net::NetworkMessage::GetNew();
+            msg->AddByte(AB::GameProtocol::ServerPacketType::ChatMessage);
+            AB::Packets::Server::ChatMessage packet = {
+                static_cast<uint8_t>(AB::GameProtocol::ChatChannel::Whisper),
+                0,
+                playerName,
+                text
+            };
+            AB::Packets::Add(packet, *msg);
+            recipient.WriteToOutput(*msg);
+        });
         return true;
     }
     return false;
@@ -255,19 +290,22 @@ bool WhisperChatChannel::TalkNpc(Npc& npc, const std::string& text)
 {
     if (auto p = player_.lock())
     {
-        if (!p->IsOnline())
-            return false;
-
-        auto msg = Net::NetworkMessage::GetNew();
-        msg->AddByte(AB::GameProtocol::ServerPacketType::ChatMessage);
-        AB::Packets::Server::ChatMessage packet = {
-            static_cast<uint8_t>(AB::GameProtocol::ChatChannel::Whisper),
-            npc.id_,
-            npc.GetName(),
-            text
-        };
-        AB::Packets::Add(packet, *msg);
-        p->WriteToOutput(*msg);
+        p->RunOnGameThread([npcId = npc.id_, npcName = npc.GetName(), text](Player& recipient)
+        {
+            if (!recipient.IsOnline())
+                return;
+
+            auto msg = Net::NetworkMessage::GetNew();
+            msg->AddByte(AB::GameProtocol::ServerPacketType::ChatMessage);
+            AB::Packets::Server::ChatMessage packet = {
+                static_cast<uint8_t>(AB::GameProtocol::ChatChannel::Whisper),
+                npcId,
+                npcName,
+                text
+            };
+            AB::Packets::Add(packet, *msg);
+            recipient.WriteToOutput(*msg);
+        });
         return true;
     }
     return false;
@@ -308,16 +346,19 @@ void GuildChatChannel::Broadcast(const std::string& playerName, const std::strin
     };
     AB::Packets::Add(packet, *msg);
 
+    std::shared_ptr<Net::NetworkMessage> sharedMsg = std::move(msg);
     for (const auto& g : gs.members)
     {
         ea::shared_ptr<Player> player = GetSubsystem<PlayerManager>()->GetPlayerByAccountUuid(g.accountUuid);
         if (!player)
             // This player not on this server.
             continue;
-        if (player->IsIgnored(playerName))
-            continue;
-
-        player->WriteToOutput(*msg);
+        player->RunOnGameThread([playerName, sharedMsg](Player& recipient)
+        {
+            if (recipient.IsIgnored(playerName))
+                return;
+            recipient.WriteToOutput(*sharedMsg);
+        });
     }
 }
 
@@ -345,16 +386,22 @@ void TradeChatChannel::Broadcast(const std::string& playerName, const std::strin
         text
     };
     AB::Packets::Add(packet, *msg);
-    playerMngr->VisitPlayers([&playerName, &msg](Player& player) {
-        if (player.IsIgnored(playerName))
-            return Iteration::Continue;
-        if (!AB::Entities::IsOutpost(player.GetGame()->data_.type))
-            return Iteration::Continue;
-        player.WriteToOutput(*msg);
+    std::shared_ptr<Net::NetworkMessage> sharedMsg = std::move(msg);
+    playerMngr->VisitPlayers([&playerName, &sharedMsg](Player& player) {
+        player.RunOnGameThread([playerName, sharedMsg](Player& recipient)
+        {
+            if (recipient.IsIgnored(playerName))
+                return;
+            auto game = recipient.GetGame();
+            if (!game || !AB::Entities::IsOutpost(game->data_.type))
+                return;
+            recipient.WriteToOutput(*sharedMsg);
+        });
         return Iteration::Continue;
     });
 }
 
+// All members of a party are in the same game, so this runs on their game thread.
 bool PartyChatChannel::Talk(Player& player, const std::string& text)
 {
     if (!party_)
@@ -24,6 +24,7 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <sa/StringHash.h>
 #include <AB/ProtocolCodes.h>
 #include <eastl.hpp>
@@ -135,6 +136,8 @@ class Chat
 {
     NON_COPYABLE(Chat)
 private:
+    /// Channels are requested from all game threads
+    std::mutex lock_;
     // Type | ID
     ea::map<ea::pair<ChatType, uint64_t>, ea::shared_ptr<ChatChannel>> channels_;
     ea::shared_ptr<ChatChannel> tradeChat_;
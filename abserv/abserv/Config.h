@@ -53,6 +53,8 @@
 
 // Update server load every second
 #define UPDATE_SERVER_LOAD_MS (1000)
+// Log thread utilization and network stats every minute
+#define STATS_MS (1000 * 60)
 // Update game instances
 #define UPDATE_INSTANCES_MS (1000)
 // Clean assets cache every 10min (ms)
@@ -76,6 +78,32 @@
 // Time after a party is teleported back to the outpost after it was defeated/resigned in ms
 #define PARTY_TELEPORT_BACK_TIME (3000u)
 #define AI_SERVER_UPDATE_INTERVAL (1000)
+// Max time all NPCs of a game may spend in their behavior trees per tick in microseconds
+#define AI_TICK_BUDGET_US (8000)
+// How often the BT of an NPC runs when a player is in interest range but not in compass range
+#define AI_UPDATE_INTERVAL_NEAR (250u)
+// How often the BT of an NPC runs when no player is around
+#define AI_UPDATE_INTERVAL_FAR (1000u)
+// Max time the Lua GC of a game may take per tick in microseconds. Can be changed
+// with lua_gc_budget_us in the config file.
+#define LUA_GC_TICK_BUDGET_US (1000)
+// A Lua VM whose heap grew to this multiple of its size after the last GC cycle
+// is collected regardless of the budget
+#define LUA_GC_EMERGENCY_FACTOR (4)
+// GC parameters of the Lua VMs. Pause is the heap growth in percent until the next
+// cycle starts, step multiplier is the work done per step relative to allocation.
+// The game VM has many short lived objects from callbacks
+#define LUA_GC_PAUSE_GAME (150)
+#define LUA_GC_STEPMUL_GAME (200)
+// Skills of a player, these mostly allocate when a skill is used
+#define LUA_GC_PAUSE_SKILLS (200)
+#define LUA_GC_STEPMUL_SKILLS (200)
+// Quests of a player, small and rarely allocating
+#define LUA_GC_PAUSE_QUESTS (200)
+#define LUA_GC_STEPMUL_QUESTS (150)
+// VMs of a single object, e.g. items. These use the automatic GC of Lua.
+#define LUA_GC_PAUSE_PRIVATE (200)
+#define LUA_GC_STEPMUL_PRIVATE (200)
 #define FILEWATCHER_INTERVAL (1000)
 // Merchant returns a maximum of 20 items. The user should narrow the search.
 #define MERCHANTITEMS_PAGESIZE 20
@@ -21,6 +21,7 @@
 
 
 #include "ConfigManager.h"
+#include "Config.h"
 #include <abscommon/StringUtils.h>
 #include <abscommon/UuidUtils.h>
 
@@ -49,22 +50,28 @@ bool ConfigManager::Load(const std::string& file)
     config_[Key::DataDir] = GetGlobalString("data_dir", "");
     config_[Key::RecordingsDir] = GetGlobalString("recordings_dir", "");
     config_[Key::RecordGames] = GetGlobalBool("record_games", false);
+    config_[Key::ScriptCacheDir] = GetGlobalString("script_cache_dir", "");
     config_[Key::GamePort] = static_cast<int>(GetGlobalInt("game_port", 0ll));
     config_[Key::GameHost] = GetGlobalString("game_host", "");
     config_[Key::ServerKeys] = GetGlobalString("server_keys", "");
 
     config_[Key::DataServerHost] = GetGlobalString("data_host", "localhost");
     config_[Key::DataServerPort] = static_cast<int>(GetGlobalInt("data_port", 2770ll));
+    config_[Key::DataServerConnections] = static_cast<int>(GetGlobalInt("data_connections", 1ll));
     config_[Key::MessageServerHost] = GetGlobalString("message_host", "localhost");
     config_[Key::MessageServerPort] = static_cast<int>(GetGlobalInt("message_port", 2771ll));
 
     config_[Key::MaxPacketsPerSecond] = static_cast<int>(GetGlobalInt("max_packets_per_second", 25ll));
+    config_[Key::GameThreads] = static_cast<int>(GetGlobalInt("game_threads", 1ll));
+    config_[Key::NetworkThreads] = static_cast<int>(GetGlobalInt("network_threads", 1ll));
+    config_[Key::NetworkCompression] = GetGlobalBool("network_compression", true);
 
     config_[Key::Behaviours] = GetGlobalString("behaviours", "/scripts/behaviors/behaviors.lua");
     config_[Key::AiServer] = GetGlobalBool("ai_server", false);
     config_[Key::AiServerIp] = GetGlobalString("ai_server_ip", "127.0.0.1");
     config_[Key::AiServerPort] = static_cast<int>(GetGlobalInt("ai_server_port", 12345ll));
     config_[Key::AiUpdateInterval] = static_cast<int>(GetGlobalInt("ai_server_interval", 1000ll));
+    config_[Key::LuaGcBudget] = static_cast<int>(GetGlobalInt("lua_gc_budget_us", static_cast<int64_t>(LUA_GC_TICK_BUDGET_US)));
 
     config_[Key::WatchAssets] = GetGlobalBool("watch_assets", true);
 
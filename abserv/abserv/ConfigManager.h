@@ -42,19 +42,25 @@ public:
         DataDir,
         RecordingsDir,
         RecordGames,
+        ScriptCacheDir,
 
         DataServerHost,
         DataServerPort,
+        DataServerConnections,
         MessageServerHost,
         MessageServerPort,
 
         MaxPacketsPerSecond,
+        GameThreads,
+        NetworkThreads,
+        NetworkCompression,
 
         Behaviours,
         AiServer,
         AiServerIp,
         AiServerPort,
         AiUpdateInterval,
+        LuaGcBudget,
         WatchAssets,
     };
 public:
@@ -44,10 +44,10 @@ void Effect::RegisterLua(kaguya::State& state)
     // clang-format on
 }
 
-void Effect::InitializeLua()
+void Effect::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
 }
 
 bool Effect::LoadScript(const std::string& fileName)
@@ -55,56 +55,56 @@ bool Effect::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    if (!script->Execute(luaEnv_))
         return false;
 
-    persistent_ = luaState_["isPersistent"];
-    if (Lua::IsBool(luaState_, "internal"))
-        internal_ = luaState_["internal"];
+    persistent_ = luaEnv_["isPersistent"];
+    if (Lua::IsBool(luaEnv_, "internal"))
+        internal_ = luaEnv_["internal"];
 
-    if (Lua::IsFunction(luaState_, "onUpdate"))
+    if (Lua::IsFunction(luaEnv_, "onUpdate"))
         sa::bits::set(functions_, FunctionUpdate);
-    if (Lua::IsFunction(luaState_, "getSkillCost"))
+    if (Lua::IsFunction(luaEnv_, "getSkillCost"))
         sa::bits::set(functions_, FunctionGetSkillCost);
-    if (Lua::IsFunction(luaState_, "getDamage"))
+    if (Lua::IsFunction(luaEnv_, "getDamage"))
         sa::bits::set(functions_, FunctionGetDamage);
-    if (Lua::IsFunction(luaState_, "getAttackSpeed"))
+    if (Lua::IsFunction(luaEnv_, "getAttackSpeed"))
         sa::bits::set(functions_, FunctionGetAttackSpeed);
-    if (Lua::IsFunction(luaState_, "getAttackDamageType"))
+    if (Lua::IsFunction(luaEnv_, "getAttackDamageType"))
         sa::bits::set(functions_, FunctionGetAttackDamageType);
-    if (Lua::IsFunction(luaState_, "getAttackDamage"))
+    if (Lua::IsFunction(luaEnv_, "getAttackDamage"))
         sa::bits::set(functions_, FunctionGetAttackDamage);
-    if (Lua::IsFunction(luaState_, "onAttack"))
+    if (Lua::IsFunction(luaEnv_, "onAttack"))
         sa::bits::set(functions_, FunctionOnAttack);
-    if (Lua::IsFunction(luaState_, "onGettingAttacked"))
+    if (Lua::IsFunction(luaEnv_, "onGettingAttacked"))
         sa::bits::set(functions_, FunctionOnGettingAttacked);
-    if (Lua::IsFunction(luaState_, "onUseSkill"))
+    if (Lua::IsFunction(luaEnv_, "onUseSkill"))
         sa::bits::set(functions_, FunctionOnUseSkill);
-    if (Lua::IsFunction(luaState_, "onSkillTargeted"))
+    if (Lua::IsFunction(luaEnv_, "onSkillTargeted"))
         sa::bits::set(functions_, FunctionOnSkillTargeted);
-    if (Lua::IsFunction(luaState_, "onAttacked"))
+    if (Lua::IsFunction(luaEnv_, "onAttacked"))
         sa::bits::set(functions_, FunctionOnAttacked);
-    if (Lua::IsFunction(luaState_, "onInterruptingAttack"))
+    if (Lua::IsFunction(luaEnv_, "onInterruptingAttack"))
         sa::bits::set(functions_, FunctionOnInterruptingAttack);
-    if (Lua::IsFunction(luaState_, "onInterruptingSkill"))
+    if (Lua::IsFunction(luaEnv_, "onInterruptingSkill"))
         sa::bits::set(functions_, FunctionOnInterruptingSkill);
-    if (Lua::IsFunction(luaState_, "onKnockingDown"))
+    if (Lua::IsFunction(luaEnv_, "onKnockingDown"))
         sa::bits::set(functions_, FunctionOnKnockingDown);
-    if (Lua::IsFunction(luaState_, "onHealing"))
+    if (Lua::IsFunction(luaEnv_, "onHealing"))
         sa::bits::set(functions_, FunctionOnHealing);
-    if (Lua::IsFunction(luaState_, "onGetCriticalHit"))
+    if (Lua::IsFunction(luaEnv_, "onGetCriticalHit"))
         sa::bits::set(functions_, FunctionOnGetCriticalHit);
-    if (Lua::IsFunction(luaState_, "getArmor"))
+    if (Lua::IsFunction(luaEnv_, "getArmor"))
         sa::bits::set(functions_, FunctionGetArmor);
-    if (Lua::IsFunction(luaState_, "getArmorPenetration"))
+    if (Lua::IsFunction(luaEnv_, "getArmorPenetration"))
         sa::bits::set(functions_, FunctionGetArmorPenetration);
-    if (Lua::IsFunction(luaState_, "getAttributeRank"))
+    if (Lua::IsFunction(luaEnv_, "getAttributeRank"))
         sa::bits::set(functions_, FunctionGetAttributeRank);
-    if (Lua::IsFunction(luaState_, "getResources"))
+    if (Lua::IsFunction(luaEnv_, "getResources"))
         sa::bits::set(functions_, FunctionGetResources);
-    if (Lua::IsFunction(luaState_, "getSkillRecharge"))
+    if (Lua::IsFunction(luaEnv_, "getSkillRecharge"))
         sa::bits::set(functions_, FunctionGetSkillRecharge);
-    if (Lua::IsFunction(luaState_, "onRemove"))
+    if (Lua::IsFunction(luaEnv_, "onRemove"))
         sa::bits::set(functions_, FunctionOnRemoved);
     return true;
 }
@@ -131,10 +131,10 @@ void Effect::Update(uint32_t timeElapsed)
     auto source = source_.lock();
     auto target = target_.lock();
     if (HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](source.get(), target.get(), timeElapsed);
+        luaEnv_["onUpdate"](source.get(), target.get(), timeElapsed);
     if (endTime_ <= sa::time::tick())
     {
-        luaState_["onEnd"](source.get(), target.get());
+        luaEnv_["onEnd"](source.get(), target.get());
         ended_ = true;
     }
 }
@@ -157,11 +157,11 @@ bool Effect::Start(ea::shared_ptr<Actor> source, ea::shared_ptr<Actor> target, u
     source_ = source;
     startTime_ = sa::time::tick();
     if (time == 0)
-        ticks_ = luaState_["getDuration"](source.get(), target.get());
+        ticks_ = luaEnv_["getDuration"](source.get(), target.get());
     else
         ticks_ = time;
     endTime_ = startTime_ + ticks_;
-    const bool succ = luaState_["onStart"](source.get(), target.get());
+    const bool succ = luaEnv_["onStart"](source.get(), target.get());
     if (!succ)
         endTime_ = 0;
     return succ;
@@ -174,7 +174,7 @@ void Effect::Remove()
     {
         auto source = source_.lock();
         auto target = target_.lock();
-        Lua::CallFunction(luaState_, "onRemove", source.get(), target.get());
+        Lua::CallFunction(luaEnv_, "onRemove", source.get(), target.get());
     }
     cancelled_ = true;
 }
@@ -184,7 +184,7 @@ void Effect::GetSkillRecharge(Skill* skill, uint32_t& recharge)
     if (!HaveFunction(FunctionGetSkillRecharge))
         return;
 
-    recharge = luaState_["getSkillRecharge"](skill, recharge);
+    recharge = luaEnv_["getSkillRecharge"](skill, recharge);
 }
 
 void Effect::GetSkillCost(Skill* skill,
@@ -194,7 +194,7 @@ void Effect::GetSkillCost(Skill* skill,
         return;
 
     kaguya::tie(activation, energy, adrenaline, overcast, hp) =
-        luaState_["getSkillCost"](skill, activation, energy, adrenaline, overcast, hp);
+        luaEnv_["getSkillCost"](skill, activation, energy, adrenaline, overcast, hp);
 }
 
 void Effect::GetDamage(DamageType type, int32_t& value, bool& critical)
@@ -203,116 +203,116 @@ void Effect::GetDamage(DamageType type, int32_t& value, bool& critical)
         return;
 
     kaguya::tie(value, critical) =
-        luaState_["getDamage"](static_cast<int>(type), value, critical);
+        luaEnv_["getDamage"](static_cast<int>(type), value, critical);
 }
 
 void Effect::GetAttackSpeed(Item* weapon, uint32_t& value)
 {
     if (!HaveFunction(FunctionGetAttackSpeed))
         return;
-    value = luaState_["getAttackSpeed"](weapon, value);
+    value = luaEnv_["getAttackSpeed"](weapon, value);
 }
 
 void Effect::GetAttackDamageType(DamageType& type)
 {
     if (!HaveFunction(FunctionGetAttackDamageType))
         return;
-    type = luaState_["getAttackDamageType"](type);
+    type = luaEnv_["getAttackDamageType"](type);
 }
 
 void Effect::GetArmor(DamageType type, int& value)
 {
     if (!HaveFunction(FunctionGetArmor))
         return;
-    value = luaState_["getArmor"](type, value);
+    value = luaEnv_["getArmor"](type, value);
 }
 
 void Effect::GetArmorPenetration(float& value)
 {
     if (!HaveFunction(FunctionGetArmorPenetration))
         return;
-    value = luaState_["getArmorPenetration"](value);
+    value = luaEnv_["getArmorPenetration"](value);
 }
 
 void Effect::GetAttributeRank(Attribute index, int32_t& value)
 {
     if (!HaveFunction(FunctionGetAttributeRank))
         return;
-    value = luaState_["getAttributeRank"](static_cast<uint32_t>(index), value);
+    value = luaEnv_["getAttributeRank"](static_cast<uint32_t>(index), value);
 }
 
 void Effect::GetAttackDamage(int32_t& value)
 {
     if (!HaveFunction(FunctionGetAttackDamage))
         return;
-    value = luaState_["getAttackDamage"](value);
+    value = luaEnv_["getAttackDamage"](value);
 }
 
 void Effect::GetRecources(int& maxHealth, int& maxEnergy)
 {
     if (!HaveFunction(FunctionGetResources))
         return;
-    kaguya::tie(maxHealth, maxEnergy) = luaState_["getResources"](maxHealth, maxEnergy);
+    kaguya::tie(maxHealth, maxEnergy) = luaEnv_["getResources"](maxHealth, maxEnergy);
 }
 
 void Effect::OnAttack(Actor* source, Actor* target, bool& value)
 {
     if (HaveFunction(FunctionOnAttack))
-        value = luaState_["onAttack"](source, target);
+        value = luaEnv_["onAttack"](source, target);
 }
 
 void Effect::OnAttacked(Actor* source, Actor* target, DamageType type, int32_t damage, bool& success)
 {
     if (HaveFunction(FunctionOnAttacked))
-        success = luaState_["onAttacked"](source, target, type, damage);
+        success = luaEnv_["onAttacked"](source, target, type, damage);
 }
 
 void Effect::OnGettingAttacked(Actor* source, Actor* target, bool& value)
 {
     if (HaveFunction(FunctionOnGettingAttacked))
-        value = luaState_["onGettingAttacked"](source, target);
+        value = luaEnv_["onGettingAttacked"](source, target);
 }
 
 void Effect::OnUseSkill(Actor* source, Actor* target, Skill* skill, bool& value)
 {
     if (HaveFunction(FunctionOnUseSkill))
-        value = luaState_["onUseSkill"](source, target, skill);
+        value = luaEnv_["onUseSkill"](source, target, skill);
 }
 
 void Effect::OnSkillTargeted(Actor* source, Actor* target, Skill* skill, bool& value)
 {
     if (HaveFunction(FunctionOnSkillTargeted))
-        value = luaState_["onSkillTargeted"](source, target, skill);
+        value = luaEnv_["onSkillTargeted"](source, target, skill);
 }
 
 void Effect::OnInterruptingAttack(bool& value)
 {
     if (HaveFunction(FunctionOnInterruptingAttack))
-        value = luaState_["onInterruptingAttack"]();
+        value = luaEnv_["onInterruptingAttack"]();
 }
 
 void Effect::OnInterruptingSkill(AB::Entities::SkillType type, Skill* skill, bool& value)
 {
     if (HaveFunction(FunctionOnInterruptingSkill))
-        value = luaState_["onInterruptingSkill"](type, skill);
+        value = luaEnv_["onInterruptingSkill"](type, skill);
 }
 
 void Effect::OnKnockingDown(Actor* source, Actor* target, uint32_t time, bool& value)
 {
     if (HaveFunction(FunctionOnKnockingDown))
-        value = luaState_["onKnockingDown"](source, target, time);
+        value = luaEnv_["onKnockingDown"](source, target, time);
 }
 
 void Effect::OnGetCriticalHit(Actor* source, Actor* target, bool& value)
 {
     if (HaveFunction(FunctionOnKnockingDown))
-        value = luaState_["onGetCriticalHit"](source, target);
+        value = luaEnv_["onGetCriticalHit"](source, target);
 }
 
 void Effect::OnHealing(Actor* source, Actor* target, int& value)
 {
     if (HaveFunction(FunctionOnHealing))
-        value = luaState_["onHealing"](source, target, value);
+        value = luaEnv_["onHealing"](source, target, value);
 }
 
 bool Effect::Serialize(sa::PropWriteStream& stream)
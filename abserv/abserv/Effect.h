@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "LuaEnvironment.h"
 #include <memory>
 #include <kaguya/kaguya.hpp>
 #include <sa/PropStream.h>
@@ -81,7 +82,7 @@ private:
     int64_t endTime_;
     /// Duration
     uint32_t ticks_;
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     ea::weak_ptr<Actor> target_;
     ea::weak_ptr<Actor> source_;
     bool persistent_{ false };
@@ -89,7 +90,7 @@ private:
     /// Internal effects are not visible to the player.
     bool internal_{ false };
     bool UnserializeProp(EffectAttr attr, sa::PropReadStream& stream);
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     bool HaveFunction(Function func) const
     {
         return sa::bits::is_set(functions_, func);
@@ -100,7 +101,8 @@ public:
     static void RegisterLua(kaguya::State& state);
 
     Effect() = delete;
-    explicit Effect(const AB::Entities::Effect& effect) :
+    /// If state is null the effect gets its own Lua VM
+    explicit Effect(const AB::Entities::Effect& effect, ea::shared_ptr<Lua::SharedState> state = {}) :
         startTime_(0),
         endTime_(0),
         ticks_(0),
@@ -108,7 +110,7 @@ public:
         ended_(false),
         cancelled_(false)
     {
-        InitializeLua();
+        InitializeLua(std::move(state));
     }
     ~Effect() = default;
 
@@ -62,13 +62,13 @@ AB::Entities::EffectCategory EffectCatNameToEffectCat(const std::string& name)
     }
 }
 
-ea::shared_ptr<Effect> EffectManager::Get(uint32_t index)
+ea::shared_ptr<Effect> EffectManager::Get(uint32_t index, ea::shared_ptr<Lua::SharedState> state)
 {
     ea::shared_ptr<Effect> result;
     auto it = effects_.find(index);
     if (it != effects_.end())
     {
-        result = ea::make_shared<Effect>((*it).second);
+        result = ea::make_shared<Effect>((*it).second, std::move(state));
     }
     else
     {
@@ -80,7 +80,7 @@ ea::shared_ptr<Effect> EffectManager::Get(uint32_t index)
             LOG_ERROR << "Error reading effect with index " << index << std::endl;
             return ea::shared_ptr<Effect>();
         }
-        result = ea::make_shared<Effect>(effect);
+        result = ea::make_shared<Effect>(effect, std::move(state));
         // Move to cache
         effects_.emplace(index, effect);
     }
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "LuaEnvironment.h"
 #include <AB/Entities/Effect.h>
 #include <sa/StringHash.h>
 #include <eastl.hpp>
@@ -53,7 +54,9 @@ public:
     EffectManager() = default;
     ~EffectManager() = default;
 
-    ea::shared_ptr<Effect> Get(uint32_t index);
+    /// Create an effect and load its script. The script runs in state, or in its
+    /// own VM if state is null.
+    ea::shared_ptr<Effect> Get(uint32_t index, ea::shared_ptr<Lua::SharedState> state = {});
 };
 
 }
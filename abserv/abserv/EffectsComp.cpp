@@ -23,6 +23,7 @@
 #include "EffectsComp.h"
 #include "Actor.h"
 #include "EffectManager.h"
+#include "Game.h"
 #include "Item.h"
 #include <AB/Packets/Packet.h>
 #include <AB/Packets/ServerPackets.h>
@@ -89,7 +90,9 @@ bool EffectsComp::HasEffectOf(AB::Entities::EffectCategory category)
 
 void EffectsComp::AddEffect(ea::shared_ptr<Actor> source, uint32_t index, uint32_t time)
 {
-    auto effect = GetSubsystem<EffectManager>()->Get(index);
+    // Effects of objects in a game run in the VM of the game
+    auto game = owner_.GetGame();
+    auto effect = GetSubsystem<EffectManager>()->Get(index, game ? game->GetScriptState() : ea::shared_ptr<Lua::SharedState>());
     if (effect)
     {
         // Effects are not stackable:
@@ -27,7 +27,9 @@
 #include "DataProvider.h"
 #include "Effect.h"
 #include "EffectManager.h"
+#include "GameExecutor.h"
 #include "GameManager.h"
+#include "InterestComp.h"
 #include "IOGame.h"
 #include "IOMap.h"
 #include "ItemDrop.h"
@@ -38,6 +40,7 @@
 #include "PlayerManager.h"
 #include "Projectile.h"
 #include "ProtocolGame.h"
+#include "QuestComp.h"
 #include "Script.h"
 #include "ScriptManager.h"
 #include "Skill.h"
@@ -64,26 +67,20 @@ void Game::InitMessageFilter()
     using namespace AB::Packets::Server;
     messageFilter = ea::make_unique<Net::MessageFilter>();
     // Subscribe to all messages we may filter out
-    messageFilter->Subscribe<ObjectPositionUpdate>([](const Game& game, const Player& player, ObjectPositionUpdate& packet) -> bool
+    messageFilter->Subscribe<ObjectPositionUpdate>([](const Game&, const Player& player, const ObjectPositionUpdate& packet) -> bool
     {
-        if (packet.id == player.id_)
-            return true;
-        const auto* object = game.GetObject<GameObject>(packet.id);
-        if (!player.IsInRange(Ranges::Interest, object))
-            return false;
-        return true;
+        // The InterestComp knows what's in the interest range
+        return player.interestComp_->IsKnown(packet.id);
     });
-    messageFilter->Subscribe<ObjectRotationUpdate>([](const Game& game, const Player& player, ObjectRotationUpdate& packet) -> bool
+    messageFilter->Subscribe<ObjectRotationUpdate>([](const Game&, const Player& player, const ObjectRotationUpdate& packet) -> bool
     {
-        if (packet.id == player.id_)
-            return true;
-        const auto* object = game.GetObject<GameObject>(packet.id);
-        if (!player.IsInRange(Ranges::Interest, object))
-            return false;
-        return true;
+        // The InterestComp knows what's in the interest range
+        return player.interestComp_->IsKnown(packet.id);
     });
-    messageFilter->Subscribe<ObjectSkillFailure>([](const Game& game, const Player& player, ObjectSkillFailure& packet) -> bool
+    messageFilter->Subscribe<ObjectSkillFailure>([](const Game& game, const Player& player, const ObjectSkillFailure& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -91,8 +88,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectUseSkill>([](const Game& game, const Player& player, ObjectUseSkill& packet) -> bool
+    messageFilter->Subscribe<ObjectUseSkill>([](const Game& game, const Player& player, const ObjectUseSkill& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -100,8 +99,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectSkillSuccess>([](const Game& game, const Player& player, ObjectSkillSuccess& packet) -> bool
+    messageFilter->Subscribe<ObjectSkillSuccess>([](const Game& game, const Player& player, const ObjectSkillSuccess& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -109,8 +110,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectAttackFailure>([](const Game& game, const Player& player, ObjectAttackFailure& packet) -> bool
+    messageFilter->Subscribe<ObjectAttackFailure>([](const Game& game, const Player& player, const ObjectAttackFailure& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -118,8 +121,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectSetAttackSpeed>([](const Game& game, const Player& player, ObjectSetAttackSpeed& packet) -> bool
+    messageFilter->Subscribe<ObjectSetAttackSpeed>([](const Game& game, const Player& player, const ObjectSetAttackSpeed& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -127,8 +132,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectTargetSelected>([](const Game& game, const Player& player, ObjectTargetSelected& packet) -> bool
+    messageFilter->Subscribe<ObjectTargetSelected>([](const Game& game, const Player& player, const ObjectTargetSelected& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_ || packet.targetId == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -136,8 +143,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectEffectAdded>([](const Game& game, const Player& player, ObjectEffectAdded& packet) -> bool
+    messageFilter->Subscribe<ObjectEffectAdded>([](const Game& game, const Player& player, const ObjectEffectAdded& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
 
@@ -153,14 +162,16 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectEffectRemoved>([](const Game& game, const Player& player, ObjectEffectRemoved& packet) -> bool
+    messageFilter->Subscribe<ObjectEffectRemoved>([](const Game& game, const Player& player, const ObjectEffectRemoved& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
 
         // Can't get the Effect object from the Actor because it was removed
         auto* effectMngr = GetSubsystem<EffectManager>();
-        auto effect = effectMngr->Get(packet.effectIndex);
+        auto effect = effectMngr->Get(packet.effectIndex, game.GetScriptState());
         if (!effect)
             return false;
         // Pass long lasting effects, in case the player comes into range
@@ -172,8 +183,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectDamaged>([](const Game& game, const Player& player, ObjectDamaged& packet) -> bool
+    messageFilter->Subscribe<ObjectDamaged>([](const Game& game, const Player& player, const ObjectDamaged& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_ || packet.sourceId == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -181,8 +194,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectHealed>([](const Game& game, const Player& player, ObjectHealed& packet) -> bool
+    messageFilter->Subscribe<ObjectHealed>([](const Game& game, const Player& player, const ObjectHealed& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_ || packet.sourceId == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -190,8 +205,10 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
-    messageFilter->Subscribe<ObjectResourceChanged>([](const Game& game, const Player& player, ObjectResourceChanged& packet) -> bool
+    messageFilter->Subscribe<ObjectResourceChanged>([](const Game& game, const Player& player, const ObjectResourceChanged& packet) -> bool
     {
+        if (!player.interestComp_->IsKnown(packet.id))
+            return false;
         if (packet.id == player.id_)
             return true;
         const auto* object = game.GetObject<GameObject>(packet.id);
@@ -199,9 +216,52 @@ void Game::InitMessageFilter()
             return false;
         return true;
     });
+    // Objects the client doesn't know, i.e. which are not in the interest range of the player
+    messageFilter->Subscribe<ObjectSpawn>([](const Game&, const Player& player, const ObjectSpawn& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<ObjectDespawn>([](const Game&, const Player& player, const ObjectDespawn& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<ObjectGroupMaskChanged>([](const Game&, const Player& player, const ObjectGroupMaskChanged& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<ObjectForcePosition>([](const Game&, const Player& player, const ObjectForcePosition& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<ObjectSpeedChanged>([](const Game&, const Player& player, const ObjectSpeedChanged& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<ObjectStateChanged>([](const Game&, const Player& player, const ObjectStateChanged& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<ObjectProgress>([](const Game&, const Player& player, const ObjectProgress& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.id);
+    });
+    messageFilter->Subscribe<SetObjectAttributeValue>([](const Game&, const Player& player, const SetObjectAttributeValue& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.objectId);
+    });
+    messageFilter->Subscribe<ObjectSetSkill>([](const Game&, const Player& player, const ObjectSetSkill& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.objectId);
+    });
+    messageFilter->Subscribe<ObjectSecProfessionChanged>([](const Game&, const Player& player, const ObjectSecProfessionChanged& packet) -> bool
+    {
+        return player.interestComp_->IsKnown(packet.objectId);
+    });
 }
 
-Game::Game()
+Game::Game() :
+    scriptState_(ea::make_shared<Lua::SharedState>(Lua::StateKind::Game)),
+    filteredStatus_(ea::make_unique<Net::FilteredMessage>())
 {
     InitializeLua();
     // Create gameStatus_ here, because we may already write it.
@@ -219,7 +279,8 @@ Game::~Game()
     AB::Entities::GameInstanceList il;
     client->Invalidate(il);
     players_.clear();
-    objects_.clear();
+    proximity_.Clear();
+    objects_.Clear();
     GetSubsystem<Chat>()->Remove(ChatType::Map, id_);
 }
 
@@ -332,8 +393,8 @@ void Game::RegisterLua(kaguya::State& state)
 
 void Game::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(scriptState_);
+    luaEnv_["self"] = this;
 }
 
 void Game::Start()
@@ -374,15 +435,13 @@ void Game::Start()
     SetState(ExecutionState::Running);
 
     // Initial game update
-    GetSubsystem<Asynch::Dispatcher>()->Add(
-        Asynch::CreateTask(std::bind(&Game::Update, shared_from_this()))
-    );
+    Post(std::bind(&Game::Update, shared_from_this()));
 }
 
 void Game::Update()
 {
     const uint32_t frequency = GetUpdateFrequency();
-    // Dispatcher Thread
+    // Game Thread
     if (state_ != ExecutionState::Terminated)
     {
         if (lastUpdate_ == 0)
@@ -399,7 +458,7 @@ void Game::Update()
             }
 
             noplayerTime_ = 0;
-            Lua::CallFunction(luaState_, "onStart");
+            Lua::CallFunction(luaEnv_, "onStart");
             // Add start tick at the beginning
             gameStatus_->AddByte(AB::GameProtocol::ServerPacketType::GameStart);
             AB::Packets::Server::GameStart packet = { startTime_ };
@@ -419,17 +478,22 @@ void Game::Update()
             AB::Packets::Add(packet, *gameStatus_);
         }
 
+        // Ranges between objects which moved in the last tick
+        proximity_.Update();
+
+        // Behavior trees first, the objects act on the decisions in their update
+        aiScheduler_.Update(*this, delta);
+
         // First Update all objects
         {
-            // We need a copy of the objects because the iterator may become
-            // invalid if objects are added.
-            const auto localObjs = objects_;
-            for (const auto& o : localObjs)
+            // Objects added during the update are appended and updated in the next
+            // tick. Removed objects stay alive until the list is compacted.
+            const size_t count = objects_.GetSlotCount();
+            for (size_t i = 0; i < count; ++i)
             {
-                if (!o.second)
-                    return;
-                if (o.second->HasGame())
-                    o.second->Update(delta, *gameStatus_);
+                GameObject* object = objects_.GetSlot(i);
+                if (object && object->HasGame())
+                    object->Update(delta, *gameStatus_);
             }
         }
 
@@ -437,11 +501,14 @@ void Game::Update()
         map_->UpdateOctree(delta);
 
         // Then call Lua Update function
-        Lua::CallFunction(luaState_, "onUpdate", delta);
+        Lua::CallFunction(luaEnv_, "onUpdate", delta);
 
         // Send game status to players
         SendStatus();
 
+        // Now release objects removed during this tick
+        objects_.Compact();
+
         if (GetPlayerCount() == 0)
             noplayerTime_ += delta;
         else
@@ -460,7 +527,7 @@ void Game::Update()
             // Keep empty games for 10 seconds
             LOG_INFO << "Shutting down game " << id_ << ", " << map_->name_ << " no players for " << noplayerTime_ << std::endl;
             SetState(ExecutionState::Terminated);
-            Lua::CallFunction(luaState_, "onStop");
+            Lua::CallFunction(luaEnv_, "onStop");
         }
 
         // Schedule next update
@@ -469,9 +536,7 @@ void Game::Update()
         const uint32_t sleepTime = frequency > duration ?
             frequency - duration :
             0;
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(sleepTime, std::bind(&Game::Update, shared_from_this()))
-        );
+        Schedule(sleepTime, std::bind(&Game::Update, shared_from_this()));
 
         break;
     }
@@ -487,7 +552,15 @@ void Game::Update()
         // Do nothing
         break;
     }
-    Lua::CollectGarbage(luaState_);
+
+    gcManager_.Add(*scriptState_);
+    for (const auto& player : players_)
+    {
+        gcManager_.Add(*player.second->skills_->GetScriptState());
+        if (auto questState = player.second->questComp_->GetScriptState())
+            gcManager_.Add(*questState);
+    }
+    gcManager_.Update();
 }
 
 void Game::SendStatus()
@@ -495,12 +568,36 @@ void Game::SendStatus()
     // Must not be empty. Update adds at least the time stamp.
     ASSERT(gameStatus_->GetSize() != 0);
 
+    // Spawn objects coming into and despawn objects leaving the interest range
     for (const auto& p : players_)
+        p.second->interestComp_->Update(spawnedObjects_);
+
+    messageFilter->Prepare(*gameStatus_, *filteredStatus_);
+    if (!filteredStatus_->NeedsFilter())
+    {
+        // Nothing to filter, all players get the same message
+        for (const auto& p : players_)
+            p.second->WriteToOutput(*gameStatus_);
+    }
+    else
+    {
+        for (const auto& p : players_)
+        {
+            auto msg = Net::NetworkMessage::GetNew();
+            messageFilter->Execute(*this, *p.second, *filteredStatus_, *msg);
+            p.second->WriteToOutput(*msg);
+        }
+    }
+    filteredStatus_->Clear();
+
+    // The despawns of removed objects were sent now
+    for (uint32_t id : leftObjects_)
     {
-        auto msg = Net::NetworkMessage::GetNew();
-        messageFilter->Execute(*this, *p.second, *gameStatus_, *msg);
-        p.second->WriteToOutput(*msg);
+        for (const auto& p : players_)
+            p.second->interestComp_->Forget(id);
     }
+    leftObjects_.clear();
+    spawnedObjects_.clear();
 
     if (writeStream_ && writeStream_->IsOpen())
         writeStream_->Write(*gameStatus_);
@@ -532,24 +629,25 @@ Player* Game::GetPlayerByName(const std::string& name)
 void Game::AddObject(ea::shared_ptr<GameObject> object)
 {
     AddObjectInternal(object);
-    Lua::CallFunction(luaState_, "onAddObject", object.get());
+    Lua::CallFunction(luaEnv_, "onAddObject", object.get());
 }
 
 void Game::AddObjectInternal(ea::shared_ptr<GameObject> object)
 {
-    objects_.emplace(object->id_, object);
+    objects_.Add(object);
     object->SetGame(shared_from_this());
+    proximity_.Add(*object);
 }
 
 void Game::InternalRemoveObject(GameObject* object)
 {
-    const auto it = objects_.find(object->id_);
-    if (it == objects_.end())
+    if (!objects_.Contains(object->id_))
         return;
-    Lua::CallFunction(luaState_, "onRemoveObject", object);
+    Lua::CallFunction(luaEnv_, "onRemoveObject", object);
+    proximity_.Remove(*object);
     object->SetGame(ea::shared_ptr<Game>());
-    if (it != objects_.end())
-        objects_.erase(it);
+    // Keeps the object alive until the end of the tick
+    objects_.Remove(object->id_);
 }
 
 ea::shared_ptr<Npc> Game::AddNpc(const std::string& script)
@@ -560,10 +658,7 @@ ea::shared_ptr<Npc> Game::AddNpc(const std::string& script)
         return ea::shared_ptr<Npc>();
 
     // After all initialization is done, we can call this
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendSpawnObject,
-            shared_from_this(), result))
-    );
+    Schedule(std::bind(&Game::SendSpawnObject, shared_from_this(), result));
 
     return result;
 }
@@ -584,10 +679,7 @@ ea::shared_ptr<AreaOfEffect> Game::AddAreaOfEffect(const std::string& script,
         return ea::shared_ptr<AreaOfEffect>();
 
     // After all initialization is done, we can call this
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendSpawnObject,
-            shared_from_this(), result))
-    );
+    Schedule(std::bind(&Game::SendSpawnObject, shared_from_this(), result));
 
     return result;
 }
@@ -604,10 +696,7 @@ void Game::AddProjectile(const std::string& itemUuid,
     if (!result->Load())
         return;
 
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendSpawnObject,
-            shared_from_this(), result))
-    );
+    Schedule(std::bind(&Game::SendSpawnObject, shared_from_this(), result));
 }
 
 ea::shared_ptr<ItemDrop> Game::AddRandomItemDropFor(Actor* dropper, Actor* target)
@@ -689,8 +778,23 @@ std::vector<Party*> Game::_LuaGetParties() const
 
 void Game::CallLuaEvent(const std::string& name, GameObject* sender, GameObject* data)
 {
-    if (Lua::IsFunction(luaState_, name))
-        luaState_[name](sender, data);
+    if (Lua::IsFunction(luaEnv_, name))
+        luaEnv_[name](sender, data);
+}
+
+void Game::Post(std::function<void(void)>&& f)
+{
+    GetSubsystem<GameExecutor>()->Add(workerIndex_, std::move(f));
+}
+
+void Game::Schedule(uint32_t delay, std::function<void(void)>&& f)
+{
+    GetSubsystem<GameExecutor>()->Schedule(workerIndex_, delay, std::move(f));
+}
+
+bool Game::IsGameThread() const
+{
+    return GetSubsystem<GameExecutor>()->IsWorkerThread(workerIndex_);
 }
 
 void Game::SetState(ExecutionState state)
@@ -735,7 +839,7 @@ void Game::Load(const std::string& mapUuid)
         LOG_ERROR << "Unable to get script " << data_.script << std::endl;
         return;
     }
-    if (!script->Execute(luaState_))
+    if (!script->Execute(luaEnv_))
     {
         LOG_ERROR << "Error executing script " << data_.script << std::endl;
         return;
@@ -767,6 +871,7 @@ void Game::SendSpawnObject(ea::shared_ptr<GameObject> object)
 
     gameStatus_->AddByte(AB::GameProtocol::ServerPacketType::ObjectSpawn);
     object->WriteSpawnData(*gameStatus_);
+    spawnedObjects_.emplace(object->id_);
     AddObject(object);
 }
 
@@ -777,57 +882,13 @@ void Game::SendLeaveObject(uint32_t objectId)
         objectId
     };
     AB::Packets::Add(packet, *gameStatus_);
-}
-
-void Game::SendInitStateToPlayer(Player& player)
-{
-    // Send all already existing objects to the player, excluding the player itself.
-    // This is sent to all players when they enter a game.
-    // Only called when the player enters a game. All spawns during the game are sent
-    // when they happen.
-    const auto write = [&player](Net::NetworkMessage& msg, GameObject& o)
-    {
-        if (o.GetType() < AB::GameProtocol::GameObjectType::__SentToPlayer)
-            // No need to send terrain patch to client
-            return;
-        if (o.id_ == player.id_)
-            // Don't send spawn of our self
-            return;
-
-        msg.AddByte(AB::GameProtocol::ServerPacketType::ObjectSpawnExisting);
-        o.WriteSpawnData(msg);
-    };
-
-    auto msg = Net::NetworkMessage::GetNew();
-    for (const auto& o : objects_)
-    {
-        write(*msg, *o.second);
-        // When there are many objects this may exceed the buffer size.
-        if (msg->GetSpace() < 512)
-        {
-            player.WriteToOutput(*msg);
-            msg = Net::NetworkMessage::GetNew();
-        }
-    }
-
-    // Also send queued objects
-    for (const auto& o : queuedObjects_)
-    {
-        write(*msg, *o);
-        if (msg->GetSpace() < 512)
-        {
-            player.WriteToOutput(*msg);
-            msg = Net::NetworkMessage::GetNew();
-        }
-    }
-
-    player.WriteToOutput(*msg);
+    leftObjects_.push_back(objectId);
 }
 
 void Game::PlayerJoin(uint32_t playerId)
 {
 #ifdef DEBUG_NET
-    ASSERT(GetSubsystem<Asynch::Dispatcher>()->IsDispatcherThread());
+    ASSERT(IsGameThread());
 #endif
     ea::shared_ptr<Player> player = GetSubsystem<PlayerManager>()->GetPlayerById(playerId);
     if (!player)
@@ -838,7 +899,8 @@ void Game::PlayerJoin(uint32_t playerId)
     player->data_.instanceUuid = instanceData_.uuid;
     UpdateEntity(player->data_);
 
-    SendInitStateToPlayer(*player);
+    // Existing objects are sent by the InterestComp when they are in range of the player
+    player->interestComp_->Clear();
 
     if (GetState() == ExecutionState::Running)
     {
@@ -851,34 +913,27 @@ void Game::PlayerJoin(uint32_t playerId)
 
     // From now on the player receives the game status
     players_[player->id_] = player.get();
-    Lua::CallFunction(luaState_, "onPlayerJoin", player.get());
+    Lua::CallFunction(luaEnv_, "onPlayerJoin", player.get());
 
     // Notify other servers that a player joined, e.g. for friend list
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::BroadcastPlayerLoggedIn,
-            shared_from_this(),
-            player))
-    );
+    Post(std::bind(&Game::BroadcastPlayerLoggedIn, shared_from_this(), player));
 }
 
 void Game::RemoveObject(GameObject* object)
 {
     if (!object)
         return;
-    auto it = objects_.find(object->id_);
-    if (it == objects_.end())
+    if (!objects_.Contains(object->id_))
         return;
 
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendLeaveObject, shared_from_this(), object->id_))
-    );
+    Schedule(std::bind(&Game::SendLeaveObject, shared_from_this(), object->id_));
     InternalRemoveObject(object);
 }
 
 void Game::PlayerLeave(uint32_t playerId)
 {
 #ifdef DEBUG_NET
-    ASSERT(GetSubsystem<Asynch::Dispatcher>()->IsDispatcherThread());
+    ASSERT(IsGameThread());
 #endif
     Player* player = GetPlayerById(playerId);
     if (!player)
@@ -888,22 +943,15 @@ void Game::PlayerLeave(uint32_t playerId)
     auto it = players_.find(playerId);
     if (it != players_.end())
     {
-        Lua::CallFunction(luaState_, "onPlayerLeave", player);
+        Lua::CallFunction(luaEnv_, "onPlayerLeave", player);
         players_.erase(it);
     }
     player->data_.instanceUuid = "";
     UpdateEntity(player->data_);
 
-    auto* sched = GetSubsystem<Asynch::Scheduler>();
-    sched->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendLeaveObject, shared_from_this(), playerId))
-    );
+    Schedule(std::bind(&Game::SendLeaveObject, shared_from_this(), playerId));
     // Notify other servers that a player left, e.g. for friend list
-    sched->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::BroadcastPlayerLoggedOut,
-            shared_from_this(),
-            player->GetPtr<Player>()))
-    );
+    Post(std::bind(&Game::BroadcastPlayerLoggedOut, shared_from_this(), player->GetPtr<Player>()));
     InternalRemoveObject(player);
 }
 
@@ -21,16 +21,22 @@
 
 #pragma once
 
+#include "AiScheduler.h"
 #include "Chat.h"
 #include "Config.h"
+#include "GcManager.h"
 #include "GameObject.h"
 #include "GameStream.h"
+#include "LuaEnvironment.h"
 #include "Map.h"
 #include "NavigationMesh.h"
+#include "ObjectList.h"
 #include "PartyManager.h"
+#include "ProximityIndex.h"
 #include <AB/Entities/Game.h>
 #include <AB/Entities/GameInstance.h>
 #include <abscommon/NetworkMessage.h>
+#include <abscommon/Scheduler.h>
 #include <atomic>
 #include <CleanupNs.h>
 #include <eastl.hpp>
@@ -41,6 +47,7 @@
 
 namespace Net {
 class MessageFilter;
+class FilteredMessage;
 }
 
 namespace Game {
@@ -52,9 +59,6 @@ class ItemDrop;
 class Projectile;
 class Crowd;
 
-/// The list which owns the objects. We use a std::map because we want to
-/// have it in the order of creation (allocation) when Update() is called.
-using ObjectList = ea::map<uint32_t, ea::shared_ptr<GameObject>>;
 using PlayersList = ea::unordered_map<uint32_t, Player*>;
 using GroupList = ea::unordered_map<uint32_t, ea::unique_ptr<Group>>;
 
@@ -79,9 +83,18 @@ private:
     uint32_t noplayerTime_{ 0 };
     /// The primary owner of the game objects
     ObjectList objects_;
+    /// Which objects are in which range of each other
+    ProximityIndex proximity_;
+    /// Runs the behavior trees of the NPCs
+    AiScheduler aiScheduler_{ AI_TICK_BUDGET_US };
     PlayersList players_;
     GroupList groups_;
-    kaguya::State luaState_;
+    /// The Lua VM of this game. The game script and the scripts of NPCs, AOEs etc.
+    /// run in it, each one in its own environment.
+    ea::shared_ptr<Lua::SharedState> scriptState_;
+    Lua::Environment luaEnv_;
+    /// Runs the GC of the game VM and the VMs of the players in this game
+    Lua::GcManager gcManager_;
     /// First player(s) triggering the creation of this game
     ea::vector<ea::shared_ptr<GameObject>> queuedObjects_;
     void InitializeLua();
@@ -97,6 +110,11 @@ private:
     }
     /// Changes to the game are written to this message and sent to all players
     std::unique_ptr<Net::NetworkMessage> gameStatus_;
+    /// gameStatus_ decoded once per tick when some players get a filtered version
+    ea::unique_ptr<Net::FilteredMessage> filteredStatus_;
+    /// Objects spawned and removed since the last status was sent
+    ea::unordered_set<uint32_t> spawnedObjects_;
+    ea::vector<uint32_t> leftObjects_;
     /// Stream to record games
     std::unique_ptr<IO::GameWriteStream> writeStream_;
     template<typename E>
@@ -145,8 +163,6 @@ private:
     void InternalRemoveObject(GameObject* object);
     void SendSpawnObject(ea::shared_ptr<GameObject> object);
     void SendLeaveObject(uint32_t objectId);
-    /// Send spawn message for all existing objects
-    void SendInitStateToPlayer(Player& player);
 public:
     static void RegisterLua(kaguya::State& state);
 
@@ -162,6 +178,8 @@ public:
     AB::Entities::GameInstance instanceData_;
 
     ea::unique_ptr<Map> map_;
+    /// Index of the GameExecutor worker which runs this game
+    size_t workerIndex_{ 0 };
 
     int64_t GetUpdateTick() const { return lastUpdate_; }
     uint32_t GetPlayerCount() const { return static_cast<uint32_t>(players_.size()); }
@@ -173,6 +191,10 @@ public:
     Player* GetPlayerById(uint32_t playerId);
     Player* GetPlayerByName(const std::string& name);
     const ObjectList& GetObjects() const { return objects_; }
+    const AiScheduler& GetAiScheduler() const { return aiScheduler_; }
+    const Lua::GcManager& GetGcManager() const { return gcManager_; }
+    /// Only use it on the thread running this game
+    ea::shared_ptr<Lua::SharedState> GetScriptState() const { return scriptState_; }
     template <typename T>
     T* GetObject(uint32_t id)
     {
@@ -222,6 +244,12 @@ public:
             return false;
         return noplayerTime_ > GAME_INACTIVE_TIME;
     }
+    /// Execute a function on the thread running this game
+    void Post(std::function<void(void)>&& f);
+    /// Execute a function on the thread running this game after delay ms
+    void Schedule(uint32_t delay, std::function<void(void)>&& f);
+    void Schedule(std::function<void(void)>&& f) { Schedule(Asynch::SCHEDULER_MINTICKS, std::move(f)); }
+    bool IsGameThread() const;
     void CallLuaEvent(const std::string& name, GameObject* sender, GameObject* data);
     void SetState(ExecutionState state);
     void Load(const std::string& mapUuid);
@@ -229,7 +257,7 @@ public:
     void RemoveObject(GameObject* object);
     void BroadcastPlayerChanged(const Player& player, uint32_t fields);
 
-    /// From GameProtocol (Dispatcher Thread)
+    /// From GameProtocol (Game Thread)
     void PlayerJoin(uint32_t playerId);
     void PlayerLeave(uint32_t playerId);
 
@@ -237,27 +265,23 @@ public:
     template<typename O = GameObject, typename Callback>
     void VisitObjects(Callback&& callback)
     {
-        for (auto& object : objects_)
+        objects_.VisitObjects([&](GameObject& object)
         {
-            if (object.second && Is<O>(*object.second))
-            {
-                if (callback(To<O>(*object.second)) != Iteration::Continue)
-                    break;
-            }
-        }
+            if (!Is<O>(object))
+                return Iteration::Continue;
+            return callback(To<O>(object));
+        });
     }
     // Visit all objects. Const version
     template<typename O = GameObject, typename Callback>
     void VisitObjects(Callback&& callback) const
     {
-        for (auto& object : objects_)
+        objects_.VisitObjects([&](const GameObject& object)
         {
-            if (object.second && Is<O>(*object.second))
-            {
-                if (callback(To<O>(*object.second)) != Iteration::Continue)
-                    break;
-            }
-        }
+            if (!Is<O>(object))
+                return Iteration::Continue;
+            return callback(To<O>(object));
+        });
     }
     template<typename Callback>
     void VisitPlayers(Callback&& callback)
@@ -280,18 +304,12 @@ public:
 template <>
 SA_ALWAYS_INLINE GameObject* Game::GetObject<GameObject>(uint32_t id)
 {
-    const auto it = objects_.find(id);
-    if (it == objects_.end())
-        return nullptr;
-    return (*it).second.get();
+    return objects_.Get(id);
 }
 template <>
 SA_ALWAYS_INLINE const GameObject* Game::GetObject<GameObject>(uint32_t id) const
 {
-    const auto it = objects_.find(id);
-    if (it == objects_.end())
-        return nullptr;
-    return (*it).second.get();
+    return objects_.Get(id);
 }
 
 }
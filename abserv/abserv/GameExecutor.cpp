@@ -0,0 +1,137 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "GameExecutor.h"
+#include <abscommon/Subsystems.h>
+#include <sa/Assert.h>
+
+namespace Game {
+
+GameExecutor::~GameExecutor()
+{
+    Stop();
+}
+
+void GameExecutor::SetNumWorkers(size_t value)
+{
+    ASSERT(!running_);
+    numWorkers_ = std::max<size_t>(1, value);
+}
+
+void GameExecutor::Start()
+{
+    if (running_)
+        return;
+
+    std::scoped_lock lock(lock_);
+    workers_.resize(numWorkers_);
+    workers_[0].dispatcher = GetSubsystem<Asynch::Dispatcher>();
+    for (size_t i = 1; i < numWorkers_; ++i)
+    {
+        workers_[i].ownDispatcher = ea::make_unique<Asynch::Dispatcher>();
+        workers_[i].dispatcher = workers_[i].ownDispatcher.get();
+        workers_[i].dispatcher->Start();
+    }
+    running_ = true;
+}
+
+void GameExecutor::Stop()
+{
+    if (!running_)
+        return;
+
+    std::scoped_lock lock(lock_);
+    running_ = false;
+    for (auto& worker : workers_)
+    {
+        // The default Dispatcher is stopped by the Application
+        if (worker.ownDispatcher)
+            worker.ownDispatcher->Stop();
+    }
+    workers_.clear();
+}
+
+size_t GameExecutor::AcquireWorker()
+{
+    std::scoped_lock lock(lock_);
+    if (workers_.empty())
+        return 0;
+    size_t result = 0;
+    for (size_t i = 1; i < workers_.size(); ++i)
+    {
+        if (workers_[i].games < workers_[result].games)
+            result = i;
+    }
+    ++workers_[result].games;
+    return result;
+}
+
+void GameExecutor::ReleaseWorker(size_t index)
+{
+    std::scoped_lock lock(lock_);
+    if (index < workers_.size() && workers_[index].games > 0)
+        --workers_[index].games;
+}
+
+Asynch::Dispatcher* GameExecutor::GetDispatcher(size_t index) const
+{
+    if (index < workers_.size())
+        return workers_[index].dispatcher;
+    return GetSubsystem<Asynch::Dispatcher>();
+}
+
+void GameExecutor::Add(size_t index, std::function<void(void)>&& f)
+{
+    if (auto* disp = GetDispatcher(index))
+        disp->Add(Asynch::CreateTask(std::move(f)));
+}
+
+uint32_t GameExecutor::Schedule(size_t index, uint32_t delay, std::function<void(void)>&& f)
+{
+    auto* task = Asynch::CreateScheduledTask(delay, std::move(f));
+    task->SetDispatcher(GetDispatcher(index));
+    return GetSubsystem<Asynch::Scheduler>()->Add(task);
+}
+
+bool GameExecutor::IsWorkerThread(size_t index) const
+{
+    if (auto* disp = GetDispatcher(index))
+        return disp->IsDispatcherThread();
+    return false;
+}
+
+uint32_t GameExecutor::GetUtilization(size_t index) const
+{
+    if (auto* disp = GetDispatcher(index))
+        return disp->GetUtilization();
+    return 0;
+}
+
+uint32_t GameExecutor::GetMaxUtilization() const
+{
+    std::scoped_lock lock(lock_);
+    uint32_t result = 0;
+    for (const auto& worker : workers_)
+        result = std::max(result, worker.dispatcher->GetUtilization());
+    return result;
+}
+
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <abscommon/Dispatcher.h>
+#include <abscommon/Scheduler.h>
+#include <eastl.hpp>
+#include <functional>
+#include <mutex>
+
+namespace Game {
+
+/// Runs game updates on one or more threads. Each Game is pinned to one worker,
+/// so all its objects, its Lua state and its status message are only touched by
+/// that thread. Worker 0 is the default Dispatcher, so with one worker nothing
+/// changes compared to running everything on the Dispatcher.
+class GameExecutor
+{
+private:
+    struct Worker
+    {
+        Asynch::Dispatcher* dispatcher{ nullptr };
+        /// Dispatchers owned by the executor. Worker 0 uses the default Dispatcher.
+        ea::unique_ptr<Asynch::Dispatcher> ownDispatcher;
+        unsigned games{ 0 };
+    };
+    mutable std::mutex lock_;
+    ea::vector<Worker> workers_;
+    size_t numWorkers_{ 1 };
+    bool running_{ false };
+public:
+    GameExecutor() = default;
+    ~GameExecutor();
+
+    /// Must be called before Start()
+    void SetNumWorkers(size_t value);
+    size_t GetNumWorkers() const { return numWorkers_; }
+    void Start();
+    void Stop();
+
+    /// Returns the index of the worker with the least games and counts the game for it.
+    size_t AcquireWorker();
+    void ReleaseWorker(size_t index);
+    Asynch::Dispatcher* GetDispatcher(size_t index) const;
+    /// Execute a task on the given worker
+    void Add(size_t index, std::function<void(void)>&& f);
+    /// Execute a task on the given worker after delay ms
+    uint32_t Schedule(size_t index, uint32_t delay, std::function<void(void)>&& f);
+    bool IsWorkerThread(size_t index) const;
+    /// Utilization of a worker in %
+    uint32_t GetUtilization(size_t index) const;
+    /// Utilization of the busiest worker in %
+    uint32_t GetMaxUtilization() const;
+};
+
+}
@@ -23,6 +23,7 @@
 #include "GameManager.h"
 #include "AiDebugServer.h"
 #include "Game.h"
+#include "GameExecutor.h"
 #include "Group.h"
 #include "IOGame.h"
 #include "Npc.h"
@@ -64,6 +65,7 @@ ea::shared_ptr<Game> GameManager::CreateGame(const std::string& mapUuid)
     {
         std::scoped_lock lock(lock_);
         game->id_ = GetNewGameId();
+        game->workerIndex_ = GetSubsystem<GameExecutor>()->AcquireWorker();
         games_[game->id_] = game;
         maps_[mapUuid].push_back(game.get());
     }
@@ -91,6 +93,7 @@ void GameManager::DeleteGameTask(uint32_t gameId)
         // games_.size() may be called from another thread so lock it
         std::scoped_lock lock(lock_);
         GetSubsystem<AI::DebugServer>()->RemoveGame(gameId);
+        GetSubsystem<GameExecutor>()->ReleaseWorker((*it).second->workerIndex_);
         maps_.erase((*it).second->data_.uuid);
         games_.erase(it);
     }
@@ -105,64 +105,15 @@ GameObject::~GameObject()
     RemoveFromOctree();
 }
 
-void GameObject::UpdateRanges()
-{
-    // Most objects are static objects or terrain patches, which do not have any logic,
-    // so we can skip this, which is very expensive. It was always on top of profiles.
-    if (GetType() <= AB::GameProtocol::GameObjectType::__SentToPlayer)
-        return;
-
-    ranges_.clear();
-    ea::vector<Math::OctreeObject*> res;
-
-    const SentToPlayerMatcher matcher;
-    // Compass radius
-    if (QueryObjects(res, RANGE_INTEREST, &matcher))
-    {
-        const Math::Vector3& myPos = GetPosition();
-        for (const auto* oo : res)
-        {
-            const auto* o = static_cast<const GameObject*>(oo);
-            const Math::Vector3& objectPos = o->GetPosition();
-            const float dist = myPos.Distance(objectPos) - AVERAGE_BB_EXTENDS;
-            if (dist <= RANGE_AGGRO)
-                ranges_[Ranges::Aggro].emplace(o->id_);
-            if (dist <= RANGE_COMPASS)
-                ranges_[Ranges::Compass].emplace(o->id_);
-            if (dist <= RANGE_SPIRIT)
-                ranges_[Ranges::Spirit].emplace(o->id_);
-            if (dist <= RANGE_EARSHOT)
-                ranges_[Ranges::Earshot].emplace(o->id_);
-            if (dist <= RANGE_CASTING)
-                ranges_[Ranges::Casting].emplace(o->id_);
-            if (dist <= RANGE_PROJECTILE)
-                ranges_[Ranges::Projectile].emplace(o->id_);
-            if (dist <= RANGE_HALF_COMPASS)
-                ranges_[Ranges::HalfCompass].emplace(o->id_);
-            if (dist <= RANGE_TOUCH)
-                ranges_[Ranges::Touch].emplace(o->id_);
-            if (dist <= RANGE_ADJECENT)
-                ranges_[Ranges::Adjecent].emplace(o->id_);
-            if (dist <= RANGE_VISIBLE)
-                ranges_[Ranges::Visible].emplace(o->id_);
-            if (dist <= RANGE_TWO_COMPASS)
-                ranges_[Ranges::TwoCompass].emplace(o->id_);
-            if (dist <= RANGE_INTEREST)
-                ranges_[Ranges::Interest].emplace(o->id_);
-        }
-    }
-}
-
 void GameObject::Update(uint32_t timeElapsed, Net::NetworkMessage&)
 {
-    UpdateRanges();
     if (triggerComp_)
         triggerComp_->Update(timeElapsed);
 
     if (removeAt_ != 0 && removeAt_ <= sa::time::tick())
     {
-        auto* disp = GetSubsystem<Asynch::Dispatcher>();
-        disp->Add(Asynch::CreateTask(std::bind(&GameObject::Remove, shared_from_this())));
+        if (auto game = GetGame())
+            game->Post(std::bind(&GameObject::Remove, shared_from_this()));
     }
 }
 
@@ -441,12 +392,7 @@ bool GameObject::IsInRange(Ranges range, const GameObject* object) const
     if (range == Ranges::Map)
         return true;
     // Don't calculate the distance now, but use previously calculated values.
-    const auto rIt = ranges_.find(range);
-    if (rIt == ranges_.end())
-        return false;
-    const auto& r = (*rIt).second;
-    const auto it = r.find(object->id_);
-    return it != r.end();
+    return ranges_.IsInRange(object->id_, range);
 }
 
 bool GameObject::IsCloserThan(float maxDist, const GameObject* object) const
@@ -732,12 +678,12 @@ void GameObject::VisitInRange(Ranges range, const std::function<Iteration(GameOb
 {
     auto game = GetGame();
     ASSERT(game);
-    const auto r = ranges_.find(range);
-    if (r == ranges_.end())
-        return;
-    for (uint32_t objectId : (*r).second)
+    const uint16_t bit = RangeList::GetBit(range);
+    for (const auto& item : ranges_)
     {
-        auto* object = game->GetObject<GameObject>(objectId);
+        if ((item.ranges & bit) == 0)
+            continue;
+        auto* object = game->GetObject<GameObject>(item.id);
         if (object)
         {
             if (func(*object) != Iteration::Continue)
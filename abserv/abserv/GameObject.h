@@ -24,6 +24,7 @@
 #include <abshared/Damage.h>
 #include <absmath/OctreeObject.h>
 #include <absmath/OctreeQuery.h>
+#include "ProximityIndex.h"
 #include "StateComp.h"
 #include <AB/Entities/Character.h>
 #include <AB/Entities/Skill.h>
@@ -106,6 +107,7 @@ inline const float AVERAGE_BB_EXTENDS = 0.3f;
 class GameObject : public Math::OctreeObject, public ea::enable_shared_from_this<GameObject>
 {
     NON_COPYABLE(GameObject)
+    friend class ProximityIndex;
 public:
     static sa::IdGenerator<uint32_t> objectIds_;
 private:
@@ -153,8 +155,8 @@ protected:
     Utils::VariantMap variables_;
     ea::weak_ptr<Game> game_;
     GameObjectEvents events_;
-    ea::map<Ranges, ea::set<uint32_t>> ranges_;
-    void UpdateRanges();
+    /// Maintained by the ProximityIndex of the game
+    RangeList ranges_;
     uint32_t GetNewId()
     {
         return objectIds_.Next();
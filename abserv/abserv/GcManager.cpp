@@ -0,0 +1,139 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "GcManager.h"
+#include "Config.h"
+#include "LuaEnvironment.h"
+#include <atomic>
+#include <chrono>
+
+namespace Game {
+namespace Lua {
+
+int64_t GcManager::tickBudgetUs = LUA_GC_TICK_BUDGET_US;
+
+namespace {
+std::atomic<uint64_t> heapSize{ 0 };
+std::atomic<uint64_t> steps{ 0 };
+std::atomic<uint64_t> cycles{ 0 };
+std::atomic<uint64_t> emergencies{ 0 };
+std::atomic<uint64_t> timeUs{ 0 };
+}
+
+GcManager::GlobalStats GcManager::GetGlobalStats()
+{
+    return { heapSize.load(), steps.load(), cycles.load(), emergencies.load(), timeUs.load() };
+}
+
+GcManager::~GcManager()
+{
+    heapSize -= stats_.heapSize;
+}
+
+void GcManager::Add(SharedState& state)
+{
+    if (!state.IsManaged())
+        return;
+    if (ea::find(states_.begin(), states_.end(), &state) != states_.end())
+        return;
+    states_.push_back(&state);
+}
+
+bool GcManager::NeedsStep(SharedState& state, size_t heapSize)
+{
+    if (state.gcInCycle_)
+        return true;
+    // Same as the pause of the automatic GC: Start a new cycle when the heap grew enough
+    return heapSize >= state.gcEstimate_ / 100 * static_cast<size_t>(state.gcPause_);
+}
+
+bool GcManager::Step(SharedState& state)
+{
+    state.gcInCycle_ = true;
+    if (lua_gc(state.GetState().state(), LUA_GCSTEP, 0) == 0)
+        return false;
+    state.gcInCycle_ = false;
+    state.gcEstimate_ = state.GetHeapSize();
+    return true;
+}
+
+void GcManager::Update()
+{
+    const size_t oldHeapSize = stats_.heapSize;
+    stats_ = {};
+    stats_.states = states_.size();
+    if (states_.empty())
+    {
+        heapSize -= oldHeapSize;
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    for (auto* state : states_)
+    {
+        state->Update();
+        // If the budget is too small for the garbage of a VM, it must not grow without limit
+        if (state->GetHeapSize() >= state->gcEstimate_ * LUA_GC_EMERGENCY_FACTOR)
+        {
+            lua_gc(state->GetState().state(), LUA_GCCOLLECT, 0);
+            state->gcInCycle_ = false;
+            state->gcEstimate_ = state->GetHeapSize();
+            ++stats_.emergencies;
+        }
+    }
+
+    // Round-robin, so with a small budget all VMs get their turn
+    size_t idle = 0;
+    while (idle < states_.size())
+    {
+        const auto used = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        if (used >= tickBudgetUs)
+            break;
+        next_ = (next_ + 1) % states_.size();
+        SharedState& state = *states_[next_];
+        if (!NeedsStep(state, state.GetHeapSize()))
+        {
+            ++idle;
+            continue;
+        }
+        idle = 0;
+        ++stats_.steps;
+        if (Step(state))
+            ++stats_.cycles;
+    }
+
+    for (auto* state : states_)
+        stats_.heapSize += state->GetHeapSize();
+    stats_.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    states_.clear();
+
+    heapSize += stats_.heapSize;
+    heapSize -= oldHeapSize;
+    steps += stats_.steps;
+    cycles += stats_.cycles;
+    emergencies += stats_.emergencies;
+    timeUs += static_cast<uint64_t>(stats_.timeUs);
+}
+
+}
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <eastl.hpp>
+#include <sa/Noncopyable.h>
+
+namespace Game {
+namespace Lua {
+
+class SharedState;
+
+/// Runs the GC of the Lua VMs used by a game. Each tick it does GC steps round-robin
+/// across the VMs until the time budget is used up, so the GC cost of a tick does
+/// not depend on how many VMs allocated.
+class GcManager
+{
+    NON_COPYABLE(GcManager)
+    NON_MOVEABLE(GcManager)
+public:
+    struct Stats
+    {
+        size_t states{ 0 };
+        /// Heap of all states in bytes
+        size_t heapSize{ 0 };
+        uint32_t steps{ 0 };
+        /// Completed GC cycles
+        uint32_t cycles{ 0 };
+        /// Full collections because a heap grew too much
+        uint32_t emergencies{ 0 };
+        int64_t timeUs{ 0 };
+    };
+    /// Sum of all GcManagers since the start
+    struct GlobalStats
+    {
+        uint64_t heapSize;
+        uint64_t steps;
+        uint64_t cycles;
+        uint64_t emergencies;
+        uint64_t timeUs;
+    };
+    /// Time budget per tick in microseconds
+    static int64_t tickBudgetUs;
+    static GlobalStats GetGlobalStats();
+private:
+    ea::vector<SharedState*> states_;
+    size_t next_{ 0 };
+    Stats stats_;
+    static bool NeedsStep(SharedState& state, size_t heapSize);
+    /// @return true when the step finished a cycle
+    static bool Step(SharedState& state);
+public:
+    GcManager() = default;
+    ~GcManager();
+
+    /// Add a VM which is collected in the next Update(). Only managed states are added.
+    void Add(SharedState& state);
+    /// Do the GC steps of this tick and clear the list of VMs
+    void Update();
+    const Stats& GetStats() const { return stats_; }
+};
+
+}
+}
@@ -106,7 +106,7 @@ static void CreateObjects(Game::Map& map)
         case Math::ShapeType::TriangleMesh:
             object->SetCollisionShape(
                 ea::make_unique<Math::CollisionShape<Math::TriangleMesh>>(
-                    Math::ShapeType::TriangleMesh, *so->model->GetShape())
+                    Math::ShapeType::TriangleMesh, *so->model->GetShape(), so->model->bvh_)
             );
 #ifdef DEBUG_LOAD
             LOG_DEBUG << *object << ": TriangleMesh " << std::endl;
@@ -20,6 +20,7 @@
  */
 
 #include "IOModel.h"
+#include <absmath/Bvh.h>
 #include <absmath/Shape.h>
 #include <absmath/IO.h>
 #include <eastl.hpp>
@@ -32,6 +33,8 @@ bool IOModel::Import(Game::Model& asset, const std::string& name)
 
     asset.SetShape(ea::make_unique<Math::Shape>());
     const bool result = IO::LoadShape(name, *asset.GetShape(), asset.boundingBox_);
+    if (result)
+        asset.bvh_ = ea::make_shared<Math::Bvh>(*asset.GetShape());
 //    LOG_DEBUG << "Loaded model " << name << ", tris " << asset.GetShape()->GetTriangleCount() << std::endl;
     return result;
 }
@@ -79,36 +79,24 @@ static bool SavePlayerInventory(Game::Player& player)
 {
     ASSERT(player.inventoryComp_);
     IO::DataClient* client = GetSubsystem<IO::DataClient>();
-    // Equipment
-    player.inventoryComp_->VisitEquipement([client](Game::Item& item)
+    // Write all items with one request
+    std::vector<AB::Entities::ConcreteItem> items;
+    const auto collect = [&items](Game::Item& item)
     {
         item.concreteItem_.itemStats = item.stats_.ToString();
-        client->Update(item.concreteItem_);
-        client->Invalidate(item.concreteItem_);
+        items.push_back(item.concreteItem_);
         return Iteration::Continue;
-    });
+    };
+    player.inventoryComp_->VisitEquipement(collect);
+    player.inventoryComp_->VisitInventory(collect);
+    player.inventoryComp_->VisitChest(collect);
+    client->UpdateAll(items);
+    // Flush them now, the inventory and chest lists below are read from the DB
+    client->InvalidateAll(items);
 
-    // Inventory
-    player.inventoryComp_->VisitInventory([client](Game::Item& item)
-    {
-        item.concreteItem_.itemStats = item.stats_.ToString();
-        client->Update(item.concreteItem_);
-        client->Invalidate(item.concreteItem_);
-        return Iteration::Continue;
-    });
     AB::Entities::InventoryItems inventory;
     inventory.uuid = player.data_.uuid;
     client->Invalidate(inventory);
-
-    // Chest
-    player.inventoryComp_->VisitChest([client](Game::Item& item)
-    {
-        item.concreteItem_.itemStats = item.stats_.ToString();
-        client->Update(item.concreteItem_);
-        client->Invalidate(item.concreteItem_);
-        return Iteration::Continue;
-    });
-
     AB::Entities::ChestItems chest;
     chest.uuid = player.account_.uuid;
     client->Invalidate(chest);
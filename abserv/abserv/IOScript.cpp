@@ -21,30 +21,60 @@
 
 
 #include "IOScript.h"
+#include <abscommon/FileUtils.h>
+#include <abscommon/UuidUtils.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <lua.hpp>
 #include <llimits.h>
 #include <sa/ScopeGuard.h>
+#include <sa/StringHash.h>
+
+namespace fs = std::filesystem;
 
 namespace IO {
 
+std::string IOScript::cacheDir_;
+
+namespace {
+
+/// Written in front of the byte code in the cache files
+struct CacheHeader
+{
+    char magic[4]{ 'A', 'B', 'L', 'C' };
+    uint32_t luaVersion{ LUA_VERSION_NUM };
+    // Of the source file, if one changes the cache file is outdated
+    int64_t sourceTime{ 0 };
+    uint64_t sourceSize{ 0 };
+    bool operator==(const CacheHeader& rhs) const
+    {
+        return memcmp(magic, rhs.magic, sizeof(magic)) == 0 &&
+            luaVersion == rhs.luaVersion &&
+            sourceTime == rhs.sourceTime &&
+            sourceSize == rhs.sourceSize;
+    }
+};
+
+}
+
 static int writer(lua_State*, const void* p, size_t size, void* u)
 {
     if (size == 0)
         return 1;
     const char* addr = reinterpret_cast<const char*>(p);
-    ea::vector<char>& buffer = reinterpret_cast<Game::Script*>(u)->GetBuffer();
+    ea::vector<char>& buffer = *reinterpret_cast<ea::vector<char>*>(u);
     ea::copy(addr, addr + size, ea::back_inserter(buffer));
     return 0;
 }
 
-bool IOScript::Import(Game::Script& asset, const std::string& name)
+static bool Compile(const std::string& name, ea::vector<char>& buffer)
 {
     // https://stackoverflow.com/questions/8936369/compile-lua-code-store-bytecode-then-load-and-execute-it
     // https://stackoverflow.com/questions/17597816/lua-dump-in-c
     lua_State* L;
     L = luaL_newstate();
 
-    asset.GetBuffer().clear();
     sa::ScopeGuard luaGuard([&L]()
     {
         lua_close(L);
@@ -57,10 +87,92 @@ bool IOScript::Import(Game::Script& asset, const std::string& name)
         return false;
     }
     lua_lock(L);
-    lua_dump(L, writer, &asset, 1);
+    lua_dump(L, writer, &buffer, 1);
     lua_unlock(L);
 
     return true;
 }
 
+static std::string GetCacheFile(const std::string& name)
+{
+    char hash[32];
+    snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(sa::StringHashRt(name.c_str())));
+    return Utils::AddSlash(IOScript::cacheDir_) + hash + ".luac";
+}
+
+static bool ReadCache(const std::string& name, const CacheHeader& header, ea::vector<char>& buffer)
+{
+    std::ifstream in(GetCacheFile(name), std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+        return false;
+    const auto size = static_cast<size_t>(in.tellg());
+    if (size <= sizeof(CacheHeader))
+        return false;
+    in.seekg(0);
+    CacheHeader cached;
+    in.read(reinterpret_cast<char*>(&cached), sizeof(CacheHeader));
+    if (!in || !(cached == header))
+        return false;
+    buffer.resize(size - sizeof(CacheHeader));
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return !!in;
+}
+
+static void WriteCache(const std::string& name, const CacheHeader& header, const ea::vector<char>& buffer)
+{
+    std::error_code ec;
+    fs::create_directories(IOScript::cacheDir_, ec);
+    if (ec)
+        return;
+    const std::string fileName = GetCacheFile(name);
+    // Other servers may share the cache directory, so they must never see a half written file
+    const std::string tmpName = fileName + "." + Utils::Uuid::New();
+    {
+        std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!out)
+        {
+            out.close();
+            fs::remove(tmpName, ec);
+            return;
+        }
+    }
+    fs::rename(tmpName, fileName, ec);
+    if (ec)
+    {
+        LOG_WARNING << "Unable to write script cache file " << fileName << ": " << ec.message() << std::endl;
+        fs::remove(tmpName, ec);
+    }
+}
+
+bool IOScript::Import(Game::Script& asset, const std::string& name)
+{
+    CacheHeader header;
+    const bool useCache = !cacheDir_.empty();
+    if (useCache)
+    {
+        std::error_code ec;
+        header.sourceTime = static_cast<int64_t>(fs::last_write_time(name, ec).time_since_epoch().count());
+        header.sourceSize = static_cast<uint64_t>(fs::file_size(name, ec));
+        ea::vector<char> buffer;
+        if (!ec && ReadCache(name, header, buffer))
+        {
+            asset.GetBuffer() = std::move(buffer);
+            return true;
+        }
+    }
+
+    // When a changed file does not compile, keep the old byte code
+    ea::vector<char> buffer;
+    if (!Compile(name, buffer))
+        return false;
+    if (useCache)
+        WriteCache(name, header, buffer);
+    asset.GetBuffer() = std::move(buffer);
+    return true;
+}
+
 }
@@ -30,6 +30,9 @@ namespace IO {
 class IOScript final : public IOAssetImpl<Game::Script>
 {
 public:
+    /// If not empty the compiled scripts are also stored in this directory, so
+    /// they don't need to be compiled again on the next start.
+    static std::string cacheDir_;
     bool Import(Game::Script& asset, const std::string& name) override;
 };
 
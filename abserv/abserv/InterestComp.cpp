@@ -0,0 +1,136 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "InterestComp.h"
+#include "Game.h"
+#include "Party.h"
+#include "Player.h"
+#include <AB/Packets/Packet.h>
+#include <AB/Packets/ServerPackets.h>
+#include <abscommon/NetworkMessage.h>
+#include <abshared/Mechanic.h>
+
+namespace Game {
+namespace Components {
+
+// Objects must move a bit further away before they are despawned, so they
+// don't flicker when moving around the interest boundary.
+static constexpr float RANGE_INTEREST_LEAVE = RANGE_INTEREST * 1.1f;
+
+InterestComp::InterestComp(Player& owner) :
+    owner_(owner)
+{ }
+
+bool InterestComp::ShouldForget(const GameObject& object) const
+{
+    return owner_.GetDistance(&object) > RANGE_INTEREST_LEAVE;
+}
+
+void InterestComp::Update(const ea::unordered_set<uint32_t>& spawned)
+{
+    auto game = owner_.GetGame();
+    if (!game)
+        return;
+
+    interest_.clear();
+    interest_.emplace(owner_.id_);
+    // Party members are always known, e.g. for the party window
+    if (auto party = owner_.GetParty())
+    {
+        for (const auto& member : party->GetMembers())
+        {
+            if (auto m = member.lock())
+            {
+                if (game->GetObject<GameObject>(m->id_))
+                    interest_.emplace(m->id_);
+            }
+        }
+    }
+    owner_.VisitInRange(Ranges::Interest, [this](const GameObject& object)
+    {
+        interest_.emplace(object.id_);
+        return Iteration::Continue;
+    });
+
+    auto msg = Net::NetworkMessage::GetNew();
+    const auto flush = [&]()
+    {
+        // When many objects come into range at once, e.g. when entering a game,
+        // this may exceed the buffer size.
+        if (msg->GetSpace() < 512)
+        {
+            owner_.WriteToOutput(*msg);
+            msg = Net::NetworkMessage::GetNew();
+        }
+    };
+
+    for (auto it = known_.begin(); it != known_.end(); )
+    {
+        if (interest_.find(*it) != interest_.end())
+        {
+            ++it;
+            continue;
+        }
+        auto* object = game->GetObject<GameObject>(*it);
+        // A removed object is forgotten when the despawn in the game status was sent.
+        if (!object || !ShouldForget(*object))
+        {
+            ++it;
+            continue;
+        }
+        msg->AddByte(AB::GameProtocol::ServerPacketType::ObjectDespawn);
+        AB::Packets::Server::ObjectDespawn packet = {
+            *it
+        };
+        AB::Packets::Add(packet, *msg);
+        flush();
+        it = known_.erase(it);
+    }
+
+    for (uint32_t id : interest_)
+    {
+        if (known_.find(id) != known_.end())
+            continue;
+        known_.emplace(id);
+        // Spawned this tick, the spawn is in the game status
+        if (spawned.find(id) != spawned.end())
+            continue;
+        auto* object = game->GetObject<GameObject>(id);
+        if (!object)
+            continue;
+        msg->AddByte(AB::GameProtocol::ServerPacketType::ObjectSpawnExisting);
+        object->WriteSpawnData(*msg);
+        flush();
+    }
+
+    if (msg->GetSize() != 0)
+        owner_.WriteToOutput(*msg);
+}
+
+void InterestComp::Clear()
+{
+    known_.clear();
+    interest_.clear();
+}
+
+}
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <sa/Noncopyable.h>
+#include <eastl.hpp>
+
+namespace Game {
+
+class Player;
+class GameObject;
+
+namespace Components {
+
+/// Keeps track of the objects the client of a player knows about. Objects
+/// coming into the interest range are spawned, objects leaving it are despawned.
+/// Updates of objects the client doesn't know are not sent to the player.
+class InterestComp
+{
+    NON_COPYABLE(InterestComp)
+    NON_MOVEABLE(InterestComp)
+private:
+    Player& owner_;
+    /// Objects the client knows
+    ea::unordered_set<uint32_t> known_;
+    /// Objects the player should know, rebuilt every update
+    ea::unordered_set<uint32_t> interest_;
+    bool ShouldForget(const GameObject& object) const;
+public:
+    InterestComp() = delete;
+    explicit InterestComp(Player& owner);
+    ~InterestComp() = default;
+
+    /// Called before the game status is sent to the player. Sends spawns and
+    /// despawns of objects crossing the interest boundary. Objects in spawned
+    /// are spawned with the game status.
+    void Update(const ea::unordered_set<uint32_t>& spawned);
+    /// Object was removed from the game and the despawn was sent
+    void Forget(uint32_t id) { known_.erase(id); }
+    void Clear();
+    bool IsKnown(uint32_t id) const { return known_.find(id) != known_.end(); }
+    size_t GetKnownCount() const { return known_.size(); }
+};
+
+}
+}
@@ -50,15 +50,16 @@ void Item::RegisterLua(kaguya::State& state)
 Item::Item(const AB::Entities::Item& item) :
     data_(item)
 {
-    InitializeLua();
+    // Items are cached and shared by all games, so they need their own VM
+    InitializeLua({});
 }
 
 Item::~Item() = default;
 
-void Item::InitializeLua()
+void Item::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
 }
 
 void Item::RemoveFromCache()
@@ -97,36 +98,36 @@ bool Item::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    if (!script->Execute(luaEnv_))
         return false;
 
-    if (Lua::IsFunction(luaState_, "onUpdate"))
+    if (Lua::IsFunction(luaEnv_, "onUpdate"))
         sa::bits::set(functions_, FunctionUpdate);
-    if (Lua::IsFunction(luaState_, "getDamage"))
+    if (Lua::IsFunction(luaEnv_, "getDamage"))
         sa::bits::set(functions_, FunctionGetDamage);
-    if (Lua::IsFunction(luaState_, "getDamageType"))
+    if (Lua::IsFunction(luaEnv_, "getDamageType"))
         sa::bits::set(functions_, FunctionGetDamageType);
-    if (Lua::IsFunction(luaState_, "onEquip"))
+    if (Lua::IsFunction(luaEnv_, "onEquip"))
         sa::bits::set(functions_, FunctionOnEquip);
-    if (Lua::IsFunction(luaState_, "onUnequip"))
+    if (Lua::IsFunction(luaEnv_, "onUnequip"))
         sa::bits::set(functions_, FunctionOnUnequip);
-    if (Lua::IsFunction(luaState_, "getSkillCost"))
+    if (Lua::IsFunction(luaEnv_, "getSkillCost"))
         sa::bits::set(functions_, FunctionGetSkillCost);
-    if (Lua::IsFunction(luaState_, "getSkillRecharge"))
+    if (Lua::IsFunction(luaEnv_, "getSkillRecharge"))
         sa::bits::set(functions_, FunctionGetSkillRecharge);
     return true;
 }
 
 void Item::CreateGeneralStats(uint32_t level, bool maxStats)
 {
-    if (!Lua::IsFunction(luaState_, "getValueStat"))
+    if (!Lua::IsFunction(luaEnv_, "getValueStat"))
         return;
 
     auto setValues = [&](int number)
     {
         uint32_t index;
         uint32_t count;
-        kaguya::tie(index, count) = luaState_["getValueStat"](number, level, maxStats);
+        kaguya::tie(index, count) = luaEnv_["getValueStat"](number, level, maxStats);
         if (index != 0 && count != 0)
         {
             stats_.SetValue(static_cast<int>(ItemStatIndex::Material1Index) + ((number - 1) * 2), index);
@@ -139,11 +140,11 @@ void Item::CreateGeneralStats(uint32_t level, bool maxStats)
 
 void Item::CreateAttributeStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getAttributeStats"))
+    if (Lua::IsFunction(luaEnv_, "getAttributeStats"))
     {
         int32_t attribIndex = 0;
         int32_t attribValue = 0;
-        kaguya::tie(attribIndex, attribValue) = luaState_["getAttributeStats"](level, maxStats);
+        kaguya::tie(attribIndex, attribValue) = luaEnv_["getAttributeStats"](level, maxStats);
         if (attribIndex > 0)
             stats_.SetValue(ItemStatIndex::Attribute, attribIndex);
         if (attribValue > -1)
@@ -153,54 +154,54 @@ void Item::CreateAttributeStats(uint32_t level, bool maxStats)
 
 void Item::CreateInsigniaStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getHealthStats"))
+    if (Lua::IsFunction(luaEnv_, "getHealthStats"))
     {
-        int32_t health = luaState_["getHealthStats"](level, maxStats);
+        int32_t health = luaEnv_["getHealthStats"](level, maxStats);
         stats_.SetValue(ItemStatIndex::Health, health);
     }
 }
 
 void Item::CreateWeaponStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getDamageStats"))
+    if (Lua::IsFunction(luaEnv_, "getDamageStats"))
     {
         int32_t minDamage = 0;
         int32_t maxDamage = 0;
-        kaguya::tie(minDamage, maxDamage) = luaState_["getDamageStats"](level, maxStats);
+        kaguya::tie(minDamage, maxDamage) = luaEnv_["getDamageStats"](level, maxStats);
         stats_.SetValue(ItemStatIndex::MinDamage, minDamage);
         stats_.SetValue(ItemStatIndex::MaxDamage, maxDamage);
     }
-    if (Lua::IsFunction(luaState_, "getDamageTypeStats"))
+    if (Lua::IsFunction(luaEnv_, "getDamageTypeStats"))
     {
         int attrib = static_cast<int>(stats_.GetAttribute());
-        int32_t damageType = luaState_["getDamageTypeStats"](level, maxStats, attrib);
+        int32_t damageType = luaEnv_["getDamageTypeStats"](level, maxStats, attrib);
         stats_.SetValue(ItemStatIndex::DamageType, damageType);
     }
 }
 
 void Item::CreateFocusStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getEnergyStats"))
+    if (Lua::IsFunction(luaEnv_, "getEnergyStats"))
     {
-        int32_t energy = luaState_["getEnergyStats"](level, maxStats);
+        int32_t energy = luaEnv_["getEnergyStats"](level, maxStats);
         stats_.SetValue(ItemStatIndex::Energy, energy);
     }
 }
 
 void Item::CreateShieldStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getArmorStats"))
+    if (Lua::IsFunction(luaEnv_, "getArmorStats"))
     {
-        int32_t armor = luaState_["getArmorStats"](level, maxStats);
+        int32_t armor = luaEnv_["getArmorStats"](level, maxStats);
         stats_.SetValue(ItemStatIndex::Armor, armor);
     }
 }
 
 void Item::CreateConsumeableStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getUsagesStats"))
+    if (Lua::IsFunction(luaEnv_, "getUsagesStats"))
     {
-        int32_t usages = luaState_["getUsagesStats"](level, maxStats);
+        int32_t usages = luaEnv_["getUsagesStats"](level, maxStats);
         stats_.SetValue(ItemStatIndex::Usages, usages);
     }
 }
@@ -269,7 +270,7 @@ bool Item::IsPossibleAttribute(Attribute attribute)
 void Item::Update(uint32_t timeElapsed)
 {
     if (HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](timeElapsed);
+        luaEnv_["onUpdate"](timeElapsed);
 
     auto* cache = GetSubsystem<ItemsCache>();
     for (auto& i : upgrades_)
@@ -606,7 +607,7 @@ void Item::GetSkillRecharge(Skill *skill, uint32_t &recharge)
 {
     if (HaveFunction(FunctionGetSkillRecharge))
     {
-        recharge = luaState_["getSkillRecharge"](skill, recharge);
+        recharge = luaEnv_["getSkillRecharge"](skill, recharge);
     }
 
     auto* cache = GetSubsystem<ItemsCache>();
@@ -623,7 +624,7 @@ void Item::GetSkillCost(Skill* skill, int32_t& activation, int32_t& energy, int3
     if (HaveFunction(FunctionGetSkillCost))
     {
         kaguya::tie(activation, energy, adrenaline, overcast, hp) =
-            luaState_["getSkillCost"](skill, activation, energy, adrenaline, overcast, hp);
+            luaEnv_["getSkillCost"](skill, activation, energy, adrenaline, overcast, hp);
     }
 
     auto* cache = GetSubsystem<ItemsCache>();
@@ -652,7 +653,7 @@ void Item::GetAttributeRank(Attribute index, uint32_t& value)
 void Item::OnEquip(Actor* target)
 {
     if (HaveFunction(FunctionOnEquip))
-        luaState_["onEquip"](target);
+        luaEnv_["onEquip"](target);
 
     auto* cache = GetSubsystem<ItemsCache>();
     for (auto& i : upgrades_)
@@ -666,7 +667,7 @@ void Item::OnEquip(Actor* target)
 void Item::OnUnequip(Actor* target)
 {
     if (HaveFunction(FunctionOnUnequip))
-        luaState_["onUnequip"](target);
+        luaEnv_["onUnequip"](target);
 
     auto* cache = GetSubsystem<ItemsCache>();
     for (auto& i : upgrades_)
@@ -734,11 +735,11 @@ bool Item::Consume()
 {
     if (data_.type != AB::Entities::ItemType::Consumeable && data_.type != AB::Entities::ItemType::Dye)
         return false;
-    if (Lua::IsFunction(luaState_, "onConsume"))
+    if (Lua::IsFunction(luaEnv_, "onConsume"))
         return false;
     if (stats_.GetUsages() < 1)
         return false;
-    bool ret = luaState_["onConsume"]();
+    bool ret = luaEnv_["onConsume"]();
     if (ret)
     {
         stats_.DescreaseUsages();
@@ -751,7 +752,7 @@ void Item::GetWeaponDamage(int32_t& value, bool critical)
 {
     if (HaveFunction(FunctionGetDamage))
     {
-        float val = luaState_["getDamage"](baseMinDamage_, baseMaxDamage_, critical);
+        float val = luaEnv_["getDamage"](baseMinDamage_, baseMaxDamage_, critical);
         value = static_cast<int32_t>(val);
     }
 
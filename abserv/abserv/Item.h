@@ -22,6 +22,7 @@
 #pragma once
 
 #include "ItemStats.h"
+#include "LuaEnvironment.h"
 #include <AB/Entities/ConcreteItem.h>
 #include <AB/Entities/Item.h>
 #include <abshared/Attributes.h>
@@ -77,12 +78,12 @@ private:
         FunctionGetSkillCost = 1 << 5,
         FunctionGetSkillRecharge = 1 << 6,
     };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     uint32_t functions_{ FunctionNone };
     UpgradesMap upgrades_;
     int32_t baseMinDamage_{ 0 };
     int32_t baseMaxDamage_{ 0 };
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     bool HaveFunction(Function func) const
     {
         return sa::bits::is_set(functions_, func);
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "LuaEnvironment.h"
+#include "Config.h"
+#include "ScriptManager.h"
+
+namespace Game {
+namespace Lua {
+
+namespace {
+
+struct GcParams
+{
+    int pause;
+    int stepMul;
+};
+
+constexpr GcParams GC_PARAMS[] = {
+    { LUA_GC_PAUSE_GAME, LUA_GC_STEPMUL_GAME },
+    { LUA_GC_PAUSE_SKILLS, LUA_GC_STEPMUL_SKILLS },
+    { LUA_GC_PAUSE_QUESTS, LUA_GC_STEPMUL_QUESTS },
+    { LUA_GC_PAUSE_PRIVATE, LUA_GC_STEPMUL_PRIVATE },
+};
+
+}
+
+SharedState::SharedState(StateKind kind) :
+    kind_(kind)
+{
+    RegisterLuaAll(state_);
+
+    lua_State* L = state_.state();
+    const GcParams& params = GC_PARAMS[static_cast<size_t>(kind_)];
+    gcPause_ = params.pause;
+    lua_gc(L, LUA_GCSETPAUSE, params.pause);
+    lua_gc(L, LUA_GCSETSTEPMUL, params.stepMul);
+    if (IsManaged())
+        lua_gc(L, LUA_GCSTOP, 0);
+    gcEstimate_ = GetHeapSize();
+
+    lua_createtable(L, 0, 1);
+    lua_pushglobaltable(L);
+    lua_setfield(L, -2, "__index");
+    envMeta_ = luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+void SharedState::ReleasePending()
+{
+    std::scoped_lock lock(releaseLock_);
+    if (released_.empty())
+        return;
+    lua_State* L = state_.state();
+    for (int ref : released_)
+        luaL_unref(L, LUA_REGISTRYINDEX, ref);
+    released_.clear();
+}
+
+int SharedState::NewEnvironment()
+{
+    ReleasePending();
+
+    lua_State* L = state_.state();
+    lua_createtable(L, 0, 4);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, envMeta_);
+    lua_setmetatable(L, -2);
+    // Scripts included from this environment must run in it
+    lua_pushvalue(L, -1);
+    PushInclude(L);
+    lua_setfield(L, -2, "include");
+    return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+void SharedState::Release(int ref)
+{
+    std::scoped_lock lock(releaseLock_);
+    released_.push_back(ref);
+}
+
+size_t SharedState::GetHeapSize()
+{
+    lua_State* L = state_.state();
+    return static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB, 0));
+}
+
+void SharedState::Update()
+{
+    ReleasePending();
+}
+
+Environment::~Environment()
+{
+    if (shared_ && ref_ != LUA_NOREF)
+        shared_->Release(ref_);
+}
+
+void Environment::Create(ea::shared_ptr<SharedState> shared)
+{
+    ASSERT(!IsCreated());
+    if (shared)
+        shared_ = std::move(shared);
+    else
+        shared_ = ea::make_shared<SharedState>();
+    ref_ = shared_->NewEnvironment();
+}
+
+void Environment::Push() const
+{
+    ASSERT(IsCreated());
+    lua_rawgeti(state(), LUA_REGISTRYINDEX, ref_);
+}
+
+}
+}
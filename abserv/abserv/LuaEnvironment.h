@@ -0,0 +1,128 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <eastl.hpp>
+#include <kaguya/kaguya.hpp>
+#include <mutex>
+#include <sa/Assert.h>
+#include <sa/Noncopyable.h>
+
+namespace Game {
+namespace Lua {
+
+enum class StateKind
+{
+    Game,
+    Skills,
+    Quests,
+    /// A VM owned by a single object
+    Private
+};
+
+/// A Lua VM with all classes registered and the main script executed. The scripts
+/// of many objects run in it, each one in its own Environment. Like a private
+/// kaguya::State it must only be used by one thread at a time, e.g. the VM of a
+/// game is only used by the thread running the game.
+/// Private states use the automatic GC of Lua, the GC of all other states is
+/// stopped and driven by a GcManager.
+class SharedState
+{
+    NON_COPYABLE(SharedState)
+    NON_MOVEABLE(SharedState)
+    friend class GcManager;
+private:
+    kaguya::State state_;
+    StateKind kind_;
+    /// Heap size after the last completed GC cycle
+    size_t gcEstimate_{ 0 };
+    int gcPause_{ 0 };
+    /// A GC cycle was started and is not finished yet
+    bool gcInCycle_{ false };
+    /// Metatable of all environments, reads fall back to the globals
+    int envMeta_{ LUA_NOREF };
+    std::mutex releaseLock_;
+    /// Environments released on other threads
+    ea::vector<int> released_;
+    void ReleasePending();
+public:
+    explicit SharedState(StateKind kind = StateKind::Private);
+    ~SharedState() = default;
+
+    kaguya::State& GetState() { return state_; }
+    StateKind GetKind() const { return kind_; }
+    bool IsManaged() const { return kind_ != StateKind::Private; }
+    /// Memory used by the VM in bytes
+    size_t GetHeapSize();
+    /// Create a new environment table and return a reference to it in the registry
+    int NewEnvironment();
+    /// May be called from any thread, the reference is released when the owning
+    /// thread uses this state the next time.
+    void Release(int ref);
+    /// Release environments of deleted objects. Call once per tick.
+    void Update();
+};
+
+/// The globals of one script instance. Reads which are not found in the environment
+/// fall back to the globals of the SharedState, writes stay in the environment, so
+/// the scripts don't see each other.
+class Environment
+{
+    NON_COPYABLE(Environment)
+    NON_MOVEABLE(Environment)
+private:
+    ea::shared_ptr<SharedState> shared_;
+    int ref_{ LUA_NOREF };
+public:
+    Environment() = default;
+    ~Environment();
+
+    /// Create the environment in shared. If shared is null it gets its own VM.
+    void Create(ea::shared_ptr<SharedState> shared);
+    bool IsCreated() const { return ref_ != LUA_NOREF; }
+    lua_State* state() const
+    {
+        ASSERT(shared_);
+        return shared_->GetState().state();
+    }
+    /// Push the environment table on the stack
+    void Push() const;
+
+    kaguya::TableKeyReferenceProxy<std::string> operator[](const std::string& key)
+    {
+        lua_State* L = state();
+        const int top = lua_gettop(L);
+        Push();
+        return kaguya::TableKeyReferenceProxy<std::string>(L, top + 1, key, top);
+    }
+    kaguya::TableKeyReferenceProxy<const char*> operator[](const char* key)
+    {
+        lua_State* L = state();
+        const int top = lua_gettop(L);
+        Push();
+        return kaguya::TableKeyReferenceProxy<const char*>(L, top + 1, key, top);
+    }
+};
+
+}
+}
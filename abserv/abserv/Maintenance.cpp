@@ -25,12 +25,14 @@
 #include "Chat.h"
 #include "ConfigManager.h"
 #include "DataProvider.h"
+#include "GameExecutor.h"
 #include "GameManager.h"
 #include "PlayerManager.h"
 #include <AB/Entities/Service.h>
 #include <abscommon/CpuUsage.h>
 #include <abscommon/DataClient.h>
 #include <abscommon/FileWatcher.h>
+#include <abscommon/IoServicePool.h>
 #include <abscommon/ThreadPool.h>
 #include <sa/time.h>
 #include "Game.h"
@@ -117,6 +119,55 @@ void Maintenance::UpdateServerLoadTask()
     );
 }
 
+void Maintenance::StatsTask()
+{
+    // Build the lines first, other threads may log at the same time
+    std::string games;
+    auto* gameExecutor = GetSubsystem<Game::GameExecutor>();
+    for (size_t i = 0; i < gameExecutor->GetNumWorkers(); ++i)
+        games += " " + std::to_string(gameExecutor->GetUtilization(i)) + "%";
+    std::string network;
+    auto* ioPool = GetSubsystem<Net::IoServicePool>();
+    for (size_t i = 0; i < ioPool->GetNumThreads(); ++i)
+        network += " " + std::to_string(ioPool->GetUtilization(i)) + "%";
+    LOG_INFO << "Thread utilization: game" << games << ", network" << network << std::endl;
+
+    const Net::Connection::WriteStats stats = Net::Connection::GetWriteStats();
+    if (stats.writes != lastWriteStats_.writes)
+    {
+        const uint64_t messages = stats.messages - lastWriteStats_.messages;
+        const uint64_t writes = stats.writes - lastWriteStats_.writes;
+        LOG_INFO << "Network writes: " << messages << " messages, " << (stats.bytes - lastWriteStats_.bytes) <<
+            " bytes in " << writes << " writes, " << (messages - writes) << " saved" << std::endl;
+        lastWriteStats_ = stats;
+    }
+    const Net::Protocol::CompressionStats compression = Net::Protocol::GetCompressionStats();
+    if (compression.bytesIn != lastCompressionStats_.bytesIn)
+    {
+        const uint64_t in = compression.bytesIn - lastCompressionStats_.bytesIn;
+        const uint64_t out = compression.bytesOut - lastCompressionStats_.bytesOut;
+        LOG_INFO << "Network compression: " << in << " bytes to " << out << " bytes (" <<
+            (out * 100 / in) << "%)" << std::endl;
+        lastCompressionStats_ = compression;
+    }
+    const Game::Lua::GcManager::GlobalStats gc = Game::Lua::GcManager::GetGlobalStats();
+    if (gc.steps != lastGcStats_.steps || gc.emergencies != lastGcStats_.emergencies)
+    {
+        LOG_INFO << "Lua GC: heap " << (gc.heapSize / 1024) << " KB, " << (gc.steps - lastGcStats_.steps) <<
+            " steps, " << (gc.cycles - lastGcStats_.cycles) << " cycles, " <<
+            (gc.emergencies - lastGcStats_.emergencies) << " emergency collections in " <<
+            ((gc.timeUs - lastGcStats_.timeUs) / 1000) << " ms" << std::endl;
+        lastGcStats_ = gc;
+    }
+
+    if (status_ == Status::Runnig)
+    {
+        GetSubsystem<Asynch::Scheduler>()->Add(
+            Asynch::CreateScheduledTask(STATS_MS, std::bind(&Maintenance::StatsTask, this))
+        );
+    }
+}
+
 void Maintenance::UpdateGameInstances()
 {
     if (status_ != Status::Runnig)
@@ -195,6 +246,9 @@ void Maintenance::Run()
     shed->Add(
         Asynch::CreateScheduledTask(UPDATE_SERVER_LOAD_MS, std::bind(&Maintenance::UpdateServerLoadTask, this))
     );
+    shed->Add(
+        Asynch::CreateScheduledTask(STATS_MS, std::bind(&Maintenance::StatsTask, this))
+    );
     shed->Add(
         Asynch::CreateScheduledTask(UPDATE_INSTANCES_MS, std::bind(&Maintenance::UpdateGameInstances, this))
     );
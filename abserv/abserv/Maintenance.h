@@ -23,6 +23,9 @@
 
 #include <mutex>
 #include "Config.h"
+#include "GcManager.h"
+#include <abscommon/Connection.h>
+#include <abscommon/Protocol.h>
 
 class Maintenance
 {
@@ -33,11 +36,15 @@ private:
         Terminated
     };
     Status status_;
+    Net::Connection::WriteStats lastWriteStats_{};
+    Net::Protocol::CompressionStats lastCompressionStats_{};
+    Game::Lua::GcManager::GlobalStats lastGcStats_{};
     void CleanCacheTask();
     void CleanGamesTask();
     void CleanPlayersTask();
     void CleanChatsTask();
     void UpdateServerLoadTask();
+    void StatsTask();
     void FileWatchTask();
     void CheckAutoTerminate();
     void UpdateAiServer();
@@ -131,7 +131,8 @@ void MessageDispatcher::DispatchNewMail(const Net::MessageMsg& msg)
     ea::shared_ptr<Game::Player> player = GetSubsystem<Game::PlayerManager>()->GetPlayerByAccountUuid(recvAccUuid);
     if (!player)
         return;
-    player->NotifyNewMail();
+    // Players live on the thread of their game
+    player->RunOnGameThread([](Game::Player& p) { p.NotifyNewMail(); });
 }
 
 void MessageDispatcher::DispatchPlayerChanged(const Net::MessageMsg& msg)
@@ -186,7 +187,7 @@ void MessageDispatcher::DispatchPlayerChanged(const Net::MessageMsg& msg)
     {
         auto player = playerMan->GetPlayerByAccountUuid(acc);
         if (player)
-            player->SendPlayerInfo(ch, fields);
+            player->RunOnGameThread([ch, fields](Game::Player& p) { p.SendPlayerInfo(ch, fields); });
     }
 }
 
@@ -268,7 +269,10 @@ void MessageDispatcher::DispatchTeamsEnterMatch(const Net::MessageMsg& msg)
         auto pPlayer = playerMngr->GetPlayerByUuid(player);
         if (pPlayer)
         {
-            pPlayer->GetParty()->ChangeServerInstance(serverUuid, mapUuid, instanceUuid);
+            pPlayer->RunOnGameThread([serverUuid, mapUuid, instanceUuid](Game::Player& p)
+            {
+                p.GetParty()->ChangeServerInstance(serverUuid, mapUuid, instanceUuid);
+            });
         }
     }
 }
@@ -289,7 +293,7 @@ void MessageDispatcher::DispatchQueueAdded(const Net::MessageMsg& msg)
     auto* playerMngr = GetSubsystem<Game::PlayerManager>();
     auto pPlayer = playerMngr->GetPlayerByUuid(playerUuid);
     if (pPlayer)
-        pPlayer->GetParty()->NotifyPlayersQueued();
+        pPlayer->RunOnGameThread([](Game::Player& p) { p.GetParty()->NotifyPlayersQueued(); });
 }
 
 void MessageDispatcher::DispatchQueueRemoved(const Net::MessageMsg& msg)
@@ -305,7 +309,7 @@ void MessageDispatcher::DispatchQueueRemoved(const Net::MessageMsg& msg)
     auto* playerMngr = GetSubsystem<Game::PlayerManager>();
     auto pPlayer = playerMngr->GetPlayerByUuid(playerUuid);
     if (pPlayer)
-        pPlayer->GetParty()->NotifyPlayersUnqueued();
+        pPlayer->RunOnGameThread([](Game::Player& p) { p.GetParty()->NotifyPlayersUnqueued(); });
 }
 
 void MessageDispatcher::Dispatch(const Net::MessageMsg& msg)
@@ -28,12 +28,33 @@
 
 namespace Net {
 
-void MessageFilter::Execute(const Game::Game& game, const Game::Player& player, const NetworkMessage& source, NetworkMessage& dest)
+void FilteredMessage::AddSegment(size_t start, size_t end, Filter&& filter)
+{
+    if (start == end)
+        return;
+    if (!filter)
+    {
+        // Merge with the previous range when it's always sent too
+        if (!segments_.empty() && !segments_.back().filter && segments_.back().end == start)
+        {
+            segments_.back().end = end;
+            return;
+        }
+    }
+    else
+        needsFilter_ = true;
+    segments_.push_back({ start, end, std::move(filter) });
+}
+
+void MessageFilter::Prepare(const NetworkMessage& source, FilteredMessage& result)
 {
     using namespace AB::Packets::Server;
+    result.Clear();
+    result.source_ = &source;
     MessageDecoder decoder(source);
     for (;;)
     {
+        const size_t start = decoder.GetPos();
         auto code = decoder.GetNext();
         if (!code.has_value())
             return;
@@ -44,21 +65,53 @@ void MessageFilter::Execute(const Game::Game& game, const Game::Player& player,
             {                                                                                       \
                 v packet = AB::Packets::Get<v>(decoder);                                            \
                 constexpr size_t id = sa::StringHash(sa::TypeName<v>::Get());                       \
-                if (events_.HasSubscribers<bool(const Game::Game&, const Game::Player&, v&)>(id))   \
+                if (events_.HasSubscribers<bool(const Game::Game&, const Game::Player&, const v&)>(id)) \
                 {                                                                                   \
-                    if (!events_.CallOne<bool(const Game::Game&, const Game::Player&, v&)>(id, game, player, packet))  \
-                        continue;                                                                   \
+                    result.AddSegment(start, decoder.GetPos(),                                      \
+                        [this, packet = std::move(packet)](const Game::Game& game, const Game::Player& player) \
+                    {                                                                               \
+                        return events_.CallOne<bool(const Game::Game&, const Game::Player&, const v&)>(id, game, player, packet); \
+                    });                                                                             \
                 }                                                                                   \
-                Insert(dest, AB::GameProtocol::ServerPacketType::v, packet);                        \
+                else                                                                                \
+                    result.AddSegment(start, decoder.GetPos(), {});                                 \
                 break;                                                                              \
             }
             ENUMERATE_SERVER_PACKET_CODES
 #undef ENUMERATE_SERVER_PACKET_CODE
         default:
-            dest.Add(code.value());
-            break;
+            // Unknown packet, we can't know where it ends, so pass the rest unchanged.
+            LOG_WARNING << "Unknown packet code " << static_cast<int>(code.value()) << std::endl;
+            result.AddSegment(start, source.GetSize() + NetworkMessage::INITIAL_BUFFER_POSITION, {});
+            return;
+        }
+    }
+}
+
+void MessageFilter::Execute(const Game::Game& game, const Game::Player& player, const FilteredMessage& source, NetworkMessage& dest)
+{
+    ASSERT(source.source_);
+    const uint8_t* buffer = source.source_->GetBuffer();
+    // Copy adjacent kept packets at once
+    size_t runStart = 0;
+    size_t runEnd = 0;
+    auto flush = [&]()
+    {
+        if (runEnd > runStart)
+            dest.AddBytes(reinterpret_cast<const char*>(buffer + runStart), static_cast<uint32_t>(runEnd - runStart));
+    };
+    for (const auto& segment : source.segments_)
+    {
+        if (segment.filter && !segment.filter(game, player))
+            continue;
+        if (segment.start != runEnd)
+        {
+            flush();
+            runStart = segment.start;
         }
+        runEnd = segment.end;
     }
+    flush();
 }
 
 }
@@ -27,6 +27,8 @@
 #include <sa/Events.h>
 #include <sa/StringHash.h>
 #include <sa/TypeName.h>
+#include <functional>
+#include <eastl.hpp>
 
 namespace Game {
 class Game;
@@ -37,22 +39,48 @@ namespace Net {
 
 // Oh, well, I'm not sure about this...
 
+/// A message decoded once by MessageFilter::Prepare() and shared by all players.
+/// It's a list of byte ranges in the source message. Ranges of packets which
+/// may be filtered keep the decoded packet so we don't need to decode it again
+/// for each player.
+class FilteredMessage
+{
+    friend class MessageFilter;
+private:
+    using Filter = std::function<bool(const Game::Game&, const Game::Player&)>;
+    struct Segment
+    {
+        size_t start;
+        size_t end;
+        /// Empty when the packet is always sent
+        Filter filter;
+    };
+    const NetworkMessage* source_{ nullptr };
+    ea::vector<Segment> segments_;
+    bool needsFilter_{ false };
+    void AddSegment(size_t start, size_t end, Filter&& filter);
+public:
+    void Clear()
+    {
+        source_ = nullptr;
+        segments_.clear();
+        needsFilter_ = false;
+    }
+    /// Returns false if no packet has a filter subscriber, then the source
+    /// message can be sent to all players as it is.
+    bool NeedsFilter() const { return needsFilter_; }
+};
+
 class MessageFilter
 {
 private:
     using FilterEvents = sa::Events<
-#define ENUMERATE_SERVER_PACKET_CODE(v) bool(const Game::Game&, const Game::Player&, AB::Packets::Server::v&),
+#define ENUMERATE_SERVER_PACKET_CODE(v) bool(const Game::Game&, const Game::Player&, const AB::Packets::Server::v&),
         ENUMERATE_SERVER_PACKET_CODES
 #undef ENUMERATE_SERVER_PACKET_CODE
         bool(void)
     >;
     FilterEvents events_;
-    template<typename T>
-    static void Insert(NetworkMessage& dest, AB::GameProtocol::ServerPacketType type, T& packet)
-    {
-        dest.AddByte(type);
-        AB::Packets::Add(packet, dest);
-    }
 public:
     MessageFilter()
     { }
@@ -62,9 +90,12 @@ public:
     size_t Subscribe(Callback&& callback)
     {
         constexpr size_t id = sa::StringHash(sa::TypeName<T>::Get());
-        return events_.Subscribe<bool(const Game::Game&, const Game::Player&, T&)>(id, std::move(callback));
+        return events_.Subscribe<bool(const Game::Game&, const Game::Player&, const T&)>(id, std::move(callback));
     }
-    void Execute(const Game::Game& game, const Game::Player& player, const NetworkMessage& source, NetworkMessage& dest);
+    /// Decode the message once and find the packets that may be filtered
+    void Prepare(const NetworkMessage& source, FilteredMessage& result);
+    /// Copy the byte ranges of all packets the player should get to dest
+    void Execute(const Game::Game& game, const Game::Player& player, const FilteredMessage& source, NetworkMessage& dest);
 };
 
 }
@@ -27,6 +27,7 @@
 
 namespace Math {
 class Shape;
+class Bvh;
 }
 
 namespace Game {
@@ -46,6 +47,8 @@ public:
     Math::Shape* GetShape() const;
 
     Math::BoundingBox boundingBox_;
+    /// Triangle hierarchy of the shape, shared by the collision shapes of all objects using this model
+    ea::shared_ptr<Math::Bvh> bvh_;
 };
 
 }
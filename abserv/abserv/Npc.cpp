@@ -34,10 +34,10 @@
 
 namespace Game {
 
-void Npc::InitializeLua()
+void Npc::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
     luaInitialized_ = true;
 }
 
@@ -96,7 +96,6 @@ Npc::Npc() :
     events_.Subscribe<void(Actor*)>(EVENT_ON_INTERACT, std::bind(&Npc::OnInteract, this, std::placeholders::_1));
     // Party and Groups must be unique, i.e. share the same ID pool.
     groupId_ = Group::GetNewId();
-    InitializeLua();
 }
 
 Npc::~Npc()
@@ -111,31 +110,34 @@ bool Npc::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    // The game is set before the script is loaded, so it can run in the VM of the game
+    auto game = GetGame();
+    InitializeLua(game ? game->GetScriptState() : ea::shared_ptr<Lua::SharedState>());
+    if (!script->Execute(luaEnv_))
         return false;
 
-    name_ = static_cast<const char*>(luaState_["name"]);
-    level_ = luaState_["level"];
-    itemIndex_ = luaState_["itemIndex"];
-    if (Lua::IsNumber(luaState_, "sex"))
-        sex_ = luaState_["sex"];
-    if (Lua::IsNumber(luaState_, "interactionRange"))
-        interactionRange_ = static_cast<Ranges>(luaState_["interactionRange"]);
-    if (Lua::IsNumber(luaState_, "group_id"))
-        groupId_ = luaState_["group_id"];
-    if (Lua::IsBool(luaState_, "wander"))
-        SetWander(luaState_("wander"));
-
-    if (Lua::IsNumber(luaState_, "creatureState"))
-        stateComp_.SetState(luaState_["creatureState"], true);
+    name_ = static_cast<const char*>(luaEnv_["name"]);
+    level_ = luaEnv_["level"];
+    itemIndex_ = luaEnv_["itemIndex"];
+    if (Lua::IsNumber(luaEnv_, "sex"))
+        sex_ = luaEnv_["sex"];
+    if (Lua::IsNumber(luaEnv_, "interactionRange"))
+        interactionRange_ = static_cast<Ranges>(luaEnv_["interactionRange"]);
+    if (Lua::IsNumber(luaEnv_, "group_id"))
+        groupId_ = luaEnv_["group_id"];
+    if (Lua::IsBool(luaEnv_, "wander"))
+        SetWander(luaEnv_["wander"]);
+
+    if (Lua::IsNumber(luaEnv_, "creatureState"))
+        stateComp_.SetState(luaEnv_["creatureState"], true);
     else
         stateComp_.SetState(AB::GameProtocol::CreatureState::Idle, true);
 
     IO::DataClient* client = GetSubsystem<IO::DataClient>();
 
-    if (Lua::IsNumber(luaState_, "prof1Index"))
+    if (Lua::IsNumber(luaEnv_, "prof1Index"))
     {
-        skills_->prof1_.index = luaState_["prof1Index"];
+        skills_->prof1_.index = luaEnv_["prof1Index"];
         if (skills_->prof1_.index != 0)
         {
             if (!client->Read(skills_->prof1_))
@@ -144,9 +146,9 @@ bool Npc::LoadScript(const std::string& fileName)
             }
         }
     }
-    if (Lua::IsNumber(luaState_, "prof2Index"))
+    if (Lua::IsNumber(luaEnv_, "prof2Index"))
     {
-        skills_->prof2_.index = luaState_["prof2Index"];
+        skills_->prof2_.index = luaEnv_["prof2Index"];
         if (skills_->prof2_.index != 0)
         {
             if (!client->Read(skills_->prof2_))
@@ -157,20 +159,20 @@ bool Npc::LoadScript(const std::string& fileName)
     }
 
     std::string bt;
-    if (Lua::IsString(luaState_, "behavior"))
-        bt = static_cast<const char*>(luaState_["behavior"]);
-    if (Lua::IsFunction(luaState_, "onUpdate"))
+    if (Lua::IsString(luaEnv_, "behavior"))
+        bt = static_cast<const char*>(luaEnv_["behavior"]);
+    if (Lua::IsFunction(luaEnv_, "onUpdate"))
         sa::bits::set(functions_, FunctionUpdate);
-    if (Lua::IsFunction(luaState_, "onTrigger"))
+    if (Lua::IsFunction(luaEnv_, "onTrigger"))
         sa::bits::set(functions_, FunctionOnTrigger);
-    if (Lua::IsFunction(luaState_, "onLeftArea"))
+    if (Lua::IsFunction(luaEnv_, "onLeftArea"))
         sa::bits::set(functions_, FunctionOnLeftArea);
-    if (Lua::IsFunction(luaState_, "onGetQuote"))
+    if (Lua::IsFunction(luaEnv_, "onGetQuote"))
         sa::bits::set(functions_, FunctionOnGetQuote);
 
-    if (Lua::IsFunction(luaState_, "getSellingItemTypes"))
+    if (Lua::IsFunction(luaEnv_, "getSellingItemTypes"))
     {
-        std::vector<uint32_t> types = luaState_["getSellingItemTypes"]();
+        std::vector<uint32_t> types = luaEnv_["getSellingItemTypes"]();
         for (auto type : types)
         {
             sellItemTypes_.emplace(static_cast<AB::Entities::ItemType>(type));
@@ -184,7 +186,7 @@ bool Npc::LoadScript(const std::string& fileName)
     if (!bt.empty())
         SetBehavior(bt);
 
-    return luaState_["onInit"]();
+    return luaEnv_["onInit"]();
 }
 
 void Npc::SetLevel(uint32_t value)
@@ -195,18 +197,14 @@ void Npc::SetLevel(uint32_t value)
 
 void Npc::Update(uint32_t timeElapsed, Net::NetworkMessage& message)
 {
-    // I think first we should run the BT
-    if (aiComp_)
-        aiComp_->Update(timeElapsed);
+    // The BT was already run by the AiScheduler of the game
     if (wanderComp_)
         wanderComp_->Update(timeElapsed);
 
     Actor::Update(timeElapsed, message);
 
     if (luaInitialized_ && HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](timeElapsed);
-
-    Lua::CollectGarbage(luaState_);
+        luaEnv_["onUpdate"](timeElapsed);
 }
 
 bool Npc::SetBehavior(const std::string& name)
@@ -376,7 +374,7 @@ std::string Npc::GetQuote(int index)
 {
     if (!HaveFunction(FunctionOnGetQuote))
         return "";
-    const char* q = static_cast<const char*>(luaState_["onGetQuote"](index));
+    const char* q = static_cast<const char*>(luaEnv_["onGetQuote"](index));
     return q;
 }
 
@@ -444,13 +442,13 @@ void Npc::ShootAt(const std::string& itemUuid, Actor* target)
 void Npc::OnSelected(Actor* selector)
 {
     if (luaInitialized_ && selector)
-        Lua::CallFunction(luaState_, "onSelected", selector);
+        Lua::CallFunction(luaEnv_, "onSelected", selector);
 }
 
 void Npc::OnClicked(Actor* selector)
 {
     if (luaInitialized_ && selector)
-        Lua::CallFunction(luaState_, "onClicked", selector);
+        Lua::CallFunction(luaEnv_, "onClicked", selector);
     if (Is<Player>(selector))
     {
         if (!IsInRange(Ranges::Adjecent, selector))
@@ -465,121 +463,121 @@ void Npc::OnClicked(Actor* selector)
 void Npc::OnArrived()
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onArrived");
+        Lua::CallFunction(luaEnv_, "onArrived");
 }
 
 void Npc::OnCollide(GameObject* other)
 {
     if (luaInitialized_ && other)
-        Lua::CallFunction(luaState_, "onCollide", other);
+        Lua::CallFunction(luaEnv_, "onCollide", other);
 }
 
 void Npc::OnTrigger(GameObject* other)
 {
     if (luaInitialized_ && HaveFunction(FunctionOnTrigger))
-        Lua::CallFunction(luaState_, "onTrigger", other);
+        Lua::CallFunction(luaEnv_, "onTrigger", other);
 }
 
 void Npc::OnLeftArea(GameObject* other)
 {
     if (luaInitialized_ && HaveFunction(FunctionOnLeftArea))
-        Lua::CallFunction(luaState_, "onLeftArea", other);
+        Lua::CallFunction(luaEnv_, "onLeftArea", other);
 }
 
 void Npc::OnEndUseSkill(Skill* skill)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onEndUseSkill", skill);
+        Lua::CallFunction(luaEnv_, "onEndUseSkill", skill);
 }
 
 void Npc::OnStartUseSkill(Skill* skill)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onStartUseSkill", skill);
+        Lua::CallFunction(luaEnv_, "onStartUseSkill", skill);
 }
 
 void Npc::OnAttack(Actor* target, bool& canAttack)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onAttack", target, canAttack);
+        Lua::CallFunction(luaEnv_, "onAttack", target, canAttack);
 }
 
 void Npc::OnAttacked(Actor* source, DamageType type, int32_t damage, bool& canGetAttacked)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onAttacked", source, type, damage, canGetAttacked);
+        Lua::CallFunction(luaEnv_, "onAttacked", source, type, damage, canGetAttacked);
 }
 
 void Npc::OnGettingAttacked(Actor* source, bool& canGetAttacked)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onGettingAttacked", source, canGetAttacked);
+        Lua::CallFunction(luaEnv_, "onGettingAttacked", source, canGetAttacked);
 }
 
 void Npc::OnUseSkill(Actor* target, Skill* skill, bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onUseSkill", target, skill, success);
+        Lua::CallFunction(luaEnv_, "onUseSkill", target, skill, success);
 }
 
 void Npc::OnSkillTargeted(Actor* source, Skill* skill, bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onSkillTargeted", source, skill, success);
+        Lua::CallFunction(luaEnv_, "onSkillTargeted", source, skill, success);
 }
 
 void Npc::OnInteract(Actor* actor)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInteract", actor);
+        Lua::CallFunction(luaEnv_, "onInteract", actor);
 }
 
 void Npc::OnInterruptingAttack(bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptingAttack", success);
+        Lua::CallFunction(luaEnv_, "onInterruptingAttack", success);
 }
 
 void Npc::OnInterruptingSkill(AB::Entities::SkillType type, Skill* skill, bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptingSkill", type, skill, success);
+        Lua::CallFunction(luaEnv_, "onInterruptingSkill", type, skill, success);
 }
 
 void Npc::OnInterruptedAttack()
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptedAttack");
+        Lua::CallFunction(luaEnv_, "onInterruptedAttack");
 }
 
 void Npc::OnInterruptedSkill(Skill* skill)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptedSkill", skill);
+        Lua::CallFunction(luaEnv_, "onInterruptedSkill", skill);
 }
 
 void Npc::OnKnockedDown(uint32_t time)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onKnockedDown", time);
+        Lua::CallFunction(luaEnv_, "onKnockedDown", time);
 }
 
 void Npc::OnHealed(int hp)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onHealed", hp);
+        Lua::CallFunction(luaEnv_, "onHealed", hp);
 }
 
 void Npc::OnDied(Actor*, Actor*)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onDied");
+        Lua::CallFunction(luaEnv_, "onDied");
 }
 
 void Npc::OnResurrected(int, int)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onResurrected");
+        Lua::CallFunction(luaEnv_, "onResurrected");
 }
 
 void Npc::_LuaAddQuest(uint32_t index)
@@ -617,9 +615,9 @@ bool Npc::IsSellingItemType(AB::Entities::ItemType type) const
 
 bool Npc::IsSellingItem(uint32_t itemIndex)
 {
-    if (!Lua::IsFunction(luaState_, "isSellingItem"))
+    if (!Lua::IsFunction(luaEnv_, "isSellingItem"))
         return false;
-    const bool result = luaState_["isSellingItem"](itemIndex);
+    const bool result = luaEnv_["isSellingItem"](itemIndex);
     return result;
 }
 
@@ -25,6 +25,7 @@
 #include "AiComp.h"
 #include "AiLoader.h"
 #include "Chat.h"
+#include "LuaEnvironment.h"
 #include "TriggerComp.h"
 #include "WanderComp.h"
 #include <eastl.hpp>
@@ -62,9 +63,9 @@ private:
     {
         return luaInitialized_ && sa::bits::is_set(functions_, func);
     }
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     bool luaInitialized_;
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     std::string GetQuote(int index);
     void _LuaAddWanderPoint(const Math::StdVector3& point);
     void _LuaAddWanderPoints(const std::vector<Math::StdVector3>& points);
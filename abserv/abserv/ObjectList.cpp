@@ -0,0 +1,76 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ObjectList.h"
+#include "GameObject.h"
+
+namespace Game {
+
+bool ObjectList::Add(ea::shared_ptr<GameObject> object)
+{
+    const uint32_t id = object->id_;
+    if (Contains(id))
+        return false;
+    index_.emplace(id, objects_.size());
+    objects_.push_back(ea::move(object));
+    return true;
+}
+
+bool ObjectList::Remove(uint32_t id)
+{
+    const auto it = index_.find(id);
+    if (it == index_.end())
+        return false;
+    removed_.push_back(ea::move(objects_[(*it).second]));
+    index_.erase(it);
+    return true;
+}
+
+void ObjectList::Compact()
+{
+    if (removed_.empty())
+        return;
+
+    // Keep the order of creation
+    size_t dest = 0;
+    for (size_t i = 0; i < objects_.size(); ++i)
+    {
+        if (!objects_[i])
+            continue;
+        if (dest != i)
+        {
+            objects_[dest] = ea::move(objects_[i]);
+            index_[objects_[dest]->id_] = dest;
+        }
+        ++dest;
+    }
+    objects_.resize(dest);
+    removed_.clear();
+}
+
+void ObjectList::Clear()
+{
+    index_.clear();
+    objects_.clear();
+    removed_.clear();
+}
+
+}
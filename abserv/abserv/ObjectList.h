@@ -0,0 +1,85 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eastl.hpp>
+#include <sa/Iteration.h>
+
+namespace Game {
+
+class GameObject;
+
+/// The list which owns the objects of a game. Objects are kept in a contiguous
+/// array in the order of creation (allocation), so Update() is a linear walk.
+/// Objects added while iterating, with VisitObjects() or by index up to the
+/// slot count, are appended and not visited by that iteration. Removed objects leave an empty slot and are kept alive until
+/// Compact() is called at the end of the tick, so an object may remove itself
+/// in its Update(). The object ID is the stable handle to look up an object.
+class ObjectList
+{
+private:
+    ea::vector<ea::shared_ptr<GameObject>> objects_;
+    /// Object ID -> index in objects_
+    ea::unordered_map<uint32_t, size_t> index_;
+    /// Removed objects, alive until Compact()
+    ea::vector<ea::shared_ptr<GameObject>> removed_;
+public:
+    ObjectList() = default;
+    ~ObjectList() = default;
+
+    bool Add(ea::shared_ptr<GameObject> object);
+    bool Remove(uint32_t id);
+    /// Close the gaps of removed objects and release them
+    void Compact();
+    void Clear();
+
+    GameObject* Get(uint32_t id) const
+    {
+        const auto it = index_.find(id);
+        if (it == index_.end())
+            return nullptr;
+        return objects_[(*it).second].get();
+    }
+    bool Contains(uint32_t id) const { return index_.find(id) != index_.end(); }
+    size_t GetCount() const { return index_.size(); }
+    /// Number of slots including empty slots of removed objects
+    size_t GetSlotCount() const { return objects_.size(); }
+    /// May return nullptr for a removed object
+    GameObject* GetSlot(size_t index) const { return objects_[index].get(); }
+
+    template<typename Callback>
+    void VisitObjects(Callback&& callback) const
+    {
+        // The callback may add objects, which may reallocate objects_, so no iterators
+        const size_t count = objects_.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            GameObject* object = objects_[i].get();
+            if (!object)
+                continue;
+            if (callback(*object) != Iteration::Continue)
+                break;
+        }
+    }
+};
+
+}
@@ -36,6 +36,7 @@ void PartyManager::AddToIndex(const Party& party)
 
 void PartyManager::SetPartyGameId(uint32_t partyId, uint32_t gameId)
 {
+    std::scoped_lock lock(lock_);
     auto& idIndex = partyIndex_.get<PartyIdTag>();
     auto its = idIndex.find(partyId);
     if (its != idIndex.end())
@@ -56,11 +57,15 @@ void PartyManager::SetPartyGameId(uint32_t partyId, uint32_t gameId)
 
 ea::shared_ptr<Party> PartyManager::GetByUuid(const std::string& uuid)
 {
-    auto& idIndex = partyIndex_.get<PartyUuidTag>();
-    auto indexIt = idIndex.find(uuid);
-    if (indexIt != idIndex.end())
-        return Get((*indexIt).partyId);
+    {
+        std::scoped_lock lock(lock_);
+        auto& idIndex = partyIndex_.get<PartyUuidTag>();
+        auto indexIt = idIndex.find(uuid);
+        if (indexIt != idIndex.end())
+            return InternalGet((*indexIt).partyId);
+    }
 
+    // Don't block other games while talking to the data server
     std::string _uuid(uuid);
     if (uuids::uuid(_uuid).nil())
         _uuid = Utils::Uuid::New();
@@ -70,6 +75,13 @@ ea::shared_ptr<Party> PartyManager::GetByUuid(const std::string& uuid)
     if (!cli->Read(p))
         cli->Create(p);
 
+    std::scoped_lock lock(lock_);
+    // Another game may have created it meanwhile
+    auto& idIndex = partyIndex_.get<PartyUuidTag>();
+    auto indexIt = idIndex.find(p.uuid);
+    if (indexIt != idIndex.end())
+        return InternalGet((*indexIt).partyId);
+
     ea::shared_ptr<Party> result = ea::make_shared<Party>();
     result->data_ = std::move(p);
     parties_[result->GetId()] = result;
@@ -77,7 +89,7 @@ ea::shared_ptr<Party> PartyManager::GetByUuid(const std::string& uuid)
     return result;
 }
 
-ea::shared_ptr<Party> PartyManager::Get(uint32_t partyId) const
+ea::shared_ptr<Party> PartyManager::InternalGet(uint32_t partyId) const
 {
     const auto it = parties_.find(partyId);
     if (it == parties_.end())
@@ -85,11 +97,39 @@ ea::shared_ptr<Party> PartyManager::Get(uint32_t partyId) const
     return (*it).second;
 }
 
+ea::shared_ptr<Party> PartyManager::Get(uint32_t partyId) const
+{
+    std::scoped_lock lock(lock_);
+    return InternalGet(partyId);
+}
+
 void PartyManager::Remove(uint32_t partyId)
 {
+    // The Party dtor removes the chat channel, don't do this while holding the lock
+    ea::shared_ptr<Party> party;
+    std::scoped_lock lock(lock_);
     auto it = parties_.find(partyId);
     if (it != parties_.end())
+    {
+        party = (*it).second;
         parties_.erase(it);
+    }
+}
+
+ea::vector<ea::shared_ptr<Party>> PartyManager::GetGameParties(uint32_t gameId) const
+{
+    ea::vector<ea::shared_ptr<Party>> result;
+    std::scoped_lock lock(lock_);
+    auto& idIndex = partyIndex_.get<GameIdTag>();
+    auto its = idIndex.equal_range(gameId);
+    while (its.first != its.second)
+    {
+        auto party = InternalGet((*its.first).partyId);
+        if (party)
+            result.push_back(std::move(party));
+        ++its.first;
+    }
+    return result;
 }
 
 std::vector<Party*> PartyManager::GetByGame(uint32_t gameId) const
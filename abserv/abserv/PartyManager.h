@@ -28,12 +28,15 @@
 #include <multi_index/ordered_index.hpp>
 #include <multi_index/member.hpp>
 #include <eastl.hpp>
+#include <mutex>
 
 namespace Game {
 
+/// Parties of all games. It is used from all game threads, so it is locked.
 class PartyManager
 {
 private:
+    mutable std::mutex lock_;
     /// The owner of Parties
     ea::unordered_map<uint32_t, ea::shared_ptr<Party>> parties_;
 
@@ -66,6 +69,9 @@ private:
     >;
     PartyIndex partyIndex_;
     void AddToIndex(const Party& party);
+    ea::shared_ptr<Party> InternalGet(uint32_t partyId) const;
+    /// Copy of the parties in a game, so they can be visited without holding the lock
+    ea::vector<ea::shared_ptr<Party>> GetGameParties(uint32_t gameId) const;
 public:
     PartyManager() = default;
     ~PartyManager() = default;
@@ -83,15 +89,10 @@ public:
         if (gameId == 0)
             return;
 
-        auto& idIndex = partyIndex_.get<GameIdTag>();
-        auto its = idIndex.equal_range(gameId);
-        while (its.first != its.second)
+        for (const auto& party : GetGameParties(gameId))
         {
-            auto it = parties_.find((*its.first).partyId);
-            if ((*it).second)
-                if (callback(*(*it).second) != Iteration::Continue)
-                    return;
-            ++its.first;
+            if (callback(*party) != Iteration::Continue)
+                return;
         }
     }
 };
@@ -27,6 +27,7 @@
 #include "Guild.h"
 #include "GuildManager.h"
 #include "InteractionComp.h"
+#include "InterestComp.h"
 #include "IOAccount.h"
 #include "IOGame.h"
 #include "IOMail.h"
@@ -93,7 +94,8 @@ Player::Player(std::shared_ptr<Net::ProtocolGame> client) :
     client_(client),
     questComp_(ea::make_unique<Components::QuestComp>(*this)),
     tradeComp_(ea::make_unique<Components::TradeComp>(*this)),
-    interactionComp_(ea::make_unique<Components::InteractionComp>(*this))
+    interactionComp_(ea::make_unique<Components::InteractionComp>(*this)),
+    interestComp_(ea::make_unique<Components::InterestComp>(*this))
 {
     events_.Subscribe<void(AB::GameProtocol::CommandType, const std::string&, Net::NetworkMessage&)>(EVENT_ON_HANDLECOMMAND,
         std::bind(&Player::OnHandleCommand, this,
@@ -117,7 +119,12 @@ void Player::SendError(AB::GameProtocol::PlayerErrorValue value)
 
 void Player::SetGame(ea::shared_ptr<Game> game)
 {
-    Actor::SetGame(game);
+    {
+        std::scoped_lock lock(gameLock_);
+        Actor::SetGame(game);
+    }
+    // The client of the new game doesn't know any objects
+    interestComp_->Clear();
     // Changing the instance also clears any invites. The client should check that we
     // leave the instance so don't send anything to invitees.
     party_->ClearInvites();
@@ -129,6 +136,25 @@ void Player::SetGame(ea::shared_ptr<Game> game)
     }
 }
 
+void Player::RunOnGameThread(std::function<void(Player&)>&& f)
+{
+    ea::shared_ptr<Game> game;
+    {
+        std::scoped_lock lock(gameLock_);
+        game = GetGame();
+    }
+    if (!game || game->IsGameThread())
+    {
+        f(*this);
+        return;
+    }
+    // Check again when it runs, the player may have changed the game meanwhile
+    game->Post([self = GetPtr<Player>(), f = std::move(f)]() mutable
+    {
+        self->RunOnGameThread(std::move(f));
+    });
+}
+
 size_t Player::GetGroupPos()
 {
     return party_->GetPosition(this);
@@ -176,7 +202,8 @@ void Player::Initialize()
 {
     Actor::Initialize();
     SetParty(GetSubsystem<PartyManager>()->GetByUuid(data_.partyUuid));
-    GetSubsystem<Asynch::Dispatcher>()->Add(Asynch::CreateTask(std::bind(&Player::LoadFriendList, this)));
+    // Load it before the player enters a game, from then on the game thread uses it
+    LoadFriendList();
 }
 
 void Player::Logout(bool leavePary)
@@ -191,7 +218,7 @@ void Player::Logout(bool leavePary)
         PartyLeave();
     if (auto g = GetGame())
     {
-        GetSubsystem<Asynch::Scheduler>()->Add(Asynch::CreateScheduledTask(std::bind(&Game::PlayerLeave, g, id_)));
+        g->Schedule(std::bind(&Game::PlayerLeave, g, id_));
     }
     client_->Logout();
 }
@@ -1144,9 +1171,11 @@ void Player::CRQPartyInvitePlayer(uint32_t playerId)
         return;
     if (party_->IsFull())
         return;
-    ea::shared_ptr<Player> player = GetSubsystem<PlayerManager>()->GetPlayerById(playerId);
-    if (!player)
+    // Parties are formed in outposts, so the player must be in our game
+    Player* other = GetGame()->GetPlayerById(playerId);
+    if (!other)
         return;
+    ea::shared_ptr<Player> player = other->GetPtr<Player>();
 
     if (party_->Invite(player))
     {
@@ -1177,9 +1206,11 @@ void Player::CRQPartyKickPlayer(uint32_t playerId)
         // Only leader can kick
         return;
 
-    ea::shared_ptr<Player> player = GetSubsystem<PlayerManager>()->GetPlayerById(playerId);
-    if (!player)
+    // All members and invitees are in our game
+    Player* other = GetGame()->GetPlayerById(playerId);
+    if (!other)
         return;
+    ea::shared_ptr<Player> player = other->GetPtr<Player>();
 
     bool removedMember = false;
     {
@@ -1274,7 +1305,8 @@ void Player::CRQPartyAccept(uint32_t playerId)
     if (!AB::Entities::IsOutpost(GetGame()->data_.type))
         return;
 
-    ea::shared_ptr<Player> leader = GetSubsystem<PlayerManager>()->GetPlayerById(playerId);
+    // The inviter is in our game, invites are cleared when changing the game
+    Player* leader = GetGame()->GetPlayerById(playerId);
     if (!leader)
         return;
 
@@ -1304,7 +1336,7 @@ void Player::CRQPartyRejectInvite(uint32_t inviterId)
     // We are the rejecter
     if (!AB::Entities::IsOutpost(GetGame()->data_.type))
         return;
-    ea::shared_ptr<Player> leader = GetSubsystem<PlayerManager>()->GetPlayerById(inviterId);
+    Player* leader = GetGame()->GetPlayerById(inviterId);
     if (!leader)
         return;
 
@@ -1521,7 +1553,7 @@ void Player::CRQEquipSkill(uint32_t skillIndex, uint8_t pos)
         if (skillIndex != 0)
         {
             auto* sm = GetSubsystem<SkillManager>();
-            auto skill = sm->Get(skillIndex);
+            auto skill = sm->Get(skillIndex, skills_->GetScriptState());
             if (skill)
             {
                 if (haveAccess(skill->data_, account_.type >= AB::Entities::AccountType::Gamemaster) &&
@@ -2339,23 +2371,10 @@ void Player::HandleWhisperCommand(const std::string& arguments, Net::NetworkMess
     if (target)
     {
         // Found a player with the name so the target is on this server.
+        // The channel sends us the confirmation from the game thread of the target.
         ea::shared_ptr<ChatChannel> channel = GetSubsystem<Chat>()->Get(ChatType::Whisper, target->id_);
-        if (channel)
-        {
-            if (channel->Talk(*this, msg))
-            {
-                auto nmsg = Net::NetworkMessage::GetNew();
-                nmsg->AddByte(AB::GameProtocol::ServerPacketType::ServerMessage);
-                AB::Packets::Server::ServerMessage packet = {
-                    static_cast<uint8_t>(AB::GameProtocol::ServerMessageType::PlayerGotMessage),
-                    name,
-                    msg
-                };
-                AB::Packets::Add(packet, *nmsg);
-                WriteToOutput(*nmsg);
-                return;
-            }
-        }
+        if (channel && channel->Talk(*this, msg))
+            return;
     }
 
     // No player found with the name, pass the message to the message server
@@ -2747,18 +2766,7 @@ void Player::HandleGotoPlayerCommand(const std::string& playerName, Net::Network
     // May need to enter this command twice:
     // 1. Change to the instance
     // 2. Teleport to player
-    auto* playerMan = GetSubsystem<PlayerManager>();
-    auto player = playerMan->GetPlayerByName(playerName);
-    if (!player)
-        return;
-
-    auto* gameMan = GetSubsystem<GameManager>();
-    const std::string& currentMap = player->data_.currentMapUuid;
-    const std::string& currentInst = player->data_.instanceUuid;
-    if (!gameMan->InstanceExists(currentInst))
-        return;
-
-    if (Utils::Uuid::IsEqual(data_.instanceUuid, currentInst))
+    if (Player* player = GetGame()->GetPlayerByName(playerName))
     {
         // This is the same instance -> teleport to player
         Math::Vector3 pos = player->transformation_.position_;
@@ -2770,8 +2778,25 @@ void Player::HandleGotoPlayerCommand(const std::string& playerName, Net::Network
         moveComp_->forcePosition_ = true;
         return;
     }
-    // Enter the same instance as the player
-    ChangeInstance(currentMap, currentInst);
+
+    auto* playerMan = GetSubsystem<PlayerManager>();
+    auto player = playerMan->GetPlayerByName(playerName);
+    if (!player)
+        return;
+
+    // The player is in another game, read where it is on its thread and come back to ours
+    player->RunOnGameThread([self = GetPtr<Player>()](Player& target)
+    {
+        std::string currentMap = target.data_.currentMapUuid;
+        std::string currentInst = target.data_.instanceUuid;
+        self->RunOnGameThread([currentMap = std::move(currentMap), currentInst = std::move(currentInst)](Player& player)
+        {
+            if (!GetSubsystem<GameManager>()->InstanceExists(currentInst))
+                return;
+            // Enter the same instance as the player
+            player.ChangeInstance(currentMap, currentInst);
+        });
+    });
 }
 
 void Player::HandleUnknownCommand()
@@ -30,6 +30,7 @@
 #include <AB/Entities/ItemPrice.h>
 #include <eastl.hpp>
 #include <set>
+#include <mutex>
 #include <sa/time.h>
 
 namespace Net {
@@ -47,6 +48,7 @@ namespace Components {
 class QuestComp;
 class TradeComp;
 class InteractionComp;
+class InterestComp;
 }
 
 class Player final : public Actor
@@ -61,6 +63,8 @@ private:
     bool resigned_{ false  };
     bool queueing_{ false };
     ea::map<std::string, AB::Entities::ItemPrice> calculatedItemPrices_;
+    /// Guards game_, other game threads read it in RunOnGameThread()
+    mutable std::mutex gameLock_;
     Party* _LuaGetParty();
     void LoadFriendList();
     MailBox& GetMailBox();
@@ -162,6 +166,10 @@ public:
     void PingPosition(const Math::Vector3& worldPos);
 
     void WriteToOutput(const Net::NetworkMessage& message);
+    /// Run f on the thread of the game this player is in, right away when we are already on it
+    /// or the player is not in a game. Anything but WriteToOutput() on a player of another game
+    /// must go through this.
+    void RunOnGameThread(std::function<void(Player&)>&& f);
     bool IsResigned() const { return resigned_; }
 
     void SetParty(ea::shared_ptr<Party> party);
@@ -270,6 +278,7 @@ public:
     ea::unique_ptr<Components::QuestComp> questComp_;
     ea::unique_ptr<Components::TradeComp> tradeComp_;
     ea::unique_ptr<Components::InteractionComp> interactionComp_;
+    ea::unique_ptr<Components::InterestComp> interestComp_;
 };
 
 template <>
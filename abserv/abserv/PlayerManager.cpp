@@ -23,6 +23,7 @@
 #include "Player.h"
 #include <abscommon/Logger.h>
 #include <abscommon/StringUtils.h>
+#include <sa/ConditionSleep.h>
 
 namespace Game {
 
@@ -33,14 +34,15 @@ ea::shared_ptr<Player> PlayerManager::GetPlayerByName(const std::string& name)
 
 ea::shared_ptr<Player> PlayerManager::GetPlayerByUuid(const std::string& uuid)
 {
+    std::scoped_lock lock(lock_);
     auto& index = playerIndex_.get<PlayerUuidIndexTag>();
     const auto accountIt = index.find(uuid);
     if (accountIt == index.end())
         return ea::shared_ptr<Player>();
-    return GetPlayerById((*accountIt).id);
+    return InternalGetPlayerById((*accountIt).id);
 }
 
-ea::shared_ptr<Player> PlayerManager::GetPlayerById(uint32_t id)
+ea::shared_ptr<Player> PlayerManager::InternalGetPlayerById(uint32_t id) const
 {
     auto it = players_.find(id);
     if (it != players_.end())
@@ -49,20 +51,42 @@ ea::shared_ptr<Player> PlayerManager::GetPlayerById(uint32_t id)
     return ea::shared_ptr<Player>();
 }
 
+ea::vector<ea::shared_ptr<Player>> PlayerManager::GetPlayers() const
+{
+    std::scoped_lock lock(lock_);
+    ea::vector<ea::shared_ptr<Player>> result;
+    result.reserve(players_.size());
+    for (const auto& player : players_)
+    {
+        if (player.second)
+            result.push_back(player.second);
+    }
+    return result;
+}
+
+ea::shared_ptr<Player> PlayerManager::GetPlayerById(uint32_t id)
+{
+    std::scoped_lock lock(lock_);
+    return InternalGetPlayerById(id);
+}
+
 ea::shared_ptr<Player> PlayerManager::GetPlayerByAccountUuid(const std::string& uuid)
 {
+    std::scoped_lock lock(lock_);
     auto& index = playerIndex_.get<AccountUuidIndexTag>();
     const auto accountIt = index.find(uuid);
     if (accountIt == index.end())
         return ea::shared_ptr<Player>();
-    return GetPlayerById((*accountIt).id);
+    return InternalGetPlayerById((*accountIt).id);
 }
 
 uint32_t PlayerManager::GetPlayerIdByName(const std::string& name)
 {
-    auto& index = playerIndex_.get<PlayerNameIndexTag>();
     // Player names are case insensitive
-    const auto accountIt = index.find(Utils::Utf8ToLower(name));
+    const std::string lowerName = Utils::Utf8ToLower(name);
+    std::scoped_lock lock(lock_);
+    auto& index = playerIndex_.get<PlayerNameIndexTag>();
+    const auto accountIt = index.find(lowerName);
     if (accountIt == index.end())
         return 0;
     return (*accountIt).id;
@@ -71,6 +95,7 @@ uint32_t PlayerManager::GetPlayerIdByName(const std::string& name)
 ea::shared_ptr<Player> PlayerManager::CreatePlayer(std::shared_ptr<Net::ProtocolGame> client)
 {
     ea::shared_ptr<Player> result = ea::make_shared<Player>(client);
+    std::scoped_lock lock(lock_);
     players_[result->id_] = result;
 
     return result;
@@ -78,6 +103,7 @@ ea::shared_ptr<Player> PlayerManager::CreatePlayer(std::shared_ptr<Net::Protocol
 
 void PlayerManager::UpdatePlayerIndex(const Player& player)
 {
+    std::scoped_lock lock(lock_);
     playerIndex_.insert({
         player.id_,
         player.data_.uuid,
@@ -88,11 +114,15 @@ void PlayerManager::UpdatePlayerIndex(const Player& player)
 
 void PlayerManager::RemovePlayer(uint32_t playerId)
 {
+    // Keep the last reference until we released the lock
+    ea::shared_ptr<Player> player;
+    std::scoped_lock lock(lock_);
     auto it = players_.find(playerId);
     if (it != players_.end())
     {
+        player = (*it).second;
         auto& idIndex = playerIndex_.get<IdIndexTag>();
-        auto indexIt = idIndex.find((*it).second->id_);
+        auto indexIt = idIndex.find(playerId);
         if (indexIt != idIndex.end())
             idIndex.erase(indexIt);
 
@@ -105,68 +135,66 @@ void PlayerManager::RemovePlayer(uint32_t playerId)
 
 void PlayerManager::CleanPlayers()
 {
-    if (players_.size() == 0)
-        return;
-
     // Logout all inactive players
-    auto i = players_.begin();
-    while ((i = ea::find_if(i, players_.end(), [](const auto& current) -> bool
+    for (const auto& p : GetPlayers())
     {
         // Disconnect after 10sec
-        return current.second->GetInactiveTime() > PLAYER_INACTIVE_TIME_KICK;
-    })) != players_.end())
-    {
-        ea::shared_ptr<Player> p = (*i).second;
+        if (p->GetInactiveTime() <= PLAYER_INACTIVE_TIME_KICK)
+            continue;
         LOG_INFO << "No ping from player " << p->GetName() << " for " << p->GetInactiveTime() << "ms, logging out now" << std::endl;
-        ++i;
         // Calls PlayerManager::RemovePlayer()
-        p->Logout(true);
-   }
+        p->RunOnGameThread([](Player& player) { player.Logout(true); });
+    }
 }
 
 void PlayerManager::RefreshAuthTokens()
 {
     // No inactive players here
-    auto* client = GetSubsystem<IO::DataClient>();
-    int64_t tick = sa::time::tick();
-    for (const auto& player : players_)
+    for (const auto& p : GetPlayers())
     {
-        if (tick - player.second->account_.authTokenExpiry < Auth::AUTH_TOKEN_EXPIRES_IN / 2)
+        // account_ is owned by the game thread of the player
+        p->RunOnGameThread([](Player& player)
         {
-            player.second->account_.authTokenExpiry = tick + Auth::AUTH_TOKEN_EXPIRES_IN;
-            client->Update(player.second->account_);
-        }
+            const int64_t tick = sa::time::tick();
+            if (tick - player.account_.authTokenExpiry < Auth::AUTH_TOKEN_EXPIRES_IN / 2)
+            {
+                player.account_.authTokenExpiry = tick + Auth::AUTH_TOKEN_EXPIRES_IN;
+                GetSubsystem<IO::DataClient>()->Update(player.account_);
+            }
+        });
     }
 }
 
 void PlayerManager::KickPlayer(uint32_t playerId)
 {
-    auto it = players_.find(playerId);
-    if (it != players_.end())
+    ea::shared_ptr<Player> p = GetPlayerById(playerId);
+    if (p)
     {
-        ea::shared_ptr<Player> p = (*it).second;
         LOG_INFO << "Kicking player " << p->GetName() << std::endl;
-        p->Logout(true);
+        p->RunOnGameThread([](Player& player) { player.Logout(true); });
     }
 }
 
 void PlayerManager::KickAllPlayers()
 {
     LOG_INFO << "Kicking all players" << std::endl;
-    while (!players_.empty())
-    {
-        auto it = players_.begin();
-        ea::shared_ptr<Player> p = (*it).second;
+    for (const auto& p : GetPlayers())
+        p->RunOnGameThread([](Player& player) { player.Logout(true); });
+
+    sa::ConditionSleep([this]() {
+        return GetPlayerCount() == 0;
+    }, 2000);
+
+    // Whatever is left, e.g. because its game doesn't run anymore
+    for (const auto& p : GetPlayers())
         p->Logout(true);
-    }
 }
 
 void PlayerManager::BroadcastNetMessage(const Net::NetworkMessage& msg)
 {
-    for (const auto& p : players_)
-    {
-        p.second->WriteToOutput(msg);
-    }
+    // Writing to the output of a player is thread safe
+    for (const auto& p : GetPlayers())
+        p->WriteToOutput(msg);
 }
 
 }
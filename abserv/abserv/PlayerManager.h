@@ -25,6 +25,7 @@
 #include <map>
 #include <memory>
 #include <limits>
+#include <mutex>
 #include <abscommon/Utils.h>
 #include <eastl.hpp>
 #include <sa/Iteration.h>
@@ -43,6 +44,9 @@ namespace Game {
 
 class Player;
 
+/// All players on this server. It is used from all game threads, so it is locked.
+/// The players it returns may be in another game, use Player::RunOnGameThread()
+/// to do anything with them except sending them messages.
 class PlayerManager
 {
 private:
@@ -81,12 +85,16 @@ private:
         >
     >;
 
+    mutable std::mutex lock_;
     /// Index to lookup players
     PlayerIndex playerIndex_;
     /// Time with no players
     int64_t idleTime_;
     /// The owner of players
     ea::map<uint32_t, ea::shared_ptr<Player>> players_;
+    ea::shared_ptr<Player> InternalGetPlayerById(uint32_t id) const;
+    /// Copy of all players, so they can be visited without holding the lock
+    ea::vector<ea::shared_ptr<Player>> GetPlayers() const;
 public:
     PlayerManager() :
         idleTime_(sa::time::tick())
@@ -111,16 +119,19 @@ public:
     void CleanPlayers();
     void RefreshAuthTokens();
     void KickPlayer(uint32_t playerId);
+    /// Waits until all players logged out. Must not be called from a game thread.
     void KickAllPlayers();
     void BroadcastNetMessage(const Net::NetworkMessage& msg);
 
     size_t GetPlayerCount() const
     {
+        std::scoped_lock lock(lock_);
         return players_.size();
     }
 
     int64_t GetIdleTime() const
     {
+        std::scoped_lock lock(lock_);
         if (players_.size() != 0)
             return 0;
         return sa::time::tick() - idleTime_;
@@ -128,13 +139,10 @@ public:
     template<typename Callback>
     inline void VisitPlayers(Callback&& callback)
     {
-        for (auto& player : players_)
+        for (auto& player : GetPlayers())
         {
-            if (player.second)
-            {
-                if (callback(*player.second) != Iteration::Continue)
-                    break;
-            }
+            if (callback(*player) != Iteration::Continue)
+                break;
         }
     }
 };
@@ -54,16 +54,14 @@ Projectile::Projectile(const std::string& itemUuid) :
     undestroyable_ = true;
     selectable_ = false;
     itemUuid_ = itemUuid;
-
-    InitializeLua();
 }
 
 Projectile::~Projectile() = default;
 
-void Projectile::InitializeLua()
+void Projectile::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
     luaInitialized_ = true;
 }
 
@@ -72,17 +70,20 @@ bool Projectile::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    // The game is set before the script is loaded, so it can run in the VM of the game
+    auto game = GetGame();
+    InitializeLua(game ? game->GetScriptState() : ea::shared_ptr<Lua::SharedState>());
+    if (!script->Execute(luaEnv_))
         return false;
 
-    if (Lua::IsFunction(luaState_, "onCollide"))
+    if (Lua::IsFunction(luaEnv_, "onCollide"))
         sa::bits::set(functions_, FunctionOnCollide);
-    if (Lua::IsFunction(luaState_, "onHitTarget"))
+    if (Lua::IsFunction(luaEnv_, "onHitTarget"))
         sa::bits::set(functions_, FunctionOnHitTarget);
-    if (Lua::IsFunction(luaState_, "onStart"))
+    if (Lua::IsFunction(luaEnv_, "onStart"))
         sa::bits::set(functions_, FunctionOnStart);
 
-    bool ret = luaState_["onInit"]();
+    bool ret = luaEnv_["onInit"]();
     return ret;
 }
 
@@ -266,7 +267,7 @@ uint32_t Projectile::GetLevel() const
 void Projectile::OnCollide(GameObject* other)
 {
     if (HaveFunction(FunctionOnCollide))
-        Lua::CallFunction(luaState_, "onCollide", other);
+        Lua::CallFunction(luaEnv_, "onCollide", other);
 
     if (other)
     {
@@ -277,7 +278,7 @@ void Projectile::OnCollide(GameObject* other)
                 if (error_ == AB::GameProtocol::AttackError::None)
                 {
                     if (HaveFunction(FunctionOnHitTarget))
-                        Lua::CallFunction(luaState_, "onHitTarget", other);
+                        Lua::CallFunction(luaEnv_, "onHitTarget", other);
                 }
             }
         }
@@ -293,7 +294,7 @@ bool Projectile::DoStart()
     ASSERT(t);
     bool ret = true;
     if (HaveFunction(FunctionOnStart))
-        ret = luaState_["onStart"](t.get());
+        ret = luaEnv_["onStart"](t.get());
     if (ret)
         startTick_ = sa::time::tick();
     return true;
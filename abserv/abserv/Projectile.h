@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Actor.h"
+#include "LuaEnvironment.h"
 #include <abscommon/Utils.h>
 #include <sa/Bits.h>
 #include <eastl.hpp>
@@ -45,7 +46,7 @@ private:
         FunctionOnHitTarget = 1 << 2,
         FunctionOnStart = 1 << 3,
     };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     bool luaInitialized_{ false };
     bool startSet_{ false };
     Math::Vector3 startPos_;
@@ -62,7 +63,7 @@ private:
     uint32_t lifeTime_{ DEFAULT_LIFETIME };
     uint32_t functions_{ FunctionNone };
     AB::GameProtocol::AttackError error_{ AB::GameProtocol::AttackError::None };
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     bool LoadScript(const std::string& fileName);
     bool HaveFunction(Function func) const
     {
@@ -22,6 +22,7 @@
 #include "ProtocolGame.h"
 #include "ConfigManager.h"
 #include "Game.h"
+#include "GameExecutor.h"
 #include "GameManager.h"
 #include "IOAccount.h"
 #include "IOGame.h"
@@ -33,6 +34,7 @@
 #include <AB/Packets/Packet.h>
 #include <AB/Packets/ServerPackets.h>
 #include <abscommon/BanManager.h>
+#include <abscommon/MessageClient.h>
 #include <abscommon/StringUtils.h>
 #include <sa/time.h>
 
@@ -64,6 +66,16 @@ inline void ProtocolGame::AddPlayerInput(Game::InputType type)
         p->AddInput(type);
 }
 
+void ProtocolGame::PostPlayerTask(const ea::shared_ptr<Game::Player>& player, std::function<void(void)>&& f)
+{
+    if (auto game = player->GetGame())
+    {
+        game->Post(std::move(f));
+        return;
+    }
+    GetSubsystem<Asynch::Dispatcher>()->Add(Asynch::CreateTask(std::move(f)));
+}
+
 void ProtocolGame::Login(AB::Packets::Client::GameLogin packet)
 {
 #ifdef DEBUG_NET
@@ -116,6 +128,7 @@ void ProtocolGame::Login(AB::Packets::Client::GameLogin packet)
     player->account_.currentCharacterUuid = player->data_.uuid;
     player->account_.currentServerUuid = ProtocolGame::serverId_;
     client->Update(player->account_);
+    SendPlayerLoggedIn(*player);
 
     player->Initialize();
     player->data_.currentMapUuid = packet.mapUuid;
@@ -136,6 +149,29 @@ void ProtocolGame::Login(AB::Packets::Client::GameLogin packet)
     connected_ = true;
 }
 
+void ProtocolGame::SendPlayerLoggedIn(const Game::Player& player)
+{
+    Net::MessageMsg msg;
+    msg.type_ = Net::MessageType::PlayerLoggedIn;
+    sa::PropWriteStream stream;
+    stream.WriteString(player.account_.uuid);
+    stream.WriteString(player.data_.uuid);
+    stream.WriteString(ProtocolGame::serverId_);
+    msg.SetPropStream(stream);
+    GetSubsystem<Net::MessageClient>()->Write(msg);
+}
+
+void ProtocolGame::SendPlayerLoggedOut(const Game::Player& player)
+{
+    Net::MessageMsg msg;
+    msg.type_ = Net::MessageType::PlayerLoggedOut;
+    sa::PropWriteStream stream;
+    stream.WriteString(player.account_.uuid);
+    stream.WriteString(ProtocolGame::serverId_);
+    msg.SetPropStream(stream);
+    GetSubsystem<Net::MessageClient>()->Write(msg);
+}
+
 void ProtocolGame::Logout()
 {
     auto player = GetPlayer();
@@ -151,6 +187,7 @@ void ProtocolGame::Logout()
     player->logoutTime_ = sa::time::tick();
     player->data_.instanceUuid = Utils::Uuid::EMPTY_UUID;
     IO::IOAccount::AccountLogout(player->data_.accountUuid);
+    SendPlayerLoggedOut(*player);
     IO::IOPlayer::SavePlayer(*player);
     GetSubsystem<Game::PlayerManager>()->RemovePlayer(player->id_);
 
@@ -622,6 +659,8 @@ void ProtocolGame::OnRecvFirstMessage(NetworkMessage& msg)
         DisconnectClient(AB::ErrorCodes::WrongProtocolVersion);
         return;
     }
+    if (packet.compression && (*GetSubsystem<ConfigManager>())[ConfigManager::Key::NetworkCompression].GetBool())
+        EnableCompression();
     for (int i = 0; i < DH_KEY_LENGTH; ++i)
         clientKey_[i] = packet.key[i];
     auto* keys = GetSubsystem<Crypto::DHKeys>();
@@ -717,10 +756,7 @@ void ProtocolGame::Connect()
 
 void ProtocolGame::WriteToOutput(const NetworkMessage& message)
 {
-#ifdef DEBUG_NET
-    ASSERT(GetSubsystem<Asynch::Dispatcher>()->IsDispatcherThread());
-#endif
-    GetOutputBuffer(message.GetSize())->Append(message);
+    AppendToOutput(message);
 }
 
 void ProtocolGame::EnterGame(ea::shared_ptr<Game::Player> player)
@@ -775,8 +811,9 @@ void ProtocolGame::EnterGame(ea::shared_ptr<Game::Player> player)
     AB::Packets::Add(packet, *output);
     WriteToOutput(*output);
 
-    // (2) Then we can send all the rest that happens when entering an game
-    instance->PlayerJoin(player->id_);
+    // (2) Then we can send all the rest that happens when entering an game.
+    // The game may run on another thread.
+    instance->Post(std::bind(&Game::Game::PlayerJoin, instance, player->id_));
 }
 
 void ProtocolGame::ChangeServerInstance(const std::string& serverUuid,
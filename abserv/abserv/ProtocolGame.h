@@ -58,7 +58,12 @@ private:
     }
     inline void AddPlayerInput(Game::InputType type, Utils::VariantMap&& data);
     inline void AddPlayerInput(Game::InputType type);
+    /// Run the task on the thread of the players game, or on the Dispatcher if not in a game
+    void PostPlayerTask(const ea::shared_ptr<Game::Player>& player, std::function<void(void)>&& f);
     void Login(AB::Packets::Client::GameLogin packet);
+    /// Tell the message server on which server the player is
+    static void SendPlayerLoggedIn(const Game::Player& player);
+    static void SendPlayerLoggedOut(const Game::Player& player);
     /// The client requests to enter a game. Find/create it, add the player and return success.
     void EnterGame(ea::shared_ptr<Game::Player> player);
     void Release() override;
@@ -77,11 +82,7 @@ private:
     void AddPlayerTask(Callable&& function, Args&&... args)
     {
         if (auto player = GetPlayer())
-        {
-            GetSubsystem<Asynch::Dispatcher>()->Add(
-                Asynch::CreateTask(std::bind(std::move(function), player, std::forward<Args>(args)...))
-            );
-        }
+            PostPlayerTask(player, std::bind(std::move(function), player, std::forward<Args>(args)...));
     }
 
     std::shared_ptr<ProtocolGame> GetPtr()
@@ -0,0 +1,252 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ProximityIndex.h"
+#include "GameObject.h"
+#include <cmath>
+
+namespace Game {
+
+void RangeList::Set(uint32_t id, uint16_t ranges)
+{
+    auto it = ea::lower_bound(items_.begin(), items_.end(), id, [](const Item& item, uint32_t value)
+    {
+        return item.id < value;
+    });
+    if (it != items_.end() && (*it).id == id)
+    {
+        (*it).ranges = ranges;
+        return;
+    }
+    items_.insert(it, { id, ranges });
+}
+
+void RangeList::Erase(uint32_t id)
+{
+    auto it = ea::lower_bound(items_.begin(), items_.end(), id, [](const Item& item, uint32_t value)
+    {
+        return item.id < value;
+    });
+    if (it != items_.end() && (*it).id == id)
+        items_.erase(it);
+}
+
+uint16_t ProximityIndex::GetRangeMask(float distance)
+{
+    uint16_t result = 0;
+    for (unsigned r = 0; r < static_cast<unsigned>(Ranges::Map); ++r)
+    {
+        if (distance <= RangeDistances[r])
+            result |= RangeList::GetBit(static_cast<Ranges>(r));
+    }
+    return result;
+}
+
+uint64_t ProximityIndex::MakeCell(int32_t x, int32_t z)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint64_t>(static_cast<uint32_t>(z));
+}
+
+uint64_t ProximityIndex::GetCell(const Math::Vector3& position)
+{
+    return MakeCell(static_cast<int32_t>(std::floor(position.x_ / CELL_SIZE)),
+        static_cast<int32_t>(std::floor(position.z_ / CELL_SIZE)));
+}
+
+void ProximityIndex::AddToCell(uint64_t cell, GameObject* object)
+{
+    cells_[cell].push_back(object);
+}
+
+void ProximityIndex::RemoveFromCell(uint64_t cell, GameObject* object)
+{
+    auto it = cells_.find(cell);
+    if (it == cells_.end())
+        return;
+    auto& objects = (*it).second;
+    auto oIt = ea::find(objects.begin(), objects.end(), object);
+    if (oIt != objects.end())
+    {
+        *oIt = objects.back();
+        objects.pop_back();
+    }
+    if (objects.empty())
+        cells_.erase(it);
+}
+
+RangeList* ProximityIndex::GetRangeList(uint32_t id)
+{
+    const auto it = index_.find(id);
+    if (it == index_.end())
+        return nullptr;
+    return &entries_[(*it).second].object->ranges_;
+}
+
+void ProximityIndex::Add(GameObject& object)
+{
+    // Objects which are not sent to the player don't have any logic, so they don't need ranges.
+    if (object.GetType() <= AB::GameProtocol::GameObjectType::__SentToPlayer)
+        return;
+    if (index_.find(object.id_) != index_.end())
+        return;
+
+    // The object may come from another game
+    object.ranges_.Clear();
+    const Math::Vector3& position = object.GetPosition();
+    const uint64_t cell = GetCell(position);
+    index_[object.id_] = entries_.size();
+    entries_.push_back({ &object, position, cell, object.GetOctant() != nullptr, true });
+    AddToCell(cell, &object);
+}
+
+void ProximityIndex::Remove(GameObject& object)
+{
+    const auto it = index_.find(object.id_);
+    if (it == index_.end())
+        return;
+
+    const size_t index = (*it).second;
+    RemoveFromCell(entries_[index].cell, &object);
+    index_.erase(it);
+    if (index != entries_.size() - 1)
+    {
+        entries_[index] = entries_.back();
+        index_[entries_[index].object->id_] = index;
+    }
+    entries_.pop_back();
+
+    // Don't touch the RangeLists now, someone may iterate them
+    Removed removed{ object.id_, {} };
+    removed.neighbours.reserve(object.ranges_.GetCount());
+    for (const auto& item : object.ranges_)
+        removed.neighbours.push_back(item.id);
+    removed_.push_back(ea::move(removed));
+}
+
+void ProximityIndex::Clear()
+{
+    entries_.clear();
+    index_.clear();
+    cells_.clear();
+    removed_.clear();
+}
+
+void ProximityIndex::Update()
+{
+    for (const auto& removed : removed_)
+    {
+        for (uint32_t id : removed.neighbours)
+        {
+            if (auto* list = GetRangeList(id))
+                list->Erase(removed.id);
+        }
+    }
+    removed_.clear();
+
+    for (auto& entry : entries_)
+    {
+        const Math::Vector3& position = entry.object->GetPosition();
+        const bool inOctree = entry.object->GetOctant() != nullptr;
+        if (entry.position == position && entry.inOctree == inOctree)
+            continue;
+        entry.position = position;
+        entry.inOctree = inOctree;
+        entry.dirty = true;
+        const uint64_t cell = GetCell(position);
+        if (cell != entry.cell)
+        {
+            RemoveFromCell(entry.cell, entry.object);
+            AddToCell(cell, entry.object);
+            entry.cell = cell;
+        }
+    }
+
+    lastMoved_ = 0;
+    for (auto& entry : entries_)
+    {
+        if (!entry.dirty)
+            continue;
+        UpdateNeighbours(entry);
+        entry.dirty = false;
+        ++lastMoved_;
+    }
+}
+
+void ProximityIndex::UpdateNeighbours(Entry& entry)
+{
+    GameObject& object = *entry.object;
+    scratch_.clear();
+    if (entry.inOctree)
+    {
+        const int32_t cellX = static_cast<int32_t>(entry.cell >> 32);
+        const int32_t cellZ = static_cast<int32_t>(entry.cell & 0xffffffff);
+        for (int32_t x = cellX - 1; x <= cellX + 1; ++x)
+        {
+            for (int32_t z = cellZ - 1; z <= cellZ + 1; ++z)
+            {
+                const auto it = cells_.find(MakeCell(x, z));
+                if (it == cells_.end())
+                    continue;
+                for (GameObject* other : (*it).second)
+                {
+                    if (other == &object || !other->GetOctant())
+                        continue;
+                    // Use the current position, the other object may not be updated yet
+                    const float dist = entry.position.Distance(other->GetPosition()) - AVERAGE_BB_EXTENDS;
+                    const uint16_t ranges = GetRangeMask(dist);
+                    if (ranges != 0)
+                        scratch_.push_back({ other->id_, ranges });
+                }
+            }
+        }
+        ea::sort(scratch_.begin(), scratch_.end(), [](const RangeList::Item& lhs, const RangeList::Item& rhs)
+        {
+            return lhs.id < rhs.id;
+        });
+    }
+
+    // Both lists are sorted, so we can walk them side by side to find the
+    // objects which left the range.
+    const auto& previous = object.ranges_.items_;
+    auto pIt = previous.begin();
+    for (const auto& item : scratch_)
+    {
+        while (pIt != previous.end() && (*pIt).id < item.id)
+        {
+            if (auto* list = GetRangeList((*pIt).id))
+                list->Erase(object.id_);
+            ++pIt;
+        }
+        if (pIt != previous.end() && (*pIt).id == item.id)
+            ++pIt;
+        if (auto* list = GetRangeList(item.id))
+            list->Set(object.id_, item.ranges);
+    }
+    for (; pIt != previous.end(); ++pIt)
+    {
+        if (auto* list = GetRangeList((*pIt).id))
+            list->Erase(object.id_);
+    }
+
+    object.ranges_.items_.swap(scratch_);
+}
+
+}
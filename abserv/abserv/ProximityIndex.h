@@ -0,0 +1,129 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <abshared/Mechanic.h>
+#include <absmath/Vector3.h>
+#include <eastl.hpp>
+
+namespace Game {
+
+class GameObject;
+
+/// The objects inside the interest range of an object with a bit mask of the
+/// Ranges they are in. Sorted by object ID.
+class RangeList
+{
+public:
+    struct Item
+    {
+        uint32_t id;
+        uint16_t ranges;
+    };
+    using Container = ea::vector<Item>;
+
+    static constexpr uint16_t GetBit(Ranges range) { return static_cast<uint16_t>(1u << static_cast<unsigned>(range)); }
+
+    bool IsInRange(uint32_t id, Ranges range) const
+    {
+        const auto it = LowerBound(id);
+        if (it == items_.end() || (*it).id != id)
+            return false;
+        return ((*it).ranges & GetBit(range)) != 0;
+    }
+    void Set(uint32_t id, uint16_t ranges);
+    void Erase(uint32_t id);
+    void Clear() { items_.clear(); }
+    bool IsEmpty() const { return items_.empty(); }
+    size_t GetCount() const { return items_.size(); }
+    Container::const_iterator begin() const { return items_.begin(); }
+    Container::const_iterator end() const { return items_.end(); }
+private:
+    friend class ProximityIndex;
+    Container::const_iterator LowerBound(uint32_t id) const
+    {
+        return ea::lower_bound(items_.begin(), items_.end(), id, [](const Item& item, uint32_t value)
+        {
+            return item.id < value;
+        });
+    }
+    Container items_;
+};
+
+/// Keeps the RangeList of all objects of a game which are sent to the player.
+/// Objects are put into a uniform grid on the XZ plane with cells of the size of
+/// the interest range, so the neighbours of an object are in the 3x3 cells around
+/// it. Only objects which moved since the last Update() are queried again, and
+/// both sides of a pair are updated, so the cost depends on the number of moving
+/// objects and not on the number of all objects.
+class ProximityIndex
+{
+public:
+    ProximityIndex() = default;
+    ~ProximityIndex() = default;
+
+    void Add(GameObject& object);
+    /// The RangeLists of the neighbours are updated with the next Update(), so
+    /// objects can be removed while a RangeList is iterated.
+    void Remove(GameObject& object);
+    /// Call once per tick before the objects are updated
+    void Update();
+    void Clear();
+    size_t GetCount() const { return entries_.size(); }
+    /// Number of objects updated with the last Update()
+    size_t GetLastMoved() const { return lastMoved_; }
+
+    static uint16_t GetRangeMask(float distance);
+private:
+    struct Entry
+    {
+        GameObject* object;
+        Math::Vector3 position;
+        uint64_t cell;
+        bool inOctree;
+        bool dirty;
+    };
+    struct Removed
+    {
+        uint32_t id;
+        ea::vector<uint32_t> neighbours;
+    };
+    // The distance from the center minus AVERAGE_BB_EXTENDS must be inside the interest range
+    static constexpr float CELL_SIZE = RANGE_INTEREST + 1.0f;
+
+    static uint64_t GetCell(const Math::Vector3& position);
+    static uint64_t MakeCell(int32_t x, int32_t z);
+    void AddToCell(uint64_t cell, GameObject* object);
+    void RemoveFromCell(uint64_t cell, GameObject* object);
+    RangeList* GetRangeList(uint32_t id);
+    void UpdateNeighbours(Entry& entry);
+
+    ea::vector<Entry> entries_;
+    /// Object ID -> index in entries_
+    ea::unordered_map<uint32_t, size_t> index_;
+    ea::unordered_map<uint64_t, ea::vector<GameObject*>> cells_;
+    ea::vector<Removed> removed_;
+    RangeList::Container scratch_;
+    size_t lastMoved_{ 0 };
+};
+
+}
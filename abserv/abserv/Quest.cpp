@@ -49,7 +49,8 @@ void Quest::RegisterLua(kaguya::State& state)
 
 Quest::Quest(Player& owner,
     const AB::Entities::Quest& q,
-    AB::Entities::PlayerQuest&& playerQuest) :
+    AB::Entities::PlayerQuest&& playerQuest,
+    ea::shared_ptr<Lua::SharedState> state) :
     owner_(owner),
     index_(q.index),
     repeatable_(q.repeatable),
@@ -57,14 +58,14 @@ Quest::Quest(Player& owner,
 {
     owner_.SubscribeEvent<void(Actor*, Actor*)>(EVENT_ON_KILLEDFOE, std::bind(&Quest::OnKilledFoe,
         this, std::placeholders::_1, std::placeholders::_2));
-    InitializeLua();
+    InitializeLua(std::move(state));
     LoadProgress();
 }
 
-void Quest::InitializeLua()
+void Quest::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
 }
 
 bool Quest::LoadScript(const std::string& fileName)
@@ -75,10 +76,10 @@ bool Quest::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    if (!script->Execute(luaEnv_))
         return false;
 
-    if (Lua::IsFunction(luaState_, "onUpdate"))
+    if (Lua::IsFunction(luaEnv_, "onUpdate"))
         sa::bits::set(functions_, FunctionUpdate);
     return true;
 }
@@ -140,7 +141,7 @@ void Quest::Update(uint32_t timeElapsed)
         return;
 
     if (HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](timeElapsed);
+        luaEnv_["onUpdate"](timeElapsed);
 }
 
 void Quest::Write(Net::NetworkMessage& message)
@@ -211,7 +212,7 @@ void Quest::SetVar(const std::string& name, const Utils::Variant& val)
 
 void Quest::OnKilledFoe(Actor* foe, Actor* killer)
 {
-    Lua::CallFunction(luaState_, "onKilledFoe", foe, killer);
+    Lua::CallFunction(luaEnv_, "onKilledFoe", foe, killer);
 }
 
 bool Quest::IsActive() const
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "LuaEnvironment.h"
 #include <abscommon/Variant.h>
 #include <stdint.h>
 #include <kaguya/kaguya.hpp>
@@ -46,14 +47,14 @@ private:
         FunctionUpdate = 1,
     };
     uint32_t functions_{ FunctionNone };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     Utils::VariantMap variables_;
     Player& owner_;
     uint32_t index_;
     bool repeatable_;
     bool internalRewarded_{ false };
     bool internalDeleted_{ false };
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     bool HaveFunction(Function func) const
     {
         return sa::bits::is_set(functions_, func);
@@ -71,7 +72,8 @@ public:
 
     Quest(Player& owner,
         const AB::Entities::Quest& q,
-        AB::Entities::PlayerQuest&& playerQuest);
+        AB::Entities::PlayerQuest&& playerQuest,
+        ea::shared_ptr<Lua::SharedState> state);
     // non-copyable
     Quest(const Quest&) = delete;
     Quest& operator=(const Quest&) = delete;
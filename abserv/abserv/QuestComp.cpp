@@ -203,7 +203,9 @@ bool QuestComp::HaveQuest(uint32_t index) const
 
 bool QuestComp::Add(const AB::Entities::Quest& q, AB::Entities::PlayerQuest&& pq)
 {
-    ea::unique_ptr<Quest> quest = ea::make_unique<Quest>(owner_, q, std::move(pq));
+    if (!scriptState_)
+        scriptState_ = ea::make_shared<Lua::SharedState>(Lua::StateKind::Quests);
+    ea::unique_ptr<Quest> quest = ea::make_unique<Quest>(owner_, q, std::move(pq), scriptState_);
     if (!quest->LoadScript(q.script))
     {
         LOG_ERROR << "Error loading quest script " << q.script << std::endl;
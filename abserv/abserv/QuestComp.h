@@ -43,6 +43,8 @@ class QuestComp
     NON_MOVEABLE(QuestComp)
 private:
     Player& owner_;
+    /// All quests of the player run in one Lua VM
+    ea::shared_ptr<Lua::SharedState> scriptState_;
     ea::map<uint32_t, ea::unique_ptr<Quest>> activeQuests_;
     // This can be a std::map because we keep this only to check if the player
     // has the requirements for another quest.
@@ -53,6 +55,9 @@ public:
     explicit QuestComp(Player& owner);
     ~QuestComp() = default;
 
+    /// May be null when the player never had a quest
+    const ea::shared_ptr<Lua::SharedState>& GetScriptState() const { return scriptState_; }
+
     void Update(uint32_t timeElapsed);
     void Write(Net::NetworkMessage& message);
 
@@ -20,30 +20,47 @@
  */
 
 #include "Script.h"
+#include "LuaEnvironment.h"
 
 namespace Game {
 
-namespace Internal {
-template<typename CharT, typename TraitsT = std::char_traits<CharT> >
-class vectorbuf : public std::basic_streambuf<CharT, TraitsT>
+Script::~Script() = default;
+
+bool Script::Execute(kaguya::State& luaState)
 {
-public:
-    vectorbuf(ea::vector<CharT>& vec)
-    {
-        this->setg(vec.data(), vec.data(), vec.data() + vec.size());
-    }
-};
+    lua_State* L = luaState.state();
+    lua_pushglobaltable(L);
+    const bool result = Execute(L, -1);
+    lua_pop(L, 1);
+    return result;
 }
 
-Script::~Script() = default;
+bool Script::Execute(Lua::Environment& env)
+{
+    lua_State* L = env.state();
+    env.Push();
+    const bool result = Execute(L, -1);
+    lua_pop(L, 1);
+    return result;
+}
 
-bool Script::Execute(kaguya::State& luaState)
+bool Script::Execute(lua_State* L, int env)
 {
-    Internal::vectorbuf<char> databuf(buffer_);
-    std::istream is(&databuf);
-    if (!luaState.dostream(is))
+    env = lua_absindex(L, env);
+    // The buffer contains the compiled chunk, so this does not parse the source again
+    if (luaL_loadbuffer(L, buffer_.data(), buffer_.size(), fileName_.c_str()) != LUA_OK)
+    {
+        LOG_ERROR << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return false;
+    }
+    // The first upvalue of a main chunk is _ENV
+    lua_pushvalue(L, env);
+    lua_setupvalue(L, -2, 1);
+    if (lua_pcall(L, 0, 0, 0) != LUA_OK)
     {
-        LOG_ERROR << lua_tostring(luaState.state(), -1) << std::endl;
+        LOG_ERROR << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
         return false;
     }
     return true;
@@ -24,12 +24,18 @@
 #include <eastl.hpp>
 #include "Asset.h"
 
+struct lua_State;
+
 namespace kaguya {
 class State;
 }
 
 namespace Game {
 
+namespace Lua {
+class Environment;
+}
+
 class Script final : public IO::Asset
 {
 private:
@@ -45,8 +51,12 @@ public:
         return buffer_;
     }
 
-    /// Execute the script
+    /// Execute the script in the globals of luaState
     bool Execute(kaguya::State& luaState);
+    /// Execute the script in the environment of an object
+    bool Execute(Lua::Environment& env);
+    /// Execute the script with the table at index env as its globals
+    bool Execute(lua_State* L, int env);
 };
 
 }
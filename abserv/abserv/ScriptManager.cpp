@@ -46,6 +46,37 @@ static void LuaErrorHandler(int errCode, const char* message)
     LOG_ERROR << "Lua Error (" << errCode << "): " << message << std::endl;
 }
 
+static int Include(lua_State* L)
+{
+    const char* file = luaL_checkstring(L, 1);
+    auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(file);
+    if (!script)
+        return 0;
+
+    // The table the script is included into, either the globals or an Environment
+    const int env = lua_upvalueindex(1);
+    // Make something like an include guard
+    std::string ident(file);
+    sa::MakeIdent(ident);
+    ident = "__included_" + ident + "__";
+    lua_getfield(L, env, ident.c_str());
+    const bool included = lua_isboolean(L, -1);
+    lua_pop(L, 1);
+    if (included)
+        return 0;
+    if (script->Execute(L, env))
+    {
+        lua_pushboolean(L, 1);
+        lua_setfield(L, env, ident.c_str());
+    }
+    return 0;
+}
+
+void PushInclude(lua_State* L)
+{
+    lua_pushcclosure(L, Include, 1);
+}
+
 void RegisterLuaAll(kaguya::State& state)
 {
     state.setErrorHandler(LuaErrorHandler);
@@ -64,21 +95,9 @@ void RegisterLuaAll(kaguya::State& state)
     {
         return Application::Instance->GetServerId();
     });
-    state["include"] = kaguya::function([&state](const std::string& file)
-    {
-        auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(file);
-        if (script)
-        {
-            // Make something like an include guard
-            std::string ident(file);
-            sa::MakeIdent(ident);
-            ident = "__included_" + ident + "__";
-            if (IsBool(state, ident))
-                return;
-            if (script->Execute(state))
-                state[ident] = true;
-        }
-    });
+    lua_pushglobaltable(state.state());
+    PushInclude(state.state());
+    lua_setglobal(state.state(), "include");
 
     // Register all used classes
     GameObject::RegisterLua(state);
@@ -106,10 +125,5 @@ void RegisterLuaAll(kaguya::State& state)
         mainS->Execute(state);
 }
 
-void CollectGarbage(kaguya::State& state)
-{
-    state.gc().step();
-}
-
 }
 }
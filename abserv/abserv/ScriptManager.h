@@ -27,47 +27,54 @@ namespace Game {
 namespace Lua {
 
 void RegisterLuaAll(kaguya::State& state);
+/// Pops a table from the stack and pushes an include function which executes the
+/// included scripts in this table.
+void PushInclude(lua_State* L);
 
-/// Check if a function exists
-inline bool IsFunction(kaguya::State& state, const std::string& name)
+/// Check if a function exists. State may be a kaguya::State or an Environment.
+template<typename State>
+inline bool IsFunction(State& state, const std::string& name)
 {
     return state[name].type() == LUA_TFUNCTION;
 }
 
-inline bool IsVariable(kaguya::State& state, const std::string& name)
+template<typename State>
+inline bool IsVariable(State& state, const std::string& name)
 {
     auto t = state[name].type();
     return t == LUA_TBOOLEAN || t == LUA_TNUMBER || t == LUA_TSTRING;
 }
 
-inline bool IsString(kaguya::State& state, const std::string& name)
+template<typename State>
+inline bool IsString(State& state, const std::string& name)
 {
     return state[name].type() == LUA_TSTRING;
 }
 
-inline bool IsBool(kaguya::State& state, const std::string& name)
+template<typename State>
+inline bool IsBool(State& state, const std::string& name)
 {
     return state[name].type() == LUA_TBOOLEAN;
 }
 
-inline bool IsNumber(kaguya::State& state, const std::string& name)
+template<typename State>
+inline bool IsNumber(State& state, const std::string& name)
 {
     return state[name].type() == LUA_TNUMBER;
 }
 
-inline bool IsNil(kaguya::State& state, const std::string& name)
+template<typename State>
+inline bool IsNil(State& state, const std::string& name)
 {
     return state[name].type() == LUA_TNIL;
 }
 
-template<typename... _CArgs>
-inline void CallFunction(kaguya::State& state, const std::string& name, _CArgs&& ... _Args)
+template<typename State, typename... _CArgs>
+inline void CallFunction(State& state, const std::string& name, _CArgs&& ... _Args)
 {
     if (IsFunction(state, name))
         state[name](std::forward<_CArgs>(_Args)...);
 }
 
-void CollectGarbage(kaguya::State& state);
-
 }
 }
@@ -53,10 +53,10 @@ void Skill::RegisterLua(kaguya::State& state)
     // clang-format on
 }
 
-void Skill::InitializeLua()
+void Skill::InitializeLua(ea::shared_ptr<Lua::SharedState> state)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(state));
+    luaEnv_["self"] = this;
 }
 
 bool Skill::LoadScript(const std::string& fileName)
@@ -64,30 +64,30 @@ bool Skill::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    if (!script->Execute(luaEnv_))
         return false;
 
-    energy_ = luaState_["costEnergy"];
-    adrenaline_ = luaState_["costAdrenaline"];
-    activation_ = luaState_["activation"];
-    recharge_ = luaState_["recharge"];
-    overcast_ = luaState_["overcast"];
-    if (Lua::IsNumber(luaState_, "hp"))
-        hp_ = luaState_["hp"];
-
-    if (Lua::IsNumber(luaState_, "range"))
-        range_ = static_cast<Ranges>(luaState_["range"]);
-    if (Lua::IsNumber(luaState_, "targetType"))
-        targetType_ = static_cast<SkillTargetType>(luaState_["targetType"]);
-    if (Lua::IsNumber(luaState_, "effect"))
-        skillEffect_ = static_cast<uint32_t>(luaState_["effect"]);
-    if (Lua::IsNumber(luaState_, "effectTarget"))
-        effectTarget_ = static_cast<uint32_t>(luaState_["effectTarget"]);
-    if (Lua::IsNumber(luaState_, "canInterrupt"))
-        canInterrupt_ = luaState_["canInterrupt"];
-
-    haveOnCancelled_ = Lua::IsFunction(luaState_, "onCancelled");
-    haveOnInterrupted_ = Lua::IsFunction(luaState_, "onInterrupted");
+    energy_ = luaEnv_["costEnergy"];
+    adrenaline_ = luaEnv_["costAdrenaline"];
+    activation_ = luaEnv_["activation"];
+    recharge_ = luaEnv_["recharge"];
+    overcast_ = luaEnv_["overcast"];
+    if (Lua::IsNumber(luaEnv_, "hp"))
+        hp_ = luaEnv_["hp"];
+
+    if (Lua::IsNumber(luaEnv_, "range"))
+        range_ = static_cast<Ranges>(luaEnv_["range"]);
+    if (Lua::IsNumber(luaEnv_, "targetType"))
+        targetType_ = static_cast<SkillTargetType>(luaEnv_["targetType"]);
+    if (Lua::IsNumber(luaEnv_, "effect"))
+        skillEffect_ = static_cast<uint32_t>(luaEnv_["effect"]);
+    if (Lua::IsNumber(luaEnv_, "effectTarget"))
+        effectTarget_ = static_cast<uint32_t>(luaEnv_["effectTarget"]);
+    if (Lua::IsNumber(luaEnv_, "canInterrupt"))
+        canInterrupt_ = luaEnv_["canInterrupt"];
+
+    haveOnCancelled_ = Lua::IsFunction(luaEnv_, "onCancelled");
+    haveOnInterrupted_ = Lua::IsFunction(luaEnv_, "onInterrupted");
 
     return true;
 }
@@ -102,7 +102,7 @@ void Skill::Update(uint32_t)
             auto source = source_.lock();
             auto target = target_.lock();
             // A Skill may even fail here, e.g. when resurrecting an already resurrected target
-            lastError_ = luaState_["onSuccess"](source.get(), target.get());
+            lastError_ = luaEnv_["onSuccess"](source.get(), target.get());
             startUse_ = 0;
             if (lastError_ != AB::GameProtocol::SkillError::None)
                 recharged_ = 0;
@@ -200,9 +200,9 @@ uint32_t Skill::GetRecharge(uint32_t recharge)
 
 AB::GameProtocol::SkillError Skill::CanUse(Actor* source, Actor* target)
 {
-    if (Lua::IsFunction(luaState_, "canUse"))
-        return luaState_["canUse"](source, target);
-    return luaState_["onStartUse"](source, target);
+    if (Lua::IsFunction(luaEnv_, "canUse"))
+        return luaEnv_["canUse"](source, target);
+    return luaEnv_["onStartUse"](source, target);
 }
 
 AB::GameProtocol::SkillError Skill::StartUse(ea::shared_ptr<Actor> source, ea::shared_ptr<Actor> target)
@@ -233,7 +233,7 @@ AB::GameProtocol::SkillError Skill::StartUse(ea::shared_ptr<Actor> source, ea::s
     source_ = source;
     target_ = target;
 
-    lastError_ = luaState_["onStartUse"](source.get(), target.get());
+    lastError_ = luaEnv_["onStartUse"](source.get(), target.get());
     if (lastError_ != AB::GameProtocol::SkillError::None)
     {
         startUse_ = 0;
@@ -255,7 +255,7 @@ void Skill::CancelUse()
     if (haveOnCancelled_)
     {
         auto target = target_.lock();
-        Lua::CallFunction(luaState_, "onCancelled",
+        Lua::CallFunction(luaEnv_, "onCancelled",
             source.get(), target.get());
     }
     if (source)
@@ -276,7 +276,7 @@ bool Skill::Interrupt()
     if (haveOnInterrupted_)
     {
         auto target = target_.lock();
-        Lua::CallFunction(luaState_, "onInterrupted",
+        Lua::CallFunction(luaEnv_, "onInterrupted",
             source.get(), target.get());
     }
     if (source)
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "GameObject.h"
+#include "LuaEnvironment.h"
 #include <AB/Entities/Skill.h>
 #include <AB/ProtocolCodes.h>
 #include <eastl.hpp>
@@ -82,7 +83,7 @@ class Skill
     NON_COPYABLE(Skill)
     friend class SkillBar;
 private:
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     int64_t startUse_{ 0 };
     int64_t lastUse_{ 0 };
     int64_t recharged_{ 0 };
@@ -105,7 +106,7 @@ private:
     AB::GameProtocol::SkillError lastError_{ AB::GameProtocol::SkillError::None };
 
     bool CanUseSkill(Actor& source, Actor* target);
-    void InitializeLua();
+    void InitializeLua(ea::shared_ptr<Lua::SharedState> state);
     int _LuaGetType() const { return static_cast<int>(data_.type); }
     uint32_t _LuaGetIndex() const { return data_.index; }
     bool _LuaIsElite() const { return data_.isElite; }
@@ -116,10 +117,11 @@ private:
 public:
     static void RegisterLua(kaguya::State& state);
 
-    explicit Skill(const AB::Entities::Skill& skill) :
+    /// If state is null the skill gets its own Lua VM
+    explicit Skill(const AB::Entities::Skill& skill, ea::shared_ptr<Lua::SharedState> state = {}) :
         data_(skill)
     {
-        InitializeLua();
+        InitializeLua(std::move(state));
     }
     // non-copyable
     ~Skill() = default;
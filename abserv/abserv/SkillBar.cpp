@@ -21,6 +21,8 @@
 
 
 #include "Actor.h"
+#include "Game.h"
+#include "Npc.h"
 #include <abshared/AttribAlgos.h>
 #include "EffectsComp.h"
 #include "SkillBar.h"
@@ -52,6 +54,20 @@ void SkillBar::RegisterLua(kaguya::State& state)
     // clang-format on
 }
 
+ea::shared_ptr<Lua::SharedState> SkillBar::GetScriptState()
+{
+    if (!scriptState_)
+    {
+        // NPCs never leave their game, so their skills can run in the VM of the game
+        auto game = owner_.GetGame();
+        if (game && Is<Npc>(owner_))
+            scriptState_ = game->GetScriptState();
+        else
+            scriptState_ = ea::make_shared<Lua::SharedState>(Lua::StateKind::Skills);
+    }
+    return scriptState_;
+}
+
 Skill* SkillBar::_LuaGetSkill(int pos)
 {
     if (pos < 0)
@@ -65,7 +81,7 @@ Skill* SkillBar::_LuaGetSkill(int pos)
 int SkillBar::_LuaAddSkill(uint32_t skillIndex)
 {
     SkillManager* sm = GetSubsystem<SkillManager>();
-    ea::shared_ptr<Skill> skill = sm->Get(skillIndex);
+    ea::shared_ptr<Skill> skill = sm->Get(skillIndex, GetScriptState());
     if (!skill)
         return -1;
 
@@ -86,7 +102,7 @@ int SkillBar::_LuaAddSkill(uint32_t skillIndex)
 bool SkillBar::_LuaSetSkill(int pos, uint32_t skillIndex)
 {
     auto* sm = GetSubsystem<SkillManager>();
-    auto skill = sm->Get(skillIndex);
+    auto skill = sm->Get(skillIndex, GetScriptState());
     if (skill)
     {
         if (!SetSkill(static_cast<int>(pos), skill))
@@ -266,10 +282,10 @@ bool SkillBar::Load(const std::string& str, bool locked)
 
     for (size_t i = 0; i < PLAYER_MAX_SKILLS; i++)
     {
-        skills_[i] = skillMan->Get(skills[i]);
+        skills_[i] = skillMan->Get(skills[i], GetScriptState());
         if (skills_[i] && (!hasAccess(skills_[i]->data_) || !professionsMatch(skills_[i]->data_)))
             // This player can not have locked skills
-            skills_[i] = skillMan->Get(0);
+            skills_[i] = skillMan->Get(0, GetScriptState());
     }
 
     return true;
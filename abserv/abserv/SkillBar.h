@@ -43,6 +43,8 @@ private:
     SkillsArray skills_;
     Attributes attributes_;
     Actor& owner_;
+    /// The skills of this bar share a Lua VM
+    ea::shared_ptr<Lua::SharedState> scriptState_;
     int currentSkillIndex_{ -1 };
     int _LuaAddSkill(uint32_t skillIndex);
     bool _LuaSetSkill(int pos, uint32_t skillIndex);
@@ -79,6 +81,9 @@ public:
     { }
     ~SkillBar() = default;
 
+    /// The VM the scripts of the skills run in
+    ea::shared_ptr<Lua::SharedState> GetScriptState();
+
     /// 0 Based
     AB::GameProtocol::SkillError UseSkill(int index, ea::shared_ptr<Actor> target);
     Skill* GetCurrentSkill() const;
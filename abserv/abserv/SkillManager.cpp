@@ -29,7 +29,7 @@ namespace Game {
 
 SkillManager::SkillManager() = default;
 
-ea::shared_ptr<Skill> SkillManager::Get(uint32_t index)
+ea::shared_ptr<Skill> SkillManager::Get(uint32_t index, ea::shared_ptr<Lua::SharedState> state)
 {
     if (index == 0)
         return ea::shared_ptr<Skill>();
@@ -38,7 +38,7 @@ ea::shared_ptr<Skill> SkillManager::Get(uint32_t index)
     auto it = skillCache_.find(index);
     if (it != skillCache_.end())
     {
-        result = ea::make_shared<Skill>((*it).second);
+        result = ea::make_shared<Skill>((*it).second, std::move(state));
     }
     else
     {
@@ -50,7 +50,7 @@ ea::shared_ptr<Skill> SkillManager::Get(uint32_t index)
             LOG_ERROR << "Error reading skill with index " << index << std::endl;
             return ea::shared_ptr<Skill>();
         }
-        result = ea::make_shared<Skill>(skill);
+        result = ea::make_shared<Skill>(skill, std::move(state));
         // Move to cache
         skillCache_.emplace(index, skill);
     }
@@ -34,7 +34,9 @@ public:
     SkillManager();
     ~SkillManager() = default;
 
-    ea::shared_ptr<Skill> Get(uint32_t index);
+    /// Create a skill and load its script. The script runs in state, or in its
+    /// own VM if state is null.
+    ea::shared_ptr<Skill> Get(uint32_t index, ea::shared_ptr<Lua::SharedState> state = {});
 };
 
 }
@@ -102,27 +102,17 @@ TerrainPatch::TerrainPatch(ea::shared_ptr<Terrain> owner,
 
 float TerrainPatch::CastRay(const Math::Vector3& origin, const Math::Vector3& direction, float maxDist, Math::Vector3& position) const
 {
-    const float dt = 0.1f;
-    const float mint = 0.001f;
-    float lh = 0.0f;
-    float ly = 0.0f;
-    float t = mint;
-    while (t < maxDist)
+    if (auto o = owner_.lock())
     {
-        const Math::Vector3 p = origin + direction * t;
-        const float h = GetHeight(p);
-        if (p.y_ < h)
-        {
-#ifdef DEBUG_COLLISION
-//            LOG_DEBUG << *this << ": h " << h << " @ " << p << std::endl;
-#endif
-            position = { p.x_, h, p.z_ };
-            // Get the intersection distance
-            return (t - dt + dt * (lh - ly) / (p.y_ - ly - h + lh));
-        }
-        lh = h;
-        ly = p.y_;
-        t += dt;
+        // Same offset as in GetHeight()
+        const Math::Vector3 offset(
+            static_cast<float>(offset_.x_) * static_cast<float>(o->patchSize_),
+            0.0f,
+            static_cast<float>(offset_.y_) * static_cast<float>(o->patchSize_));
+        const float distance = o->GetHeightMap()->CastRay(origin + offset, direction, maxDist, position);
+        if (!Math::IsInfinite(distance))
+            position -= offset;
+        return distance;
     }
     return Math::M_INFINITE;
 }
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "Bvh.h"
+#include "MathDefs.h"
+#include "Shape.h"
+#include <algorithm>
+
+namespace Math {
+
+Bvh::Bvh(const Shape& shape)
+{
+    const size_t count = shape.GetTriangleCount();
+    if (count == 0)
+        return;
+
+    ea::vector<Vector3> mins(count);
+    ea::vector<Vector3> maxs(count);
+    ea::vector<Vector3> centers(count);
+    triangles_.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vector3& p1 = shape.GetLocalVertex(i * 3);
+        const Vector3& p2 = shape.GetLocalVertex(i * 3 + 1);
+        const Vector3& p3 = shape.GetLocalVertex(i * 3 + 2);
+        mins[i] = { std::min({ p1.x_, p2.x_, p3.x_ }), std::min({ p1.y_, p2.y_, p3.y_ }), std::min({ p1.z_, p2.z_, p3.z_ }) };
+        maxs[i] = { std::max({ p1.x_, p2.x_, p3.x_ }), std::max({ p1.y_, p2.y_, p3.y_ }), std::max({ p1.z_, p2.z_, p3.z_ }) };
+        centers[i] = (mins[i] + maxs[i]) * 0.5f;
+        triangles_[i] = static_cast<uint32_t>(i);
+    }
+
+    nodes_.reserve(count / MaxLeafSize * 2 + 1);
+    nodes_.push_back({ {}, {}, 0, static_cast<uint32_t>(count), 0 });
+    ea::vector<uint32_t> pending;
+    pending.push_back(0);
+    while (!pending.empty())
+    {
+        const uint32_t index = pending.back();
+        pending.pop_back();
+        const uint32_t start = nodes_[index].start;
+        const uint32_t size = nodes_[index].count;
+
+        Vector3 min(M_INFINITE, M_INFINITE, M_INFINITE);
+        Vector3 max(-M_INFINITE, -M_INFINITE, -M_INFINITE);
+        Vector3 centerMin = min;
+        Vector3 centerMax = max;
+        for (uint32_t i = start; i < start + size; ++i)
+        {
+            const uint32_t tri = triangles_[i];
+            min = { std::min(min.x_, mins[tri].x_), std::min(min.y_, mins[tri].y_), std::min(min.z_, mins[tri].z_) };
+            max = { std::max(max.x_, maxs[tri].x_), std::max(max.y_, maxs[tri].y_), std::max(max.z_, maxs[tri].z_) };
+            const Vector3& c = centers[tri];
+            centerMin = { std::min(centerMin.x_, c.x_), std::min(centerMin.y_, c.y_), std::min(centerMin.z_, c.z_) };
+            centerMax = { std::max(centerMax.x_, c.x_), std::max(centerMax.y_, c.y_), std::max(centerMax.z_, c.z_) };
+        }
+        nodes_[index].min = min;
+        nodes_[index].max = max;
+        if (size <= MaxLeafSize)
+            continue;
+
+        // Split at the median of the longest axis of the centers
+        const Vector3 extends = centerMax - centerMin;
+        int axis = 0;
+        if (extends.y_ > extends.x_)
+            axis = 1;
+        if (extends.z_ > (axis == 0 ? extends.x_ : extends.y_))
+            axis = 2;
+        const uint32_t half = size / 2;
+        ea::nth_element(triangles_.begin() + start, triangles_.begin() + start + half, triangles_.begin() + start + size,
+            [&](uint32_t lhs, uint32_t rhs)
+        {
+            return centers[lhs].Data()[axis] < centers[rhs].Data()[axis];
+        });
+
+        const uint32_t left = static_cast<uint32_t>(nodes_.size());
+        nodes_[index].left = left;
+        nodes_[index].count = 0;
+        nodes_.push_back({ {}, {}, start, half, 0 });
+        nodes_.push_back({ {}, {}, start + half, size - half, 0 });
+        pending.push_back(left);
+        pending.push_back(left + 1);
+    }
+}
+
+}
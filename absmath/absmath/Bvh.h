@@ -0,0 +1,89 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "Vector3.h"
+#include <eastl.hpp>
+
+namespace Math {
+
+class Shape;
+
+/// Bounding volume hierarchy of the triangles of a Shape. It is built from the
+/// vertex data, i.e. it is in the local space of the shape and does not include
+/// the matrix of the shape.
+class Bvh
+{
+public:
+    /// Max triangles in a leaf
+    static constexpr uint32_t MaxLeafSize = 4;
+    struct Node
+    {
+        Vector3 min;
+        Vector3 max;
+        /// Leafs: First triangle in triangles_
+        uint32_t start{ 0 };
+        uint32_t count{ 0 };
+        /// Inner nodes: Index of the left child, the right child follows it. 0 for leafs.
+        uint32_t left{ 0 };
+    };
+private:
+    ea::vector<Node> nodes_;
+    /// Triangle indices, each leaf owns a range of it
+    ea::vector<uint32_t> triangles_;
+public:
+    Bvh() = default;
+    explicit Bvh(const Shape& shape);
+
+    bool IsEmpty() const { return nodes_.empty(); }
+    size_t GetNodeCount() const { return nodes_.size(); }
+    /// Calls callback(size_t triangle) for all triangles whose bounds overlap the box
+    template<typename Callback>
+    void Query(const Vector3& min, const Vector3& max, Callback&& callback) const
+    {
+        if (nodes_.empty())
+            return;
+        // Children are pushed in pairs, a depth of 64 is more than enough for 2^32 triangles
+        uint32_t stack[64];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top != 0)
+        {
+            const Node& node = nodes_[stack[--top]];
+            if (node.min.x_ > max.x_ || node.max.x_ < min.x_ ||
+                node.min.y_ > max.y_ || node.max.y_ < min.y_ ||
+                node.min.z_ > max.z_ || node.max.z_ < min.z_)
+                continue;
+            if (node.left == 0)
+            {
+                for (uint32_t i = node.start; i < node.start + node.count; ++i)
+                    callback(static_cast<size_t>(triangles_[i]));
+                continue;
+            }
+            stack[top++] = node.left;
+            stack[top++] = node.left + 1;
+        }
+    }
+};
+
+}
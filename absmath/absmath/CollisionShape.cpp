@@ -108,91 +108,135 @@ bool AbstractCollisionShape::Collides(const AbstractCollisionShape& other, const
     }
 }
 
-bool AbstractCollisionShape::GetManifold(CollisionManifold& manifold, const Matrix4& transformation) const
-{
-    // We know we are colliding with this object. this simplifies stuff.
-
-    bool result = false;
-    // Transform to world coordinates
-    const Shape shape = GetShape();
+namespace {
 
-    // World coordinates
+/// Test one triangle in ellipsoid space
+bool TestTriangle(CollisionManifold& manifold, const Vector3& p1, const Vector3& p2, const Vector3& p3,
+    const Vector3& normalizedVelocity, float distanceToTravel)
+{
     const Vector3& source = manifold.position;
-    Vector3 normalizedVelocity = manifold.velocity.Normal();
 
-    float distanceToTravel = manifold.velocity.Length();
+    Vector3 planeOrigin = p1;
+    Vector3 v1 = p2 - p1;
+    Vector3 v2 = p3 - p1;
 
-    // Radius is 1 because the points are in our ellipsoid space
-    const Sphere sphere(source, 1.0f);
+    if (v1.Equals(Vector3::Zero) || v2.Equals(Vector3::Zero))
+        return false;
 
-    Vector3 sphereIntersectionPoint;
-    Vector3 planeIntersectionPoint;
-    Vector3 polyIntersectionPoint;
+    const Vector3 planeNormal = v1.CrossProduct(v2).Normal();
 
+    Vector3 sphereIntersectionPoint = source - planeNormal;
+    Vector3 planeIntersectionPoint;
     float distToPlaneIntersection = 0.0f;
-    float distToEllipsoidIntersection = 0.0f;
 
-    for (size_t i = 0; i < shape.GetCount(); i += 3)
+    PointClass pointClass = GetPointClass(sphereIntersectionPoint, planeOrigin, planeNormal);
+    if (pointClass == PointClass::PlaneBack)
     {
-        // Scale the triangle to ellipsoid space
-        const Vector3 p1 = (transformation * shape.GetVertex(i)) / manifold.radius;
-        const Vector3 p2 = (transformation * shape.GetVertex(i + 1)) / manifold.radius;
-        const Vector3 p3 = (transformation * shape.GetVertex(i + 2)) / manifold.radius;
-
-        Vector3 planeOrigin = p1;
-        Vector3 v1 = p2 - p1;
-        Vector3 v2 = p3 - p1;
-
-        if (v1.Equals(Vector3::Zero) || v2.Equals(Vector3::Zero))
-            continue;
-
-        const Vector3 planeNormal = v1.CrossProduct(v2).Normal();
+        distToPlaneIntersection = IntersectsRayPlane(sphereIntersectionPoint, planeNormal, planeOrigin, planeNormal);
+        planeIntersectionPoint = sphereIntersectionPoint + (distToPlaneIntersection * planeNormal);
+    }
+    else
+    {
+        distToPlaneIntersection = IntersectsRayPlane(sphereIntersectionPoint, normalizedVelocity, planeOrigin, planeNormal);
+        planeIntersectionPoint = sphereIntersectionPoint + (distToPlaneIntersection * normalizedVelocity);
+    }
 
-        sphereIntersectionPoint = source - planeNormal;
+    Vector3 polyIntersectionPoint = planeIntersectionPoint;
+    float distToEllipsoidIntersection = distToPlaneIntersection;
 
-        PointClass pointClass = GetPointClass(sphereIntersectionPoint, planeOrigin, planeNormal);
-        if (pointClass == PointClass::PlaneBack)
-        {
-            distToPlaneIntersection = IntersectsRayPlane(sphereIntersectionPoint, planeNormal, planeOrigin, planeNormal);
-            planeIntersectionPoint = sphereIntersectionPoint + (distToPlaneIntersection * planeNormal);
-        }
-        else
+    if (!IsPointInTriangle(planeIntersectionPoint, p1, p2, p3))
+    {
+        polyIntersectionPoint = GetClosestPointOnTriangle(p1, p2, p3, planeIntersectionPoint);
+        // PolyPoint -> colliding object
+        distToEllipsoidIntersection = IntersectsRaySphere(polyIntersectionPoint, -normalizedVelocity, source, 1.0f);
+        if (distToEllipsoidIntersection > 0.0f)
         {
-            distToPlaneIntersection = IntersectsRayPlane(sphereIntersectionPoint, normalizedVelocity, planeOrigin, planeNormal);
-            planeIntersectionPoint = sphereIntersectionPoint + (distToPlaneIntersection * normalizedVelocity);
+            sphereIntersectionPoint = polyIntersectionPoint + distToEllipsoidIntersection * -normalizedVelocity;
         }
+    }
 
-        polyIntersectionPoint = planeIntersectionPoint;
-        distToEllipsoidIntersection = distToPlaneIntersection;
+    if (IsPointInSphere(polyIntersectionPoint, source, 0.3f))
+        manifold.stuck = true;
 
-        if (!IsPointInTriangle(planeIntersectionPoint, p1, p2, p3))
+    // Update collision data if we hit something
+    if ((distToEllipsoidIntersection > 0) && (distToEllipsoidIntersection <= distanceToTravel))
+    {
+        if (!manifold.foundCollision || (distToEllipsoidIntersection < manifold.nearestDistance))
         {
-            polyIntersectionPoint = GetClosestPointOnTriangle(p1, p2, p3, planeIntersectionPoint);
-            // PolyPoint -> colliding object
-            distToEllipsoidIntersection = IntersectsRaySphere(polyIntersectionPoint, -normalizedVelocity, source, 1.0f);
-            if (distToEllipsoidIntersection > 0.0f)
-            {
-                sphereIntersectionPoint = polyIntersectionPoint + distToEllipsoidIntersection * -normalizedVelocity;
-            }
+            manifold.nearestDistance = distToEllipsoidIntersection;
+            manifold.nearestIntersectionPoint = sphereIntersectionPoint;
+            manifold.nearestPolygonIntersectionPoint = polyIntersectionPoint;
+            manifold.foundCollision = true;
+            return true;
         }
+    }
+    return false;
+}
+
+/// Transform the triangle vertices to ellipsoid space in one pass, then test the triangles
+bool TestTriangles(CollisionManifold& manifold, ea::vector<Vector3>& vertices, const Matrix4& toEllipsoid)
+{
+#if defined(HAVE_DIRECTX_MATH)
+    const XMath::XMMATRIX matrix = toEllipsoid;
+    for (auto& vertex : vertices)
+        vertex = XMath::XMVector3Transform(vertex, matrix);
+#else
+    for (auto& vertex : vertices)
+        vertex = toEllipsoid * vertex;
+#endif
+
+    const Vector3 normalizedVelocity = manifold.velocity.Normal();
+    const float distanceToTravel = manifold.velocity.Length();
+    bool result = false;
+    for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+    {
+        if (TestTriangle(manifold, vertices[i], vertices[i + 1], vertices[i + 2], normalizedVelocity, distanceToTravel))
+            result = true;
+    }
+    return result;
+}
+
+}
+
+bool AbstractCollisionShape::GetManifold(CollisionManifold& manifold, const Matrix4& transformation) const
+{
+    // We know we are colliding with this object. this simplifies stuff.
 
-        if (IsPointInSphere(polyIntersectionPoint, source, 0.3f))
-            manifold.stuck = true;
+    // Scale world coordinates to our ellipsoid space, where the radius is 1
+    const Matrix4 toEllipsoid = transformation * Matrix4::FromScale(Vector3::One / manifold.radius);
+    // Reused by all calls on this thread
+    thread_local ea::vector<Vector3> vertices;
+    vertices.clear();
 
-        // Update collision data if we hit something
-        if ((distToEllipsoidIntersection > 0) && (distToEllipsoidIntersection <= distanceToTravel))
+    if (shapeType_ == ShapeType::TriangleMesh)
+    {
+        // Don't copy the mesh, only collect the triangles we may hit
+        const TriangleMesh& mesh = static_cast<const CollisionShape<TriangleMesh>&>(*this).Object();
+        const Matrix4 meshToEllipsoid = mesh.matrix_ * toEllipsoid;
+        if (mesh.bvh_)
         {
-            if (!manifold.foundCollision || (distToEllipsoidIntersection < manifold.nearestDistance))
+            // All points the sphere can hit are within this distance of its position
+            const float reach = 1.0f + manifold.velocity.Length() + M_EPSILON;
+            const BoundingBox bounds = BoundingBox(manifold.position - reach, manifold.position + reach)
+                .Transformed(meshToEllipsoid.Inverse());
+            mesh.bvh_->Query(bounds.min_, bounds.max_, [&](size_t triangle)
             {
-                manifold.nearestDistance = distToEllipsoidIntersection;
-                manifold.nearestIntersectionPoint = sphereIntersectionPoint;
-                manifold.nearestPolygonIntersectionPoint = polyIntersectionPoint;
-                manifold.foundCollision = true;
-                result = true;
-            }
+                vertices.push_back(mesh.GetLocalVertex(triangle * 3));
+                vertices.push_back(mesh.GetLocalVertex(triangle * 3 + 1));
+                vertices.push_back(mesh.GetLocalVertex(triangle * 3 + 2));
+            });
         }
+        else
+        {
+            for (size_t i = 0; i < mesh.GetCount(); ++i)
+                vertices.push_back(mesh.GetLocalVertex(i));
+        }
+        return TestTriangles(manifold, vertices, meshToEllipsoid);
     }
-    return result;
-}
 
+    const Shape shape = GetShape();
+    for (size_t i = 0; i < shape.GetCount(); ++i)
+        vertices.push_back(shape.GetVertex(i));
+    return TestTriangles(manifold, vertices, toEllipsoid);
+}
 }
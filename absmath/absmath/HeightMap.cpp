@@ -26,10 +26,111 @@
 #include "ConvexHull.h"
 #include "Shape.h"
 #include <sa/Assert.h>
+#include <algorithm>
 #include "TriangleMesh.h"
 
 namespace Math {
 
+namespace {
+
+/// Intersect a ray with an axis aligned box, enter is the distance where the ray enters it
+bool IntersectsBox(const Vector3& origin, const Vector3& direction,
+    const Vector3& min, const Vector3& max, float maxDist, float& enter)
+{
+    float tMin = 0.0f;
+    float tMax = maxDist;
+    for (int i = 0; i < 3; ++i)
+    {
+        const float o = origin.Data()[i];
+        const float d = direction.Data()[i];
+        if (d == 0.0f)
+        {
+            if (o < min.Data()[i] || o > max.Data()[i])
+                return false;
+            continue;
+        }
+        float t1 = (min.Data()[i] - o) / d;
+        float t2 = (max.Data()[i] - o) / d;
+        if (t1 > t2)
+            std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax)
+            return false;
+    }
+    enter = tMin;
+    return true;
+}
+
+/// Exact intersection with the two triangles of the cell x, z. Ray x and z are in
+/// cells, y in world units. heights are the world heights of the corners
+/// (x, z), (x + 1, z), (x, z + 1), (x + 1, z + 1). Same triangles as GetHeight().
+float IntersectsCell(const Vector3& origin, const Vector3& direction, int x, int z,
+    const float (&heights)[4], float maxDist)
+{
+    const Vector3 min(static_cast<float>(x), -M_INFINITE, static_cast<float>(z));
+    const Vector3 max(static_cast<float>(x + 1), M_INFINITE, static_cast<float>(z + 1));
+    float t0 = 0.0f;
+    if (!IntersectsBox(origin, direction, min, max, maxDist, t0))
+        return M_INFINITE;
+    // Exit of the cell
+    float t1 = maxDist;
+    for (int i : { 0, 2 })
+    {
+        const float d = direction.Data()[i];
+        if (d == 0.0f)
+            continue;
+        const float bound = d > 0.0f ? max.Data()[i] : min.Data()[i];
+        t1 = std::min(t1, (bound - origin.Data()[i]) / d);
+    }
+
+    const auto fracX = [&](float t) { return origin.x_ + direction.x_ * t - min.x_; };
+    const auto fracZ = [&](float t) { return origin.z_ + direction.z_ * t - min.z_; };
+    const auto distance = [&](float t, bool upper)
+    {
+        const float fx = fracX(t);
+        const float fz = fracZ(t);
+        const float h = upper ?
+            heights[3] + (heights[2] - heights[3]) * (1.0f - fx) + (heights[1] - heights[3]) * (1.0f - fz) :
+            heights[0] + (heights[1] - heights[0]) * fx + (heights[2] - heights[0]) * fz;
+        return origin.y_ + direction.y_ * t - h;
+    };
+
+    // The diagonal splits the interval in up to 2 parts, the height is linear in each
+    float split[3] = { t0, t1, t1 };
+    size_t count = 2;
+    const float ds = direction.x_ + direction.z_;
+    if (ds != 0.0f)
+    {
+        const float td = (1.0f - (fracX(0.0f) + fracZ(0.0f))) / ds;
+        if (td > t0 && td < t1)
+        {
+            split[1] = td;
+            count = 3;
+        }
+    }
+    for (size_t i = 0; i + 1 < count; ++i)
+    {
+        const float a = split[i];
+        const float b = split[i + 1];
+        const float mid = (a + b) * 0.5f;
+        const bool upper = fracX(mid) + fracZ(mid) >= 1.0f;
+        // Undefined heights can not be hit
+        if (IsNegInfinite(heights[1]) || IsNegInfinite(heights[2]) ||
+            IsNegInfinite(upper ? heights[3] : heights[0]))
+            continue;
+        const float da = distance(a, upper);
+        if (da < 0.0f)
+            return a;
+        const float db = distance(b, upper);
+        if (db < 0.0f)
+            return a + (b - a) * (da / (da - db));
+    }
+    return M_INFINITE;
+}
+
+}
+
 HeightMap::HeightMap() :
     patchSize_(0),
     minHeight_(std::numeric_limits<float>::max()),
@@ -48,6 +149,56 @@ void HeightMap::ProcessData()
 
     boundingBox_.min_ = -halfExtends;
     boundingBox_.max_ = halfExtends;
+
+    BuildHeightRanges();
+}
+
+void HeightMap::BuildHeightRanges()
+{
+    heightRanges_.clear();
+    const IntVector2 cells(numVertices_.x_ - 1, numVertices_.y_ - 1);
+    if (cells.x_ < 1 || cells.y_ < 1 ||
+        heightData_.size() < static_cast<size_t>(numVertices_.x_) * static_cast<size_t>(numVertices_.y_))
+        return;
+
+    HeightRangeLevel level0;
+    level0.size = cells;
+    level0.ranges.resize(static_cast<size_t>(cells.x_) * static_cast<size_t>(cells.y_));
+    for (int z = 0; z < cells.y_; ++z)
+    {
+        for (int x = 0; x < cells.x_; ++x)
+        {
+            HeightRange& range = level0.ranges[static_cast<size_t>(z) * static_cast<size_t>(cells.x_) + static_cast<size_t>(x)];
+            for (float h : { GetRawHeight(x, z), GetRawHeight(x + 1, z), GetRawHeight(x, z + 1), GetRawHeight(x + 1, z + 1) })
+            {
+                // Triangles with undefined heights can not be hit, they don't count
+                if (IsNegInfinite(h))
+                    continue;
+                range.min = std::min(range.min, h);
+                range.max = std::max(range.max, h);
+            }
+        }
+    }
+    heightRanges_.push_back(std::move(level0));
+
+    while (heightRanges_.back().size.x_ > 1 || heightRanges_.back().size.y_ > 1)
+    {
+        const HeightRangeLevel& prev = heightRanges_.back();
+        HeightRangeLevel level;
+        level.size = IntVector2((prev.size.x_ + 1) / 2, (prev.size.y_ + 1) / 2);
+        level.ranges.resize(static_cast<size_t>(level.size.x_) * static_cast<size_t>(level.size.y_));
+        for (int z = 0; z < prev.size.y_; ++z)
+        {
+            for (int x = 0; x < prev.size.x_; ++x)
+            {
+                const HeightRange& child = prev.ranges[static_cast<size_t>(z) * static_cast<size_t>(prev.size.x_) + static_cast<size_t>(x)];
+                HeightRange& range = level.ranges[static_cast<size_t>(z / 2) * static_cast<size_t>(level.size.x_) + static_cast<size_t>(x / 2)];
+                range.min = std::min(range.min, child.min);
+                range.max = std::max(range.max, child.max);
+            }
+        }
+        heightRanges_.push_back(std::move(level));
+    }
 }
 
 float HeightMap::GetRawHeight(int x, int z) const
@@ -147,6 +298,109 @@ Vector3 HeightMap::GetNormal(const Vector3& world) const
     return matrix_.Rotation() * n;
 }
 
+float HeightMap::CastRay(const Vector3& origin, const Vector3& direction, float maxDist, Vector3& position) const
+{
+    if (heightRanges_.empty())
+        return M_INFINITE;
+
+    // Ray in height map space, x and z in cells and y in world units like in GetHeight().
+    // The transformation is affine, so distances along the ray don't change.
+    const Vector3 localOrigin = inverseMatrix_ * origin;
+    const Vector3 localDirection = (inverseMatrix_ * (origin + direction)) - localOrigin;
+    const Vector3 rayOrigin(
+        (localOrigin.x_ - patchWorldOrigin_.x_) / spacing_.x_,
+        origin.y_,
+        (localOrigin.z_ - patchWorldOrigin_.y_) / spacing_.z_);
+    const Vector3 rayDirection(
+        localDirection.x_ / spacing_.x_,
+        direction.y_,
+        localDirection.z_ / spacing_.z_);
+    const float scaleY = matrix_.Scaling().y_;
+    const float offsetY = matrix_.Translation().y_;
+    const IntVector2& cells = heightRanges_.front().size;
+
+    struct Node
+    {
+        int level;
+        int x;
+        int z;
+        float enter;
+    };
+    // Returns false when the ray misses the node or it is entirely above the ray.
+    // There is no lower bound, because everything below the surface counts as hit.
+    const auto intersectsNode = [&](Node& node) -> bool
+    {
+        const HeightRangeLevel& level = heightRanges_[static_cast<size_t>(node.level)];
+        const HeightRange& range = level.ranges[static_cast<size_t>(node.z) * static_cast<size_t>(level.size.x_) + static_cast<size_t>(node.x)];
+        if (range.min > range.max)
+            return false;
+        const int size = 1 << node.level;
+        // Some slack for rounding errors, no need to be tight here
+        const float top = (scaleY >= 0.0f ? range.max : range.min) * scaleY + offsetY + 0.001f;
+        const Vector3 min(static_cast<float>(node.x * size), -M_INFINITE, static_cast<float>(node.z * size));
+        const Vector3 max(
+            static_cast<float>(std::min((node.x + 1) * size, cells.x_)),
+            top,
+            static_cast<float>(std::min((node.z + 1) * size, cells.y_)));
+        return IntersectsBox(rayOrigin, rayDirection, min, max, maxDist, node.enter);
+    };
+
+    // Each node pushes at most 4 children
+    Node stack[4 * 32];
+    size_t top = 0;
+    Node root = { static_cast<int>(heightRanges_.size()) - 1, 0, 0, 0.0f };
+    if (!intersectsNode(root))
+        return M_INFINITE;
+    stack[top++] = root;
+
+    while (top != 0)
+    {
+        const Node node = stack[--top];
+        if (node.level == 0)
+        {
+            float heights[4];
+            int i = 0;
+            for (int z = node.z; z < node.z + 2; ++z)
+            {
+                for (int x = node.x; x < node.x + 2; ++x)
+                {
+                    const float h = GetRawHeight(x, z);
+                    heights[i++] = IsNegInfinite(h) ? -M_INFINITE : h * scaleY + offsetY;
+                }
+            }
+            const float distance = IntersectsCell(rayOrigin, rayDirection, node.x, node.z, heights, maxDist);
+            if (!IsInfinite(distance))
+            {
+                position = origin + direction * distance;
+                return distance;
+            }
+            continue;
+        }
+
+        const HeightRangeLevel& childLevel = heightRanges_[static_cast<size_t>(node.level) - 1];
+        Node children[4];
+        size_t count = 0;
+        for (int z = node.z * 2; z < std::min(node.z * 2 + 2, childLevel.size.y_); ++z)
+        {
+            for (int x = node.x * 2; x < std::min(node.x * 2 + 2, childLevel.size.x_); ++x)
+            {
+                Node child = { node.level - 1, x, z, 0.0f };
+                if (intersectsNode(child))
+                    children[count++] = child;
+            }
+        }
+        // Children don't overlap, visiting the closest first makes the first hit the closest one
+        std::sort(children, children + count, [](const Node& lhs, const Node& rhs)
+        {
+            return lhs.enter > rhs.enter;
+        });
+        ASSERT(top + count <= sizeof(stack) / sizeof(stack[0]));
+        for (size_t i = 0; i < count; ++i)
+            stack[top++] = children[i];
+    }
+    return M_INFINITE;
+}
+
 void HeightMap::SetMatrix(const Matrix4& matrix)
 {
     matrix_ = matrix;
@@ -27,6 +27,7 @@
 #include "Point.h"
 #include "Matrix4.h"
 #include <eastl.hpp>
+#include <limits>
 
 namespace Math {
 
@@ -36,13 +37,31 @@ class TriangleMesh;
 class HeightMap
 {
 private:
+    /// Min and max height of a cell or a block of cells. Empty when all
+    /// triangles in it have undefined heights.
+    struct HeightRange
+    {
+        float min{ std::numeric_limits<float>::max() };
+        float max{ std::numeric_limits<float>::lowest() };
+    };
+    /// One level of the min/max hierarchy
+    struct HeightRangeLevel
+    {
+        IntVector2 size;
+        ea::vector<HeightRange> ranges;
+    };
     /// Transformation matrix
     Matrix4 matrix_ = Matrix4::Identity;
     Matrix4 inverseMatrix_;
+    /// Level 0 has the cells between 4 vertices, each next level combines 2x2 of the
+    /// previous level. The last level has one element which covers the whole height map.
+    ea::vector<HeightRangeLevel> heightRanges_;
+    void BuildHeightRanges();
 public:
     HeightMap();
     HeightMap(const HeightMap& other) :
         matrix_(other.matrix_),
+        heightRanges_(other.heightRanges_),
         spacing_(other.spacing_),
         patchSize_(other.patchSize_),
         minHeight_(other.minHeight_),
@@ -56,6 +75,7 @@ public:
     {}
     HeightMap(HeightMap&& other) noexcept :
         matrix_(std::move(other.matrix_)),
+        heightRanges_(std::move(other.heightRanges_)),
         spacing_(std::move(other.spacing_)),
         patchSize_(other.patchSize_),
         minHeight_(other.minHeight_),
@@ -83,6 +103,7 @@ public:
             patchWorldOrigin_ = other.patchWorldOrigin_;
             heightData_ = other.heightData_;
             boundingBox_ = other.boundingBox_;
+            heightRanges_ = other.heightRanges_;
             matrix_ = other.matrix_;
         }
         return *this;
@@ -99,6 +120,7 @@ public:
         patchWorldOrigin_ = std::move(other.patchWorldOrigin_);
         heightData_ = std::move(other.heightData_);
         boundingBox_ = std::move(other.boundingBox_);
+        heightRanges_ = std::move(other.heightRanges_);
         matrix_ = std::move(other.matrix_);
         return *this;
     }
@@ -109,6 +131,9 @@ public:
     /// Return height at world coordinates.
     float GetHeight(const Vector3& world) const;
     Vector3 GetNormal(const Vector3& world) const;
+    /// Cast a ray against the surface. Returns the distance to the first point below
+    /// the surface or M_INFINITE when there is no hit within maxDist.
+    float CastRay(const Vector3& origin, const Vector3& direction, float maxDist, Vector3& position) const;
 
     BoundingBox GetBoundingBox() const
     {
@@ -140,6 +140,17 @@ public:
     float GetDistanceToTriangle(size_t i, const Vector3& pos) const;
     size_t GetClosestTriangleIndex(const Vector3& pos) const;
 
+    /// Vertex without the transformation matrix of the shape
+    const Vector3& GetLocalVertex(size_t index) const
+    {
+        if (indexCount_)
+        {
+            ASSERT(index < indexData_.size());
+            ASSERT(indexData_[index] < vertexData_.size());
+            return vertexData_[indexData_[index]];
+        }
+        return vertexData_[index];
+    }
     Vector3 GetVertex(size_t index) const
     {
         if (indexCount_)
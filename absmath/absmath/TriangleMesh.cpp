@@ -37,6 +37,7 @@ TriangleMesh::TriangleMesh(TriangleMesh&& other) noexcept
     indexCount_ = other.indexCount_;
     matrix_ = std::move(other.matrix_);
     boundingBox_ = std::move(other.boundingBox_);
+    bvh_ = std::move(other.bvh_);
 }
 
 TriangleMesh::TriangleMesh(const Shape& other) :
@@ -45,6 +46,13 @@ TriangleMesh::TriangleMesh(const Shape& other) :
     boundingBox_.Merge(other.vertexData_.data(), other.vertexData_.size());
 }
 
+TriangleMesh::TriangleMesh(const Shape& other, ea::shared_ptr<const Bvh> bvh) :
+    Shape(other),
+    bvh_(std::move(bvh))
+{
+    boundingBox_.Merge(other.vertexData_.data(), other.vertexData_.size());
+}
+
 Intersection TriangleMesh::IsInside(const Vector3& point) const
 {
     Shape shape2(point);
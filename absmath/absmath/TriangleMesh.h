@@ -22,6 +22,7 @@
 #pragma once
 
 #include "BoundingBox.h"
+#include "Bvh.h"
 #include "Shape.h"
 #include <eastl.hpp>
 
@@ -32,13 +33,17 @@ class TriangleMesh : public Shape
 public:
     TriangleMesh() = default;
     explicit TriangleMesh(const Shape& other);
+    /// bvh must be built from other, e.g. it is shared by all meshes of a model
+    TriangleMesh(const Shape& other, ea::shared_ptr<const Bvh> bvh);
     TriangleMesh(const TriangleMesh& other) :
         Shape(other),
-        boundingBox_(other.boundingBox_)
+        boundingBox_(other.boundingBox_),
+        bvh_(other.bvh_)
     {}
     TriangleMesh(const TriangleMesh& other, const Matrix4& matrix) :
         Shape(other, matrix),
-        boundingBox_(other.boundingBox_)
+        boundingBox_(other.boundingBox_),
+        bvh_(other.bvh_)
     {}
     TriangleMesh(TriangleMesh&& other) noexcept;
     ~TriangleMesh() = default;
@@ -53,6 +58,7 @@ public:
             indexCount_ = other.indexCount_;
             matrix_ = other.matrix_;
             boundingBox_ = other.boundingBox_;
+            bvh_ = other.bvh_;
         }
         return *this;
     }
@@ -64,6 +70,7 @@ public:
         indexCount_ = other.indexCount_;
         matrix_ = std::move(other.matrix_);
         boundingBox_ = std::move(other.boundingBox_);
+        bvh_ = std::move(other.bvh_);
         return *this;
     }
 
@@ -82,6 +89,8 @@ public:
     Shape GetShape() const { return TriangleMesh(*this); }
 
     BoundingBox boundingBox_;
+    /// Optional, when set only the triangles close to a colliding object are tested
+    ea::shared_ptr<const Bvh> bvh_;
 };
 
 }
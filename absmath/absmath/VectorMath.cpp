@@ -240,7 +240,7 @@ float IntersectsRaySphere(const Vector3& rayOrigin, const Vector3& rayVector, co
     Vector3 Q = sphereOrigin - rayOrigin;
     float c = Q.Length();
     float v = Q.DotProduct(rayVector);
-    float d = sphereRadius * sphereRadius + (c * c - v * v);
+    float d = sphereRadius * sphereRadius - (c * c - v * v);
     if (d < 0.0f)
         return -1.0f;
     return (v - sqrt(d));
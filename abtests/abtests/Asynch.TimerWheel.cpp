@@ -0,0 +1,204 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+
+#include <abscommon/TimerWheel.h>
+#include <queue>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct TestTimer : public Asynch::TimerNode
+{
+    uint32_t id{ 0 };
+    int64_t firedAt{ -1 };
+};
+
+// What the Scheduler used before: a priority queue and a set of event IDs
+struct QueueTimer
+{
+    uint32_t id;
+    int64_t expires;
+};
+
+struct QueueTimerComparator
+{
+    bool operator()(const QueueTimer* lhs, const QueueTimer* rhs) const
+    {
+        return lhs->expires > rhs->expires;
+    }
+};
+
+struct PriorityQueueTimers
+{
+    std::priority_queue<QueueTimer*, std::deque<QueueTimer*>, QueueTimerComparator> events;
+    std::set<uint32_t> eventIds;
+    void Add(QueueTimer* timer)
+    {
+        eventIds.insert(timer->id);
+        events.push(timer);
+    }
+    void Cancel(uint32_t id)
+    {
+        eventIds.erase(id);
+    }
+    size_t Advance(int64_t now)
+    {
+        size_t result = 0;
+        while (!events.empty() && events.top()->expires <= now)
+        {
+            auto it = eventIds.find(events.top()->id);
+            if (it != eventIds.end())
+            {
+                eventIds.erase(it);
+                ++result;
+            }
+            events.pop();
+        }
+        return result;
+    }
+};
+
+std::vector<int64_t> MakeDelays(size_t count)
+{
+    std::mt19937 rng(42);
+    // Mostly game ticks and short effects, some long maintenance jobs
+    std::uniform_int_distribution<int64_t> shortDist(10, 100);
+    std::uniform_int_distribution<int64_t> longDist(100, 1000 * 60 * 10);
+    std::vector<int64_t> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        result.push_back((i % 10 == 0) ? longDist(rng) : shortDist(rng));
+    return result;
+}
+
+}
+
+TEST_CASE("TimerWheel expires in order")
+{
+    Asynch::TimerWheel wheel(1000);
+    std::vector<TestTimer> timers(5);
+    const int64_t delays[] = { 10, 300, 70000, 255, 20000000 };
+    for (size_t i = 0; i < timers.size(); ++i)
+    {
+        timers[i].id = static_cast<uint32_t>(i);
+        wheel.Add(&timers[i], 1000 + delays[i]);
+    }
+    REQUIRE(wheel.GetCount() == 5);
+
+    std::vector<uint32_t> fired;
+    int64_t now = 1000;
+    bool monotonic = true;
+    while (!wheel.IsEmpty())
+    {
+        const int64_t next = wheel.GetNextExpiration();
+        if (next < now)
+            monotonic = false;
+        now = next;
+        wheel.Advance(now, [&](Asynch::TimerNode* node)
+        {
+            auto* timer = static_cast<TestTimer*>(node);
+            timer->firedAt = now;
+            fired.push_back(timer->id);
+        });
+    }
+    REQUIRE(monotonic);
+    REQUIRE(fired == std::vector<uint32_t>{ 0, 3, 1, 2, 4 });
+    for (size_t i = 0; i < timers.size(); ++i)
+        REQUIRE(timers[i].firedAt == 1000 + delays[i]);
+}
+
+TEST_CASE("TimerWheel remove")
+{
+    Asynch::TimerWheel wheel(0);
+    TestTimer t1;
+    TestTimer t2;
+    wheel.Add(&t1, 50);
+    wheel.Add(&t2, 5000);
+    wheel.Remove(&t1);
+    REQUIRE(!t1.IsLinked());
+    REQUIRE(wheel.GetCount() == 1);
+    size_t fired = 0;
+    wheel.Advance(10000, [&](Asynch::TimerNode* node)
+    {
+        REQUIRE(node == &t2);
+        ++fired;
+    });
+    REQUIRE(fired == 1);
+    REQUIRE(wheel.IsEmpty());
+    REQUIRE(wheel.GetNextExpiration() == -1);
+}
+
+TEST_CASE("TimerWheel late advance")
+{
+    Asynch::TimerWheel wheel(0);
+    std::vector<TestTimer> timers(100);
+    for (size_t i = 0; i < timers.size(); ++i)
+        wheel.Add(&timers[i], static_cast<int64_t>(i * 977));
+    size_t fired = 0;
+    // Advancing in one big step must fire everything
+    wheel.Advance(100 * 977, [&](Asynch::TimerNode*) { ++fired; });
+    REQUIRE(fired == 100);
+}
+
+TEST_CASE("TimerWheel benchmark")
+{
+    for (size_t count : { size_t(10000), size_t(100000) })
+    {
+        const auto delays = MakeDelays(count);
+
+        std::vector<TestTimer> wheelTimers(count);
+        size_t wheelFired = 0;
+        BENCHMARK("TimerWheel " + std::to_string(count) + " timers")
+        {
+            Asynch::TimerWheel wheel(0);
+            wheelFired = 0;
+            for (size_t i = 0; i < count; ++i)
+                wheel.Add(&wheelTimers[i], delays[i]);
+            // Cancel every 4th like effects ending early
+            for (size_t i = 0; i < count; i += 4)
+                wheel.Remove(&wheelTimers[i]);
+            for (int64_t now = 0; !wheel.IsEmpty(); now += 10)
+                wheel.Advance(now, [&](Asynch::TimerNode*) { ++wheelFired; });
+        }
+
+        std::vector<QueueTimer> queueTimers(count);
+        size_t queueFired = 0;
+        BENCHMARK("priority_queue + set " + std::to_string(count) + " timers")
+        {
+            PriorityQueueTimers timers;
+            queueFired = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                queueTimers[i] = { static_cast<uint32_t>(i + 1), delays[i] };
+                timers.Add(&queueTimers[i]);
+            }
+            for (size_t i = 0; i < count; i += 4)
+                timers.Cancel(static_cast<uint32_t>(i + 1));
+            for (int64_t now = 0; !timers.events.empty(); now += 10)
+                queueFired += timers.Advance(now);
+        }
+        REQUIRE(wheelFired == queueFired);
+    }
+}
@@ -0,0 +1,245 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <catch.hpp>
+
+#include <abscommon/DataClient.h>
+#include <AB/Entities/Game.h>
+#include <abscommon/UuidUtils.h>
+#include <future>
+#include <thread>
+
+namespace {
+
+struct StubRequest
+{
+    IO::OpCodes opCode;
+    uint32_t id;
+    std::vector<uint8_t> key;
+};
+
+uint32_t ToInt32(const uint8_t* bytes)
+{
+    return (bytes[3] << 24) | (bytes[2] << 16) | (bytes[1] << 8) | bytes[0];
+}
+
+void AddInt32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    buffer.push_back(static_cast<uint8_t>(value));
+    buffer.push_back(static_cast<uint8_t>(value >> 8));
+    buffer.push_back(static_cast<uint8_t>(value >> 16));
+    buffer.push_back(static_cast<uint8_t>(value >> 24));
+}
+
+// Data server on localhost which answers whenever the test wants
+class StubServer
+{
+private:
+    asio::io_service ioService_;
+    asio::ip::tcp::acceptor acceptor_;
+public:
+    StubServer() :
+        acceptor_(ioService_, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+    { }
+    uint16_t GetPort() const { return acceptor_.local_endpoint().port(); }
+    asio::ip::tcp::socket Accept()
+    {
+        asio::ip::tcp::socket socket(ioService_);
+        acceptor_.accept(socket);
+        return socket;
+    }
+    static bool ReadRequest(asio::ip::tcp::socket& socket, StubRequest& request)
+    {
+        uint8_t header[IO::REQUEST_HEADER_SIZE];
+        asio::error_code ec;
+        asio::read(socket, asio::buffer(header), ec);
+        if (ec)
+            return false;
+        request.opCode = static_cast<IO::OpCodes>(header[0]);
+        request.id = ToInt32(&header[1]);
+        const size_t keySize = header[5] | (header[6] << 8);
+        const size_t dataSize = ToInt32(&header[7]);
+        request.key.resize(keySize);
+        std::vector<uint8_t> data(dataSize);
+        asio::read(socket, asio::buffer(request.key), ec);
+        if (!ec && dataSize != 0)
+            asio::read(socket, asio::buffer(data), ec);
+        return !ec;
+    }
+    // Answers a read of a Game with a game named after its UUID
+    static void AnswerGame(asio::ip::tcp::socket& socket, const StubRequest& request)
+    {
+        AB::Entities::Game game;
+        game.uuid = uuids::uuid(request.key.end() - 16, request.key.end()).to_string();
+        game.name = "Game " + game.uuid;
+        std::vector<uint8_t> data;
+        bitsery::quickSerialization<bitsery::OutputBufferAdapter<std::vector<uint8_t>>>(data, game);
+
+        std::vector<uint8_t> response;
+        response.push_back(static_cast<uint8_t>(IO::OpCodes::Data));
+        AddInt32(response, request.id);
+        AddInt32(response, static_cast<uint32_t>(data.size()));
+        response.insert(response.end(), data.begin(), data.end());
+        asio::write(socket, asio::buffer(response));
+    }
+};
+
+}
+
+TEST_CASE("DataClient")
+{
+    StubServer server;
+    asio::io_service ioService;
+    IO::DataClient client(ioService);
+    client.Connect("127.0.0.1", server.GetPort());
+    REQUIRE(client.IsConnected());
+
+    SECTION("Out of order answers")
+    {
+        static constexpr size_t COUNT = 3;
+        std::vector<uint32_t> ids;
+        std::thread serverThread([&server, &ids]()
+        {
+            auto socket = server.Accept();
+            std::vector<StubRequest> requests(COUNT);
+            for (auto& request : requests)
+            {
+                if (!StubServer::ReadRequest(socket, request))
+                    return;
+                ids.push_back(request.id);
+            }
+            // Last request first
+            for (auto it = requests.rbegin(); it != requests.rend(); ++it)
+                StubServer::AnswerGame(socket, *it);
+        });
+
+        std::vector<AB::Entities::Game> games(COUNT);
+        bool results[COUNT] = {};
+        std::vector<std::thread> clients;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            games[i].uuid = Utils::Uuid::New();
+            clients.emplace_back([&client, &games, &results, i]()
+            {
+                const std::string uuid = games[i].uuid;
+                results[i] = client.Read(games[i]) && games[i].name == "Game " + uuid;
+            });
+        }
+        for (auto& c : clients)
+            c.join();
+        serverThread.join();
+
+        REQUIRE(ids.size() == COUNT);
+        REQUIRE(ids[0] != ids[1]);
+        REQUIRE(ids[1] != ids[2]);
+        REQUIRE(ids[0] != ids[2]);
+        for (size_t i = 0; i < COUNT; ++i)
+            REQUIRE(results[i]);
+    }
+
+    SECTION("Lost connection")
+    {
+        std::thread serverThread([&server]()
+        {
+            {
+                // Close the connection without answering
+                auto socket = server.Accept();
+                StubRequest request;
+                StubServer::ReadRequest(socket, request);
+            }
+            // The next request reconnects
+            auto socket = server.Accept();
+            StubRequest request;
+            if (StubServer::ReadRequest(socket, request))
+                StubServer::AnswerGame(socket, request);
+        });
+
+        AB::Entities::Game game1;
+        game1.uuid = Utils::Uuid::New();
+        // The pending request fails instead of waiting forever
+        REQUIRE(!client.Read(game1));
+
+        AB::Entities::Game game2;
+        game2.uuid = Utils::Uuid::New();
+        const std::string uuid = game2.uuid;
+        const bool success = client.Read(game2);
+        serverThread.join();
+        REQUIRE(success);
+        REQUIRE(game2.name == "Game " + uuid);
+    }
+
+    SECTION("Async")
+    {
+        std::thread serverThread([&server]()
+        {
+            auto socket = server.Accept();
+            for (int i = 0; i < 2; ++i)
+            {
+                StubRequest request;
+                if (!StubServer::ReadRequest(socket, request))
+                    return;
+                StubServer::AnswerGame(socket, request);
+            }
+        });
+
+        AB::Entities::Game game1;
+        game1.uuid = Utils::Uuid::New();
+        const std::string uuid1 = game1.uuid;
+        auto result = client.ReadAsync(game1);
+
+        AB::Entities::Game game2;
+        game2.uuid = Utils::Uuid::New();
+        std::promise<std::string> name;
+        client.ReadAsync<AB::Entities::Game>(game2, [&name](bool success, AB::Entities::Game& game)
+        {
+            name.set_value(success ? game.name : "");
+        });
+
+        REQUIRE(result.get());
+        REQUIRE(game1.name == "Game " + uuid1);
+        REQUIRE(name.get_future().get() == "Game " + game2.uuid);
+        serverThread.join();
+    }
+
+    SECTION("Timeout")
+    {
+        client.SetRequestTimeout(200);
+        std::promise<void> done;
+        std::thread serverThread([&server, &done]()
+        {
+            // Read the request but never answer it
+            auto socket = server.Accept();
+            StubRequest request;
+            StubServer::ReadRequest(socket, request);
+            done.get_future().wait();
+        });
+
+        AB::Entities::Game game;
+        game.uuid = Utils::Uuid::New();
+        auto result = client.ReadAsync(game);
+        REQUIRE(result.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        REQUIRE(!result.get());
+        done.set_value();
+        serverThread.join();
+    }
+}
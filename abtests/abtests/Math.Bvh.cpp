@@ -0,0 +1,141 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <catch.hpp>
+
+#include <absmath/Bvh.h>
+#include <absmath/CollisionShape.h>
+#include <absmath/Quaternion.h>
+#include <absmath/TriangleMesh.h>
+
+namespace {
+
+// Floor of size x size quads, 2 triangles each, at y = 0
+Math::Shape CreateFloor(unsigned size)
+{
+    ea::vector<Math::Vector3> vertices;
+    for (unsigned z = 0; z <= size; ++z)
+        for (unsigned x = 0; x <= size; ++x)
+            vertices.push_back({ static_cast<float>(x), 0.0f, static_cast<float>(z) });
+    Math::Shape shape(vertices);
+    for (unsigned z = 0; z < size; ++z)
+    {
+        for (unsigned x = 0; x < size; ++x)
+        {
+            const unsigned i = z * (size + 1) + x;
+            shape.AddTriangle(i, i + size + 1, i + 1);
+            shape.AddTriangle(i + 1, i + size + 1, i + size + 2);
+        }
+    }
+    return shape;
+}
+
+}
+
+TEST_CASE("Bvh")
+{
+    const Math::Shape floor = CreateFloor(32);
+    const auto bvh = ea::make_shared<Math::Bvh>(floor);
+
+    SECTION("Query")
+    {
+        REQUIRE(!bvh->IsEmpty());
+        ea::vector<size_t> triangles;
+        // Only the 2 triangles of the quad (3, 5)
+        bvh->Query({ 3.25f, -1.0f, 5.25f }, { 3.75f, 1.0f, 5.75f }, [&](size_t triangle)
+        {
+            triangles.push_back(triangle);
+        });
+        REQUIRE(triangles.size() >= 2);
+        const size_t quad = (5 * 32 + 3) * 2;
+        REQUIRE(ea::find(triangles.begin(), triangles.end(), quad) != triangles.end());
+        REQUIRE(ea::find(triangles.begin(), triangles.end(), quad + 1) != triangles.end());
+
+        size_t count = 0;
+        bvh->Query({ 40.0f, -1.0f, 40.0f }, { 41.0f, 1.0f, 41.0f }, [&](size_t) { ++count; });
+        REQUIRE(count == 0);
+
+        count = 0;
+        bvh->Query({ -1.0f, -1.0f, -1.0f }, { 33.0f, 1.0f, 33.0f }, [&](size_t) { ++count; });
+        REQUIRE(count == floor.GetTriangleCount());
+    }
+
+    SECTION("Ellipsoid space")
+    {
+        // Mesh matrix first, then the transformation of the object, then scaled by the radius
+        const Math::Matrix4 matrix({ 1.0f, 2.0f, 3.0f }, Math::Quaternion::FromAxisAngle(Math::Vector3::UnitY, 0.5f), { 2.0f, 1.0f, 2.0f });
+        const Math::Matrix4 transformation({ -4.0f, 0.5f, 7.0f }, Math::Quaternion::FromAxisAngle(Math::Vector3::UnitX, 0.2f), Math::Vector3::One);
+        const Math::Vector3 radius(0.5f, 2.0f, 0.5f);
+        const Math::Matrix4 combined = matrix * transformation * Math::Matrix4::FromScale(Math::Vector3::One / radius);
+        const Math::Vector3 v(3.0f, -1.0f, 2.0f);
+        const Math::Vector3 expected = (transformation * (matrix * v)) / radius;
+        const Math::Vector3 result = XMath::XMVector3Transform(v, combined);
+        REQUIRE(result.x_ == Approx(expected.x_));
+        REQUIRE(result.y_ == Approx(expected.y_));
+        REQUIRE(result.z_ == Approx(expected.z_));
+    }
+
+    SECTION("Manifold")
+    {
+        const Math::Matrix4 transformation({ -10.0f, 0.0f, -10.0f }, Math::Quaternion::Identity, Math::Vector3::One);
+        Math::CollisionShape<Math::TriangleMesh> withBvh(Math::ShapeType::TriangleMesh, floor, bvh);
+        Math::CollisionShape<Math::TriangleMesh> withoutBvh(Math::ShapeType::TriangleMesh, floor);
+
+        Math::CollisionManifold m1;
+        m1.radius = { 0.5f, 1.0f, 0.5f };
+        // Falling down onto the floor, in ellipsoid space
+        m1.position = Math::Vector3(0.0f, 1.5f, 3.0f) / m1.radius;
+        m1.velocity = Math::Vector3(0.0f, -1.0f, 0.0f) / m1.radius;
+        Math::CollisionManifold m2 = m1;
+
+        REQUIRE(withBvh.GetManifold(m1, transformation));
+        REQUIRE(withoutBvh.GetManifold(m2, transformation));
+        REQUIRE(m1.foundCollision);
+        REQUIRE(m1.nearestDistance == Approx(m2.nearestDistance));
+        REQUIRE(m1.nearestDistance == Approx(0.5f));
+        REQUIRE(m1.nearestPolygonIntersectionPoint.y_ == Approx(m2.nearestPolygonIntersectionPoint.y_));
+
+        // Rotated, must still give the same result as testing all triangles
+        const Math::Matrix4 rotated({ -10.0f, 0.0f, -10.0f }, Math::Quaternion::FromAxisAngle(Math::Vector3::UnitY, 0.3f), Math::Vector3::One);
+        for (float x = -2.0f; x < 20.0f; x += 1.7f)
+        {
+            Math::CollisionManifold r1;
+            r1.radius = { 0.5f, 1.0f, 0.5f };
+            r1.position = Math::Vector3(x, 1.2f, x * 0.5f) / r1.radius;
+            r1.velocity = Math::Vector3(0.3f, -1.0f, 0.2f) / r1.radius;
+            Math::CollisionManifold r2 = r1;
+            REQUIRE(withBvh.GetManifold(r1, rotated) == withoutBvh.GetManifold(r2, rotated));
+            REQUIRE(r1.foundCollision == r2.foundCollision);
+            REQUIRE(r1.stuck == r2.stuck);
+            if (r1.foundCollision)
+                REQUIRE(r1.nearestDistance == Approx(r2.nearestDistance));
+        }
+
+        // Far away from the floor
+        Math::CollisionManifold m3;
+        m3.radius = { 0.5f, 1.0f, 0.5f };
+        m3.position = { 0.0f, 10.0f, 3.0f };
+        m3.velocity = { 0.0f, -1.0f, 0.0f };
+        REQUIRE(!withBvh.GetManifold(m3, transformation));
+        REQUIRE(!m3.foundCollision);
+    }
+}
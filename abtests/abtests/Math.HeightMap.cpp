@@ -0,0 +1,229 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <catch.hpp>
+
+#include <absmath/HeightMap.h>
+#include <absmath/IO.h>
+#include <absmath/MathUtils.h>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+// Hills, size x size vertices centered at the origin
+void CreateHeightMap(Math::HeightMap& heightMap, int size)
+{
+    heightMap.numVertices_ = { size, size };
+    heightMap.spacing_ = { 1.0f, 1.0f, 1.0f };
+    heightMap.patchWorldOrigin_ = { -static_cast<float>(size - 1) * 0.5f, -static_cast<float>(size - 1) * 0.5f };
+    heightMap.heightData_.resize(static_cast<size_t>(size) * static_cast<size_t>(size));
+    for (int z = 0; z < size; ++z)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            const float h = std::sin(static_cast<float>(x) * 0.11f) * 6.0f +
+                std::cos(static_cast<float>(z) * 0.07f) * 9.0f +
+                std::sin(static_cast<float>(x + z) * 0.53f);
+            heightMap.heightData_[static_cast<size_t>(z) * static_cast<size_t>(size) + static_cast<size_t>(x)] = h;
+            heightMap.minHeight_ = std::min(heightMap.minHeight_, h);
+            heightMap.maxHeight_ = std::max(heightMap.maxHeight_, h);
+        }
+    }
+    heightMap.ProcessData();
+}
+
+// What TerrainPatch::CastRay did before, march with a fixed step
+float MarchRay(const Math::HeightMap& heightMap, const Math::Vector3& origin, const Math::Vector3& direction, float maxDist)
+{
+    const float dt = 0.1f;
+    float lh = 0.0f;
+    float ly = 0.0f;
+    float t = 0.001f;
+    while (t < maxDist)
+    {
+        const Math::Vector3 p = origin + direction * t;
+        const float h = heightMap.GetHeight(p);
+        if (p.y_ < h)
+            return (t - dt + dt * (lh - ly) / (p.y_ - ly - h + lh));
+        lh = h;
+        ly = p.y_;
+        t += dt;
+    }
+    return Math::M_INFINITE;
+}
+
+struct TestRay
+{
+    Math::Vector3 origin;
+    Math::Vector3 direction;
+};
+
+// Rays from above the terrain, mostly going down. They stay on the height map for maxDist.
+std::vector<TestRay> CreateRays(const Math::HeightMap& heightMap, size_t count, float maxDist)
+{
+    std::mt19937 gen(42);
+    const float extends = static_cast<float>(std::min(heightMap.numVertices_.x_, heightMap.numVertices_.y_) - 1) *
+        heightMap.spacing_.x_ * 0.5f - maxDist;
+    std::uniform_real_distribution<float> pos(-extends, extends);
+    std::uniform_real_distribution<float> height(heightMap.maxHeight_, heightMap.maxHeight_ + 5.0f);
+    std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> down(-1.0f, -0.05f);
+    std::vector<TestRay> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Math::Vector3 origin(pos(gen), height(gen), pos(gen));
+        const Math::Vector3 direction = Math::Vector3(dir(gen), down(gen), dir(gen)).Normal();
+        result.push_back({ origin, direction });
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("HeightMap CastRay")
+{
+    Math::HeightMap heightMap;
+    CreateHeightMap(heightMap, 129);
+
+    SECTION("Flat")
+    {
+        Math::HeightMap flat;
+        flat.numVertices_ = { 9, 9 };
+        flat.spacing_ = { 2.0f, 1.0f, 2.0f };
+        flat.patchWorldOrigin_ = { -8.0f, -8.0f };
+        flat.heightData_.resize(81, 5.0f);
+        flat.ProcessData();
+        flat.SetMatrix(Math::Matrix4::FromTranslation({ 0.0f, 1.0f, 0.0f }));
+
+        Math::Vector3 position;
+        const Math::Vector3 direction = Math::Vector3(1.0f, -1.0f, 0.5f).Normal();
+        const float distance = flat.CastRay({ -3.0f, 10.0f, 1.0f }, direction, 100.0f, position);
+        // 4 units down to the surface at y = 6
+        REQUIRE(distance == Approx(4.0f / -direction.y_));
+        REQUIRE(position.y_ == Approx(6.0f));
+        REQUIRE(position.x_ == Approx(-3.0f + direction.x_ * distance));
+
+        // Too short
+        REQUIRE(Math::IsInfinite(flat.CastRay({ -3.0f, 10.0f, 1.0f }, direction, 4.0f, position)));
+        // Going up
+        REQUIRE(Math::IsInfinite(flat.CastRay({ -3.0f, 10.0f, 1.0f }, -direction, 100.0f, position)));
+        // Outside
+        REQUIRE(Math::IsInfinite(flat.CastRay({ 20.0f, 10.0f, 0.0f }, Math::Vector3(1.0f, -1.0f, 0.0f).Normal(), 100.0f, position)));
+    }
+
+    SECTION("Undefined heights")
+    {
+        Math::HeightMap layer;
+        layer.numVertices_ = { 9, 9 };
+        layer.spacing_ = { 1.0f, 1.0f, 1.0f };
+        layer.patchWorldOrigin_ = { 0.0f, 0.0f };
+        layer.heightData_.resize(81, -Math::M_INFINITE);
+        // Only a platform at x, z 6..8
+        for (int z = 6; z < 9; ++z)
+            for (int x = 6; x < 9; ++x)
+                layer.heightData_[static_cast<size_t>(z * 9 + x)] = 2.0f;
+        layer.ProcessData();
+
+        Math::Vector3 position;
+        REQUIRE(Math::IsInfinite(layer.CastRay({ 2.0f, 5.0f, 2.0f }, { 0.0f, -1.0f, 0.0f }, 100.0f, position)));
+        REQUIRE(layer.CastRay({ 7.0f, 5.0f, 7.0f }, { 0.0f, -1.0f, 0.0f }, 100.0f, position) == Approx(3.0f));
+    }
+
+    SECTION("On the surface")
+    {
+        // Hits must be on the surface, and there must not be an earlier one
+        const float maxDist = 32.0f;
+        const auto rays = CreateRays(heightMap, 500, maxDist);
+        size_t hits = 0;
+        for (const auto& ray : rays)
+        {
+            Math::Vector3 position;
+            const float distance = heightMap.CastRay(ray.origin, ray.direction, maxDist, position);
+            const float marched = MarchRay(heightMap, ray.origin, ray.direction, maxDist);
+            if (Math::IsInfinite(distance))
+            {
+                REQUIRE(Math::IsInfinite(marched));
+                continue;
+            }
+            ++hits;
+            REQUIRE(heightMap.GetHeight(position) == Approx(position.y_).margin(0.001f));
+            for (float t = 0.0f; t < distance - 0.01f; t += 0.01f)
+            {
+                const Math::Vector3 p = ray.origin + ray.direction * t;
+                REQUIRE(p.y_ >= heightMap.GetHeight(p) - 0.001f);
+            }
+            // Marching overshoots by up to one step
+            if (!Math::IsInfinite(marched))
+                REQUIRE(distance <= marched + 0.1f);
+        }
+        REQUIRE(hits > 200);
+    }
+}
+
+TEST_CASE("HeightMap CastRay benchmark")
+{
+    Math::HeightMap heightMap;
+    // A real map with ABTESTS_HEIGHTMAP=path/to/file.hm
+    const char* file = std::getenv("ABTESTS_HEIGHTMAP");
+    if (file)
+    {
+        heightMap.heightData_ = IO::LoadHeightmap(file, heightMap.patchSize_,
+            heightMap.patchWorldSize_, heightMap.numPatches_,
+            heightMap.numVertices_, heightMap.patchWorldOrigin_,
+            heightMap.minHeight_, heightMap.maxHeight_);
+        heightMap.spacing_ = { 1.0f, 1.0f, 1.0f };
+        heightMap.ProcessData();
+    }
+    if (heightMap.heightData_.empty())
+        CreateHeightMap(heightMap, 1025);
+
+    // Terrain patches cast at most their size
+    const float maxDist = 32.0f;
+    const auto rays = CreateRays(heightMap, 1000, maxDist);
+
+    size_t marchedHits = 0;
+    BENCHMARK("Marching " + std::to_string(rays.size()) + " rays")
+    {
+        marchedHits = 0;
+        for (const auto& ray : rays)
+        {
+            if (!Math::IsInfinite(MarchRay(heightMap, ray.origin, ray.direction, maxDist)))
+                ++marchedHits;
+        }
+    }
+
+    size_t hits = 0;
+    BENCHMARK("Min/max hierarchy " + std::to_string(rays.size()) + " rays")
+    {
+        hits = 0;
+        for (const auto& ray : rays)
+        {
+            Math::Vector3 position;
+            if (!Math::IsInfinite(heightMap.CastRay(ray.origin, ray.direction, maxDist, position)))
+                ++hits;
+        }
+    }
+    // Marching may miss hits in its last step
+    REQUIRE(hits >= marchedHits);
+}
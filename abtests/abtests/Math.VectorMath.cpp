@@ -112,3 +112,17 @@ TEST_CASE("IsPointInSphere")
     bool res3 = Math::IsPointInSphere(pt3, origin, 1.0f);
     REQUIRE(!res3);
 }
+
+TEST_CASE("IntersectsRaySphere")
+{
+    Math::Vector3 origin{ 0.0f, 0.0f, 0.0f };
+
+    Math::Vector3 rayOrigin{ -5.0f, 0.0f, 0.0f };
+    float res = Math::IntersectsRaySphere(rayOrigin, Math::Vector3::UnitX, origin, 1.0f);
+    REQUIRE(res == Approx(4.0f));
+
+    // Passes by the sphere
+    Math::Vector3 rayOrigin2{ -5.0f, 2.0f, 0.0f };
+    float res2 = Math::IntersectsRaySphere(rayOrigin2, Math::Vector3::UnitX, origin, 1.0f);
+    REQUIRE(res2 < 0.0f);
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <catch.hpp>
+#include <sa/RingBuffer.h>
+#include <sa/SmartPtr.h>
+
+TEST_CASE("RingBuffer")
+{
+    SECTION("FIFO")
+    {
+        sa::RingBuffer<int> ring;
+        for (int i = 0; i < 5; ++i)
+            ring.PushBack(i);
+        REQUIRE(ring.Size() == 5);
+        REQUIRE(ring.Front() == 0);
+        REQUIRE(ring.Back() == 4);
+        ring.PopFront();
+        REQUIRE(ring.Front() == 1);
+        REQUIRE(ring.At(3) == 4);
+    }
+    SECTION("Grow wrapped")
+    {
+        sa::RingBuffer<int> ring(8);
+        REQUIRE(ring.Capacity() == 8);
+        for (int i = 0; i < 6; ++i)
+            ring.PushBack(i);
+        for (int i = 0; i < 4; ++i)
+            ring.PopFront();
+        // Head is now in the middle, the next pushes wrap around
+        for (int i = 6; i < 20; ++i)
+            ring.PushBack(i);
+        REQUIRE(ring.Capacity() == 16);
+        REQUIRE(ring.Size() == 16);
+        for (int i = 4; i < 20; ++i)
+        {
+            REQUIRE(ring.Front() == i);
+            ring.PopFront();
+        }
+        REQUIRE(ring.IsEmpty());
+    }
+    SECTION("Keeps slots")
+    {
+        sa::RingBuffer<int> ring;
+        for (int i = 0; i < 100; ++i)
+            ring.PushBack(i);
+        const size_t capacity = ring.Capacity();
+        ring.Clear();
+        REQUIRE(ring.IsEmpty());
+        REQUIRE(ring.Capacity() == capacity);
+    }
+    SECTION("Releases elements")
+    {
+        sa::RingBuffer<sa::SharedPtr<int>> ring;
+        sa::SharedPtr<int> p = sa::MakeShared<int>(1);
+        ring.PushBack(p);
+        REQUIRE(p.Refs() == 2);
+        ring.PopFront();
+        REQUIRE(p.Refs() == 1);
+    }
+}
@@ -4,6 +4,7 @@
 #define SA_LZ4_SUPPORT
 #include <sa/compress.h>
 #include <string>
+#include <memory>
 
 TEST_CASE("sa::compress zlib")
 {
@@ -64,3 +65,51 @@ TEST_CASE("sa::compress lz4")
     float ratio = (float)outputSize / (float)input.length();
     (void)ratio;
 }
+
+TEST_CASE("sa::compress lz4 stream")
+{
+    // Small history, so the ring buffer wraps around many times
+    static constexpr size_t HISTORY = 1024;
+    static constexpr size_t MAX_BLOCK = 256;
+    auto compress = std::make_unique<sa::lz4_stream_compress<HISTORY, MAX_BLOCK>>();
+    auto decompress = std::make_unique<sa::lz4_stream_decompress<HISTORY, MAX_BLOCK>>();
+    sa::lz4_compress blockCompress;
+
+    size_t streamSize = 0;
+    size_t blockSize = 0;
+    for (unsigned i = 0; i < 500; ++i)
+    {
+        // Similar messages, like object positions
+        std::string input;
+        for (unsigned j = 0; j < 1 + (i % 7); ++j)
+            input += "pos " + std::to_string(1000 + j) + " x " + std::to_string(i * 3 + j) + " y 12.5;";
+        REQUIRE(input.length() <= MAX_BLOCK);
+
+        std::string output;
+        output.resize(MAX_BLOCK * 2);
+        size_t outputSize = output.length();
+        REQUIRE(compress->operator()(input.data(), input.length(), output.data(), outputSize));
+        streamSize += outputSize;
+
+        std::string blockOutput;
+        blockOutput.resize(MAX_BLOCK * 2);
+        size_t blockOutputSize = blockOutput.length();
+        REQUIRE(blockCompress(input.data(), input.length(), blockOutput.data(), blockOutputSize));
+        blockSize += blockOutputSize;
+
+        std::string decompressed;
+        decompressed.resize(MAX_BLOCK);
+        size_t decompressedSize = decompressed.length();
+        REQUIRE(decompress->operator()(output.data(), outputSize, decompressed.data(), decompressedSize));
+        decompressed.resize(decompressedSize);
+        REQUIRE(input.compare(decompressed) == 0);
+
+        if (i == 250)
+        {
+            compress->reset();
+            decompress->reset();
+        }
+    }
+    // Referencing previous messages must be better than compressing each on its own
+    REQUIRE(streamSize < blockSize);
+}
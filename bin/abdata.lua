@@ -24,5 +24,8 @@ max_size = 1024 * 1024 * 1024
 flush_interval = 1000 * 60
 -- Clean cache every 10min
 clean_interval = 1000 * 60 * 10
+-- Threads loading records not in cache and flushing the cache. Each thread has
+-- its own database connection. 0 = number of CPU cores
+db_threads = 4
 
 require("config/db")
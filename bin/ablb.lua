@@ -11,5 +11,14 @@ lb_port = 2740
 lb_type = 4      -- Load balancer for Login Server (= type 4)
 -- If data_port is 0 a server list file must be given
 server_list = ""
+-- How to select the server for a new connection:
+--   least_load: Lowest load reported by the servers
+--   least_connections: Fewest connections relayed by this load balancer
+--   power_of_two: Fewer connections of two randomly selected servers
+lb_policy = "least_load"
+-- Interval in ms to read the servers from the data server
+lb_refresh_interval = 1000
+-- Threads relaying connections, 0 = number of CPU cores
+network_threads = 1
 
 require("config/data_server")
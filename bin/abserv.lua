@@ -10,6 +10,10 @@ require("config/data_server")
 
 data_dir = EXE_PATH .. "/data"
 recordings_dir = EXE_PATH .. "/recordings"
+-- Compiled Lua scripts, empty to disable
+script_cache_dir = EXE_PATH .. "/cache/scripts"
+-- Max time the Lua GC of a game may take per tick in microseconds
+lua_gc_budget_us = 1000
 record_games = false
 watch_assets = true
 
@@ -10,6 +10,7 @@ require("config/data_server")
 
 data_dir = "data"
 recordings_dir = "recordings"
+script_cache_dir = "cache/scripts"
 record_games = false
 
 -- 2nd Game server. Must listen of different ports.
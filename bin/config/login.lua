@@ -9,5 +9,13 @@ login_tries = 0
 -- how long the retry timeout until a new login can be made (without disabling the ip)
 login_retrytimeout = 5000
 
+-- Threads hashing and checking passwords, 0 = number of CPU cores
+password_threads = 0
+-- Max queued password jobs, when full new logins are rejected with "server busy".
+-- 0 = unlimited
+password_queue_size = 256
+-- Number of threads for client connections, 0 = number of CPU cores
+network_threads = 1
+
 -- DH keys
 server_keys = "abserver.dh"
@@ -16,3 +16,12 @@ ai_server_interval = 100
 
 -- DOS prevention
 max_packets_per_second = 60
+
+-- Number of threads running game updates. Each game is pinned to one thread.
+game_threads = 1
+-- Number of threads for client connections, 0 = number of CPU cores
+network_threads = 1
+-- Compress messages to clients which support it
+network_compression = true
+-- Number of connections to the data server. Many requests can be in flight on one connection.
+data_connections = 1
@@ -99,6 +99,8 @@ const char* Client::GetProtocolErrorMessage(AB::ErrorCodes err)
         return "Token authentication failure";
     case AB::ErrorCodes::AccountKeyAlreadyAdded:
         return "This account key was already added to the account";
+    case AB::ErrorCodes::ServerBusy:
+        return "The server is busy, please try again later.";
     default:
         return "";
     }
@@ -101,4 +101,15 @@ void InputMessage::FillBuffer(uint8_t* buffer, size_t size)
     size_ += size;
 }
 
+void InputMessage::SetBody(const uint8_t* data, size_t size)
+{
+    CheckWrite(static_cast<size_t>(pos_) + size);
+#ifdef _MSC_VER
+    memcpy_s(buffer_ + pos_, MaxBufferSize - pos_, data, size);
+#else
+    memcpy(buffer_ + pos_, data, size);
+#endif
+    size_ = (pos_ - headerPos_) + size;
+}
+
 }
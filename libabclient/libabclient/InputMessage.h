@@ -62,6 +62,8 @@ protected:
         pos_ = headerPos_;
     }
     void FillBuffer(uint8_t *buffer, size_t size);
+    /// Replace the unread data, e.g. with the decompressed data
+    void SetBody(const uint8_t* data, size_t size);
     void SetMessageSize(uint16_t size) { size_ = size; }
     std::string GetString();
     std::string GetStringEncrypted();
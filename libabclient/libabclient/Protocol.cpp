@@ -24,9 +24,15 @@
 #include <ctime>
 #include <AB/ProtocolCodes.h>
 #include <abcrypto.hpp>
+#define SA_LZ4_SUPPORT
+#include <sa/compress.h>
+#include <array>
 
 namespace Client {
 
+struct Protocol::Decompressor : public sa::lz4_stream_decompress<AB::COMPRESSION_HISTORY_SIZE, AB::COMPRESSION_MAX_BLOCK_SIZE>
+{ };
+
 Protocol::Protocol(Crypto::DHKeys& keys, asio::io_service& ioService) :
     inputMessage_(std::make_shared<InputMessage>()),
     ioService_(ioService),
@@ -44,6 +50,8 @@ Protocol::~Protocol()
 
 void Protocol::Connect(const std::string& host, uint16_t port)
 {
+    // New connection, new stream
+    decompressor_.reset();
     connection_ = std::make_shared<Connection>(ioService_);
     connection_->SetErrorCallback(std::bind(&Protocol::OnError, shared_from_this(),
         std::placeholders::_1, std::placeholders::_2));
@@ -53,6 +61,7 @@ void Protocol::Connect(const std::string& host, uint16_t port)
 void Protocol::Connect(const std::string& host, uint16_t port,
     std::function<void()>&& onConnect)
 {
+    decompressor_.reset();
     connection_ = std::make_shared<Connection>(ioService_);
     connection_->SetErrorCallback(std::bind(&Protocol::OnError, shared_from_this(),
         std::placeholders::_1, std::placeholders::_2));
@@ -100,6 +109,8 @@ void Protocol::InternalRecvHeader(uint8_t* buffer, size_t size)
 
     inputMessage_->FillBuffer(buffer, size);
     size_t remainingSize = inputMessage_->ReadSize();
+    compressedMessage_ = (remainingSize & AB::MESSAGE_COMPRESSED_FLAG) != 0;
+    remainingSize &= ~static_cast<size_t>(AB::MESSAGE_COMPRESSED_FLAG);
 
     // read remaining message data
     if (connection_)
@@ -121,10 +132,41 @@ void Protocol::InternalRecvData(uint8_t* buffer, size_t size)
         if (!XTEADecrypt(*inputMessage_))
             return;
     }
+    if (compressedMessage_)
+    {
+        // Can't continue with a broken stream
+        if (!Decompress(*inputMessage_))
+        {
+            Disconnect();
+            return;
+        }
+    }
+    else if (decompressor_)
+        // The server resets the stream when it sends an uncompressed message
+        decompressor_->reset();
 
     OnReceive(*inputMessage_);
 }
 
+bool Protocol::Decompress(InputMessage& inputMessage)
+{
+    if (!decompressor_)
+        decompressor_ = std::make_unique<Decompressor>();
+
+    const size_t compressedSize = inputMessage.Get<uint16_t>();
+    if (compressedSize > inputMessage.GetUnreadSize())
+        return false;
+    std::array<uint8_t, InputMessage::MaxBufferSize> buffer;
+    // What fits into the message after the current read position
+    size_t size = buffer.size() - InputMessage::MaxHeaderSize -
+        static_cast<size_t>(inputMessage.GetReadBuffer() - inputMessage.GetDataBuffer());
+    if (!(*decompressor_)(reinterpret_cast<const char*>(inputMessage.GetReadBuffer()), compressedSize,
+        reinterpret_cast<char*>(buffer.data()), size))
+        return false;
+    inputMessage.SetBody(buffer.data(), size);
+    return true;
+}
+
 bool Protocol::XTEADecrypt(InputMessage& inputMessage)
 {
     size_t encryptedSize = inputMessage.GetUnreadSize();
@@ -28,6 +28,7 @@
 #include <abcrypto.hpp>
 #include <AB/DHKeys.hpp>
 #include <AB/ProtocolCodes.h>
+#include <memory>
 
 namespace Client {
 
@@ -37,11 +38,16 @@ public:
     typedef std::function<void(ConnectionError connectionError, const std::error_code&)> ErrorCallback;
     typedef std::function<void(AB::ErrorCodes)> ProtocolErrorCallback;
 private:
+    struct Decompressor;
     std::shared_ptr<InputMessage> inputMessage_;
+    /// The message being received is compressed
+    bool compressedMessage_{ false };
+    std::unique_ptr<Decompressor> decompressor_;
     void InternalRecvHeader(uint8_t* buffer, size_t size);
     void InternalRecvData(uint8_t* buffer, size_t size);
     bool XTEADecrypt(InputMessage& inputMessage);
     void XTEAEncrypt(OutputMessage& outputMessage);
+    bool Decompress(InputMessage& inputMessage);
 protected:
     asio::io_service& ioService_;
     std::shared_ptr<Connection> connection_;
@@ -134,6 +134,7 @@ void ProtocolGame::Login(const std::string& accountUuid,
         AB::Packets::Client::GameLogin packet;
         packet.clientOs = AB::CLIENT_OS_CURRENT;
         packet.protocolVersion = AB::PROTOCOL_VERSION;
+        packet.compression = true;
         const DH_KEY& key = keys_.GetPublickKey();
         for (int i = 0; i < DH_KEY_LENGTH; ++i)
             packet.key[i] = key[i];
@@ -0,0 +1,193 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <asio.hpp>
+#include <uuid.h>
+#include <sa/ArgParser.h>
+#include <abscommon/DataClient.h>
+#include <abscommon/UuidUtils.h>
+#include <AB/Entities/Game.h>
+#include <AB/Entities/GameList.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct Latencies
+{
+    std::vector<double> hits;
+    std::vector<double> misses;
+};
+
+static void ShowHelp(const sa::arg_parser::cli& _cli)
+{
+    std::cout << sa::arg_parser::get_help("databench", _cli, "Benchmark data server read latency");
+    std::cout << std::endl;
+    std::cout << "Reads games from a running data server from many threads. Reads of" << std::endl;
+    std::cout << "existing games are answered from the cache, reads of random UUIDs" << std::endl;
+    std::cout << "always go to the database." << std::endl;
+}
+
+static void ShowInfo()
+{
+    std::cout << "databench - Benchmark data server read latency" << std::endl;
+    std::cout << "(C) 2020, Stefan Ascher" << std::endl << std::endl;
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+    const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return sorted[index];
+}
+
+static void PrintLatencies(const std::string& name, std::vector<double>& values)
+{
+    std::sort(values.begin(), values.end());
+    std::cout << std::setw(8) << std::left << name << std::right <<
+        std::setw(10) << values.size() <<
+        std::setw(10) << std::fixed << std::setprecision(3) << Percentile(values, 0.5) <<
+        std::setw(10) << Percentile(values, 0.9) <<
+        std::setw(10) << Percentile(values, 0.99) <<
+        std::setw(10) << (values.empty() ? 0.0 : values.back()) << std::endl;
+}
+
+static void RunClient(IO::DataClient& client, const std::vector<std::string>& games,
+    int requests, int missPercent, unsigned seed, Latencies& result)
+{
+    std::mt19937 rnd(seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<size_t> game(0, games.size() - 1);
+    result.hits.reserve(static_cast<size_t>(requests));
+    for (int i = 0; i < requests; ++i)
+    {
+        const bool miss = percent(rnd) < missPercent;
+        AB::Entities::Game g;
+        // A random UUID does not exist, so it is never cached
+        g.uuid = miss ? Utils::Uuid::New() : games[game(rnd)];
+        const auto start = Clock::now();
+        client.Read(g);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (miss)
+            result.misses.push_back(ms);
+        else
+            result.hits.push_back(ms);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ShowInfo();
+    sa::arg_parser::cli _cli{ {
+        { "help", { "-h", "--help", "-?" }, "Show help", false, false, sa::arg_parser::option_type::none },
+        { "host", { "-host", "--server-host" }, "Data server host (default localhost)", false, true, sa::arg_parser::option_type::string },
+        { "port", { "-port", "--server-port" }, "Data server port (default 2770)", false, true, sa::arg_parser::option_type::integer },
+        { "connections", { "-c", "--connections" }, "Connections to the data server (default 4)", false, true, sa::arg_parser::option_type::integer },
+        { "threads", { "-t", "--threads" }, "Reading threads (default 8)", false, true, sa::arg_parser::option_type::integer },
+        { "requests", { "-n", "--requests" }, "Reads per thread (default 10000)", false, true, sa::arg_parser::option_type::integer },
+        { "misses", { "-m", "--misses" }, "Percent of reads not in cache (default 5)", false, true, sa::arg_parser::option_type::integer }
+    } };
+
+    sa::arg_parser::values parsedArgs;
+    sa::arg_parser::result cmdres = sa::arg_parser::parse(argc, argv, _cli, parsedArgs);
+    auto val = sa::arg_parser::get_value<bool>(parsedArgs, "help");
+    if (val.has_value() && val.value())
+    {
+        ShowHelp(_cli);
+        return EXIT_SUCCESS;
+    }
+
+    if (!cmdres)
+    {
+        std::cout << cmdres << std::endl;
+        std::cout << "Type `databench -h` for help." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string host = sa::arg_parser::get_value<std::string>(parsedArgs, "host", "localhost");
+    const int port = sa::arg_parser::get_value<int>(parsedArgs, "port", 2770);
+    const int connections = std::max(1, sa::arg_parser::get_value<int>(parsedArgs, "connections", 4));
+    const int threads = std::max(1, sa::arg_parser::get_value<int>(parsedArgs, "threads", 8));
+    const int requests = std::max(1, sa::arg_parser::get_value<int>(parsedArgs, "requests", 10000));
+    const int misses = std::clamp(sa::arg_parser::get_value<int>(parsedArgs, "misses", 5), 0, 100);
+
+    asio::io_service ioService;
+    IO::DataClient client(ioService);
+    client.Connect(host, static_cast<uint16_t>(port), static_cast<size_t>(connections));
+    if (!client.IsConnected())
+    {
+        std::cerr << "Unable to connect to " << host << ":" << port << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    AB::Entities::GameList gl;
+    if (!client.Read(gl) || gl.gameUuids.empty())
+    {
+        std::cerr << "Unable to read the game list" << std::endl;
+        return EXIT_FAILURE;
+    }
+    // Warm up, after this all games are in the cache
+    for (const auto& uuid : gl.gameUuids)
+    {
+        AB::Entities::Game g;
+        g.uuid = uuid;
+        client.Read(g);
+    }
+
+    std::vector<Latencies> results(static_cast<size_t>(threads));
+    std::vector<std::thread> workers;
+    const auto start = Clock::now();
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(RunClient, std::ref(client), std::cref(gl.gameUuids),
+            requests, misses, static_cast<unsigned>(i + 1), std::ref(results[static_cast<size_t>(i)]));
+    }
+    for (auto& worker : workers)
+        worker.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Latencies total;
+    for (const auto& r : results)
+    {
+        total.hits.insert(total.hits.end(), r.hits.begin(), r.hits.end());
+        total.misses.insert(total.misses.end(), r.misses.begin(), r.misses.end());
+    }
+    std::vector<double> all = total.hits;
+    all.insert(all.end(), total.misses.begin(), total.misses.end());
+
+    std::cout << threads << " threads, " << connections << " connections, " << misses << "% misses" << std::endl;
+    std::cout << std::setw(8) << std::left << "Reads" << std::right <<
+        std::setw(10) << "Count" << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms" <<
+        std::setw(10) << "p99 ms" << std::setw(10) << "Max ms" << std::endl;
+    PrintLatencies("hit", total.hits);
+    PrintLatencies("miss", total.misses);
+    PrintLatencies("all", all);
+    std::cout << std::fixed << std::setprecision(0) << static_cast<double>(all.size()) / seconds << " reads/s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
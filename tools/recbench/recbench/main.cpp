@@ -0,0 +1,277 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <sa/ArgParser.h>
+#include <AB/ProtocolCodes.h>
+#define SA_LZ4_SUPPORT
+#include <sa/compress.h>
+
+using Message = std::vector<char>;
+using StreamCompress = sa::lz4_stream_compress<AB::COMPRESSION_HISTORY_SIZE, AB::COMPRESSION_MAX_BLOCK_SIZE>;
+using StreamDecompress = sa::lz4_stream_decompress<AB::COMPRESSION_HISTORY_SIZE, AB::COMPRESSION_MAX_BLOCK_SIZE>;
+using Clock = std::chrono::steady_clock;
+
+// Length header, checksum and XTEA padding the server adds to each message
+static constexpr size_t HEADER_SIZE = 6;
+static constexpr size_t XTEA_MULTIPLE = 8;
+
+struct Result
+{
+    size_t bytes{ 0 };
+    size_t wireBytes{ 0 };
+    double compressSeconds{ 0.0 };
+    double decompressSeconds{ 0.0 };
+};
+
+static void ShowHelp(const sa::arg_parser::cli& _cli)
+{
+    std::cout << sa::arg_parser::get_help("recbench", _cli, "Benchmark game message compression");
+    std::cout << std::endl;
+    std::cout << "Replays the game status messages of a recorded game (*.rec) through" << std::endl;
+    std::cout << "the compression modes of the game protocol." << std::endl;
+}
+
+static void ShowInfo()
+{
+    std::cout << "recbench - Benchmark game message compression" << std::endl;
+    std::cout << "(C) 2020, Stefan Ascher" << std::endl << std::endl;
+}
+
+static size_t WireSize(size_t bodySize)
+{
+    size_t size = bodySize;
+    if ((size % XTEA_MULTIPLE) != 0)
+        size += XTEA_MULTIPLE - (size % XTEA_MULTIPLE);
+    return size + HEADER_SIZE;
+}
+
+static double Seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static bool ReadRecording(const std::string& filename, std::vector<Message>& messages)
+{
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream.is_open())
+    {
+        std::cerr << "Unable to open file " << filename << std::endl;
+        return false;
+    }
+    char header[4] = { 0 };
+    stream.read(header, 4);
+    if (header[0] != 'R' || header[1] != 'E' || header[2] != 'C' || header[3] != '\0')
+    {
+        std::cerr << "Wrong file header " << filename << std::endl;
+        return false;
+    }
+    int16_t version = 0;
+    stream.read((char*)&version, sizeof(version));
+    if (version != 1)
+    {
+        std::cerr << "Wrong file version, got " << version << ", expected 1" << std::endl;
+        return false;
+    }
+    size_t size = 0;
+    stream.read((char*)&size, sizeof(size_t));
+    char uuid[36];
+    stream.read(uuid, 36);
+    int64_t startTime = 0;
+    stream.read((char*)&startTime, sizeof(startTime));
+
+    for (;;)
+    {
+        uint32_t msgSize = 0;
+        if (!stream.read((char*)&msgSize, sizeof(msgSize)))
+            break;
+        if (msgSize == 0)
+            continue;
+        Message msg(msgSize);
+        if (!stream.read(msg.data(), msgSize))
+        {
+            std::cerr << "Truncated message in " << filename << std::endl;
+            break;
+        }
+        messages.push_back(std::move(msg));
+    }
+    return true;
+}
+
+static Result BenchRaw(const std::vector<Message>& messages)
+{
+    Result result;
+    for (const auto& msg : messages)
+    {
+        result.bytes += msg.size();
+        result.wireBytes += WireSize(msg.size());
+    }
+    return result;
+}
+
+static Result BenchBlock(const std::vector<Message>& messages)
+{
+    Result result;
+    sa::lz4_compress compress;
+    sa::lz4_decompress decompress;
+    std::vector<char> out(LZ4_compressBound((int)AB::COMPRESSION_MAX_BLOCK_SIZE));
+    std::vector<char> check(AB::COMPRESSION_MAX_BLOCK_SIZE);
+    for (const auto& msg : messages)
+    {
+        if (msg.size() > AB::COMPRESSION_MAX_BLOCK_SIZE)
+        {
+            result.bytes += msg.size();
+            result.wireBytes += WireSize(msg.size());
+            continue;
+        }
+        auto start = Clock::now();
+        size_t outSize = out.size();
+        if (!compress(msg.data(), msg.size(), out.data(), outSize) || outSize + 2 >= msg.size())
+        {
+            result.compressSeconds += Seconds(start);
+            result.bytes += msg.size();
+            result.wireBytes += WireSize(msg.size());
+            continue;
+        }
+        result.compressSeconds += Seconds(start);
+        result.bytes += outSize + 2;
+        result.wireBytes += WireSize(outSize + 2);
+
+        start = Clock::now();
+        size_t checkSize = check.size();
+        if (!decompress(out.data(), outSize, check.data(), checkSize) ||
+            checkSize != msg.size() || memcmp(check.data(), msg.data(), checkSize) != 0)
+            std::cerr << "Block decompression failed" << std::endl;
+        result.decompressSeconds += Seconds(start);
+    }
+    return result;
+}
+
+// Same as the game protocol does it: messages that can not be compressed are sent
+// uncompressed and reset the stream on both sides.
+static Result BenchStream(const std::vector<Message>& messages)
+{
+    Result result;
+    auto compress = std::make_unique<StreamCompress>();
+    auto decompress = std::make_unique<StreamDecompress>();
+    std::vector<char> out(LZ4_compressBound((int)AB::COMPRESSION_MAX_BLOCK_SIZE));
+    std::vector<char> check(AB::COMPRESSION_MAX_BLOCK_SIZE);
+    for (const auto& msg : messages)
+    {
+        auto start = Clock::now();
+        size_t outSize = out.size();
+        if (msg.size() > AB::COMPRESSION_MAX_BLOCK_SIZE ||
+            !(*compress)(msg.data(), msg.size(), out.data(), outSize))
+        {
+            compress->reset();
+            result.compressSeconds += Seconds(start);
+            decompress->reset();
+            result.bytes += msg.size();
+            result.wireBytes += WireSize(msg.size());
+            continue;
+        }
+        result.compressSeconds += Seconds(start);
+        result.bytes += outSize + 2;
+        result.wireBytes += WireSize(outSize + 2);
+
+        start = Clock::now();
+        size_t checkSize = check.size();
+        if (!(*decompress)(out.data(), outSize, check.data(), checkSize) ||
+            checkSize != msg.size() || memcmp(check.data(), msg.data(), checkSize) != 0)
+            std::cerr << "Stream decompression failed" << std::endl;
+        result.decompressSeconds += Seconds(start);
+    }
+    return result;
+}
+
+static void PrintResult(const std::string& name, const Result& result, const Result& raw, size_t count)
+{
+    const double ratio = raw.wireBytes != 0 ? (double)result.wireBytes / (double)raw.wireBytes * 100.0 : 0.0;
+    std::cout << std::left << std::setw(8) << name << std::right
+        << std::setw(14) << result.bytes
+        << std::setw(14) << result.wireBytes
+        << std::setw(9) << std::fixed << std::setprecision(1) << ratio << "%"
+        << std::setw(12) << std::setprecision(3) << (count != 0 ? result.compressSeconds * 1000000.0 / (double)count : 0.0)
+        << std::setw(12) << (count != 0 ? result.decompressSeconds * 1000000.0 / (double)count : 0.0)
+        << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    ShowInfo();
+    sa::arg_parser::cli _cli{ {
+        { "help", { "-h", "--help", "-?" }, "Show help", false, false, sa::arg_parser::option_type::none },
+        { "files", {}, "Recorded games (*.rec)", true, true, sa::arg_parser::option_type::string }
+    } };
+
+    sa::arg_parser::values parsedArgs;
+    sa::arg_parser::result cmdres = sa::arg_parser::parse(argc, argv, _cli, parsedArgs);
+    auto val = sa::arg_parser::get_value<bool>(parsedArgs, "help");
+    if (val.has_value() && val.value())
+    {
+        ShowHelp(_cli);
+        return EXIT_SUCCESS;
+    }
+
+    if (!cmdres)
+    {
+        std::cout << cmdres << std::endl;
+        std::cout << "Type `recbench -h` for help." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Message> messages;
+    for (int i = 0; ; ++i)
+    {
+        auto file = sa::arg_parser::get_value<std::string>(parsedArgs, std::to_string(i));
+        if (!file.has_value())
+            break;
+        if (!ReadRecording(file.value(), messages))
+            return EXIT_FAILURE;
+    }
+    if (messages.empty())
+    {
+        std::cerr << "No messages" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const Result raw = BenchRaw(messages);
+    const Result block = BenchBlock(messages);
+    const Result stream = BenchStream(messages);
+
+    std::cout << messages.size() << " messages, history " << AB::COMPRESSION_HISTORY_SIZE <<
+        " bytes, max block " << AB::COMPRESSION_MAX_BLOCK_SIZE << " bytes" << std::endl << std::endl;
+    std::cout << std::left << std::setw(8) << "Mode" << std::right
+        << std::setw(14) << "Bytes"
+        << std::setw(14) << "Wire bytes"
+        << std::setw(10) << "Wire"
+        << std::setw(12) << "Comp us/msg"
+        << std::setw(12) << "Dec us/msg" << std::endl;
+    PrintResult("raw", raw, raw, messages.size());
+    PrintResult("block", block, raw, messages.size());
+    PrintResult("stream", stream, raw, messages.size());
+    return EXIT_SUCCESS;
+}